@@ -177,6 +177,16 @@ namespace espressopp {
       }
     }
 
+    /** fill the buffer with size bytes of data, e.g. read from a file,
+        and reset the read position */
+    void assign(const char* data, int size) {
+      usedSize = 0;
+      if (size > capacity) allocate(size);
+      for (int i = 0; i < size; i++) buf[i] = data[i];
+      usedSize = size;
+      pos      = 0;
+    }
+
     void recv(longint sender, int tag) {
 
       // blocking test for the incomming message
@@ -293,6 +303,10 @@ namespace espressopp {
       }
     }
 
+    /// packed data, e.g. to write it into a file
+    const char* getData() const { return buf; }
+    int getSize() const { return usedSize; }
+
     void send(longint receiver, int tag) {
       comm.send(receiver, tag, buf, pos);
       // printf("%d: send size = %d to %d\n", comm.rank(), pos, receiver);
@@ -41,8 +41,10 @@ namespace espressopp {
       
       Caution: This implementation needs double sided ghost
       communication! For single sided ghost communication one would
-      need some ghost-ghost cell interaction as well, which we do not
-      need!
+      need some ghost-ghost cell interaction as well, which is only
+      set up by the eighth-shell mode of the DomainDecomposition. There,
+      also ghost cells have neighbors, and the pair loops visit them
+      without the pairs inside the ghost cell.
 	
       It follows: inner cells: #neighbors = 14
       ghost cells:             #neighbors = 0
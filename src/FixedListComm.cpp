@@ -37,8 +37,11 @@ namespace espressopp {
         //std::cout << "fixedlist" << std::endl;
 
         LOG4ESPP_INFO(theLogger, "construct FixedPairList");
+        con4 = storage->requireFullGhostShell("FixedListComm");
         con1 = storage->beforeSendParticles.connect
           (boost::bind(&FixedListComm::beforeSendParticles, this, _1, _2));
+        con5 = storage->beforeSaveParticles.connect
+          (boost::bind(&FixedListComm::packParticles, this, _1, _2, false));
         con2 = storage->afterRecvParticles.connect
           (boost::bind(&FixedListComm::afterRecvParticles, this, _1, _2));
         con3 = storage->onParticlesChanged.connect
@@ -54,6 +57,8 @@ namespace espressopp {
         con1.disconnect();
         con2.disconnect();
         con3.disconnect();
+        con4.disconnect();
+        con5.disconnect();
     }
 
     bool FixedListComm::add(pvec pids) {
@@ -107,8 +112,11 @@ namespace espressopp {
         return true;
     }
 
-    void FixedListComm::beforeSendParticles
-                                    (ParticleList& pl, OutBuffer& buf) {
+    void FixedListComm::beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+      packParticles(pl, buf, true);
+    }
+
+    void FixedListComm::packParticles(ParticleList& pl, OutBuffer& buf, bool erase) {
 
         std::vector<longint> toSend;
 
@@ -146,7 +154,7 @@ namespace espressopp {
                 }
 
                 // delete all of these pairs from the global list
-                globalLists.erase(equalRange.first, equalRange.second);
+                if (erase) globalLists.erase(equalRange.first, equalRange.second);
             }
         }
         // send the list
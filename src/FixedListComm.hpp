@@ -35,7 +35,7 @@
 namespace espressopp {
     class FixedListComm: public PairList, public TripleList, public QuadrupleList {
         protected:
-        boost::signals2::connection con1, con2, con3;
+        boost::signals2::connection con1, con2, con3, con4, con5;
         shared_ptr<storage::Storage> storage;
         typedef std::vector<longint> pvec;
         typedef boost::unordered_multimap<longint, pvec> GlobalList;
@@ -51,6 +51,7 @@ namespace espressopp {
         ~FixedListComm();
         bool add(pvec pids);
         void beforeSendParticles(ParticleList& pl, class OutBuffer& buf);
+        void packParticles(ParticleList& pl, class OutBuffer& buf, bool erase);
         void afterRecvParticles(ParticleList& pl, class InBuffer& buf);
         void onParticlesChanged();
 
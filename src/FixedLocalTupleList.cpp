@@ -38,8 +38,11 @@ namespace espressopp {
     {
 	LOG4ESPP_INFO(theLogger, "construct FixedLocalTupleList");
 	
+	con4 = storage->requireFullGhostShell("FixedLocalTupleList");
 	con1 = storage->beforeSendParticles.connect
 	    (boost::bind(&FixedLocalTupleList::beforeSendParticles, this, _1, _2));
+	con5 = storage->beforeSaveParticles.connect
+	    (boost::bind(&FixedLocalTupleList::packParticles, this, _1, _2, false));
 	con2 = storage->afterRecvParticles.connect
 	    (boost::bind(&FixedLocalTupleList::afterRecvParticles, this, _1, _2));
 	con3 = storage->onParticlesChanged.connect
@@ -53,6 +56,8 @@ namespace espressopp {
 	con1.disconnect();
 	con2.disconnect();
 	con3.disconnect();
+	con4.disconnect();
+	con5.disconnect();
     }
     
     bool FixedLocalTupleList::
@@ -122,8 +127,11 @@ namespace espressopp {
         return alltuples;
     }
     
-    void FixedLocalTupleList::
-    beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+    void FixedLocalTupleList::beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+      packParticles(pl, buf, true);
+    }
+
+    void FixedLocalTupleList::packParticles(ParticleList& pl, OutBuffer& buf, bool erase) {
         std::vector<longint> toSend;
         // loop over the particle list
         for (ParticleList::Iterator pit(pl); pit.isValid(); ++pit) {
@@ -146,7 +154,7 @@ namespace espressopp {
                     toSend.push_back(*it2);
                 }
                 // delete this pid from the global list
-                globalTuples.erase(pidK);
+                if (erase) globalTuples.erase(pidK);
 		LOG4ESPP_DEBUG(theLogger, "Erase pid " << pidK);
             }
         }
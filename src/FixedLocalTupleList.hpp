@@ -33,7 +33,7 @@
 namespace espressopp {
     class FixedLocalTupleList : public TupleList {
     protected:
-	boost::signals2::connection con1, con2, con3;
+	boost::signals2::connection con1, con2, con3, con4, con5;
 	shared_ptr<storage::Storage> storage;
 	typedef std::vector<longint> tuple;
 	typedef std::multimap <longint,tuple > GlobalTuples;
@@ -45,6 +45,7 @@ namespace espressopp {
 	virtual ~FixedLocalTupleList();
 	virtual bool addTuple(boost::python::list& tuple);
 	virtual void beforeSendParticles(ParticleList& pl, class OutBuffer &buf);
+	void packParticles(ParticleList& pl, class OutBuffer& buf, bool erase);
 	void afterRecvParticles(ParticleList& pl, class InBuffer &buf);
 	virtual void onParticlesChanged();
 	
@@ -38,8 +38,11 @@ namespace espressopp {
   {
     LOG4ESPP_INFO(theLogger, "construct FixedPairDistList");
 
+    con4 = storage->requireFullGhostShell("FixedPairDistList");
     con1 = storage->beforeSendParticles.connect
       (boost::bind(&FixedPairDistList::beforeSendParticles, this, _1, _2));
+    con5 = storage->beforeSaveParticles.connect
+      (boost::bind(&FixedPairDistList::packParticles, this, _1, _2, false));
     con2 = storage->afterRecvParticles.connect
       (boost::bind(&FixedPairDistList::afterRecvParticles, this, _1, _2));
     con3 = storage->onParticlesChanged.connect
@@ -53,6 +56,8 @@ namespace espressopp {
     con1.disconnect();
     con2.disconnect();
     con3.disconnect();
+    con4.disconnect();
+    con5.disconnect();
   }
 
   bool FixedPairDistList::
@@ -145,9 +150,11 @@ namespace espressopp {
 	return returnVal;
   }
 
-  void FixedPairDistList::
-  beforeSendParticles(ParticleList& pl, 
-		      OutBuffer& buf) {
+  void FixedPairDistList::beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+    packParticles(pl, buf, true);
+  }
+
+  void FixedPairDistList::packParticles(ParticleList& pl, OutBuffer& buf, bool erase) {
     std::vector< longint > toSendInt;
     std::vector< real > toSendReal;
     // loop over the particle list
@@ -180,7 +187,7 @@ namespace espressopp {
 
         // delete all of these pairs from the global list
         //globalPairs.erase(equalRange.first->first, equalRange.second->first);
-        pairsDist.erase(pid);
+        if (erase) pairsDist.erase(pid);
         // std::cout << "erasing particle " << pid << " from here" << std::endl;
       }
     }
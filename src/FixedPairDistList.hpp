@@ -39,7 +39,7 @@ namespace espressopp {
 	class FixedPairDistList : public PairList{
 	  protected:
 	    typedef std::multimap<longint, std::pair<longint, real> > PairsDist;
-		boost::signals2::connection con1, con2, con3;
+		boost::signals2::connection con1, con2, con3, con4, con5;
 		shared_ptr <storage::Storage> storage;
 		PairsDist pairsDist;
 		using PairList::add;
@@ -56,6 +56,7 @@ namespace espressopp {
 		*/
 		virtual bool add(longint pid1, longint pid2);
 		virtual void beforeSendParticles(ParticleList& pl, class OutBuffer& buf);
+		void packParticles(ParticleList& pl, class OutBuffer& buf, bool erase);
 		void afterRecvParticles(ParticleList& pl, class InBuffer& buf);
 		virtual void onParticlesChanged();
 
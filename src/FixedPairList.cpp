@@ -30,6 +30,7 @@
 #include "Buffer.hpp"
 
 #include "esutil/Error.hpp"
+#include "esutil/PyBuffer.hpp"
 
 using namespace std;
 
@@ -53,8 +54,11 @@ namespace espressopp {
   {
     LOG4ESPP_INFO(theLogger, "construct FixedPairList");
 
+    sigFullGhostShell = storage->requireFullGhostShell("FixedPairList");
     sigBeforeSend = storage->beforeSendParticles.connect
       (boost::bind(&FixedPairList::beforeSendParticles, this, _1, _2));
+    sigBeforeSave = storage->beforeSaveParticles.connect
+      (boost::bind(&FixedPairList::packParticles, this, _1, _2, false));
     sigAfterRecv = storage->afterRecvParticles.connect
       (boost::bind(&FixedPairList::afterRecvParticles, this, _1, _2));
     sigOnParticlesChanged = storage->onParticlesChanged.connect
@@ -65,8 +69,10 @@ namespace espressopp {
 
     LOG4ESPP_INFO(theLogger, "~FixedPairList");
     sigBeforeSend.disconnect();
+    sigBeforeSave.disconnect();
     sigAfterRecv.disconnect();
     sigOnParticlesChanged.disconnect();
+    sigFullGhostShell.disconnect();
   }
 
 
@@ -117,31 +123,46 @@ namespace espressopp {
       // add the pair locally
       this->add(p1, p2);
       // ADD THE GLOBAL PAIR
-      // see whether the particle already has pairs
-      std::pair<GlobalPairs::const_iterator,
-        GlobalPairs::const_iterator> equalRange
-        = globalPairs.equal_range(pid1);
-      if (equalRange.first == globalPairs.end()) {
-        // if it hasn't, insert the new pair
-        globalPairs.insert(std::make_pair(pid1, pid2));
-      }
-      else {
-        // otherwise test whether the pair already exists
-        for (GlobalPairs::const_iterator it = equalRange.first; it != equalRange.second; ++it) {
-  	    if (it->second == pid2) {
-  	      // TODO: Pair already exists, generate error!
-  	      ;
-  	    }
-        }
-        // if not, insert the new pair
-        globalPairs.insert(equalRange.first, std::make_pair(pid1, pid2));
-      }
+      // no lookup here, the global list is only sorted again before the
+      // next one, so adding pair by pair stays linear
+      globalPairs.insert(std::make_pair(pid1, pid2));
       LOG4ESPP_INFO(theLogger, "added fixed pair to global pair list");
     }
     LOG4ESPP_DEBUG(theLogger, "Leaving add with returnVal " << returnVal);
     return returnVal;
   }
 
+  longint FixedPairList::addBondsArray(python::object bonds) {
+    esutil::PyBuffer< long long > pids(bonds, "bonds", 2);
+    if (!pids.valid())
+      throw std::invalid_argument("addBondsArray: bonds must not be None");
+
+    longint n = pids.size();
+    globalPairs.reserve(globalPairs.size() + n / storage->getSystemRef().comm->size());
+
+    longint added = 0;
+    for (longint i = 0; i < n; ++i) {
+      longint pid1 = pids[i][0];
+      longint pid2 = pids[i][1];
+      if (pid1 > pid2)
+        std::swap(pid1, pid2);
+
+      Particle *p1 = storage->lookupRealParticle(pid1);
+      if (!p1) continue;
+
+      Particle *p2 = storage->lookupLocalParticle(pid2);
+      if (!p2) {
+        LOG4ESPP_DEBUG(theLogger, "Particle p2 " << pid2 << " not found");
+      }
+
+      this->add(p1, p2);
+      globalPairs.insert(std::make_pair(pid1, pid2));
+      ++added;
+    }
+    LOG4ESPP_INFO(theLogger, "added " << added << " fixed pairs to global pair list");
+    return added;
+  }
+
   python::list FixedPairList::getBonds()
   {
 	python::tuple bond;
@@ -155,7 +176,12 @@ namespace espressopp {
   }
 
   void FixedPairList::beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+    packParticles(pl, buf, true);
+  }
+
+  void FixedPairList::packParticles(ParticleList& pl, OutBuffer& buf, bool erase) {
     std::vector< longint > toSend;
+    std::vector< longint > sent;
     // loop over the particle list
     for (ParticleList::Iterator pit(pl); pit.isValid(); ++pit) {
       longint pid = pit->id();
@@ -163,13 +189,12 @@ namespace espressopp {
       LOG4ESPP_DEBUG(theLogger, "send particle with pid " << pid << ", find pairs");
 
       // find all pairs that involve this particle
-      
-      int n = globalPairs.count(pid);
+      std::pair<GlobalPairs::const_iterator,
+        GlobalPairs::const_iterator> equalRange
+        = globalPairs.equal_range(pid);
 
-      if (n > 0) {
-        std::pair<GlobalPairs::const_iterator,
-          GlobalPairs::const_iterator> equalRange
-          = globalPairs.equal_range(pid);
+      if (equalRange.first != equalRange.second) {
+        int n = std::distance(equalRange.first, equalRange.second);
 
         // first write the pid of the first particle
         // then the number of partners
@@ -184,11 +209,12 @@ namespace espressopp {
                        << pid << " and partner " << it->second);
         }
 
-        // delete all of these pairs from the global list
-        globalPairs.erase(equalRange.first, equalRange.second);
+        sent.push_back(pid);
         // std::cout << "erasing particle " << pid << " from here" << std::endl;
       }
     }
+    // delete all of these pairs from the global list
+    if (erase) globalPairs.eraseKeys(sent);
     // send the list
     buf.write(toSend);
     LOG4ESPP_INFO(theLogger, "prepared fixed pair list before send particles");
@@ -198,7 +224,6 @@ namespace espressopp {
     std::vector< longint > received;
     int n;
     longint pid1, pid2;
-    GlobalPairs::iterator it = globalPairs.begin();
     // receive the bond list
     buf.read(received);
     int size = received.size(); int i = 0;
@@ -212,7 +237,7 @@ namespace espressopp {
 	pid2 = received[i++];
 	// add the bond to the global list
         LOG4ESPP_DEBUG(theLogger, "received pair " << pid1 << " , " << pid2);
-	it = globalPairs.insert(it, std::make_pair(pid1, pid2));
+	globalPairs.insert(std::make_pair(pid1, pid2));
       }
     }
     if (i != size) {
@@ -261,8 +286,10 @@ namespace espressopp {
       this->clear();
       globalPairs.clear();
       sigBeforeSend.disconnect();
+      sigBeforeSave.disconnect();
       sigAfterRecv.disconnect();
       sigOnParticlesChanged.disconnect();
+      sigFullGhostShell.disconnect();
   }
 
   /****************************************************
@@ -280,6 +307,7 @@ namespace espressopp {
     class_<FixedPairList, shared_ptr<FixedPairList> >
       ("FixedPairList", init <shared_ptr<storage::Storage> >())
       .def("add", pyAdd)
+      .def("addBondsArray", &FixedPairList::addBondsArray)
       .def("size", &FixedPairList::size)
       .def("getBonds",  &FixedPairList::getBonds)
       .def("remove",  &FixedPairList::remove)
@@ -29,7 +29,7 @@
 #include "types.hpp"
 #include "Particle.hpp"
 #include "esutil/ESPPIterator.hpp"
-#include <boost/unordered_map.hpp>
+#include "esutil/FlatMultimap.hpp"
 #include <boost/signals2.hpp>
 
 //#include "FixedListComm.hpp"
@@ -37,10 +37,11 @@
 namespace espressopp {
 	class FixedPairList : public PairList {
 	  public:
-	    typedef boost::unordered_multimap<longint, longint> GlobalPairs;
+	    /// the partners of the particles of this processor, sorted by particle id
+	    typedef esutil::FlatMultimap<longint, longint> GlobalPairs;
 
 	  protected:
-		boost::signals2::connection sigBeforeSend, sigOnParticlesChanged, sigAfterRecv;
+		boost::signals2::connection sigBeforeSend, sigOnParticlesChanged, sigAfterRecv, sigFullGhostShell, sigBeforeSave;
 		shared_ptr <storage::Storage> storage;
 		GlobalPairs globalPairs;
 		using PairList::add;
@@ -61,7 +62,15 @@ namespace espressopp {
 		\return whether the particle was inserted on this processor.
 		*/
 		virtual bool add(longint pid1, longint pid2);
+		/** Add many pairs at once. bonds is a C-contiguous N x 2 array of
+		8 byte integers with the buffer protocol (e.g. a NumPy array);
+		like add(), a pair is only stored on the processor that owns the
+		particle with the lower id. Must be called on all processors.
+		\return the number of pairs inserted on this processor.
+		*/
+		longint addBondsArray(python::object bonds);
 		virtual void beforeSendParticles(ParticleList& pl, class OutBuffer& buf);
+		void packParticles(ParticleList& pl, class OutBuffer& buf, bool erase);
 		void afterRecvParticles(ParticleList& pl, class InBuffer& buf);
 		virtual void onParticlesChanged();
 		void remove();
@@ -91,25 +91,7 @@ namespace espressopp {
       // add the pair locally
       this->add(p1, p2);
       // ADD THE GLOBAL PAIR
-      // see whether the particle already has pairs
-      std::pair<GlobalPairs::const_iterator,
-        GlobalPairs::const_iterator> equalRange
-        = globalPairs.equal_range(pid1);
-      if (equalRange.first == globalPairs.end()) {
-        // if it hasn't, insert the new pair
-        globalPairs.insert(std::make_pair(pid1, pid2));
-      }
-      else {
-        // otherwise test whether the pair already exists
-        for (GlobalPairs::const_iterator it = equalRange.first; it != equalRange.second; ++it) {
-  	      if (it->second == pid2) {
-  	        // TODO: Pair already exists, generate error!
-  	        ;
-  	      }
-        }
-        // if not, insert the new pair
-        globalPairs.insert(equalRange.first, std::make_pair(pid1, pid2));
-      }
+      globalPairs.insert(std::make_pair(pid1, pid2));
       LOG4ESPP_INFO(theLogger, "added fixed pair to global pair list");
     }
     return returnVal;
@@ -122,6 +104,7 @@ namespace espressopp {
         //std::cout << "beforeSendATParticles() fixed pl (size " << atpl.size() << ")\n";
 
         std::vector< longint > toSend;
+        std::vector< longint > sent;
 
         // loop over the VP particle list
         for (std::vector<longint>::iterator it = atpl.begin();
@@ -152,11 +135,12 @@ namespace espressopp {
                            << pid << " and partner " << it->second);
             }
 
-            // delete all of these pairs from the global list
-            globalPairs.erase(pid);
+            sent.push_back(pid);
           }
         }
 
+        // delete all of these pairs from the global list
+        globalPairs.eraseKeys(sent);
         // send the list
         buf.write(toSend);
         LOG4ESPP_INFO(theLogger, "prepared fixed pair list before send particles");
@@ -49,8 +49,11 @@ namespace espressopp {
   {
     LOG4ESPP_INFO(theLogger, "construct FixedQuadrupleAngleList");
 
+    con4 = storage->requireFullGhostShell("FixedQuadrupleAngleList");
     con1 = storage->beforeSendParticles.connect
       (boost::bind(&FixedQuadrupleAngleList::beforeSendParticles, this, _1, _2));
+    con5 = storage->beforeSaveParticles.connect
+      (boost::bind(&FixedQuadrupleAngleList::packParticles, this, _1, _2, false));
     con2 = storage->afterRecvParticles.connect
       (boost::bind(&FixedQuadrupleAngleList::afterRecvParticles, this, _1, _2));
     con3 = storage->onParticlesChanged.connect
@@ -63,6 +66,8 @@ namespace espressopp {
     con1.disconnect();
     con2.disconnect();
     con3.disconnect();
+    con4.disconnect();
+    con5.disconnect();
   }
 
   bool FixedQuadrupleAngleList::
@@ -199,8 +204,11 @@ namespace espressopp {
 	return returnVal;
   }
   
-  void FixedQuadrupleAngleList::
-  beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+  void FixedQuadrupleAngleList::beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+    packParticles(pl, buf, true);
+  }
+
+  void FixedQuadrupleAngleList::packParticles(ParticleList& pl, OutBuffer& buf, bool erase) {
     
     std::vector< longint > toSendInt;
     std::vector< real > toSendReal;
@@ -232,7 +240,7 @@ namespace espressopp {
         }
 
         // delete all of these quadruples from the global list
-        quadruplesAngles.erase(pid);
+        if (erase) quadruplesAngles.erase(pid);
       }
     }
     // send the list
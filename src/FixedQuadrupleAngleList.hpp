@@ -37,7 +37,7 @@
 namespace espressopp {
   class FixedQuadrupleAngleList : public QuadrupleList{
   protected:
-    boost::signals2::connection con1, con2, con3;
+    boost::signals2::connection con1, con2, con3, con4, con5;
     typedef std::multimap< longint,
             std::pair<Triple < longint, longint, longint >, real> > QuadruplesAngles;
     shared_ptr <storage::Storage> storage;
@@ -63,6 +63,7 @@ namespace espressopp {
     */
     bool add(longint pid1, longint pid2, longint pid3, longint pid4);
     void beforeSendParticles(ParticleList& pl, class OutBuffer &buf);
+    void packParticles(ParticleList& pl, class OutBuffer& buf, bool erase);
     void afterRecvParticles(ParticleList& pl, class InBuffer &buf);
     void onParticlesChanged();
 
@@ -50,8 +50,11 @@ namespace espressopp {
   {
     LOG4ESPP_INFO(theLogger, "construct FixedQuadrupleList");
 
+    sigFullGhostShell = storage->requireFullGhostShell("FixedQuadrupleList");
     sigBeforeSend = storage->beforeSendParticles.connect
       (boost::bind(&FixedQuadrupleList::beforeSendParticles, this, _1, _2));
+    sigBeforeSave = storage->beforeSaveParticles.connect
+      (boost::bind(&FixedQuadrupleList::packParticles, this, _1, _2, false));
     sigAfterRecv = storage->afterRecvParticles.connect
       (boost::bind(&FixedQuadrupleList::afterRecvParticles, this, _1, _2));
     sigOnParticlesChanged = storage->onParticlesChanged.connect
@@ -63,8 +66,10 @@ namespace espressopp {
     LOG4ESPP_INFO(theLogger, "~FixedQuadrupleList");
 
     sigBeforeSend.disconnect();
+    sigBeforeSave.disconnect();
     sigAfterRecv.disconnect();
     sigOnParticlesChanged.disconnect();
+    sigFullGhostShell.disconnect();
   }
 
 
@@ -156,8 +161,11 @@ namespace espressopp {
 	return quadruples;
   }
 
-  void FixedQuadrupleList::
-  beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+  void FixedQuadrupleList::beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+    packParticles(pl, buf, true);
+  }
+
+  void FixedQuadrupleList::packParticles(ParticleList& pl, OutBuffer& buf, bool erase) {
     
     std::vector< longint > toSend;
     // loop over the particle list
@@ -189,7 +197,7 @@ namespace espressopp {
           //printf ("send global quadruple: pid %d and partner %d\n", pid, it->second.third);
         }
 	    // delete all of these quadruples from the global list
-	    globalQuadruples.erase(equalRange.first, equalRange.second);
+	    if (erase) globalQuadruples.erase(equalRange.first, equalRange.second);
       }
     }
     // send the list
@@ -281,7 +289,9 @@ namespace espressopp {
       this->clear();
       globalQuadruples.clear();
       sigBeforeSend.disconnect();
+      sigBeforeSave.disconnect();
       sigAfterRecv.disconnect();
+      sigFullGhostShell.disconnect();
   }
   /****************************************************
   ** REGISTRATION WITH PYTHON
@@ -37,7 +37,7 @@
 namespace espressopp {
   class FixedQuadrupleList : public QuadrupleList {
   protected:
-    boost::signals2::connection sigBeforeSend, sigAfterRecv, sigOnParticlesChanged;
+    boost::signals2::connection sigBeforeSend, sigAfterRecv, sigOnParticlesChanged, sigFullGhostShell, sigBeforeSave;
     shared_ptr< storage::Storage > storage;
     typedef boost::unordered_multimap< longint,
             Triple < longint, longint, longint > > GlobalQuadruples;
@@ -57,6 +57,7 @@ namespace espressopp {
     */
     bool add(longint pid1, longint pid2, longint pid3, longint pid4);
     void beforeSendParticles(ParticleList& pl, class OutBuffer &buf);
+    void packParticles(ParticleList& pl, class OutBuffer& buf, bool erase);
     void afterRecvParticles(ParticleList& pl, class InBuffer &buf);
     virtual void onParticlesChanged();
 
@@ -43,6 +43,8 @@ namespace espressopp {
 
     con1 = storage->beforeSendParticles.connect
       (boost::bind(&FixedSingleList::beforeSendParticles, this, _1, _2));
+    con4 = storage->beforeSaveParticles.connect
+      (boost::bind(&FixedSingleList::packParticles, this, _1, _2, false));
     con2 = storage->afterRecvParticles.connect
       (boost::bind(&FixedSingleList::afterRecvParticles, this, _1, _2));
     con3 = storage->onParticlesChanged.connect
@@ -56,6 +58,7 @@ namespace espressopp {
     con1.disconnect();
     con2.disconnect();
     con3.disconnect();
+    con4.disconnect();
   }
 
   bool FixedSingleList::
@@ -99,12 +102,16 @@ namespace espressopp {
   }
 
   void FixedSingleList::beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+    packParticles(pl, buf, true);
+  }
+
+  void FixedSingleList::packParticles(ParticleList& pl, OutBuffer& buf, bool erase) {
 	std::vector< longint > toSend(pl.size());
     // loop over the particle list
     for (ParticleList::Iterator pit(pl); pit.isValid(); ++pit) {
       longint pid = pit->id();
       toSend.push_back(pid);
-      globalSingles.erase(pid);
+      if (erase) globalSingles.erase(pid);
       LOG4ESPP_DEBUG(theLogger, "erase and send particle with pid from FixedSingleList" << pid);
     }
     // send the list
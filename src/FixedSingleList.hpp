@@ -39,7 +39,7 @@ namespace espressopp {
 	    typedef std::set<longint> GlobalSingles;
 
 	  protected:
-		boost::signals2::connection con1, con2, con3;
+		boost::signals2::connection con1, con2, con3, con4;
 		shared_ptr <storage::Storage> storage;
 		GlobalSingles globalSingles;
 		using SingleList::add;
@@ -56,6 +56,7 @@ namespace espressopp {
 		*/
 		virtual bool add(longint pid1);
 		virtual void beforeSendParticles(ParticleList& pl, class OutBuffer& buf);
+		void packParticles(ParticleList& pl, class OutBuffer& buf, bool erase);
 		void afterRecvParticles(ParticleList& pl, class InBuffer& buf);
 		virtual void onParticlesChanged();
 
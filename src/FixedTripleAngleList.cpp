@@ -40,8 +40,11 @@ namespace espressopp {
   {
     LOG4ESPP_INFO(theLogger, "construct FixedTripleAngleList");
     
+    con4 = storage->requireFullGhostShell("FixedTripleAngleList");
     con1 = storage->beforeSendParticles.connect
       (boost::bind(&FixedTripleAngleList::beforeSendParticles, this, _1, _2));
+    con5 = storage->beforeSaveParticles.connect
+      (boost::bind(&FixedTripleAngleList::packParticles, this, _1, _2, false));
     con2 = storage->afterRecvParticles.connect
       (boost::bind(&FixedTripleAngleList::afterRecvParticles, this, _1, _2));
     con3 = storage->onParticlesChanged.connect
@@ -55,6 +58,8 @@ namespace espressopp {
     con1.disconnect();
     con2.disconnect();
     con3.disconnect();
+    con4.disconnect();
+    con5.disconnect();
   }
 
   bool FixedTripleAngleList::
@@ -167,6 +172,10 @@ namespace espressopp {
   }
   
   void FixedTripleAngleList::beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+    packParticles(pl, buf, true);
+  }
+
+  void FixedTripleAngleList::packParticles(ParticleList& pl, OutBuffer& buf, bool erase) {
     std::vector< longint > toSendInt;
     std::vector< real > toSendReal;
     // loop over the particle list
@@ -194,7 +203,7 @@ namespace espressopp {
         }
 
         // delete all of these triples from the global list
-        triplesAngles.erase(pid);
+        if (erase) triplesAngles.erase(pid);
       }
     }
     // send the list
@@ -46,7 +46,7 @@ using namespace std;
 namespace espressopp {
   class FixedTripleAngleList: public TripleList{
       protected:
-		boost::signals2::connection con1, con2, con3;
+		boost::signals2::connection con1, con2, con3, con4, con5;
 		typedef multimap <longint,pair<pair<longint, longint>, real> > TriplesAngles;
 		shared_ptr <storage::Storage> storage;
 		TriplesAngles triplesAngles;
@@ -63,6 +63,7 @@ namespace espressopp {
 		*/
 		virtual bool add(longint pid1, longint pid2, longint pid3);
 		virtual void beforeSendParticles(ParticleList& pl, class OutBuffer &buf);
+		void packParticles(ParticleList& pl, class OutBuffer& buf, bool erase);
 		void afterRecvParticles(ParticleList& pl, class InBuffer &buf);
 		virtual void onParticlesChanged();
 
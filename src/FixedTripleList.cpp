@@ -32,6 +32,7 @@
 #include "Buffer.hpp"
 
 #include "esutil/Error.hpp"
+#include "esutil/PyBuffer.hpp"
 
 
 namespace espressopp {
@@ -49,8 +50,11 @@ namespace espressopp {
   {
     LOG4ESPP_INFO(theLogger, "construct FixedTripleList");
 
+    sigFullGhostShell = storage->requireFullGhostShell("FixedTripleList");
     sigBeforeSend = storage->beforeSendParticles.connect
       (boost::bind(&FixedTripleList::beforeSendParticles, this, _1, _2));
+    sigBeforeSave = storage->beforeSaveParticles.connect
+      (boost::bind(&FixedTripleList::packParticles, this, _1, _2, false));
     sigAfterRecv = storage->afterRecvParticles.connect
       (boost::bind(&FixedTripleList::afterRecvParticles, this, _1, _2));
     sigOnParticleChanged = storage->onParticlesChanged.connect
@@ -62,8 +66,10 @@ namespace espressopp {
     LOG4ESPP_INFO(theLogger, "~FixedTripleList");
 
     sigBeforeSend.disconnect();
+    sigBeforeSave.disconnect();
     sigAfterRecv.disconnect();
     sigOnParticleChanged.disconnect();
+    sigFullGhostShell.disconnect();
   }
 
   /*
@@ -129,31 +135,64 @@ namespace espressopp {
       //printf("me = %d: pid1 %d, pid2 %d, pid3 %d\n", mpiWorld->rank(), pid1, pid2, pid3);
 
       // ADD THE GLOBAL TRIPLET
-      // see whether the particle already has triples
-      std::pair<GlobalTriples::const_iterator,
-                GlobalTriples::const_iterator> equalRange
-        = globalTriples.equal_range(pid2);
-      if (equalRange.first == globalTriples.end()) {
-        // if it hasn't, insert the new triple
-        globalTriples.insert(std::make_pair(pid2,
-                             std::pair<longint, longint>(pid1, pid3)));
-      }
-      else {
-        // otherwise test whether the triple already exists
-        for (GlobalTriples::const_iterator it = equalRange.first; it != equalRange.second; ++it) {
-          if (it->second == std::pair<longint, longint>(pid1, pid3)) {
-            // TODO: Triple already exists, generate error!
-  	      ;
-          }
-        }
-        // if not, insert the new triple
-        globalTriples.insert(equalRange.first, std::make_pair(pid2, std::pair<longint, longint>(pid1, pid3)));
-      }
+      // inserted unsorted, see FixedPairList::add
+      globalTriples.insert(std::make_pair(pid2, std::pair<longint, longint>(pid1, pid3)));
       LOG4ESPP_INFO(theLogger, "added fixed triple to global triple list");
     }
     return returnVal;
   }
 
+  longint FixedTripleList::addTriplesArray(python::object triples) {
+    esutil::PyBuffer< long long > pids(triples, "triples", 3);
+    if (!pids.valid())
+      throw std::invalid_argument("addTriplesArray: triples must not be None");
+
+    System& system = storage->getSystemRef();
+    esutil::Error err(system.comm);
+
+    // check the whole array before anything is inserted, so that an error
+    // on any CPU leaves all lists unchanged
+    longint n = pids.size();
+    std::vector< Particle* > local;
+    std::vector< longint > rows;
+    for (longint i = 0; i < n; ++i) {
+      longint pid1 = pids[i][0];
+      longint pid2 = pids[i][1];
+      longint pid3 = pids[i][2];
+
+      // middle particle is the reference particle and must exist here
+      Particle *p2 = storage->lookupRealParticle(pid2);
+      if (!p2) continue;
+
+      Particle *p1 = storage->lookupLocalParticle(pid1);
+      Particle *p3 = storage->lookupLocalParticle(pid3);
+      if (!p1 || !p3) {
+        std::stringstream msg;
+        msg << "adding error: triple particle " << (p1 ? pid3 : pid1)
+            << " does not exists here and cannot be added";
+        msg << " triplet: " << pid1 << "-" << pid2 << "-" << pid3;
+        err.setException( msg.str() );
+        continue;
+      }
+      local.push_back(p1);
+      local.push_back(p2);
+      local.push_back(p3);
+      rows.push_back(i);
+    }
+    err.checkException();
+
+    longint added = rows.size();
+    globalTriples.reserve(globalTriples.size() + added);
+    for (longint t = 0; t < added; ++t) {
+      longint i = rows[t];
+      this->add(local[3 * t], local[3 * t + 1], local[3 * t + 2]);
+      globalTriples.insert(std::make_pair(pids[i][1], std::pair<longint, longint>(pids[i][0], pids[i][2])));
+    }
+
+    LOG4ESPP_INFO(theLogger, "added " << added << " fixed triples to global triple list");
+    return added;
+  }
+
   python::list FixedTripleList::getTriples()
   {
 	python::tuple triple;
@@ -166,9 +205,13 @@ namespace espressopp {
 	return triples;
   }
 
-  void FixedTripleList::
-  beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+  void FixedTripleList::beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+    packParticles(pl, buf, true);
+  }
+
+  void FixedTripleList::packParticles(ParticleList& pl, OutBuffer& buf, bool erase) {
     std::vector< longint > toSend;
+    std::vector< longint > sent;
     // loop over the particle list
     for (ParticleList::Iterator pit(pl); pit.isValid(); ++pit) {
       longint pid = pit->id();
@@ -177,14 +220,12 @@ namespace espressopp {
       //printf ("me = %d: send particle with pid %d find triples\n", mpiWorld->rank(), pid);
 
       // find all triples that involve this particle
-      int n = globalTriples.count(pid);
-      //printf ("me = %d: send particle with pid %d, has %d global triples\n", 
-                //mpiWorld->rank(), pid, n);
+      std::pair<GlobalTriples::const_iterator,
+      GlobalTriples::const_iterator> equalRange
+          = globalTriples.equal_range(pid);
 
-      if (n > 0) {
-          std::pair<GlobalTriples::const_iterator,
-          GlobalTriples::const_iterator> equalRange
-              = globalTriples.equal_range(pid);
+      if (equalRange.first != equalRange.second) {
+          int n = std::distance(equalRange.first, equalRange.second);
 
           // first write the pid of this particle
           // then the number of partners (n)
@@ -200,10 +241,11 @@ namespace espressopp {
                   //printf ("send global triple: pid %d and partner %d\n", pid, it->second.second);
           }
 
-          // delete all of these triples from the global list
-          globalTriples.erase(equalRange.first, equalRange.second);
+          sent.push_back(pid);
       }
     }
+    // delete all of these triples from the global list
+    if (erase) globalTriples.eraseKeys(sent);
     // send the list
     buf.write(toSend);
     LOG4ESPP_INFO(theLogger, "prepared fixed triple list before send particles");
@@ -215,7 +257,6 @@ namespace espressopp {
     std::vector< longint > received;
     int n;
     longint pid1, pid2, pid3;
-    GlobalTriples::iterator it = globalTriples.begin();
     // receive the triple list
     buf.read(received);
     int size = received.size(); int i = 0;
@@ -230,7 +271,7 @@ namespace espressopp {
 	    pid3 = received[i++];
 	    // add the triple to the global list
         //printf("received triple %d %d %d, add triple to global list\n", pid1, pid2, pid3);
-	    it = globalTriples.insert(it, std::make_pair(pid2,std::pair<longint, longint>(pid1, pid3)));
+	    globalTriples.insert(std::make_pair(pid2,std::pair<longint, longint>(pid1, pid3)));
       }
     }
     if (i != size) {
@@ -286,8 +327,10 @@ namespace espressopp {
       this->clear();
       globalTriples.clear();
       sigBeforeSend.disconnect();
+      sigBeforeSave.disconnect();
       sigAfterRecv.disconnect();
       sigOnParticleChanged.disconnect();
+      sigFullGhostShell.disconnect();
   }
   /****************************************************
   ** REGISTRATION WITH PYTHON
@@ -305,6 +348,7 @@ namespace espressopp {
     class_< FixedTripleList, shared_ptr< FixedTripleList > >
       ("FixedTripleList", init< shared_ptr< storage::Storage > >())
       .def("add", pyAdd)
+      .def("addTriplesArray", &FixedTripleList::addTriplesArray)
       .def("size", &FixedTripleList::size)
       .def("remove",  &FixedTripleList::remove)
       .def("getTriples",  &FixedTripleList::getTriples)
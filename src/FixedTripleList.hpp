@@ -29,16 +29,17 @@
 
 #include "Particle.hpp"
 #include "esutil/ESPPIterator.hpp"
-#include <boost/unordered_map.hpp>
+#include "esutil/FlatMultimap.hpp"
 #include <boost/signals2.hpp>
 //#include "FixedListComm.hpp"
 
 namespace espressopp {
   class FixedTripleList : public TripleList {
       protected:
-		boost::signals2::connection sigAfterRecv, sigOnParticleChanged, sigBeforeSend;
+		boost::signals2::connection sigAfterRecv, sigOnParticleChanged, sigBeforeSend, sigFullGhostShell, sigBeforeSave;
 		shared_ptr<storage::Storage> storage;
-		typedef boost::unordered_multimap <longint,std::pair <longint, longint> > GlobalTriples;
+		/// the outer particles of the triples, sorted by the id of the central one
+		typedef esutil::FlatMultimap <longint,std::pair <longint, longint> > GlobalTriples;
 		GlobalTriples globalTriples;
 		using TripleList::add;
 
@@ -55,7 +56,16 @@ namespace espressopp {
 		\return whether the triple was inserted on this processor.
 		*/
 		virtual bool add(longint pid1, longint pid2, longint pid3);
+		/** Add many triples at once. triples is a C-contiguous N x 3 array
+		of 8 byte integers with the buffer protocol (e.g. a NumPy array);
+		like add(), a triple is stored on the processor that owns the
+		middle particle. Unlike calling add() N times, the processors
+		synchronize only once. Must be called on all processors.
+		\return the number of triples inserted on this processor.
+		*/
+		longint addTriplesArray(python::object triples);
 		virtual void beforeSendParticles(ParticleList& pl, class OutBuffer &buf);
+		void packParticles(ParticleList& pl, class OutBuffer& buf, bool erase);
 		void afterRecvParticles(ParticleList& pl, class InBuffer &buf);
 		virtual void onParticlesChanged();
 
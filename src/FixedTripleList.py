@@ -46,8 +46,20 @@ espressopp.FixedTripleList
 		:type triplelist: 
 		:rtype: 
 
+.. function:: espressopp.FixedTripleList.addTriplesArray(triples)
+
+		Adds the triples of an (N, 3) array of particle ids (a NumPy
+		array or anything numpy.asarray accepts). The triples are added in
+		C++, which is much faster than `addTriples` for long lists.
+
+		:param triples: 
+		:type triples: 
+		:rtype: 
+
 .. function:: espressopp.FixedTripleList.getTriples()
 
+		The triples of every CPU, sorted by the id of the central particle.
+
 		:rtype: 
 
 .. function:: espressopp.FixedTripleList.size()
@@ -89,6 +101,12 @@ class FixedTripleListLocal(_espressopp.FixedTripleList):
                 pid1, pid2, pid3 = triple
                 self.cxxclass.add(self, pid1, pid2, pid3)
 
+    def addTriplesArray(self, triples):
+        if pmi.workerIsActive():
+            import numpy
+            triples = numpy.ascontiguousarray(triples, dtype=numpy.int64).reshape(-1, 3)
+            return self.cxxclass.addTriplesArray(self, triples)
+
     def size(self):
 
         if pmi.workerIsActive():
@@ -124,6 +142,6 @@ if pmi.isController:
         pmiproxydefs = dict(
             cls = 'espressopp.FixedTripleListLocal',
             localcall = [ "add" ],
-            pmicall = [ "addTriples","remove" ],
+            pmicall = [ "addTriples", "addTriplesArray", "remove" ],
             pmiinvoke = ["getTriples", "size"]
         )
@@ -104,25 +104,7 @@ FixedTripleListAdress::~FixedTripleListAdress() {
       this->add(p1, p2, p3);
 
       // ADD THE GLOBAL TRIPLET
-      // see whether the particle already has triples
-      std::pair<GlobalTriples::const_iterator,
-                GlobalTriples::const_iterator> equalRange
-        = globalTriples.equal_range(pid2);
-      if (equalRange.first == globalTriples.end()) {
-        // if it hasn't, insert the new triple
-        globalTriples.insert(std::make_pair(pid2,
-                             std::pair<longint, longint>(pid1, pid3)));
-      }
-      else {
-        // otherwise test whether the triple already exists
-        for (GlobalTriples::const_iterator it = equalRange.first;
-             it != equalRange.second; ++it)
-          if (it->second == std::pair<longint, longint>(pid1, pid3))
-          // TODO: Triple already exists, generate error!
-        ;
-        // if not, insert the new triple
-        globalTriples.insert(equalRange.first, std::make_pair(pid2, std::pair<longint, longint>(pid1, pid3)));
-      }
+      globalTriples.insert(std::make_pair(pid2, std::pair<longint, longint>(pid1, pid3)));
     LOG4ESPP_INFO(theLogger, "added fixed pair to global pair list");
     }
     return returnVal;
@@ -135,6 +117,7 @@ FixedTripleListAdress::~FixedTripleListAdress() {
         //std::cout << "beforeSendATParticles() fixed pl (size " << atpl.size() << ")\n";
 
         std::vector< longint > toSend;
+        std::vector< longint > sent;
 
         // loop over the VP particle list
         for (std::vector<longint>::iterator it = atpl.begin();
@@ -163,11 +146,12 @@ FixedTripleListAdress::~FixedTripleListAdress() {
                 toSend.push_back(it->second.second);
             }
 
-            // delete all of these triples from the global list
-            globalTriples.erase(equalRange.first, equalRange.second);
+            sent.push_back(pid);
           }
         }
 
+        // delete all of these triples from the global list
+        globalTriples.eraseKeys(sent);
         // send the list
         buf.write(toSend);
         LOG4ESPP_INFO(theLogger, "prepared fixed triple list before send particles");
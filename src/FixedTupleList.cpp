@@ -43,8 +43,11 @@ namespace espressopp {
   {
     LOG4ESPP_INFO(theLogger, "construct FixedTupleList");
 
+    con4 = storage->requireFullGhostShell("FixedTupleList");
     con1 = storage->beforeSendParticles.connect
       (boost::bind(&FixedTupleList::beforeSendParticles, this, _1, _2));
+    con5 = storage->beforeSaveParticles.connect
+      (boost::bind(&FixedTupleList::packParticles, this, _1, _2, false));
     con2 = storage->afterRecvParticles.connect
       (boost::bind(&FixedTupleList::afterRecvParticles, this, _1, _2));
     con3 = storage->onParticlesChanged.connect
@@ -58,6 +61,8 @@ namespace espressopp {
     con1.disconnect();
     con2.disconnect();
     con3.disconnect();
+    con4.disconnect();
+    con5.disconnect();
     }
 
     bool FixedTupleList::
@@ -129,8 +134,11 @@ namespace espressopp {
         return alltuples;
     }
 
-  void FixedTupleList::
-    beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+  void FixedTupleList::beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+    packParticles(pl, buf, true);
+  }
+
+  void FixedTupleList::packParticles(ParticleList& pl, OutBuffer& buf, bool erase) {
         std::vector<longint> toSend;
         // loop over the particle list
         for (ParticleList::Iterator pit(pl); pit.isValid(); ++pit) {
@@ -157,7 +165,7 @@ namespace espressopp {
                     toSend.push_back(*it2);
                 }
                 // delete this pid from the global list
-                globalTuples.erase(pidK);
+                if (erase) globalTuples.erase(pidK);
 
             }
         }
@@ -35,7 +35,7 @@
 namespace espressopp {
   class FixedTupleList : public TupleList {
       protected:
-		boost::signals2::connection con1, con2, con3;
+		boost::signals2::connection con1, con2, con3, con4, con5;
 		shared_ptr<storage::Storage> storage;
                 typedef std::vector<longint> tuple;
 		typedef std::multimap <longint,tuple > GlobalTuples;
@@ -49,6 +49,7 @@ namespace espressopp {
 		virtual ~FixedTupleList();
 		virtual bool addTuple(boost::python::list& tuple);
 		virtual void beforeSendParticles(ParticleList& pl, class OutBuffer &buf);
+		void packParticles(ParticleList& pl, class OutBuffer& buf, bool erase);
 		void afterRecvParticles(ParticleList& pl, class InBuffer &buf);
 		virtual void onParticlesChanged();
 
@@ -46,6 +46,7 @@ namespace espressopp {
 
         LOG4ESPP_INFO(theLogger, "construct FixedTupleListAdress");
 
+        sigFullGhostShell = storage->requireFullGhostShell("FixedTupleListAdress");
         sigBeforeSend = storage->beforeSendParticles.connect
            (boost::bind(&FixedTupleListAdress::beforeSendParticles, this, _1, _2));
         sigAfterRecv = storage->afterRecvParticles.connect
@@ -60,6 +61,7 @@ namespace espressopp {
         sigBeforeSend.disconnect();
         sigAfterRecv.disconnect();
         sigOnTupleChanged.disconnect();
+        sigFullGhostShell.disconnect();
     }
 
     bool FixedTupleListAdress::addT(tuple pids) {
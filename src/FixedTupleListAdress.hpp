@@ -38,7 +38,7 @@
 namespace espressopp {
     class FixedTupleListAdress: public TupleList  {
         protected:
-            boost::signals2::connection sigOnTupleChanged, sigAfterRecv, sigBeforeSend;
+            boost::signals2::connection sigOnTupleChanged, sigAfterRecv, sigBeforeSend, sigFullGhostShell;
             shared_ptr<storage::Storage> storage;
             typedef std::vector<longint> tuple;
             typedef boost::unordered_map<longint, tuple> GlobalTuples;
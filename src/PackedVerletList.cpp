@@ -0,0 +1,245 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include "python.hpp"
+#include "PackedVerletList.hpp"
+#include "Cell.hpp"
+#include "System.hpp"
+#include "storage/Storage.hpp"
+#include "storage/ParticleArrays.hpp"
+
+namespace espressopp {
+
+  LOG4ESPP_LOGGER(PackedVerletList::theLogger, "PackedVerletList");
+
+/*-------------------------------------------------------------*/
+
+  // cut is a cutoff (without skin)
+  PackedVerletList::PackedVerletList(shared_ptr<System> system, real _cut, bool rebuildVL)
+    : SystemAccess(system)
+  {
+    LOG4ESPP_INFO(theLogger, "construct PackedVerletList, cut = " << _cut);
+
+    if (!system->storage) {
+       throw std::runtime_error("system has no storage");
+    }
+
+    // the neighbor indices refer to the particle arrays, so keep them up to date
+    system->storage->setUseParticleArrays(true);
+
+    cut = _cut;
+    cutVerlet = cut + system->getSkin();
+    cutsq = cutVerlet * cutVerlet;
+    builds = 0;
+
+    if (rebuildVL) rebuild(); // not called if exclusions are provided
+
+    // make a connection to System to invoke rebuild on resort
+    connectionResort = system->storage->onParticlesChanged.connect(
+        boost::bind(&PackedVerletList::rebuild, this));
+    connectionMoved = system->storage->onParticlesMoved.connect(
+        boost::bind(&PackedVerletList::rebuild, this));
+  }
+
+  real PackedVerletList::getVerletCutoff() {
+    return cutVerlet;
+  }
+
+  void PackedVerletList::connect()
+  {
+    // make a connection to System to invoke rebuild on resort
+    connectionResort = getSystem()->storage->onParticlesChanged.connect(
+        boost::bind(&PackedVerletList::rebuild, this));
+    connectionMoved = getSystem()->storage->onParticlesMoved.connect(
+        boost::bind(&PackedVerletList::rebuild, this));
+  }
+
+  void PackedVerletList::disconnect()
+  {
+    // disconnect from System to avoid rebuild on resort
+    connectionResort.disconnect();
+    connectionMoved.disconnect();
+  }
+
+  /*-------------------------------------------------------------*/
+
+  void PackedVerletList::rebuild()
+  {
+    cutVerlet = cut + getSystem()->getSkin();
+    cutsq = cutVerlet * cutVerlet;
+
+    storage::Storage &storage = *getSystem()->storage;
+    storage::ParticleArrays &pa = storage.getParticleArrays();
+    pa.updatePositions();
+
+    const real *x = pa.x.data(), *y = pa.y.data(), *z = pa.z.data();
+    const bool checkExclusions = !exList.empty();
+
+    offsets.assign(pa.getNReal() + 1, 0);
+    neighbors.clear();
+
+    // same traversal as the CellListAllPairsIterator: pairs within a real
+    // cell, and pairs with the half of the neighbor cells that is not
+    // marked useForAllPairs, but grouped by the first particle. Ghost
+    // cells only have neighbors with an eighth-shell ghost import; then
+    // the ghosts get rows as well, without the pairs within their cell.
+    bool ghostRows = false;
+    CellList ghostCells = storage.getGhostCells();
+    for (CellList::Iterator cit(ghostCells); cit.isValid(); ++cit) {
+      if (!(*cit)->neighborCells.empty()) {
+        ghostRows = true;
+        break;
+      }
+    }
+
+    std::vector< std::pair< longint, longint > > nbCells; // array offset, size
+    for (int pass = 0; pass < (ghostRows ? 2 : 1); ++pass) {
+      const bool ghosts = (pass == 1);
+      if (ghosts) {
+        offsets.resize(pa.size() + 1, neighbors.size());
+      }
+      CellList cells = ghosts ? ghostCells : storage.getRealCells();
+      for (CellList::Iterator cit(cells); cit.isValid(); ++cit) {
+        ParticleList &pl = (*cit)->particles;
+        if (pl.empty()) continue;
+        const longint base = pa.indexOf(&pl.front());
+        const longint np = pl.size();
+
+        nbCells.clear();
+        for (NeighborCellList::Iterator ncit((*cit)->neighborCells); ncit.isValid(); ++ncit) {
+          if (ncit->useForAllPairs) continue;
+          ParticleList &npl = ncit->cell->particles;
+          if (npl.empty()) continue;
+          nbCells.push_back(std::make_pair(pa.indexOf(&npl.front()), longint(npl.size())));
+        }
+
+        for (longint i = base; i < base + np; ++i) {
+          const real xi = x[i], yi = y[i], zi = z[i];
+
+          // the rest of the own cell
+          for (longint j = i + 1; !ghosts && j < base + np; ++j) {
+            const real dx = xi - x[j], dy = yi - y[j], dz = zi - z[j];
+            if (dx * dx + dy * dy + dz * dz > cutsq) continue;
+            if (checkExclusions && isExcluded(pa.id[i], pa.id[j])) continue;
+            neighbors.push_back(j);
+          }
+
+          // the neighbor cells
+          for (size_t c = 0; c < nbCells.size(); ++c) {
+            const longint jbegin = nbCells[c].first;
+            const longint jend = jbegin + nbCells[c].second;
+            for (longint j = jbegin; j < jend; ++j) {
+              const real dx = xi - x[j], dy = yi - y[j], dz = zi - z[j];
+              if (dx * dx + dy * dy + dz * dz > cutsq) continue;
+              if (checkExclusions && isExcluded(pa.id[i], pa.id[j])) continue;
+              neighbors.push_back(j);
+            }
+          }
+
+          offsets[i + 1] = neighbors.size();
+        }
+      }
+    }
+
+    builds++;
+    LOG4ESPP_DEBUG(theLogger, "rebuilt PackedVerletList (count=" << builds << "), cutsq = " << cutsq
+                   << " local size = " << neighbors.size());
+  }
+
+  bool PackedVerletList::isExcluded(longint pid1, longint pid2) const
+  {
+    // see if it's in the exclusion list (both directions)
+    return exList.count(std::make_pair(pid1, pid2)) == 1 ||
+           exList.count(std::make_pair(pid2, pid1)) == 1;
+  }
+
+  /*-------------------------------------------------------------*/
+
+  int PackedVerletList::totalSize() const
+  {
+    System& system = getSystemRef();
+    int size = localSize();
+    int allsize;
+
+    mpi::all_reduce(*system.comm, size, allsize, std::plus<int>());
+    return allsize;
+  }
+
+  int PackedVerletList::localSize() const
+  {
+    return neighbors.size();
+  }
+
+  python::tuple PackedVerletList::getPair(int i) {
+    if (i <= 0 || i > localSize()) {
+      LOG4ESPP_ERROR(theLogger, "PackedVerletList pair " << i << " does not exist");
+      return python::make_tuple();
+    }
+
+    // the row of pair k is the last one starting at or before k
+    const longint k = i - 1;
+    const longint row = std::upper_bound(offsets.begin(), offsets.end(), k) - offsets.begin() - 1;
+    storage::ParticleArrays &pa = getSystem()->storage->getParticleArrays();
+    return python::make_tuple(pa.id[row], pa.id[neighbors[k]]);
+  }
+
+  bool PackedVerletList::exclude(longint pid1, longint pid2) {
+
+    exList.insert(std::make_pair(pid1, pid2));
+
+    return true;
+  }
+
+  /*-------------------------------------------------------------*/
+
+  PackedVerletList::~PackedVerletList()
+  {
+    LOG4ESPP_INFO(theLogger, "~PackedVerletList");
+
+    if (connectionResort.connected()) {
+      connectionResort.disconnect();
+    }
+    connectionMoved.disconnect();
+  }
+
+  /****************************************************
+  ** REGISTRATION WITH PYTHON
+  ****************************************************/
+
+  void PackedVerletList::registerPython() {
+    using namespace espressopp::python;
+
+    class_<PackedVerletList, shared_ptr<PackedVerletList> >
+      ("PackedVerletList", init< shared_ptr<System>, real, bool >())
+      .add_property("system", &SystemAccess::getSystem)
+      .add_property("builds", &PackedVerletList::getBuilds, &PackedVerletList::setBuilds)
+      .def("totalSize", &PackedVerletList::totalSize)
+      .def("localSize", &PackedVerletList::localSize)
+      .def("getPair", &PackedVerletList::getPair)
+      .def("exclude", &PackedVerletList::exclude)
+      .def("rebuild", &PackedVerletList::rebuild)
+      .def("connect", &PackedVerletList::connect)
+      .def("disconnect", &PackedVerletList::disconnect)
+      .def("getVerletCutoff", &PackedVerletList::getVerletCutoff)
+      ;
+  }
+
+}
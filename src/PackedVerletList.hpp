@@ -0,0 +1,127 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _PACKEDVERLETLIST_HPP
+#define _PACKEDVERLETLIST_HPP
+
+#include <vector>
+#include "log4espp.hpp"
+#include "types.hpp"
+#include "python.hpp"
+#include "SystemAccess.hpp"
+#include "boost/signals2.hpp"
+#include "boost/unordered_set.hpp"
+
+namespace espressopp {
+
+  namespace storage {
+    class ParticleArrays;
+  }
+
+  /** Verlet list stored as a compact half neighbor list.
+
+      Instead of a PairList of particle pointers, the neighbors of the
+      real particles are kept in compressed sparse row format: the
+      neighbors of the real particle with array index i are the entries
+      neighbors[offsets[i]] ... neighbors[offsets[i+1]-1]. All indices
+      refer to the storage's ParticleArrays, so that a force kernel can
+      keep the data of particle i in registers while it loops over its
+      neighbors. Every pair is stored only once, with i being a real
+      particle, and takes 4 bytes instead of the 16 bytes of a PairList
+      entry. With an eighth-shell ghost import of the storage, pairs of
+      two ghosts are stored as well, and the ghosts get rows after the
+      real particles.
+
+      Like the VerletList, the list is rebuilt whenever the storage
+      signals that particles changed.
+  */
+  class PackedVerletList : public SystemAccess {
+
+  public:
+
+    /** Build a packed verlet list of all particle pairs in the storage
+        whose distance is less than a given cutoff (plus skin).
+
+        \param system is the system for which the verlet list is built
+        \param cut is the cutoff value without the skin
+        \param rebuildVL whether to build the list in the constructor
+    */
+    PackedVerletList(shared_ptr< System >, real cut, bool rebuildVL);
+
+    ~PackedVerletList();
+
+    /** row offsets into the neighbor array, one row per real particle
+        (and per ghost with an eighth-shell ghost import) */
+    const std::vector< longint > &getOffsets() const { return offsets; }
+
+    /** array indices of the neighbors */
+    const std::vector< int > &getNeighbors() const { return neighbors; }
+
+    python::tuple getPair(int i);
+
+    real getVerletCutoff(); // returns cutoff + skin
+
+    void connect();
+
+    void disconnect();
+
+    void rebuild();
+
+    /** Get the total number of pairs for the Verlet list */
+    int totalSize() const;
+
+    /** Get the number of pairs for the local Verlet list */
+    int localSize() const;
+
+    /** Add pairs to exclusion list */
+    bool exclude(longint pid1, longint pid2);
+
+    /** Get the number of times the Verlet list has been rebuilt */
+    int getBuilds() const { return builds; }
+
+    /** Set the number of times the Verlet list has been rebuilt */
+    void setBuilds(int _builds) { builds = _builds; }
+
+    /** Register this class so it can be used from Python. */
+    static void registerPython();
+
+  protected:
+
+    bool isExcluded(longint pid1, longint pid2) const;
+
+    std::vector< longint > offsets;
+    std::vector< int > neighbors;
+    boost::unordered_set< std::pair< longint, longint > > exList; // exclusion list
+
+    real cutsq;
+    real cut;
+    real cutVerlet;
+
+    int builds;
+    boost::signals2::connection connectionResort;
+    boost::signals2::connection connectionMoved;
+
+    static LOG4ESPP_DECL_LOGGER(theLogger);
+  };
+
+}
+
+#endif
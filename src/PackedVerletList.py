@@ -0,0 +1,134 @@
+#  Copyright (C) 2017
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+r"""
+***************************
+espressopp.PackedVerletList
+***************************
+
+A Verlet list that stores the neighbors of every real particle as a
+compact array of particle indices (compressed sparse row format) instead
+of a list of particle pointer pairs. This needs a quarter of the memory
+of the :class:`espressopp.VerletList` and lets the force loop keep the
+data of one particle in registers while it runs over its neighbors.
+
+The indices refer to the structure-of-arrays mirror of the storage, which
+is switched on automatically (see ``useParticleArrays`` of
+:class:`espressopp.storage.DomainDecomposition`). The list can only be
+used with the ``PackedVerletList`` interactions, e.g.
+:class:`espressopp.interaction.PackedVerletListLennardJones`.
+
+Example:
+
+>>> vl = espressopp.PackedVerletList(system, cutoff=rc)
+>>> interLJ = espressopp.interaction.PackedVerletListLennardJones(vl)
+
+.. function:: espressopp.PackedVerletList(system, cutoff, exclusionlist)
+
+		:param system:
+		:param cutoff:
+		:param exclusionlist: (default: [])
+		:type system:
+		:type cutoff: real
+		:type exclusionlist:
+
+.. function:: espressopp.PackedVerletList.exclude(exclusionlist)
+
+		:param exclusionlist:
+		:type exclusionlist:
+		:rtype:
+
+.. function:: espressopp.PackedVerletList.getAllPairs()
+
+		:rtype:
+
+.. function:: espressopp.PackedVerletList.localSize()
+
+		:rtype:
+
+.. function:: espressopp.PackedVerletList.totalSize()
+
+		:rtype:
+"""
+from espressopp import pmi
+import _espressopp
+import espressopp
+from espressopp.esutil import cxxinit
+
+class PackedVerletListLocal(_espressopp.PackedVerletList):
+
+
+    def __init__(self, system, cutoff, exclusionlist=[]):
+
+        if pmi.workerIsActive():
+            if (exclusionlist == []):
+                # rebuild list in constructor
+                cxxinit(self, _espressopp.PackedVerletList, system, cutoff, True)
+            else:
+                # do not rebuild list in constructor
+                cxxinit(self, _espressopp.PackedVerletList, system, cutoff, False)
+                # add exclusions
+                for pair in exclusionlist:
+                    pid1, pid2 = pair
+                    self.cxxclass.exclude(self, pid1, pid2)
+                # now rebuild list with exclusions
+                self.cxxclass.rebuild(self)
+
+    def totalSize(self):
+
+        if pmi.workerIsActive():
+            return self.cxxclass.totalSize(self)
+
+    def localSize(self):
+
+        if pmi.workerIsActive():
+            return self.cxxclass.localSize(self)
+
+    def exclude(self, exclusionlist):
+        """
+        Each processor takes the broadcasted exclusion list
+        and adds it to its list.
+        """
+        if pmi.workerIsActive():
+            for pair in exclusionlist:
+                pid1, pid2 = pair
+                self.cxxclass.exclude(self, pid1, pid2)
+            # rebuild list with exclusions
+            self.cxxclass.rebuild(self)
+
+    def getAllPairs(self):
+
+        if pmi.workerIsActive():
+            pairs=[]
+            npairs=self.localSize()
+            for i in xrange(npairs):
+              pair=self.cxxclass.getPair(self, i+1)
+              pairs.append(pair)
+            return pairs
+
+
+if pmi.isController:
+  class PackedVerletList(object):
+    __metaclass__ = pmi.Proxy
+    pmiproxydefs = dict(
+      cls = 'espressopp.PackedVerletListLocal',
+      pmiproperty = [ 'builds' ],
+      pmicall = [ 'totalSize', 'exclude', 'connect', 'disconnect', 'getVerletCutoff' ],
+      pmiinvoke = [ 'getAllPairs' ]
+    )
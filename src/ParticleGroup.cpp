@@ -31,6 +31,8 @@ namespace espressopp {
     : storage(_storage) {
         con_send = storage->beforeSendParticles.connect
                 (boost::bind(&ParticleGroup::beforeSendParticles, this, _1, _2));
+        con_save = storage->beforeSaveParticles.connect
+                (boost::bind(&ParticleGroup::packParticles, this, _1, _2, false));
         con_recv = storage->afterRecvParticles.connect
                 (boost::bind(&ParticleGroup::afterRecvParticles, this, _1, _2));
         con_changed = storage->onParticlesChanged.connect
@@ -40,6 +42,7 @@ namespace espressopp {
 
     ParticleGroup::~ParticleGroup() {
         con_send.disconnect();
+        con_save.disconnect();
         con_recv.disconnect();
         con_changed.disconnect();
     }
@@ -75,14 +78,18 @@ namespace espressopp {
     }
 
 
-    void ParticleGroup::beforeSendParticles(ParticleList& pl, class OutBuffer& buf) {
+    void ParticleGroup::beforeSendParticles(ParticleList& pl, OutBuffer& buf) {
+      packParticles(pl, buf, true);
+    }
+
+    void ParticleGroup::packParticles(ParticleList& pl, OutBuffer& /*buf*/, bool erase) {
         // remove all particles that move to a different node
         for (ParticleList::Iterator pit(pl); pit.isValid(); ++pit) {
             longint pid = pit->id();
 
             std::map<longint, Particle*>::iterator p;
             p = active.find(pid);
-            if (p != active.end())
+            if (erase && p != active.end())
                 active.erase(p);
         }
     }
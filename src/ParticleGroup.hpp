@@ -117,10 +117,11 @@ namespace espressopp {
             shared_ptr<storage::Storage> storage;
 
             // some signalling stuff to keep track of the particles in cell
-            boost::signals2::connection con_send, con_recv, con_changed;
+            boost::signals2::connection con_send, con_recv, con_changed, con_save;
 
             void beforeSendParticles(ParticleList& pl,
                     class OutBuffer& buf);
+            void packParticles(ParticleList& pl, class OutBuffer& buf, bool erase);
             void afterRecvParticles(ParticleList& pl,
                     class InBuffer& buf);
             void onParticlesChanged();
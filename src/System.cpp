@@ -28,8 +28,14 @@
 #include "esutil/RNG.hpp"
 #include "mpi.hpp"
 #include "esutil/Error.hpp"
+#include "integrator/MDIntegrator.hpp"
+#include "iterator/CellListIterator.hpp"
+#include "Buffer.hpp"
 
 #include <limits>
+#include <fstream>
+#include <sstream>
+#include <boost/filesystem.hpp>
 
 #include <mpi4py/mpi4py.h>
 
@@ -139,6 +145,221 @@ namespace espressopp {
 	return shortRangeInteractions.size();
   }
 
+  /////////////////////////////////////////////////////
+  // Checkpoints                                     //
+  /////////////////////////////////////////////////////
+
+  namespace {
+    // "ESPPCK" and the format version
+    const long long checkpointMagic = 0x455350504b430001LL;
+
+    // layout of the integer part of the header file
+    enum { CK_MAGIC, CK_NRANKS, CK_SIZEOF_REAL, CK_SIZEOF_PARTICLE,
+           CK_NPARTICLES, CK_STEP, CK_INTEGRATOR, CK_NINTS };
+    // layout of the real part of the header file
+    enum { CK_BOXX, CK_BOXY, CK_BOXZ, CK_DT, CK_NREALS };
+
+    std::string checkpointHeader(const std::string& path) {
+      return path + "/header.bin";
+    }
+
+    std::string checkpointFile(const std::string& path, int rank) {
+      std::ostringstream name;
+      name << path << "/rank." << rank << ".bin";
+      return name.str();
+    }
+  }
+
+  /* Each CPU writes one file with
+       long long             number of particles N
+       Particle[N]           the particles, as in the migration buffers
+       int, char[]           the data the fixed lists and particle groups
+                             pack for these particles before a migration
+       long long, char[]     the state of the RNG of this CPU
+     and CPU 0 the header with the global information. */
+  void System::checkpoint(std::string path,
+                          shared_ptr< integrator::MDIntegrator > integrator) {
+    esutil::Error err(comm);
+
+    if (comm->rank() == 0) {
+      boost::system::error_code ec;
+      boost::filesystem::create_directories(path, ec);
+      if (ec) {
+        std::stringstream msg;
+        msg << "can not create checkpoint directory " << path;
+        err.setException( msg.str() );
+      }
+    }
+    err.checkException();
+
+    ParticleList particles;
+    particles.reserve(storage->getNRealParticles());
+    CellList realCells = storage->getRealCells();
+    for (iterator::CellListIterator cit(realCells); !cit.isDone(); ++cit)
+      particles.push_back(*cit);
+
+    // the tuples are packed as if all particles left this CPU, but they
+    // stay in the lists, which the running system keeps using
+    if (storage->beforeSaveParticles.num_slots() != storage->beforeSendParticles.num_slots())
+      throw std::runtime_error("System: a list of the storage can not be checkpointed, e.g. with AdResS");
+    OutBuffer tuples(*comm);
+    storage->beforeSaveParticles(particles, tuples);
+
+    std::string rngState = rng ? rng->getState() : std::string();
+
+    std::ofstream out(checkpointFile(path, comm->rank()).c_str(),
+                      std::ios::binary | std::ios::trunc);
+    long long n = particles.size();
+    int tupleSize = tuples.getSize();
+    long long rngSize = rngState.size();
+    out.write((const char*)&n, sizeof(n));
+    if (n > 0)
+      out.write((const char*)&particles[0], n * sizeof(Particle));
+    out.write((const char*)&tupleSize, sizeof(tupleSize));
+    out.write(tuples.getData(), tupleSize);
+    out.write((const char*)&rngSize, sizeof(rngSize));
+    out.write(rngState.data(), rngSize);
+    out.close();
+    if (!out) {
+      std::stringstream msg;
+      msg << "can not write checkpoint file " << checkpointFile(path, comm->rank());
+      err.setException( msg.str() );
+    }
+
+    long long nTotal;
+    mpi::all_reduce(*comm, n, nTotal, std::plus<long long>());
+
+    if (comm->rank() == 0) {
+      long long ints[CK_NINTS];
+      ints[CK_MAGIC] = checkpointMagic;
+      ints[CK_NRANKS] = comm->size();
+      ints[CK_SIZEOF_REAL] = sizeof(real);
+      ints[CK_SIZEOF_PARTICLE] = sizeof(Particle);
+      ints[CK_NPARTICLES] = nTotal;
+      ints[CK_STEP] = integrator ? integrator->getStep() : 0;
+      ints[CK_INTEGRATOR] = integrator ? 1 : 0;
+
+      Real3D L = bc->getBoxL();
+      real reals[CK_NREALS];
+      reals[CK_BOXX] = L[0];
+      reals[CK_BOXY] = L[1];
+      reals[CK_BOXZ] = L[2];
+      reals[CK_DT] = integrator ? integrator->getTimeStep() : 0.0;
+
+      std::ofstream header(checkpointHeader(path).c_str(),
+                           std::ios::binary | std::ios::trunc);
+      header.write((const char*)ints, sizeof(ints));
+      header.write((const char*)reals, sizeof(reals));
+      header.close();
+      if (!header) {
+        std::stringstream msg;
+        msg << "can not write checkpoint file " << checkpointHeader(path);
+        err.setException( msg.str() );
+      }
+    }
+    err.checkException();
+  }
+
+  void System::restore(std::string path,
+                       shared_ptr< integrator::MDIntegrator > integrator) {
+    esutil::Error err(comm);
+
+    long long ints[CK_NINTS];
+    real reals[CK_NREALS];
+    if (comm->rank() == 0) {
+      std::ifstream header(checkpointHeader(path).c_str(), std::ios::binary);
+      header.read((char*)ints, sizeof(ints));
+      header.read((char*)reals, sizeof(reals));
+      if (!header) {
+        std::stringstream msg;
+        msg << "can not read checkpoint file " << checkpointHeader(path);
+        err.setException( msg.str() );
+      }
+    }
+    err.checkException();
+    mpi::broadcast(*comm, ints, CK_NINTS, 0);
+    mpi::broadcast(*comm, reals, CK_NREALS, 0);
+
+    // the same on all CPUs, so it is safe to throw
+    if (ints[CK_MAGIC] != checkpointMagic)
+      throw std::runtime_error("System: " + path + " is not a checkpoint");
+    if (ints[CK_SIZEOF_REAL] != sizeof(real) || ints[CK_SIZEOF_PARTICLE] != sizeof(Particle))
+      throw std::runtime_error("System: checkpoint " + path +
+                               " was written by a build with another particle layout");
+
+    long long nLocal = storage->getNRealParticles(), nBefore;
+    mpi::all_reduce(*comm, nLocal, nBefore, std::plus<long long>());
+    if (nBefore > 0)
+      throw std::runtime_error("System: restore() needs a system without particles");
+
+    // the box may have changed, e.g. with a barostat
+    Real3D L = bc->getBoxL();
+    Real3D savedL(reals[CK_BOXX], reals[CK_BOXY], reals[CK_BOXZ]);
+    if (L != savedL)
+      scaleVolume(Real3D(savedL[0] / L[0], savedL[1] / L[1], savedL[2] / L[2]), false);
+
+    // the files of the writing CPUs are distributed round robin, decompose()
+    // moves the particles to their CPUs afterwards
+    int nRanks = ints[CK_NRANKS];
+    for (int file = comm->rank(); file < nRanks; file += comm->size()) {
+      std::ifstream in(checkpointFile(path, file).c_str(), std::ios::binary);
+
+      long long n = 0;
+      in.read((char*)&n, sizeof(n));
+      ParticleList particles;
+      particles.resize(in ? n : 0);
+      if (n > 0)
+        in.read((char*)&particles[0], n * sizeof(Particle));
+
+      int tupleSize = 0;
+      in.read((char*)&tupleSize, sizeof(tupleSize));
+      std::vector< char > tupleData(in ? tupleSize : 0);
+      if (tupleSize > 0)
+        in.read(&tupleData[0], tupleSize);
+
+      long long rngSize = 0;
+      in.read((char*)&rngSize, sizeof(rngSize));
+      std::string rngState(in ? rngSize : 0, ' ');
+      if (rngSize > 0)
+        in.read(&rngState[0], rngSize);
+
+      if (!in) {
+        std::stringstream msg;
+        msg << "can not read checkpoint file " << checkpointFile(path, file);
+        err.setException( msg.str() );
+        break;
+      }
+
+      storage->insertParticles(particles);
+      InBuffer tuples(*comm);
+      tuples.assign(tupleData.empty() ? 0 : &tupleData[0], tupleData.size());
+      storage->afterRecvParticles(particles, tuples);
+
+      // a CPU continues the RNG stream of the CPU with the same rank,
+      // additional CPUs keep their fresh streams
+      if (file == comm->rank() && rng && rngSize > 0)
+        rng->setState(rngState);
+    }
+    err.checkException();
+
+    storage->decompose();
+
+    nLocal = storage->getNRealParticles();
+    long long nTotal;
+    mpi::all_reduce(*comm, nLocal, nTotal, std::plus<long long>());
+    if (nTotal != ints[CK_NPARTICLES]) {
+      std::stringstream msg;
+      msg << "System: restored " << nTotal << " particles instead of "
+          << ints[CK_NPARTICLES] << " from checkpoint " << path;
+      throw std::runtime_error(msg.str());
+    }
+
+    if (integrator && ints[CK_INTEGRATOR]) {
+      integrator->setStep(ints[CK_STEP]);
+      integrator->setTimeStep(reals[CK_DT]);
+    }
+  }
+
   /* If one wants overload scaleVolume it should be done here as well:
    * - Storage
    * - BC
@@ -210,6 +431,8 @@ namespace espressopp {
       .def("getNumberOfInteractions", &System::getNumberOfInteractions)
       .def("scaleVolume", &System::scaleVolume3D)
       .def("setTrace", &System::setTrace)
+      .def("checkpoint", &System::checkpoint)
+      .def("restore", &System::restore)
       ;
   }
 }
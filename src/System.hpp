@@ -29,6 +29,7 @@
 #include "boost/enable_shared_from_this.hpp"
 #include "interaction/Interaction.hpp"
 #include "types.hpp"
+#include <string>
 
 namespace espressopp {
 
@@ -36,6 +37,10 @@ namespace espressopp {
     class RNG;
   }
 
+  namespace integrator {
+    class MDIntegrator;
+  }
+
   class System : public enable_shared_from_this< System > {
   
   private:
@@ -73,6 +78,21 @@ namespace espressopp {
     void removeInteraction(int i);
     shared_ptr< interaction::Interaction > getInteraction(int i);
     int getNumberOfInteractions();
+
+    /** Write the real particles, the tuples of the fixed lists and
+        particle groups, the box, the RNG states and the step and time
+        step of the integrator (may be null) into the directory path.
+        Every CPU writes its own binary file.
+    */
+    void checkpoint(std::string path, shared_ptr< integrator::MDIntegrator > integrator);
+
+    /** Read a checkpoint written by checkpoint(), possibly with another
+        number of CPUs. The system must not contain particles yet, and the
+        fixed lists and particle groups must have been created in the same
+        order as when the checkpoint was written.
+    */
+    void restore(std::string path, shared_ptr< integrator::MDIntegrator > integrator);
+
     static void registerPython();
 
   };
@@ -98,6 +98,40 @@ Example (not complete):
 
 		:param switch: 
 		:type switch: 
+
+.. function:: espressopp.System.checkpoint(path, integrator=None)
+
+		Writes a binary checkpoint into the directory `path`: all
+		particles with all their properties, the tuples of the fixed
+		lists (FixedPairList, FixedTripleList, ...) and particle groups,
+		the box, the state of the random number generators and, if an
+		integrator is given (or set as `System.integrator`), its step and
+		time step. Every CPU writes its own file.
+
+		:param path: directory, created if needed
+		:type path: str
+		:param integrator:
+		:type integrator: MDIntegrator
+
+.. function:: espressopp.System.restore(path, integrator=None)
+
+		Reads a checkpoint written by `checkpoint()`, also with a
+		different number of CPUs. The script has to set up the system,
+		the storage, the interactions with their fixed lists and the
+		integrator with its extensions as before, but must not add
+		particles or tuples. The fixed lists and particle groups have to
+		be created in the same order as when the checkpoint was written.
+		Extensions with their own data, e.g. the LB fluid, are restored
+		separately.
+
+		:param path: directory of the checkpoint
+		:type path: str
+		:param integrator:
+		:type integrator: MDIntegrator
+
+		>>> system.checkpoint('restart', integrator)
+		>>> # new job, same script without addParticles / addBonds
+		>>> system.restore('restart', integrator)
 """
 
 from espressopp import pmi, Real3D, toReal3DFromVector
@@ -215,6 +249,20 @@ class SystemLocal(_espressopp.System):
         if pmi.workerIsActive():
             self.cxxclass.setTrace(self, switch)
 
+    def checkpoint(self, path, integrator=None):
+
+        if pmi.workerIsActive():
+            if integrator is None:
+                integrator = self._integrator
+            self.cxxclass.checkpoint(self, path, integrator)
+
+    def restore(self, path, integrator=None):
+
+        if pmi.workerIsActive():
+            if integrator is None:
+                integrator = self._integrator
+            self.cxxclass.restore(self, path, integrator)
+
 if pmi.isController:
   class System(object):
     __metaclass__ = pmi.Proxy
@@ -223,5 +271,5 @@ if pmi.isController:
       pmiproperty = ['storage', 'bc', 'rng', 'skin', 'maxCutoff', 'integrator'],
       pmicall = ['addInteraction','removeInteraction', 'removeInteractionByName',
             'getInteraction', 'getNumberOfInteractions','scaleVolume', 'setTrace',
-            'getAllInteractions', 'getInteractionByName']
+            'getAllInteractions', 'getInteractionByName', 'checkpoint', 'restore']
     )
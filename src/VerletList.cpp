@@ -29,6 +29,7 @@
 #include "storage/Storage.hpp"
 #include "bc/BC.hpp"
 #include "iterator/CellListAllPairsIterator.hpp"
+#include <algorithm>
 
 namespace espressopp {
 
@@ -51,6 +52,7 @@ namespace espressopp {
     cutVerlet = cut + system -> getSkin();
     cutsq = cutVerlet * cutVerlet;
     builds = 0;
+    numRealPairs = 0;
 
     if (rebuildVL) rebuild(); // not called if exclutions are provided
 
@@ -58,6 +60,8 @@ namespace espressopp {
     // make a connection to System to invoke rebuild on resort
     connectionResort = system->storage->onParticlesChanged.connect(
         boost::bind(&VerletList::rebuild, this));
+    connectionMoved = system->storage->onParticlesMoved.connect(
+        boost::bind(&VerletList::rebuild, this));
   }
   
   real VerletList::getVerletCutoff(){
@@ -70,6 +74,8 @@ namespace espressopp {
   // make a connection to System to invoke rebuild on resort
   connectionResort = getSystem()->storage->onParticlesChanged.connect(
       boost::bind(&VerletList::rebuild, this));
+  connectionMoved = getSystem()->storage->onParticlesMoved.connect(
+      boost::bind(&VerletList::rebuild, this));
   }
 
   void VerletList::disconnect()
@@ -77,10 +83,15 @@ namespace espressopp {
 
   // disconnect from System to avoid rebuild on resort
   connectionResort.disconnect();
+  connectionMoved.disconnect();
   }
 
   /*-------------------------------------------------------------*/
-  
+
+  static bool isRealPair(const ParticlePair &pair) {
+    return !pair.first->ghost() && !pair.second->ghost();
+  }
+
   void VerletList::rebuild()
   {
     //real cutVerlet = cut + getSystem() -> getSkin();
@@ -91,12 +102,17 @@ namespace espressopp {
 
     // add particles to adress zone
     CellList cl = getSystem()->storage->getRealCells();
+    // ghost cells only contribute pairs with an eighth-shell ghost import
+    CellList gcl = getSystem()->storage->getGhostCells();
     LOG4ESPP_DEBUG(theLogger, "local cell list size = " << cl.size());
-    for (CellListAllPairsIterator it(cl); it.isValid(); ++it) {
+    for (CellListAllPairsIterator it(cl, gcl); it.isValid(); ++it) {
       checkPair(*it->first, *it->second);
       LOG4ESPP_DEBUG(theLogger, "checking particles " << it->first->id() << " and " << it->second->id());
     }
-    
+
+    // pairs of two real particles first, they can be computed before the ghosts arrive
+    numRealPairs = std::partition(vlPairs.begin(), vlPairs.end(), isRealPair) - vlPairs.begin();
+
     builds++;
     LOG4ESPP_DEBUG(theLogger, "rebuilt VerletList (count=" << builds << "), cutsq = " << cutsq
                  << " local size = " << vlPairs.size());
@@ -170,6 +186,7 @@ namespace espressopp {
     if (!connectionResort.connected()) {
       connectionResort.disconnect();
     }
+    connectionMoved.disconnect();
   }
   
   /****************************************************
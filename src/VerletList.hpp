@@ -83,6 +83,10 @@ namespace espressopp {
     /** Set the number of times the Verlet list has been rebuilt */
     void setBuilds(int _builds) { builds = _builds; }
 
+    /** Get the number of pairs of two real particles. These come first
+	in the pair list, the pairs with a ghost follow. */
+    int getNumRealPairs() const { return numRealPairs; }
+
     /** Register this class so it can be used from Python. */
     static void registerPython();
 
@@ -97,7 +101,9 @@ namespace espressopp {
     real cutVerlet;
     
     int builds;
+    int numRealPairs;
     boost::signals2::connection connectionResort;
+    boost::signals2::connection connectionMoved;
 
     static LOG4ESPP_DECL_LOGGER(theLogger);
   };
@@ -47,6 +47,7 @@ namespace espressopp {
       if (!system->storage) {
          throw std::runtime_error("system has no storage");
       }
+      connectionFullGhostShell = system->storage->requireFullGhostShell("VerletListAdress");
       skin = system->getSkin();
       cutverlet = cut + skin;
       cutsq = cutverlet * cutverlet;
@@ -223,6 +224,7 @@ namespace espressopp {
       if (!connectionResort.connected()) {
         connectionResort.disconnect();
       }
+      connectionFullGhostShell.disconnect();
     }
 
     /****************************************************
@@ -118,6 +118,7 @@ namespace espressopp {
     real cutsq;
     int builds;
     boost::signals2::connection connectionResort;
+    boost::signals2::connection connectionFullGhostShell;
 
     static LOG4ESPP_DECL_LOGGER(theLogger);
   };
@@ -43,6 +43,7 @@ namespace espressopp {
     if (!system->storage) {
       throw std::runtime_error("system has no storage");
     }
+    connectionFullGhostShell = system->storage->requireFullGhostShell("VerletListTriple");
 
     cut = _cut;
     cutVerlet = cut + system -> getSkin();
@@ -54,6 +55,8 @@ namespace espressopp {
     // make a connection to System to invoke rebuild on resort
     connectionResort = system->storage->onParticlesChanged.connect(
         boost::bind(&VerletListTriple::rebuild, this));
+    connectionMoved = system->storage->onParticlesMoved.connect(
+        boost::bind(&VerletListTriple::rebuild, this));
   }
   
   real VerletListTriple::getVerletCutoff(){
@@ -64,11 +67,14 @@ namespace espressopp {
     // make a connection to System to invoke rebuild on resort
     connectionResort = getSystem()->storage->onParticlesChanged.connect( 
             boost::bind(&VerletListTriple::rebuild, this));
+    connectionMoved = getSystem()->storage->onParticlesMoved.connect(
+        boost::bind(&VerletListTriple::rebuild, this));
   }
 
   void VerletListTriple::disconnect(){
     // disconnect from System to avoid rebuild on resort
     connectionResort.disconnect();
+    connectionMoved.disconnect();
   }
 
   /*-------------------------------------------------------------*/
@@ -165,6 +171,8 @@ namespace espressopp {
     if (!connectionResort.connected()){
       connectionResort.disconnect();
     }
+    connectionMoved.disconnect();
+    connectionFullGhostShell.disconnect();
   }
   
   /****************************************************
@@ -97,6 +97,8 @@ namespace espressopp {
     
     int builds;
     boost::signals2::connection connectionResort;
+    boost::signals2::connection connectionMoved;
+    boost::signals2::connection connectionFullGhostShell;
 
     static LOG4ESPP_DECL_LOGGER(theLogger);
   };
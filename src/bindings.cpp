@@ -31,6 +31,7 @@
 #include <VerletList.hpp>
 #include <VerletListAdress.hpp>
 #include <VerletListTriple.hpp>
+#include <PackedVerletList.hpp>
 #include <FixedSingleList.hpp>
 #include <FixedPairList.hpp>
 #include <FixedPairDistList.hpp>
@@ -68,6 +69,7 @@ void espressopp::registerPython() {
   espressopp::VerletList::registerPython();
   espressopp::VerletListAdress::registerPython();
   espressopp::VerletListTriple::registerPython();
+  espressopp::PackedVerletList::registerPython();
   espressopp::FixedSingleList::registerPython();
   espressopp::FixedPairList::registerPython();
   espressopp::FixedPairDistList::registerPython();
@@ -0,0 +1,130 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _ESUTIL_FLATMULTIMAP_HPP
+#define _ESUTIL_FLATMULTIMAP_HPP
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace espressopp {
+  namespace esutil {
+
+    /** Multimap stored as one vector of (key, value) pairs sorted by key,
+        e.g. the global tuples of the fixed lists, keyed by particle id.
+        Lookups are binary searches, and iterating visits the keys in
+        ascending order in one contiguous block of memory.
+
+        New entries are collected unsorted and merged into the vector
+        before the next access, so inserting many entries costs one sort
+        of the new ones and one linear merge. Entries with the same key
+        keep the order of their insertion. Erasing shifts the rest of the
+        vector, eraseKeys() removes the entries of many keys in one pass.
+    */
+    template< typename Key, typename T >
+    class FlatMultimap {
+    public:
+      typedef Key key_type;
+      typedef T mapped_type;
+      typedef std::pair< Key, T > value_type;
+      typedef typename std::vector< value_type >::size_type size_type;
+      typedef typename std::vector< value_type >::iterator iterator;
+      typedef typename std::vector< value_type >::const_iterator const_iterator;
+
+      size_type size() const { return entries.size() + pending.size(); }
+      bool empty() const { return entries.empty() && pending.empty(); }
+      void clear() { entries.clear(); pending.clear(); }
+      void reserve(size_type n) { entries.reserve(n); }
+
+      void insert(const value_type& v) { pending.push_back(v); }
+      /// the position is only a hint for the compatibility with std::multimap
+      void insert(const_iterator /*hint*/, const value_type& v) { insert(v); }
+
+      iterator begin() { merge(); return entries.begin(); }
+      iterator end() { merge(); return entries.end(); }
+      const_iterator begin() const { merge(); return entries.begin(); }
+      const_iterator end() const { merge(); return entries.end(); }
+
+      std::pair< iterator, iterator > equal_range(const Key& key) {
+        merge();
+        return std::equal_range(entries.begin(), entries.end(), key, KeyLess());
+      }
+
+      std::pair< const_iterator, const_iterator > equal_range(const Key& key) const {
+        merge();
+        return std::equal_range(entries.begin(), entries.end(), key, KeyLess());
+      }
+
+      size_type count(const Key& key) const {
+        std::pair< const_iterator, const_iterator > range = equal_range(key);
+        return range.second - range.first;
+      }
+
+      iterator erase(const_iterator first, const_iterator last) {
+        merge();
+        return entries.erase(first, last);
+      }
+
+      size_type erase(const Key& key) {
+        std::pair< iterator, iterator > range = equal_range(key);
+        size_type n = range.second - range.first;
+        entries.erase(range.first, range.second);
+        return n;
+      }
+
+      /// erase the entries of all the given keys, which get sorted
+      void eraseKeys(std::vector< Key >& keys) {
+        merge();
+        std::sort(keys.begin(), keys.end());
+        typename std::vector< Key >::const_iterator k = keys.begin();
+        iterator out = entries.begin();
+        for (iterator it = entries.begin(); it != entries.end(); ++it) {
+          while (k != keys.end() && *k < it->first) ++k;
+          if (k != keys.end() && *k == it->first) continue;
+          *out++ = *it;
+        }
+        entries.erase(out, entries.end());
+      }
+
+    private:
+      struct KeyLess {
+        bool operator()(const value_type& a, const value_type& b) const { return a.first < b.first; }
+        bool operator()(const value_type& a, const Key& b) const { return a.first < b; }
+        bool operator()(const Key& a, const value_type& b) const { return a < b.first; }
+      };
+
+      void merge() const {
+        if (pending.empty()) return;
+        size_type n = entries.size();
+        std::stable_sort(pending.begin(), pending.end(), KeyLess());
+        entries.insert(entries.end(), pending.begin(), pending.end());
+        pending.clear();
+        std::inplace_merge(entries.begin(), entries.begin() + n, entries.end(), KeyLess());
+      }
+
+      // the entries are sorted by key, pending the ones inserted since the last access
+      mutable std::vector< value_type > entries;
+      mutable std::vector< value_type > pending;
+    };
+  }
+}
+
+#endif
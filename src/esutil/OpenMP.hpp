@@ -0,0 +1,57 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _ESUTIL_OPENMP_HPP
+#define _ESUTIL_OPENMP_HPP
+
+/** Thin wrappers around the OpenMP runtime, so that threaded code also
+    compiles (and runs on one thread) when OpenMP is not enabled, see
+    the WITH_OPENMP cmake option.
+*/
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace espressopp {
+  namespace esutil {
+
+    /// number of threads a parallel region with n requested threads will use (n <= 0: default)
+    inline int getNumThreads(int n = 0) {
+#ifdef _OPENMP
+      return (n > 0) ? n : omp_get_max_threads();
+#else
+      return 1;
+#endif
+    }
+
+    /// index of the calling thread in the current parallel region
+    inline int getThreadNum() {
+#ifdef _OPENMP
+      return omp_get_thread_num();
+#else
+      return 0;
+#endif
+    }
+
+  }
+}
+#endif
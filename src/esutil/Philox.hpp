@@ -0,0 +1,74 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _ESUTIL_PHILOX_HPP
+#define _ESUTIL_PHILOX_HPP
+
+#include <stdint.h>
+#include "types.hpp"
+
+namespace espressopp {
+  namespace esutil {
+    /** Philox4x32-10 counter-based random number generator
+        (J. K. Salmon et al., SC'11). It has no state besides the key:
+        every counter of four 32-bit words is mapped to four independent
+        32-bit random numbers. Streams can thus be drawn in any order and
+        from any thread, and the numbers only depend on the key and on
+        what the counter encodes (e.g. site index and time step).
+    */
+    class Philox {
+    public:
+      Philox(uint32_t _k0 = 0, uint32_t _k1 = 0) { key[0] = _k0; key[1] = _k1; }
+
+      /** Fills out with the four random numbers of the counter ctr. */
+      void operator()(const uint32_t ctr[4], uint32_t out[4]) const {
+        uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+        uint32_t k0 = key[0], k1 = key[1];
+
+        for (int r = 0; r < 10; ++r) {
+          if (r > 0) {
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+          }
+          uint64_t p0 = (uint64_t)0xD2511F53u * c0;
+          uint64_t p1 = (uint64_t)0xCD9E8D57u * c2;
+          uint32_t hi0 = (uint32_t)(p0 >> 32), lo0 = (uint32_t)p0;
+          uint32_t hi1 = (uint32_t)(p1 >> 32), lo1 = (uint32_t)p1;
+          c0 = hi1 ^ c1 ^ k0;
+          c1 = lo1;
+          c2 = hi0 ^ c3 ^ k1;
+          c3 = lo0;
+        }
+        out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+      }
+
+      /** Maps a 32-bit random number to a uniform real in (0, 1). */
+      static real toUniform(uint32_t x) {
+        return (x + 0.5) * (1. / 4294967296.);
+      }
+
+    private:
+      uint32_t key[2];
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,94 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _ESUTIL_PYBUFFER_HPP
+#define _ESUTIL_PYBUFFER_HPP
+
+#include "python.hpp"
+#include "types.hpp"
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace espressopp {
+  namespace esutil {
+
+    /** Read-only view of a C-contiguous Python object with the buffer
+        protocol (e.g. a NumPy array) that holds rows of dim values of
+        type T. Integers are accepted in any 8 byte format, floats only
+        in the format of T. A None object gives an invalid view.
+    */
+    template< typename T >
+    class PyBuffer {
+    public:
+      PyBuffer(python::object obj, const char* name, int _dim)
+        : dim(_dim), data(0), rows(0) {
+        view.obj = 0;
+        if (obj.is_none()) return;
+
+        if (PyObject_GetBuffer(obj.ptr(), &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0)
+          python::throw_error_already_set();
+
+        // accept the native and the explicit little/big endian codes
+        const char* format = view.format;
+        if (format && strchr("@=<>!", format[0])) ++format;
+        if (view.itemsize != sizeof(T) || !format || !strchr(formats(), format[0])) {
+          PyBuffer_Release(&view);
+          view.obj = 0;
+          std::ostringstream msg;
+          msg << name << " must hold " << sizeof(T) << " byte "
+              << (isInteger() ? "integers" : "floats");
+          throw std::invalid_argument(msg.str());
+        }
+        if ((view.len / view.itemsize) % dim != 0) {
+          PyBuffer_Release(&view);
+          view.obj = 0;
+          std::ostringstream msg;
+          msg << name << " must hold " << dim << " values per row";
+          throw std::invalid_argument(msg.str());
+        }
+        data = static_cast< const T* >(view.buf);
+        rows = view.len / view.itemsize / dim;
+      }
+
+      ~PyBuffer() { if (view.obj) PyBuffer_Release(&view); }
+
+      bool valid() const { return data != 0; }
+      /// number of rows
+      longint size() const { return rows; }
+      const T* operator[](longint i) const { return data + i * dim; }
+
+    private:
+      PyBuffer(const PyBuffer&);
+      PyBuffer& operator=(const PyBuffer&);
+
+      static bool isInteger() { return std::numeric_limits< T >::is_integer; }
+      static const char* formats() { return isInteger() ? "ilqILQ" : "fd"; }
+
+      int dim;
+      const T* data;
+      longint rows;
+      Py_buffer view;
+    };
+  }
+}
+
+#endif
@@ -24,6 +24,8 @@
 #include "RNG.hpp"
 #include "mpi.hpp"
 #include "types.hpp"
+#include <sstream>
+#include <stdexcept>
 
 using namespace boost;
 
@@ -47,6 +49,20 @@ namespace espressopp {
       return seed_;
     }
 
+    std::string RNG::getState() {
+      std::ostringstream state;
+      // the distributions of the variates only hold their parameters
+      state << seed_ << ' ' << *boostRNG;
+      return state.str();
+    }
+
+    void RNG::setState(const std::string& state) {
+      std::istringstream in(state);
+      in >> seed_ >> *boostRNG;
+      if (!in)
+        throw std::runtime_error("RNG: invalid state");
+    }
+
     real RNG::operator()() { 
       variate_generator< RNGType&, uniform_01<> > uni(*boostRNG, uniform_01<>());
       return uni();
@@ -26,6 +26,7 @@
 #include <boost/random.hpp>
 #include "Real3D.hpp"
 #include <vector>
+#include <string>
 
 
 #include "types.hpp"
@@ -48,6 +49,13 @@ namespace espressopp {
 
       /** Gets RNG seed. */
       long get_seed();
+
+      /** Returns the complete state of the generator of this CPU,
+          e.g. to write it into a checkpoint. */
+      std::string getState();
+
+      /** Restores a state returned by getState(). */
+      void setState(const std::string& state);
     
       /** returns a uniformly distributed random number between 0 and
 	  1. */
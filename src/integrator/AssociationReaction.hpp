@@ -38,6 +38,7 @@
 #include "interaction/Potential.hpp"
 
 #include "boost/signals2.hpp"
+#include "boost/unordered_map.hpp"
 
 
 namespace espressopp {
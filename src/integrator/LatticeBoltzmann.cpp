@@ -29,6 +29,7 @@
 #include "iterator/CellListIterator.hpp"
 #include "esutil/RNG.hpp"
 #include "esutil/Grid.hpp"
+#include "esutil/OpenMP.hpp"
 #include "bc/BC.hpp"
 
 #define REQ_HALO_SPREAD 501
@@ -41,6 +42,9 @@
 #define COMM_DEN_0 704
 #define COMM_DEN_1 705
 
+#define LB_CHECKPOINT_HEADER 8
+#define LB_CHECKPOINT_MAGIC 0x455350504c420001LL   // "ESPPLB" and format version 1
+
 namespace espressopp {
    using namespace boost;
    using namespace iterator;
@@ -68,6 +72,7 @@ namespace espressopp {
          /* setup simulation parameters */
          setDoFluct(false);                                 // no fluctuations
          setDoRestart(true);                                // at first set true
+         setCheckpointRead(false);                          // no binary checkpoint read
          setDoExtForce(false);                              // no external forces
 
          /* setup random numbers generator */
@@ -81,6 +86,7 @@ namespace espressopp {
          setNSteps(1);                                      // # MD steps between LB update
          setPrevDumpStep(0);                                // interval between dumping coupl-files
          setProfStep(10000);                                // set default time profiling step
+         setNumThreads(0);                                  // default number of threads
 
          /* find total number of MD particles*/
          int _Npart = _system->storage->getNRealParticles();
@@ -262,14 +268,17 @@ namespace espressopp {
 
       void LatticeBoltzmann::keepLBDump () { setPrevDumpStep(0);}
 
+      void LatticeBoltzmann::setCheckpointRead (bool _read) { ckptRead = _read;}
+      bool LatticeBoltzmann::checkpointRead () { return ckptRead;}
+
       /* Setter and getter for access to population values */
       void LatticeBoltzmann::setPops (Int3D _Ni, int _l, real _value) {
-         (*lbfluid)[_Ni[0]][_Ni[1]][_Ni[2]].setF_i(_l, _value);   }
+         lbfluid->setF_i(_Ni[0], _Ni[1], _Ni[2], _l, _value);   }
       real LatticeBoltzmann::getPops (Int3D _Ni, int _l) {
-         return (*lbfluid)[_Ni[0]][_Ni[1]][_Ni[2]].getF_i(_l);   }
+         return lbfluid->getF_i(_Ni[0], _Ni[1], _Ni[2], _l);   }
 
       void LatticeBoltzmann::setGhostFluid (Int3D _Ni, int _l, real _value) {
-         (*ghostlat)[_Ni[0]][_Ni[1]][_Ni[2]].setF_i(_l, _value);   }
+         ghostlat->setF_i(_Ni[0], _Ni[1], _Ni[2], _l, _value);   }
 
       void LatticeBoltzmann::setLBMom (Int3D _Ni, int _l, real _value) {
          (*lbmom)[_Ni[0]][_Ni[1]][_Ni[2]].setMom_i(_l, _value);   }
@@ -285,6 +294,10 @@ namespace espressopp {
          return getNi().getItem(0) / (getSystem()->bc->getBoxL().getItem(0) * getA());}
 
       /* Profiling definitions */
+      void LatticeBoltzmann::setNumThreads (int _numThreads) { numThreads = _numThreads;}
+      int LatticeBoltzmann::getNumThreads () { return numThreads;}
+      int LatticeBoltzmann::getUsedThreads () { return esutil::getNumThreads(numThreads);}
+
       void LatticeBoltzmann::setProfStep (int _profStep) { profStep = _profStep;}
       int LatticeBoltzmann::getProfStep () { return profStep;}
 
@@ -305,24 +318,18 @@ namespace espressopp {
          Int3D _numSites = getMyNi();
 
          /* stretch lattices resizing them in 3 dimensions */
-         lbfluid = new lblattice;
-         ghostlat = new lblattice;
+         lbfluid = new lblattice(_numSites, getNumVels());
+         ghostlat = new lblattice(_numSites, getNumVels());
          lbmom = new lbmoments;
          lbfor = new lbforces;
 
-         (*lbfluid).resize(_numSites[0]);
-         (*ghostlat).resize(_numSites[0]);
          (*lbmom).resize(_numSites[0]);
          (*lbfor).resize(_numSites[0]);
 
          for (int i = 0; i < _numSites[0]; i++) {
-            (*lbfluid)[i].resize(_numSites[1]);
-            (*ghostlat)[i].resize(_numSites[1]);
             (*lbmom)[i].resize(_numSites[1]);
             (*lbfor)[i].resize(_numSites[1]);
             for (int j = 0; j < _numSites[1]; j++) {
-               (*lbfluid)[i][j].resize(_numSites[2]);
-               (*ghostlat)[i][j].resize(_numSites[2]);
                (*lbmom)[i][j].resize(_numSites[2]);
                (*lbfor)[i][j].resize(_numSites[2]);
             }
@@ -423,16 +430,9 @@ namespace espressopp {
                setPhi(l, sqrt(mu / getInvB(l)));
             }
 
-            // set phi on every lattice site
-            Int3D _Ni = getMyNi();
-            for (int i = 0; i < _Ni[0]; i++) {
-               for (int j = 0; j < _Ni[1]; j++) {
-                  for (int k = 0; k < _Ni[2]; k++) {
-                     for (int l = 0; l < getNumVels(); l++) {
-                        (*lbfluid)[i][j][k].setPhiLoc(l,getPhi(l));
-                     }
-                  }
-               }
+            // set phi for the collision on the lattice sites
+            for (int l = 0; l < getNumVels(); l++) {
+               LBSite::setPhiLoc(l,getPhi(l));
             }
 
             if (_myRank == 0) {
@@ -516,8 +516,6 @@ namespace espressopp {
       /* COLLIDE-STREAM STEP */
       void LatticeBoltzmann::collideStream () {
          int _offset = getHaloSkin();
-         bool _extForce = doExtForce();
-         bool _fluct = doFluct();
          bool _coupling = doCoupling();
          Int3D _myNi = getMyNi();
 
@@ -526,25 +524,25 @@ namespace espressopp {
             copyForcesFromHalo();
          }
 
-         // collision-streaming //
+         // the boundary planes in x are collided first, so that their halo is //
+         // sent while the inner planes are collided                        //
          real timer = colstream.getElapsedTime();
-         for (int i = _offset; i < _myNi[0]-_offset; i++) {
-            for (int j = _offset; j < _myNi[1]-_offset; j++) {
-               for (int k = _offset; k < _myNi[2]-_offset; k++) {
-                  Real3D _f = (*lbfor)[i][j][k].getExtForceLoc()
-                            + (*lbfor)[i][j][k].getCouplForceLoc();
+         int _iLast = _myNi[0] - _offset - 1;
+         collideStreamPlanes(_offset, _offset + 1);
+         if (_iLast > _offset) collideStreamPlanes(_iLast, _iLast + 1);
+         time_colstr += ( colstream.getElapsedTime() - timer );
 
-                  (*lbfluid)[i][j][k].collision(_fluct, _extForce,
-                                                _coupling, _f, gamma);
-                  streaming (i,j,k);
-               }
-            }
-         }
+         timer = comm.getElapsedTime();
+         beginCommHalo();
+         time_comm += ( comm.getElapsedTime() - timer );
+
+         timer = colstream.getElapsedTime();
+         collideStreamPlanes(_offset + 1, _iLast);
          time_colstr += ( colstream.getElapsedTime() - timer );
 
          // halo communication //
          timer = comm.getElapsedTime();
-         commHalo();
+         endCommHalo();
          time_comm += ( comm.getElapsedTime() - timer );
 
          /* swapping of the pointers to the lattices */
@@ -574,39 +572,72 @@ namespace espressopp {
 
 /*******************************************************************************************/
 
-      /* STREAMING ALONG THE VELOCITY VECTORS. SERIAL */
-      // periodic boundaries are handled separately in commHalo() //
-      void LatticeBoltzmann::streaming(int _i, int _j, int _k) {
-
-         // assign iterations
-         int _ip = _i + 1; int _im = _i - 1;
-         int _jp = _j + 1; int _jm = _j - 1;
-         int _kp = _k + 1; int _km = _k - 1;
-
-         // do not move the staying populations
-         (*ghostlat)[_i][_j][_k].setF_i(0,(*lbfluid)[_i][_j][_k].getF_i(0));
-
-         // move populations to the nearest neighbors
-         (*ghostlat)[_ip][_j][_k].setF_i(1,(*lbfluid)[_i][_j][_k].getF_i(1));
-         (*ghostlat)[_im][_j][_k].setF_i(2,(*lbfluid)[_i][_j][_k].getF_i(2));
-         (*ghostlat)[_i][_jp][_k].setF_i(3,(*lbfluid)[_i][_j][_k].getF_i(3));
-         (*ghostlat)[_i][_jm][_k].setF_i(4,(*lbfluid)[_i][_j][_k].getF_i(4));
-         (*ghostlat)[_i][_j][_kp].setF_i(5,(*lbfluid)[_i][_j][_k].getF_i(5));
-         (*ghostlat)[_i][_j][_km].setF_i(6,(*lbfluid)[_i][_j][_k].getF_i(6));
-
-         // move populations to the next-to-the-nearest neighbors
-         (*ghostlat)[_ip][_jp][_k].setF_i(7,(*lbfluid)[_i][_j][_k].getF_i(7));
-         (*ghostlat)[_im][_jm][_k].setF_i(8,(*lbfluid)[_i][_j][_k].getF_i(8));
-         (*ghostlat)[_ip][_jm][_k].setF_i(9,(*lbfluid)[_i][_j][_k].getF_i(9));
-         (*ghostlat)[_im][_jp][_k].setF_i(10,(*lbfluid)[_i][_j][_k].getF_i(10));
-         (*ghostlat)[_ip][_j][_kp].setF_i(11,(*lbfluid)[_i][_j][_k].getF_i(11));
-         (*ghostlat)[_im][_j][_km].setF_i(12,(*lbfluid)[_i][_j][_k].getF_i(12));
-         (*ghostlat)[_ip][_j][_km].setF_i(13,(*lbfluid)[_i][_j][_k].getF_i(13));
-         (*ghostlat)[_im][_j][_kp].setF_i(14,(*lbfluid)[_i][_j][_k].getF_i(14));
-         (*ghostlat)[_i][_jp][_kp].setF_i(15,(*lbfluid)[_i][_j][_k].getF_i(15));
-         (*ghostlat)[_i][_jm][_km].setF_i(16,(*lbfluid)[_i][_j][_k].getF_i(16));
-         (*ghostlat)[_i][_jp][_km].setF_i(17,(*lbfluid)[_i][_j][_k].getF_i(17));
-         (*ghostlat)[_i][_jm][_kp].setF_i(18,(*lbfluid)[_i][_j][_k].getF_i(18));
+      /* FUSED COLLISION-STREAMING OF THE REAL SITES IN THE PLANES [_iBegin, _iEnd) IN X */
+      // each site is read once from lbfluid, collided and its populations are
+      // pushed to the neighbours in ghostlat
+      void LatticeBoltzmann::collideStreamPlanes (int _iBegin, int _iEnd) {
+         int _offset = getHaloSkin();
+         bool _extForce = doExtForce();
+         bool _fluct = doFluct();
+         bool _coupling = doCoupling();
+         Int3D _myNi = getMyNi();
+
+         int _numVels = getNumVels();
+         int _neighbour[19];
+         for (int l = 0; l < _numVels; l++) {
+            _neighbour[l] = lbfluid->getNeighbour(l);
+         }
+
+         // the fluctuations are drawn from a counter-based RNG keyed by the seed of
+         // the system RNG, with the global site index and the step as a counter
+         long _seed = rng->get_seed();
+         esutil::Philox _philox(uint32_t(_seed), uint32_t(_seed >> 32));
+         uint32_t _step = uint32_t(getStepNum());
+         Int3D _Ni = getNi();
+         Int3D _globIdx = findGlobIdx();
+
+         // every population in ghostlat is written by exactly one site, so the //
+         // planes of the lattice can be collided by different threads          //
+         #pragma omp parallel for schedule(static) num_threads(esutil::getNumThreads(numThreads))
+         for (int i = _iBegin; i < _iEnd; i++) {
+            LBSite _block;
+            Real3D _f[LBSite::blockSize];
+            uint32_t _siteId[LBSite::blockSize];
+
+            for (int j = _offset; j < _myNi[1]-_offset; j++) {
+               int _row = lbfluid->getSite(i, j, 0);
+               uint32_t _rowId = ((_globIdx[0] + i - _offset) * _Ni[1]
+                                  + _globIdx[1] + j - _offset) * _Ni[2] + _globIdx[2] - _offset;
+
+               for (int k0 = _offset; k0 < _myNi[2]-_offset; k0 += LBSite::blockSize) {
+                  int _n = std::min(LBSite::blockSize, _myNi[2]-_offset-k0);
+                  int _s = _row + k0;
+
+                  for (int w = 0; w < _n; w++) {
+                     _f[w] = (*lbfor)[i][j][k0+w].getExtForceLoc()
+                           + (*lbfor)[i][j][k0+w].getCouplForceLoc();
+                     _siteId[w] = _rowId + k0 + w;
+                  }
+
+                  for (int l = 0; l < _numVels; l++) {
+                     for (int w = 0; w < _n; w++) {
+                        _block.setF_i(l, w, lbfluid->getF_i(_s + w, l));
+                     }
+                  }
+
+                  _block.collision(_n, _fluct, _extForce, _coupling, _f, gamma,
+                                   _philox, _siteId, _step);
+
+                  // periodic boundaries are handled separately in commHalo() //
+                  for (int l = 0; l < _numVels; l++) {
+                     int _d = _s + _neighbour[l];
+                     for (int w = 0; w < _n; w++) {
+                        ghostlat->setF_i(_d + w, l, _block.getF_i(l, w));
+                     }
+                  }
+               }
+            }
+         }
       }
 
 /*******************************************************************************************/
@@ -735,8 +766,8 @@ namespace espressopp {
                   real denLoc = 0.;
                   Real3D jLoc = Real3D(0.);
                   for (int l = 0; l < _numVels; l++) {
-                     denLoc += (*lbfluid)[i][j][k].getF_i(l);
-                     jLoc += (*lbfluid)[i][j][k].getF_i(l)*getCi(l);
+                     denLoc += lbfluid->getF_i(i,j,k,l);
+                     jLoc += lbfluid->getF_i(i,j,k,l)*getCi(l);
                   }
                   (*lbmom)[i][j][k].setMom_i(0,denLoc);
                   (*lbmom)[i][j][k].setMom_i(1,jLoc[0]);
@@ -805,11 +836,16 @@ namespace espressopp {
             }
          } else if (_step != 0 && _coupling && _restart) {
             // if it is a real restart
-            readLBConf(1);
-            copyDenMomToHalo();
+            if (checkpointRead()) {
+               // the fluid came from a binary checkpoint, add the coupling forces
+               readLBConf(0);
+            } else {
+               readLBConf(1);
+               copyDenMomToHalo();
 
-            // re-check
-            saveLBConf();
+               // re-check
+               saveLBConf();
+            }
          } else {
             // if we just continue simulation
             readLBConf(0);
@@ -1156,6 +1192,197 @@ namespace espressopp {
 
       }
 
+/*******************************************************************************************/
+
+      /* BINARY CHECKPOINT OF THE LB-FLUID */
+      // one shared file for all CPUs: a header of LB_CHECKPOINT_HEADER long longs,
+      // the numVels populations and 4 moments of every real site in global
+      // C-order (x slowest) and the coupling forces acting onto the MD particles
+      // by particle id. The file does not depend on the decomposition.
+      void LatticeBoltzmann::setCheckpointView (MPI_File _fh, MPI_Datatype &_site,
+                                                MPI_Datatype &_block) {
+         int _offset = getHaloSkin();
+         Int3D _Ni = getNi();
+         Int3D _myNi = getMyNi();
+         Real3D _myLeft = getMyLeft();
+
+         int _gsizes[3], _lsizes[3], _starts[3];
+         for (int _dim = 0; _dim < 3; _dim++) {
+            _gsizes[_dim] = _Ni[_dim];
+            _lsizes[_dim] = _myNi[_dim] - 2 * _offset;
+            _starts[_dim] = (int)_myLeft[_dim];
+         }
+
+         MPI_Type_contiguous(getNumVels() + 4, mpi::get_mpi_datatype<real>(), &_site);
+         MPI_Type_commit(&_site);
+         MPI_Type_create_subarray(3, _gsizes, _lsizes, _starts, MPI_ORDER_C, _site, &_block);
+         MPI_Type_commit(&_block);
+
+         MPI_File_set_view(_fh, LB_CHECKPOINT_HEADER * sizeof(long long), _site, _block,
+                           (char*)"native", MPI_INFO_NULL);
+      }
+
+/*******************************************************************************************/
+
+      void LatticeBoltzmann::saveLBCheckpoint (std::string _filename) {
+         timeSaveLBConf.reset();
+         real timeStart = timeSaveLBConf.getElapsedTime();
+
+         mpi::communicator &_comm = *getSystem()->comm;
+         int _offset = getHaloSkin();
+         int _numVels = getNumVels();
+         Int3D _Ni = getNi();
+         Int3D _myNi = getMyNi();
+         int _totNPart = getTotNPart();
+
+         MPI_File _fh;
+         if (MPI_File_open((MPI_Comm)_comm, (char*)_filename.c_str(),
+                           MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &_fh) != MPI_SUCCESS) {
+            throw std::runtime_error("cannot open LB checkpoint file " + _filename);
+         }
+         MPI_File_set_size(_fh, 0);
+
+         long long _header[LB_CHECKPOINT_HEADER] = {LB_CHECKPOINT_MAGIC, _numVels,
+            _Ni[0], _Ni[1], _Ni[2], integrator->getStep(), _totNPart, sizeof(real)};
+         if (_comm.rank() == 0) {
+            MPI_File_write_at(_fh, 0, _header, LB_CHECKPOINT_HEADER, MPI_LONG_LONG,
+                              MPI_STATUS_IGNORE);
+         }
+
+         // populations and moments of the real sites //
+         std::vector<real> _buf;
+         _buf.reserve((_numVels + 4) * (_myNi[0] - 2 * _offset)
+                      * (_myNi[1] - 2 * _offset) * (_myNi[2] - 2 * _offset));
+         for (int _i = _offset; _i < _myNi[0] - _offset; _i++) {
+            for (int _j = _offset; _j < _myNi[1] - _offset; _j++) {
+               for (int _k = _offset; _k < _myNi[2] - _offset; _k++) {
+                  for (int _l = 0; _l < _numVels; _l++) {
+                     _buf.push_back(lbfluid->getF_i(_i, _j, _k, _l));
+                  }
+                  for (int _m = 0; _m < 4; _m++) {
+                     _buf.push_back((*lbmom)[_i][_j][_k].getMom_i(_m));
+                  }
+               }
+            }
+         }
+
+         MPI_Datatype _site, _block;
+         setCheckpointView(_fh, _site, _block);
+         MPI_File_write_all(_fh, &_buf[0], _buf.size() / (_numVels + 4), _site,
+                            MPI_STATUS_IGNORE);
+         MPI_Type_free(&_block);
+         MPI_Type_free(&_site);
+
+         // coupling forces acting onto the MD particles, collected on CPU 0 //
+         std::vector<real> _fLoc(3 * (_totNPart + 1), 0.), _fTot(3 * (_totNPart + 1), 0.);
+         CellList realCells = getSystem()->storage->getRealCells();
+         for(CellListIterator cit(realCells); !cit.isDone(); ++cit) {
+            Real3D _f = getFOnPart(cit->id());
+            for (int _dim = 0; _dim < 3; _dim++) _fLoc[3 * cit->id() + _dim] = _f[_dim];
+         }
+         MPI_Reduce(&_fLoc[0], &_fTot[0], _fLoc.size(), mpi::get_mpi_datatype<real>(),
+                    MPI_SUM, 0, (MPI_Comm)_comm);
+
+         MPI_File_set_view(_fh, 0, MPI_BYTE, MPI_BYTE, (char*)"native", MPI_INFO_NULL);
+         if (_comm.rank() == 0) {
+            MPI_Offset _pos = LB_CHECKPOINT_HEADER * sizeof(long long)
+               + MPI_Offset(_Ni[0]) * _Ni[1] * _Ni[2] * (_numVels + 4) * sizeof(real);
+            MPI_File_write_at(_fh, _pos, &_fTot[0], _fTot.size(),
+                              mpi::get_mpi_datatype<real>(), MPI_STATUS_IGNORE);
+         }
+
+         MPI_File_close(&_fh);
+
+         real timeEnd = timeSaveLBConf.getElapsedTime() - timeStart;
+         if (_comm.rank() == 0) {
+            printf("step %lld: saved LB checkpoint %s in %f seconds\n",
+                   integrator->getStep(), _filename.c_str(), timeEnd);
+         }
+      }
+
+/*******************************************************************************************/
+
+      void LatticeBoltzmann::readLBCheckpoint (std::string _filename) {
+         timeReadLBConf.reset();
+         real timeStart = timeReadLBConf.getElapsedTime();
+
+         mpi::communicator &_comm = *getSystem()->comm;
+         int _offset = getHaloSkin();
+         int _numVels = getNumVels();
+         Int3D _Ni = getNi();
+         Int3D _myNi = getMyNi();
+         int _totNPart = getTotNPart();
+
+         MPI_File _fh;
+         if (MPI_File_open((MPI_Comm)_comm, (char*)_filename.c_str(),
+                           MPI_MODE_RDONLY, MPI_INFO_NULL, &_fh) != MPI_SUCCESS) {
+            throw std::runtime_error("cannot open LB checkpoint file " + _filename);
+         }
+
+         long long _header[LB_CHECKPOINT_HEADER];
+         MPI_File_read_at_all(_fh, 0, _header, LB_CHECKPOINT_HEADER, MPI_LONG_LONG,
+                              MPI_STATUS_IGNORE);
+         if (_header[0] != LB_CHECKPOINT_MAGIC || _header[1] != _numVels
+             || _header[2] != _Ni[0] || _header[3] != _Ni[1] || _header[4] != _Ni[2]
+             || _header[7] != (long long)sizeof(real)) {
+            MPI_File_close(&_fh);
+            throw std::runtime_error("LB checkpoint file " + _filename
+                                     + " does not match the lattice");
+         }
+
+         // populations and moments of the real sites //
+         int _numSites = (_myNi[0] - 2 * _offset) * (_myNi[1] - 2 * _offset)
+                         * (_myNi[2] - 2 * _offset);
+         std::vector<real> _buf((_numVels + 4) * _numSites);
+
+         MPI_Datatype _site, _block;
+         setCheckpointView(_fh, _site, _block);
+         MPI_File_read_all(_fh, &_buf[0], _numSites, _site, MPI_STATUS_IGNORE);
+         MPI_Type_free(&_block);
+         MPI_Type_free(&_site);
+
+         int _idx = 0;
+         for (int _i = _offset; _i < _myNi[0] - _offset; _i++) {
+            for (int _j = _offset; _j < _myNi[1] - _offset; _j++) {
+               for (int _k = _offset; _k < _myNi[2] - _offset; _k++) {
+                  for (int _l = 0; _l < _numVels; _l++) {
+                     lbfluid->setF_i(_i, _j, _k, _l, _buf[_idx++]);
+                  }
+                  for (int _m = 0; _m < 4; _m++) {
+                     (*lbmom)[_i][_j][_k].setMom_i(_m, _buf[_idx++]);
+                  }
+               }
+            }
+         }
+
+         // coupling forces acting onto the MD particles //
+         MPI_File_set_view(_fh, 0, MPI_BYTE, MPI_BYTE, (char*)"native", MPI_INFO_NULL);
+         if (_header[6] == _totNPart) {
+            std::vector<real> _fTot(3 * (_totNPart + 1));
+            MPI_Offset _pos = LB_CHECKPOINT_HEADER * sizeof(long long)
+               + MPI_Offset(_Ni[0]) * _Ni[1] * _Ni[2] * (_numVels + 4) * sizeof(real);
+            MPI_File_read_at_all(_fh, _pos, &_fTot[0], _fTot.size(),
+                                 mpi::get_mpi_datatype<real>(), MPI_STATUS_IGNORE);
+            for (int _id = 0; _id <= _totNPart; _id++) {
+               setFOnPart(_id, Real3D(_fTot[3*_id], _fTot[3*_id+1], _fTot[3*_id+2]));
+            }
+         } else if (_comm.rank() == 0) {
+            std::cout << "!!! Attention !!! the number of MD particles differs from "
+                      << "the LB checkpoint, the coupling forces are not restored" << std::endl;
+         }
+
+         MPI_File_close(&_fh);
+
+         copyDenMomToHalo();
+         setCheckpointRead(true);
+
+         real timeEnd = timeReadLBConf.getElapsedTime() - timeStart;
+         if (_comm.rank() == 0) {
+            printf("read LB checkpoint %s of step %lld in %f seconds\n",
+                   _filename.c_str(), _header[5], timeEnd);
+         }
+      }
+
 /*******************************************************************************************/
 
       /////////////////////////////
@@ -1241,850 +1468,213 @@ namespace espressopp {
 
 /*******************************************************************************************/
 
-      /* COMMUNICATE POPULATIONS IN HALO REGIONS TO THE NEIGHBOURING CPUs */
-      void LatticeBoltzmann::commHalo() {
-         int i, j, k, idx;             // running indices
-         int const numPopTransf = 5;	// num of popul and hydro moms to be sent
-         int rnode, snode;             // CPU ranks to receive from and to send to
-         std::vector<real> bufToSend, bufToRecv;
-
-         int _offset = getHaloSkin();
-         Int3D _myNi = getMyNi();
-         Int3D _myPos = getMyPos();
-
-         mpi::communicator world;
-
-         //////////////////////
-         //// X-direction /////
-         //////////////////////
-         int numDataTransf = numPopTransf * _myNi[1] * _myNi[2];
-         bufToSend.resize( numDataTransf );
-         bufToRecv.resize( numDataTransf );
-
-         /* send to right, recv from left i = 1, 7, 9, 11, 13 */
-         snode = getMyNeigh(1);
-         rnode = getMyNeigh(0);
-
-         // prepare message for sending
-         i = _myNi[0] - _offset;
-         idx = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(1);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(7);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(9);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(11);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(13);
-            }
-         }
-
-         // send and receive data or use memcpy if number of CPU in x-dir is 1
-         if (getNodeGrid().getItem(0) > 1) {
-            if (_myPos[0] % 2 == 0) {
-               world.send(snode, COMM_DIR_0, bufToSend);
-               world.recv(rnode, COMM_DIR_0, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DIR_0, bufToRecv);
-               world.send(snode, COMM_DIR_0, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         i = _offset;
-         idx = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(1, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(7, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(9, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(11, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(13, bufToRecv[idx+4]);
-            }
-         }
-
-         /* send to left, recv from right i = 2, 8, 10, 12, 14 */
-         snode = getMyNeigh(0);
-         rnode = getMyNeigh(1);
-
-         // prepare message for sending
-         i = 0;
-         idx = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(2);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(8);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(10);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(12);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(14);
-            }
-         }
-
-         // send and receive data or use memcpy if number of CPU in x-dir is 1
-         if (getNodeGrid().getItem(0) > 1) {
-            if (_myPos[0] % 2 == 0) {
-               world.send(snode, COMM_DIR_1, bufToSend);
-               world.recv(rnode, COMM_DIR_1, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DIR_1, bufToRecv);
-               world.send(snode, COMM_DIR_1, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         i = _myNi[0] - 2 * _offset;
-         idx = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(2, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(8, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(10, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(12, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(14, bufToRecv[idx+4]);
-            }
-         }
-
-         //////////////////////
-         //// Y-direction /////
-         //////////////////////
-         numDataTransf = numPopTransf * _myNi[0] * _myNi[2];
-         bufToSend.resize(numDataTransf);				// resize bufToSend
-         bufToRecv.resize(numDataTransf);				// resize bufToRecv
-
-         /* send to right, recv from left i = 3, 7, 10, 15, 17 */
-         snode = getMyNeigh(3);
-         rnode = getMyNeigh(2);
-
-         // prepare message for sending
-         j = _myNi[1] - _offset;
-         idx = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(3);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(7);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(10);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(15);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(17);
-            }
-         }
-
-         // send and receive data or use memcpy if number of CPU in y-dir is 1
-         if (getNodeGrid().getItem(1) > 1) {
-            if (_myPos[1] % 2 == 0) {
-               world.send(snode, COMM_DIR_0, bufToSend);
-               world.recv(rnode, COMM_DIR_0, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DIR_0, bufToRecv);
-               world.send(snode, COMM_DIR_0, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         j = _offset;
-         idx = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(3, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(7, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(10, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(15, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(17, bufToRecv[idx+4]);
-            }
-         }
-
-         /* send to left, recv from right i = 4, 8, 9, 16, 18 */
-         snode = getMyNeigh(2);
-         rnode = getMyNeigh(3);
-
-         // prepare message for sending
-         j = 0;
-         idx = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(4);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(8);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(9);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(16);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(18);
-            }
-         }
-
-         // send and receive data or use memcpy if number of CPU in y-dir is 1
-         if (getNodeGrid().getItem(1) > 1) {
-            if (_myPos[1] % 2 == 0) {
-               world.send(snode, COMM_DIR_1, bufToSend);
-               world.recv(rnode, COMM_DIR_1, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DIR_1, bufToRecv);
-               world.send(snode, COMM_DIR_1, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         j = _myNi[1] - 2 * _offset;
-         idx = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(4, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(8, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(9, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(16, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(18, bufToRecv[idx+4]);
-            }
-         }
-
-         //////////////////////
-         //// Z-direction /////
-         //////////////////////
-         numDataTransf = numPopTransf * _myNi[0] * _myNi[1];
-         bufToSend.resize(numDataTransf);				// resize bufToSend
-         bufToRecv.resize(numDataTransf);				// resize bufToRecv
-
-         /* send to right, recv from left i = 5, 11, 14, 15, 18 */
-         snode = getMyNeigh(5);
-         rnode = getMyNeigh(4);
-
-         // prepare message for sending
-         k = _myNi[2] - _offset;
-         idx = 0;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(5);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(11);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(14);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(15);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(18);
-            }
-         }
-
-         // send and receive data or use memcpy if number of CPU in z-dir is 1
-         if (getNodeGrid().getItem(2) > 1) {
-            if (_myPos[2] % 2 == 0) {
-               world.send(snode, COMM_DIR_0, bufToSend);
-               world.recv(rnode, COMM_DIR_0, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DIR_0, bufToRecv);
-               world.send(snode, COMM_DIR_0, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         k = _offset;
-         idx = 0;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(5, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(11, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(14, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(15, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(18, bufToRecv[idx+4]);
-            }
-         }
-
-         /* send to left, recv from right i = 6, 12, 13, 16, 17 */
-         snode = getMyNeigh(4);
-         rnode = getMyNeigh(5);
-
-         // prepare message for sending
-         k = 0;
-         idx = 0;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(6);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(12);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(13);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(16);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(17);
-            }
-         }
-
-         // send and receive data or use memcpy if number of CPU in z-dir is 1
-         if (getNodeGrid().getItem(2) > 1) {
-            if (_myPos[2] % 2 == 0) {
-               world.send(snode, COMM_DIR_1, bufToSend);
-               world.recv(rnode, COMM_DIR_1, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DIR_1, bufToRecv);
-               world.send(snode, COMM_DIR_1, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         k = _myNi[2] - 2 * _offset;
-         idx = 0;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(6, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(12, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(13, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(16, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(17, bufToRecv[idx+4]);
-            }
-         }
-
-         // release buffers
-         bufToSend.resize(0); bufToRecv.resize(0);
-      }
+      /* D3Q19 POPULATIONS STREAMING OUT OF THE LEFT [0] AND RIGHT [1] FACES IN EVERY DIRECTION */
+      static const int haloPops[3][2][5] = {
+         {{2, 8, 10, 12, 14}, {1, 7,  9, 11, 13}},
+         {{4, 8,  9, 16, 18}, {3, 7, 10, 15, 17}},
+         {{6, 12, 13, 16, 17}, {5, 11, 14, 15, 18}}};
 
 /*******************************************************************************************/
 
-      /* COPY COUPLING FORCES FROM HALO REGIONS TO THE REAL ONES */
-      void LatticeBoltzmann::copyForcesFromHalo () {
-         int i, j, k, idx;             // running indices
-         int const numForceComp = 3;   // number of force components to transfer
-         int rnode, snode;             // CPU ranks to receive from and to send to
-         std::vector<real> bufToSend, bufToRecv;
-
-         Real3D _addForce;
-
-         int _offset = getHaloSkin();
-         Int3D _myNi = getMyNi();
-         Int3D _myPos = getMyPos();
-
-         mpi::communicator world;
-
-         //////////////////////
-         //// X-direction /////
-         //////////////////////
-         int numDataTransf = numForceComp * _myNi[1] * _myNi[2];
-         bufToSend.resize(numDataTransf);				// resize bufToSend
-         bufToRecv.resize(numDataTransf);				// resize bufToRecv
-
-         /* send to right, recv from left */
-         snode = getMyNeigh(1);
-         rnode = getMyNeigh(0);
-
-         // prepare message for sending
-         i = _myNi[0] - _offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++) {
-               idx = numForceComp*_myNi[1]*k + j*numForceComp;
-
-               for ( int _dir = 0; _dir < 3; ++_dir ) {
-                  bufToSend[idx+_dir] = (*lbfor)[i][j][k].getCouplForceLoc().getItem(_dir);
+      /* PACK PLANE _plane NORMAL TO _dim INTO THE BUFFER FOR THE NEIGHBOUR ON SIDE _dir */
+      void LatticeBoltzmann::packHaloPlane (int _what, int _dim, int _dir, int _plane) {
+         Int3D _lo(0);
+         Int3D _hi = getMyNi();
+         _lo[_dim] = _plane;
+         _hi[_dim] = _plane + 1;
+
+         std::vector<real> &_buf = haloSend[_dir];
+         _buf.clear();
+
+         if (_what == HALO_POPS) {
+            // only the populations that stream across the face, population by population
+            for (int p = 0; p < 5; p++) {
+               int l = haloPops[_dim][_dir][p];
+               for (int i = _lo[0]; i < _hi[0]; i++) {
+                  for (int j = _lo[1]; j < _hi[1]; j++) {
+                     for (int k = _lo[2]; k < _hi[2]; k++) {
+                        _buf.push_back(ghostlat->getF_i(i,j,k,l));
+                     }
+                  }
                }
             }
-         }
-
-         // send and receive data or use memcpy if number of CPU in x-dir is 1
-         if (getNodeGrid().getItem(0) > 1) {
-            if (_myPos[0] % 2 == 0) {
-               world.send(snode, COMM_FORCE_0, bufToSend);
-               world.recv(rnode, COMM_FORCE_0, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_FORCE_0, bufToRecv);
-               world.send(snode, COMM_FORCE_0, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         i = _offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++) {
-               idx = numForceComp*_myNi[1]*k + j*numForceComp;
-               _addForce = Real3D(bufToRecv[idx], bufToRecv[idx+1], bufToRecv[idx+2]);
-               (*lbfor)[i][j][k].addCouplForceLoc(_addForce);
-            }
-         }
-
-         /* send to left, recv from right */
-         snode = getMyNeigh(0);
-         rnode = getMyNeigh(1);
-
-         // prepare message for sending
-         i = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++) {
-               idx = numForceComp*_myNi[1]*k + j*numForceComp;
-
-               for ( int _dir = 0; _dir < 3; ++_dir ) {
-                  bufToSend[idx+_dir] = (*lbfor)[i][j][k].getCouplForceLoc().getItem(_dir);
+         } else if (_what == HALO_FORCES) {
+            for (int i = _lo[0]; i < _hi[0]; i++) {
+               for (int j = _lo[1]; j < _hi[1]; j++) {
+                  for (int k = _lo[2]; k < _hi[2]; k++) {
+                     Real3D _f = (*lbfor)[i][j][k].getCouplForceLoc();
+                     _buf.push_back(_f[0]);
+                     _buf.push_back(_f[1]);
+                     _buf.push_back(_f[2]);
+                  }
                }
             }
-         }
-
-         // send and receive data or use memcpy if number of CPU in x-dir is 1
-         if (getNodeGrid().getItem(0) > 1) {
-            if (_myPos[0] % 2 == 0) {
-               world.send(snode, COMM_FORCE_1, bufToSend);
-               world.recv(rnode, COMM_FORCE_1, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_FORCE_1, bufToRecv);
-               world.send(snode, COMM_FORCE_1, bufToSend);
-            }
          } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         i = _myNi[0] - 2 * _offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++) {
-               idx = numForceComp*_myNi[1]*k + j*numForceComp;
-               _addForce = Real3D(bufToRecv[idx], bufToRecv[idx+1], bufToRecv[idx+2]);
-               (*lbfor)[i][j][k].addCouplForceLoc(_addForce);
-            }
-         }
-
-         //////////////////////
-         //// Y-direction /////
-         //////////////////////
-         numDataTransf = numForceComp * _myNi[0] * _myNi[2];
-         bufToSend.resize(numDataTransf);				// resize bufToSend
-         bufToRecv.resize(numDataTransf);				// resize bufToRecv
-
-         /* send to right, recv from left */
-         snode = getMyNeigh(3);
-         rnode = getMyNeigh(2);
-
-         // prepare message for sending
-         j = _myNi[1] - _offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numForceComp*_myNi[0]*k + i*numForceComp;
-
-               for ( int _dir = 0; _dir < 3; ++_dir ) {
-                  bufToSend[idx+_dir] = (*lbfor)[i][j][k].getCouplForceLoc().getItem(_dir);
+            for (int i = _lo[0]; i < _hi[0]; i++) {
+               for (int j = _lo[1]; j < _hi[1]; j++) {
+                  for (int k = _lo[2]; k < _hi[2]; k++) {
+                     for (int l = 0; l < 4; l++) {
+                        _buf.push_back((*lbmom)[i][j][k].getMom_i(l));
+                     }
+                  }
                }
             }
          }
+      }
 
-         // send and receive data or use memcpy if number of CPU in y-dir is 1
-         if (getNodeGrid().getItem(1) > 1) {
-            if (_myPos[1] % 2 == 0) {
-               world.send(snode, COMM_FORCE_0, bufToSend);
-               world.recv(rnode, COMM_FORCE_0, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_FORCE_0, bufToRecv);
-               world.send(snode, COMM_FORCE_0, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         j = _offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numForceComp*_myNi[0]*k + i*numForceComp;
-               _addForce = Real3D(bufToRecv[idx], bufToRecv[idx+1], bufToRecv[idx+2]);
-               (*lbfor)[i][j][k].addCouplForceLoc(_addForce);
-            }
-         }
-
-         /* send to left, recv from right */
-         snode = getMyNeigh(2);
-         rnode = getMyNeigh(3);
-
-         // prepare message for sending
-         j = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numForceComp*_myNi[0]*k + i*numForceComp;
+/*******************************************************************************************/
 
-               for ( int _dir = 0; _dir < 3; ++_dir ) {
-                  bufToSend[idx+_dir] = (*lbfor)[i][j][k].getCouplForceLoc().getItem(_dir);
+      /* UNPACK THE BUFFER FROM THE NEIGHBOUR ON SIDE _dir INTO PLANE _plane NORMAL TO _dim */
+      void LatticeBoltzmann::unpackHaloPlane (int _what, int _dim, int _dir, int _plane) {
+         Int3D _lo(0);
+         Int3D _hi = getMyNi();
+         _lo[_dim] = _plane;
+         _hi[_dim] = _plane + 1;
+
+         std::vector<real> &_buf = haloRecv[_dir];
+         int idx = 0;
+
+         if (_what == HALO_POPS) {
+            // the neighbour on side _dir sent the populations streaming towards us
+            for (int p = 0; p < 5; p++) {
+               int l = haloPops[_dim][1 - _dir][p];
+               for (int i = _lo[0]; i < _hi[0]; i++) {
+                  for (int j = _lo[1]; j < _hi[1]; j++) {
+                     for (int k = _lo[2]; k < _hi[2]; k++) {
+                        ghostlat->setF_i(i,j,k,l, _buf[idx++]);
+                     }
+                  }
                }
             }
-         }
-
-         // send and receive data or use memcpy if number of CPU in y-dir is 1
-         if (getNodeGrid().getItem(1) > 1) {
-            if (_myPos[1] % 2 == 0) {
-               world.send(snode, COMM_FORCE_1, bufToSend);
-               world.recv(rnode, COMM_FORCE_1, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_FORCE_1, bufToRecv);
-               world.send(snode, COMM_FORCE_1, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         j = _myNi[1] - 2 * _offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numForceComp*_myNi[0]*k + i*numForceComp;
-               _addForce = Real3D(bufToRecv[idx], bufToRecv[idx+1], bufToRecv[idx+2]);
-               (*lbfor)[i][j][k].addCouplForceLoc(_addForce);
-            }
-         }
-
-         //////////////////////
-         //// Z-direction /////
-         //////////////////////
-         numDataTransf = numForceComp * _myNi[0] * _myNi[1];
-         bufToSend.resize(numDataTransf);				// resize bufToSend
-         bufToRecv.resize(numDataTransf);				// resize bufToRecv
-
-         /* send to right, recv from left */
-         snode = getMyNeigh(5);
-         rnode = getMyNeigh(4);
-
-         // prepare message for sending
-         k = _myNi[2] - _offset;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numForceComp*_myNi[0]*j + i*numForceComp;
-
-               for ( int _dir = 0; _dir < 3; ++_dir ) {
-                  bufToSend[idx+_dir] = (*lbfor)[i][j][k].getCouplForceLoc().getItem(_dir);
+         } else if (_what == HALO_FORCES) {
+            for (int i = _lo[0]; i < _hi[0]; i++) {
+               for (int j = _lo[1]; j < _hi[1]; j++) {
+                  for (int k = _lo[2]; k < _hi[2]; k++, idx += 3) {
+                     (*lbfor)[i][j][k].addCouplForceLoc(
+                        Real3D(_buf[idx], _buf[idx+1], _buf[idx+2]));
+                  }
                }
             }
-         }
-
-         // send and receive data or use memcpy if number of CPU in z-dir is 1
-         if (getNodeGrid().getItem(2) > 1) {
-            if (_myPos[2] % 2 == 0) {
-               world.send(snode, COMM_FORCE_0, bufToSend);
-               world.recv(rnode, COMM_FORCE_0, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_FORCE_0, bufToRecv);
-               world.send(snode, COMM_FORCE_0, bufToSend);
-            }
          } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         k = _offset;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numForceComp*_myNi[0]*j + i*numForceComp;
-               _addForce = Real3D(bufToRecv[idx], bufToRecv[idx+1], bufToRecv[idx+2]);
-               (*lbfor)[i][j][k].addCouplForceLoc(_addForce);
-            }
-         }
-
-         /* send to left, recv from right */
-         snode = getMyNeigh(4);
-         rnode = getMyNeigh(5);
-
-         // prepare message for sending
-         k = 0;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numForceComp*_myNi[0]*j + i*numForceComp;
-
-               for ( int _dir = 0; _dir < 3; ++_dir ) {
-                  bufToSend[idx+_dir] = (*lbfor)[i][j][k].getCouplForceLoc().getItem(_dir);
+            for (int i = _lo[0]; i < _hi[0]; i++) {
+               for (int j = _lo[1]; j < _hi[1]; j++) {
+                  for (int k = _lo[2]; k < _hi[2]; k++) {
+                     for (int l = 0; l < 4; l++) {
+                        (*lbmom)[i][j][k].setMom_i(l, _buf[idx++]);
+                     }
+                  }
                }
             }
          }
-
-         // send and receive data or use memcpy if number of CPU in z-dir is 1
-         if (getNodeGrid().getItem(2) > 1) {
-            if (_myPos[2] % 2 == 0) {
-               world.send(snode, COMM_FORCE_1, bufToSend);
-               world.recv(rnode, COMM_FORCE_1, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_FORCE_1, bufToRecv);
-               world.send(snode, COMM_FORCE_1, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
-
-         // unpack message
-         k = _myNi[2] - 2 * _offset;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numForceComp*_myNi[0]*j + i*numForceComp;
-               _addForce = Real3D(bufToRecv[idx], bufToRecv[idx+1], bufToRecv[idx+2]);
-               (*lbfor)[i][j][k].addCouplForceLoc(_addForce);
-            }
-         }
-
-         // release buffers
-         bufToSend.resize(0); bufToRecv.resize(0);
       }
 
 /*******************************************************************************************/
 
-      /* COPY DEN AND J FROM A REAL REGION TO HALO NODES */
-      void LatticeBoltzmann::copyDenMomToHalo() {
-         int i, j, k, idx;             // running indices
-         int const numPopTransf = 4;	// num of pops or hydro moms to transfer
-         int rnode, snode;             // CPU ranks to receive from and to send to
-         std::vector<real> bufToSend, bufToRecv;
-
+      /* PACK THE HALO PLANES NORMAL TO _dim AND START SENDING THEM TO BOTH NEIGHBOURS */
+      void LatticeBoltzmann::beginExchangeHalo (int _what, int _dim) {
          int _offset = getHaloSkin();
-         Int3D _myNi = getMyNi();
-         Int3D _myPos = getMyPos();
-
-         mpi::communicator world;
-
-         //////////////////////
-         //// X-direction /////
-         //////////////////////
-         int numDataTransf = numPopTransf * _myNi[1] * _myNi[2];
-         bufToSend.resize(numDataTransf);				// resize bufToSend
-         bufToRecv.resize(numDataTransf);				// resize bufToRecv
-
-         /* send to right, recv from left */
-         snode = getMyNeigh(1);
-         rnode = getMyNeigh(0);
-
-         // prepare message for sending
-         i = _myNi[0] - 2*_offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++) {
-               idx = numPopTransf*_myNi[1]*k + j*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  bufToSend[idx+l] = (*lbmom)[i][j][k].getMom_i(l);
-               }
-            }
-         }
-
-         // send and receive data or use memcpy if number of CPU in x-dir is 1
-         if (getNodeGrid().getItem(0) > 1) {
-            if (_myPos[0] % 2 == 0) {
-               world.send(snode, COMM_DEN_0, bufToSend);
-               world.recv(rnode, COMM_DEN_0, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DEN_0, bufToRecv);
-               world.send(snode, COMM_DEN_0, bufToSend);
-            }
+         int _n = getMyNi().getItem(_dim);
+         int _tagRight, _tagLeft;
+
+         // populations and coupling forces go from the halo to the real sites of the
+         // neighbours, the moments from the real sites to the halo of the neighbours
+         if (_what == HALO_MOMS) {
+            packHaloPlane(_what, _dim, 1, _n - 2 * _offset);
+            packHaloPlane(_what, _dim, 0, _offset);
+            _tagRight = COMM_DEN_0;
+            _tagLeft = COMM_DEN_1;
          } else {
-            bufToRecv = bufToSend;
+            packHaloPlane(_what, _dim, 1, _n - _offset);
+            packHaloPlane(_what, _dim, 0, 0);
+            _tagRight = (_what == HALO_POPS) ? COMM_DIR_0 : COMM_FORCE_0;
+            _tagLeft = (_what == HALO_POPS) ? COMM_DIR_1 : COMM_FORCE_1;
          }
 
-         // unpack message
-         i = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++) {
-               idx = numPopTransf*_myNi[1]*k + j*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  (*lbmom)[i][j][k].setMom_i(l, bufToRecv[idx+l]);
-               }
-            }
-         }
+         for (int r = 0; r < 4; r++) haloReq[r] = MPI_REQUEST_NULL;
 
-         /* send to left, recv from right i = 2, 8, 10, 12, 14 */
-         snode = getMyNeigh(0);
-         rnode = getMyNeigh(1);
-
-         // prepare message for sending
-         i = _offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++) {
-               idx = numPopTransf*_myNi[1]*k + j*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  bufToSend[idx+l] = (*lbmom)[i][j][k].getMom_i(l);
-               }
-            }
+         // use a copy if the number of CPUs in this direction is 1
+         if (getNodeGrid().getItem(_dim) == 1) {
+            haloRecv[0] = haloSend[1];
+            haloRecv[1] = haloSend[0];
+            return;
          }
 
-         // send and receive data or use memcpy if number of CPU in x-dir is 1
-         if (getNodeGrid().getItem(0) > 1) {
-            if (_myPos[0] % 2 == 0) {
-               world.send(snode, COMM_DEN_1, bufToSend);
-               world.recv(rnode, COMM_DEN_1, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DEN_1, bufToRecv);
-               world.send(snode, COMM_DEN_1, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
+         haloRecv[0].resize(haloSend[1].size());
+         haloRecv[1].resize(haloSend[0].size());
 
-         // unpack message
-         i = _myNi[0]-_offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (j=0; j<_myNi[1]; j++) {
-               idx = numPopTransf*_myNi[1]*k + j*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  (*lbmom)[i][j][k].setMom_i(l, bufToRecv[idx+l]);
-               }
-            }
-         }
-
-         //////////////////////
-         //// Y-direction /////
-         //////////////////////
-         numDataTransf = numPopTransf * _myNi[0] * _myNi[2];
-         bufToSend.resize(numDataTransf);				// resize bufToSend
-         bufToRecv.resize(numDataTransf);				// resize bufToRecv
-
-         /* send to right, recv from left */
-         snode = getMyNeigh(3);
-         rnode = getMyNeigh(2);
-
-         // prepare message for sending
-         j = _myNi[1] - 2*_offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numPopTransf*_myNi[0]*k + i*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  bufToSend[idx+l] = (*lbmom)[i][j][k].getMom_i(l);
-               }
-            }
-         }
+         mpi::communicator world;
+         MPI_Datatype _type = mpi::get_mpi_datatype<real>();
+         int _left = getMyNeigh(2 * _dim);
+         int _right = getMyNeigh(2 * _dim + 1);
+
+         MPI_Irecv(&haloRecv[0][0], haloRecv[0].size(), _type, _left, _tagRight,
+                   (MPI_Comm)world, &haloReq[0]);
+         MPI_Irecv(&haloRecv[1][0], haloRecv[1].size(), _type, _right, _tagLeft,
+                   (MPI_Comm)world, &haloReq[1]);
+         MPI_Isend(&haloSend[1][0], haloSend[1].size(), _type, _right, _tagRight,
+                   (MPI_Comm)world, &haloReq[2]);
+         MPI_Isend(&haloSend[0][0], haloSend[0].size(), _type, _left, _tagLeft,
+                   (MPI_Comm)world, &haloReq[3]);
+      }
 
-         // send and receive data or use memcpy if number of CPU in y-dir is 1
-         if (getNodeGrid().getItem(1) > 1) {
-            if (_myPos[1] % 2 == 0) {
-               world.send(snode, COMM_DEN_0, bufToSend);
-               world.recv(rnode, COMM_DEN_0, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DEN_0, bufToRecv);
-               world.send(snode, COMM_DEN_0, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
+/*******************************************************************************************/
 
-         // unpack message
-         j = 0;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numPopTransf*_myNi[0]*k + i*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  (*lbmom)[i][j][k].setMom_i(l, bufToRecv[idx+l]);
-               }
-            }
-         }
+      /* WAIT FOR THE HALO PLANES NORMAL TO _dim AND UNPACK THEM */
+      void LatticeBoltzmann::endExchangeHalo (int _what, int _dim) {
+         int _offset = getHaloSkin();
+         int _n = getMyNi().getItem(_dim);
 
-         /* send to left, recv from right i = 4, 8, 9, 16, 18 */
-         snode = getMyNeigh(2);
-         rnode = getMyNeigh(3);
-
-         // prepare message for sending
-         j = _offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numPopTransf*_myNi[0]*k + i*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  bufToSend[idx+l] = (*lbmom)[i][j][k].getMom_i(l);
-               }
-            }
-         }
+         MPI_Waitall(4, haloReq, MPI_STATUSES_IGNORE);
 
-         // send and receive data or use memcpy if number of CPU in y-dir is 1
-         if (getNodeGrid().getItem(1) > 1) {
-            if (_myPos[1] % 2 == 0) {
-               world.send(snode, COMM_DEN_1, bufToSend);
-               world.recv(rnode, COMM_DEN_1, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DEN_1, bufToRecv);
-               world.send(snode, COMM_DEN_1, bufToSend);
-            }
+         if (_what == HALO_MOMS) {
+            unpackHaloPlane(_what, _dim, 0, 0);
+            unpackHaloPlane(_what, _dim, 1, _n - _offset);
          } else {
-            bufToRecv = bufToSend;
+            unpackHaloPlane(_what, _dim, 0, _offset);
+            unpackHaloPlane(_what, _dim, 1, _n - 2 * _offset);
          }
+      }
 
-         // unpack message
-         j = _myNi[1] - _offset;
-         for (k=0; k<_myNi[2]; k++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numPopTransf*_myNi[0]*k + i*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  (*lbmom)[i][j][k].setMom_i(l, bufToRecv[idx+l]);
-               }
-            }
-         }
+/*******************************************************************************************/
 
-         //////////////////////
-         //// Z-direction /////
-         //////////////////////
-         numDataTransf = numPopTransf * _myNi[0] * _myNi[1];
-         bufToSend.resize(numDataTransf);				// resize bufToSend
-         bufToRecv.resize(numDataTransf);				// resize bufToRecv
-
-         /* send to right, recv from left i = 5, 11, 14, 15, 18 */
-         snode = getMyNeigh(5);
-         rnode = getMyNeigh(4);
-
-         // prepare message for sending
-         k = _myNi[2] - 2 * _offset;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numPopTransf*_myNi[0]*j + i*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  bufToSend[idx+l] = (*lbmom)[i][j][k].getMom_i(l);
-               }
-            }
-         }
+      /* COMMUNICATE POPULATIONS IN HALO REGIONS TO THE NEIGHBOURING CPUs */
+      // the directions are done one after the other, so that the populations
+      // streaming across edges reach the diagonal neighbours
+      void LatticeBoltzmann::commHalo() {
+         beginCommHalo();
+         endCommHalo();
+      }
 
-         // send and receive data or use memcpy if number of CPU in z-dir is 1
-         if (getNodeGrid().getItem(2) > 1) {
-            if (_myPos[2] % 2 == 0) {
-               world.send(snode, COMM_DEN_0, bufToSend);
-               world.recv(rnode, COMM_DEN_0, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DEN_0, bufToRecv);
-               world.send(snode, COMM_DEN_0, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
-         }
+      void LatticeBoltzmann::beginCommHalo() {
+         beginExchangeHalo(HALO_POPS, 0);
+      }
 
-         // unpack message
-         k = 0;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numPopTransf*_myNi[0]*j + i*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  (*lbmom)[i][j][k].setMom_i(l, bufToRecv[idx+l]);
-               }
-            }
+      void LatticeBoltzmann::endCommHalo() {
+         endExchangeHalo(HALO_POPS, 0);
+         for (int _dim = 1; _dim < 3; _dim++) {
+            beginExchangeHalo(HALO_POPS, _dim);
+            endExchangeHalo(HALO_POPS, _dim);
          }
+      }
 
-         /* send to left, recv from right i = 6, 12, 13, 16, 17 */
-         snode = getMyNeigh(4);
-         rnode = getMyNeigh(5);
-
-         // prepare message for sending
-         k = _offset;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numPopTransf*_myNi[0]*j + i*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  bufToSend[idx+l] = (*lbmom)[i][j][k].getMom_i(l);
-               }
-            }
-         }
+/*******************************************************************************************/
 
-         // send and receive data or use memcpy if number of CPU in z-dir is 1
-         if (getNodeGrid().getItem(2) > 1) {
-            if (_myPos[2] % 2 == 0) {
-               world.send(snode, COMM_DEN_1, bufToSend);
-               world.recv(rnode, COMM_DEN_1, bufToRecv);
-            } else {
-               world.recv(rnode, COMM_DEN_1, bufToRecv);
-               world.send(snode, COMM_DEN_1, bufToSend);
-            }
-         } else {
-            bufToRecv = bufToSend;
+      /* COPY COUPLING FORCES FROM HALO REGIONS TO THE REAL ONES */
+      void LatticeBoltzmann::copyForcesFromHalo () {
+         for (int _dim = 0; _dim < 3; _dim++) {
+            beginExchangeHalo(HALO_FORCES, _dim);
+            endExchangeHalo(HALO_FORCES, _dim);
          }
+      }
 
-         // unpack message
-         k = _myNi[2] - _offset;
-         for (j=0; j<_myNi[1]; j++) {
-            for (i=0; i<_myNi[0]; i++) {
-               idx = numPopTransf*_myNi[0]*j + i*numPopTransf;
-               for (int l = 0; l<numPopTransf; ++l) {
-                  (*lbmom)[i][j][k].setMom_i(l, bufToRecv[idx+l]);
-               }
-            }
-         }
+/*******************************************************************************************/
 
-         // release buffers
-         bufToSend.resize(0); bufToRecv.resize(0);
+      /* COPY DEN AND J FROM A REAL REGION TO HALO NODES */
+      void LatticeBoltzmann::copyDenMomToHalo() {
+         for (int _dim = 0; _dim < 3; _dim++) {
+            beginExchangeHalo(HALO_MOMS, _dim);
+            endExchangeHalo(HALO_MOMS, _dim);
+         }
       }
 
 /*******************************************************************************************/
@@ -2123,11 +1713,16 @@ namespace espressopp {
          .add_property("fricCoeff", &LatticeBoltzmann::getFricCoeff, &LatticeBoltzmann::setFricCoeff)
          .add_property("nSteps", &LatticeBoltzmann::getNSteps, &LatticeBoltzmann::setNSteps)
          .add_property("profStep", &LatticeBoltzmann::getProfStep, &LatticeBoltzmann::setProfStep)
+         .add_property("numThreads", &LatticeBoltzmann::getNumThreads, &LatticeBoltzmann::setNumThreads)
+         .add_property("usedThreads", &LatticeBoltzmann::getUsedThreads)
          .add_property("getMyNi", &LatticeBoltzmann::getMyNi)
          .def("getLBMom", &LatticeBoltzmann::getLBMom)
          .def("setLBMom", &LatticeBoltzmann::setLBMom)
+         .def("getPops", &LatticeBoltzmann::getPops)
          .def("saveLBConf", &LatticeBoltzmann::saveLBConf)
          .def("keepLBDump", &LatticeBoltzmann::keepLBDump)
+         .def("saveLBCheckpoint", &LatticeBoltzmann::saveLBCheckpoint)
+         .def("readLBCheckpoint", &LatticeBoltzmann::readLBCheckpoint)
          .def("connect", &LatticeBoltzmann::connect)
          .def("disconnect", &LatticeBoltzmann::disconnect)
          ;
@@ -25,6 +25,7 @@
 #define _INTEGRATOR_LATTICEBOLTZMANN_HPP
 
 #include "logging.hpp"
+#include "mpi.hpp"
 #include "Extension.hpp"
 #include "boost/signals2.hpp"
 #include "esutil/Timer.hpp"
@@ -32,7 +33,7 @@
 #include "Int3D.hpp"
 #include "LatticeSite.hpp"
 
-typedef std::vector< std::vector< std::vector<espressopp::integrator::LBSite> > > lblattice;
+typedef espressopp::integrator::LBLattice lblattice;
 typedef std::vector< std::vector< std::vector<espressopp::integrator::LBMom> > > lbmoments;
 typedef std::vector< std::vector< std::vector<espressopp::integrator::LBForce> > > lbforces;
 
@@ -191,6 +192,10 @@ namespace espressopp {
          void setProfStep (int _profStep);            // set profiling interval
          int getProfStep ();
 
+         void setNumThreads (int _numThreads);        // threads of the collision
+         int getNumThreads ();
+         int getUsedThreads ();                       // threads the collision runs on
+
          // simulation parameters control //
          void setStepNum (int _step);                 // current step number
          int getStepNum ();
@@ -206,6 +211,11 @@ namespace espressopp {
          void readLBConf (int _mode);                 // reads LB configuration from file
          void saveLBConf ();                          // dumps LB configuration
 
+         void saveLBCheckpoint (std::string _filename); // binary checkpoint (MPI-IO)
+         void readLBCheckpoint (std::string _filename); // ... and its restart
+         void setCheckpointRead (bool _read);         // fluid came from a checkpoint
+         bool checkpointRead ();
+
          /* FUNCTIONS DECLARATION */
          void initLatticeSize ();
          void initLatticeModel ();                    // initialize (weights, cis)
@@ -224,15 +234,16 @@ namespace espressopp {
          void calcDenMom ();
          real convMDtoLB (int _opCode);
 
-         void collideStream ();                    // use collide-stream scheme
-
-         void streaming (int _i, int _j, int _k); // streaming along velocities
+         void collideStream ();                    // fused collide-stream (push) kernel
+         void collideStreamPlanes (int _iBegin, int _iEnd); // ... for planes [_iBegin,_iEnd) in x
 
          /* MPI FUNCTIONS */
          void findMyNeighbours ();
          void assignMyLattice ();
          Int3D findGlobIdx ();      // find global index of first lb site of cpu
          void commHalo ();                     // communicate populations in halo
+         void beginCommHalo ();                // pack and start sending the x-halo
+         void endCommHalo ();                  // finish x-halo, then y- and z-halo
          void copyForcesFromHalo ();      // copy coupling forces from halo regions to the real lattice sites
          void copyDenMomToHalo ();         // copy den and j from real lattice sites to halo
          void makeDecompose ();            // decompose storage to put escaped real particles into neighbouring CPU
@@ -269,6 +280,7 @@ namespace espressopp {
          int stepNum;                           // step number
          real copyTimestep;                  // copy of the integrator timestep
          bool restart;
+         bool ckptRead;                         // binary checkpoint read before the run
          shared_ptr< esutil::RNG > rng;  //!< random number generator used for fluctuations
 
          // EXTERNAL FORCES
@@ -296,6 +308,19 @@ namespace espressopp {
          Int3D nodeGrid;                        // 3D-array of processors
          Real3D myLeft;                         // left border of a physical ("real") domain for a CPU
 
+         // HALO EXCHANGE
+         enum { HALO_POPS, HALO_FORCES, HALO_MOMS };  // what is exchanged
+         std::vector<real> haloSend[2];         // packed planes to the left [0] and right [1]
+         std::vector<real> haloRecv[2];         // packed planes from the left [0] and right [1]
+         MPI_Request haloReq[4];                // requests of the exchange in flight
+
+         void setCheckpointView (MPI_File _fh, MPI_Datatype &_site, MPI_Datatype &_block);
+
+         void packHaloPlane (int _what, int _dim, int _dir, int _plane);
+         void unpackHaloPlane (int _what, int _dim, int _dir, int _plane);
+         void beginExchangeHalo (int _what, int _dim);
+         void endExchangeHalo (int _what, int _dim);
+
          // SIGNALS
          boost::signals2::connection _befIntV;
          boost::signals2::connection _recalc2;
@@ -305,6 +330,7 @@ namespace espressopp {
          esutil::WallTimer timeReadLBConf, timeSaveLBConf;
          real time_sw, time_colstr, time_comm;
          int profStep;                           // profiling interval
+         int numThreads;                         // threads of the collision (0: default)
 
          void connect();
          void disconnect();
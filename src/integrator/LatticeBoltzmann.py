@@ -88,6 +88,13 @@ LB/MD simulations. It is implemented as :py:class:`espressopp.integrator.Extensi
         Use 0 to get density :math:`\\rho` and 1-3 for \
         mass flux components :math:`j_x`, :math:`j_y` and :math:`j_z`, correspondingly.
     
+    .. py:method:: getPops(node, i)
+
+        Get population :math:`f_i` of a specific node
+
+        :param Int3D node: node index
+        :param int i: index of the lattice velocity
+
     .. py:method:: setLBMom(node, moment, value)
     
         Set hydrodynamic moment for a specific node
@@ -118,6 +125,35 @@ LB/MD simulations. It is implemented as :py:class:`espressopp.integrator.Extensi
         >>>     lb.keepLBDump()         # flag to keep previously saved LB state
         >>>     lb.saveLBConf()         # saves current state of the LB fluid
 
+    .. py:method:: saveLBCheckpoint(filename)
+
+        Writes the populations and hydrodynamic moments of all real lattice
+        sites and the coupling forces acting onto the MD particles into one
+        binary file shared by all CPUs (MPI-IO). The sites are stored in
+        global order, so the file does not depend on the decomposition.
+
+        :param str filename: name of the checkpoint file
+
+    .. py:method:: readLBCheckpoint(filename)
+
+        Restores the LB fluid from a file written by :py:meth:`saveLBCheckpoint`.
+        The lattice has to have the same size, but the number of CPUs and the
+        nodeGrid may differ. Set the integrator step to the step of the
+        checkpoint before running on.
+
+        :param str filename: name of the checkpoint file
+
+        Example
+
+        >>> lb.saveLBCheckpoint("lb.chk")
+        >>>
+        >>> # ... later, possibly on a different number of CPUs
+        >>> integrator.step = step
+        >>> lb = espressopp.integrator.LatticeBoltzmann(system, nodeGrid)
+        >>> integrator.addExtension(lb)
+        >>> lb.readLBCheckpoint("lb.chk")
+        >>> integrator.run(steps)
+
     **Properties**
 
     .. py:data:: Int3D nodeGrid
@@ -233,6 +269,23 @@ LB/MD simulations. It is implemented as :py:class:`espressopp.integrator.Extensi
     
         >>> # set profiling frequency
         >>> lb.profStep = 5000
+
+    .. py:data:: int numThreads = 0
+
+        Number of OpenMP threads of the collision on every CPU (0 uses the
+        OpenMP default). It only has an effect if |espp| was built with
+        ``WITH_OPENMP``. The fluctuations are drawn from a counter-based RNG
+        per lattice site, so the fluid does not depend on the number of threads.
+
+        Example
+
+        >>> # collide the lattice with 4 threads per CPU
+        >>> lb.numThreads = 4
+
+    .. py:data:: int usedThreads
+
+        Number of threads the collision runs on for the current
+        ``numThreads``, 1 without ``WITH_OPENMP`` (read only)
     
     .. py:data:: Int3D getMyNi
             
@@ -259,7 +312,7 @@ if pmi.isController :
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
                             cls = 'espressopp.integrator.LatticeBoltzmannLocal',
-                            pmiproperty = ['nodeGrid', 'a', 'tau', 'numDims', 'numVels', 'visc_b', 'visc_s', 'gamma_b', 'gamma_s', 'gamma_odd', 'gamma_even', 'lbTemp', 'fricCoeff', 'nSteps', 'profStep', 'getMyNi'],
-                            pmicall = ["getLBMom","setLBMom","saveLBConf","keepLBDump"]
+                            pmiproperty = ['nodeGrid', 'a', 'tau', 'numDims', 'numVels', 'visc_b', 'visc_s', 'gamma_b', 'gamma_s', 'gamma_odd', 'gamma_even', 'lbTemp', 'fricCoeff', 'nSteps', 'profStep', 'numThreads', 'usedThreads', 'getMyNi'],
+                            pmicall = ["getLBMom","setLBMom","getPops","saveLBConf","keepLBDump","saveLBCheckpoint","readLBCheckpoint"]
                             )
 
@@ -35,240 +35,279 @@ namespace espressopp {
   using namespace iterator;
   namespace integrator {
     LBSite::LBSite () {
-            f   = std::vector<real>(LatticePar::getNumVelsLoc(), 0.);
+            for (int i = 0; i < 19; i++) {
+                for (int w = 0; w < blockSize; w++) {
+                    f[i][w] = 0.;
+                    m[i][w] = 0.;
+                }
+            }
     }
 
 /*******************************************************************************************/
 
         /* SET AND GET PART */
-    void LBSite::setF_i (int _i, real _f) { f[_i] = _f;}
-    real LBSite::getF_i (int _i) { return f[_i];}
-
     void LBSite::setPhiLoc (int _i, real _phi) { phiLoc[_i] = _phi;}
     real LBSite::getPhiLoc (int _i) { return phiLoc[_i];}
 
-/*******************************************************************************************/
-
-    /* HELPFUL OPERATIONS WITH POPULATIONS AND MOMENTS */
-    void LBSite::scaleF_i (int _i, real _value) { f[_i] *= _value;}
-
 /*******************************************************************************************/
 
     /* MANAGING STATIC VARIABLES */
     /* create storage for static variables */
     std::vector<real> LBSite::phiLoc(19, 0.);
+    const int LBSite::blockSize;
 
 /*******************************************************************************************/
 
-        void LBSite::collision(bool _fluct, bool _extForce,
-                                                     bool _coupling, Real3D _force, std::vector<real> &_gamma) {
-            real m[19];
-
-            calcLocalMoments(m);
+        void LBSite::collision(int _n, bool _fluct, bool _extForce, bool _coupling,
+                               const Real3D *_force, std::vector<real> &_gamma,
+                               const esutil::Philox &_rng, const uint32_t *_siteId, uint32_t _step) {
+            calcLocalMoments(_n);
 
-            relaxMoments(m, _extForce, _force, _gamma);
+            relaxMoments(_n, _extForce, _force, _gamma);
 
-            if (_fluct) thermalFluct(m);
+            if (_fluct) thermalFluct(_n, _rng, _siteId, _step);
 
             // coupling counts as an external force as well
-         if (_extForce) applyForces(m, _force, _gamma);
+         if (_extForce) applyForces(_n, _force, _gamma);
 
-            btranMomToPop(m);
+            btranMomToPop(_n);
         }
 
 /*******************************************************************************************/
 
         /* CALCULATION OF THE LOCAL MOMENTS */
-        void LBSite::calcLocalMoments (real *m) {
-            real f0,
-            f1p2, f1m2, f3p4, f3m4, f5p6, f5m6, f7p8, f7m8, f9p10, f9m10,
-            f11p12, f11m12, f13p14, f13m14, f15p16, f15m16, f17p18, f17m18;
-
-            /* shorthand functions for "simplified" notation */
-            f0     =  getF_i(0);
-            f1p2   =  getF_i(1) +  getF_i(2);    f1m2 =  getF_i(1) -  getF_i(2);
-            f3p4   =  getF_i(3) +  getF_i(4);    f3m4 =  getF_i(3) -  getF_i(4);
-            f5p6   =  getF_i(5) +  getF_i(6);    f5m6 =  getF_i(5) -  getF_i(6);
-            f7p8   =  getF_i(7) +  getF_i(8);    f7m8 =  getF_i(7) -  getF_i(8);
-            f9p10  =  getF_i(9) + getF_i(10);   f9m10 =  getF_i(9) - getF_i(10);
-            f11p12 = getF_i(11) + getF_i(12);  f11m12 = getF_i(11) - getF_i(12);
-            f13p14 = getF_i(13) + getF_i(14);  f13m14 = getF_i(13) - getF_i(14);
-            f15p16 = getF_i(15) + getF_i(16);  f15m16 = getF_i(15) - getF_i(16);
-            f17p18 = getF_i(17) + getF_i(18);  f17m18 = getF_i(17) - getF_i(18);
-
-            /* mass mode */
-            m[0] = f0 + f1p2 + f3p4 + f5p6 + f7p8 + f9p10 + f11p12 + f13p14 + f15p16 + f17p18;
-
-            /* momentum modes */
-            m[1] = f1m2 +   f7m8 +  f9m10 + f11m12 + f13m14;
-            m[2] = f3m4 +   f7m8 -  f9m10 + f15m16 + f17m18;
-            m[3] = f5m6 + f11m12 - f13m14 + f15m16 - f17m18;
-
-            /* stress modes */
-            m[4] = -f0 +   f7p8 + f9p10 + f11p12 + f13p14 + f15p16 + f17p18;
-            m[5] = 2.*f1p2 -   f3p4 -  f5p6 +   f7p8 +  f9p10 + f11p12 + f13p14 - 2.* (f15p16 + f17p18);
-            m[6] = f3p4 -   f5p6 +  f7p8 +  f9p10 - f11p12 - f13p14;
-            m[7] = f7p8 -  f9p10;
-            m[8] = f11p12 - f13p14;
-            m[9] = f15p16 - f17p18;
-
-            /* kinetic (ghost) modes */
-            m[10] = -2.* f1m2 +   f7m8 +  f9m10 + f11m12 + f13m14;
-            m[11] = -2.* f3m4 +   f7m8 -  f9m10 + f15m16 + f17m18;
-            m[12] = -2.* f5m6 + f11m12 - f13m14 + f15m16 - f17m18;
-            m[13] = f7m8 +  f9m10 - f11m12 - f13m14;
-            m[14] = -f7m8 +  f9m10 + f15m16 + f17m18;
-            m[15] = f11m12 - f13m14 - f15m16 + f17m18;
-            m[16] = f0 - 2.* (f1p2 + f3p4 + f5p6) +   f7p8 +  f9p10
-            + f11p12 + f13p14 + f15p16 + f17p18;
-            m[17] = -2.* f1p2 +   f3p4 +   f5p6 +   f7p8 +  f9p10 + f11p12
-            + f13p14 -    2.* (f15p16 + f17p18);
-            m[18] = -f3p4 +   f5p6 +   f7p8 +  f9p10 - f11p12 - f13p14;
+        void LBSite::calcLocalMoments (int _n) {
+            #pragma omp simd
+            for (int w = 0; w < _n; w++) {
+                real f0,
+                f1p2, f1m2, f3p4, f3m4, f5p6, f5m6, f7p8, f7m8, f9p10, f9m10,
+                f11p12, f11m12, f13p14, f13m14, f15p16, f15m16, f17p18, f17m18;
+
+                /* shorthand functions for "simplified" notation */
+                f0     =  f[0][w];
+                f1p2   =  f[1][w] +  f[2][w];    f1m2 =  f[1][w] -  f[2][w];
+                f3p4   =  f[3][w] +  f[4][w];    f3m4 =  f[3][w] -  f[4][w];
+                f5p6   =  f[5][w] +  f[6][w];    f5m6 =  f[5][w] -  f[6][w];
+                f7p8   =  f[7][w] +  f[8][w];    f7m8 =  f[7][w] -  f[8][w];
+                f9p10  =  f[9][w] + f[10][w];   f9m10 =  f[9][w] - f[10][w];
+                f11p12 = f[11][w] + f[12][w];  f11m12 = f[11][w] - f[12][w];
+                f13p14 = f[13][w] + f[14][w];  f13m14 = f[13][w] - f[14][w];
+                f15p16 = f[15][w] + f[16][w];  f15m16 = f[15][w] - f[16][w];
+                f17p18 = f[17][w] + f[18][w];  f17m18 = f[17][w] - f[18][w];
+
+                /* mass mode */
+                m[0][w] = f0 + f1p2 + f3p4 + f5p6 + f7p8 + f9p10 + f11p12 + f13p14 + f15p16 + f17p18;
+
+                /* momentum modes */
+                m[1][w] = f1m2 +   f7m8 +  f9m10 + f11m12 + f13m14;
+                m[2][w] = f3m4 +   f7m8 -  f9m10 + f15m16 + f17m18;
+                m[3][w] = f5m6 + f11m12 - f13m14 + f15m16 - f17m18;
+
+                /* stress modes */
+                m[4][w] = -f0 +   f7p8 + f9p10 + f11p12 + f13p14 + f15p16 + f17p18;
+                m[5][w] = 2.*f1p2 -   f3p4 -  f5p6 +   f7p8 +  f9p10 + f11p12 + f13p14 - 2.* (f15p16 + f17p18);
+                m[6][w] = f3p4 -   f5p6 +  f7p8 +  f9p10 - f11p12 - f13p14;
+                m[7][w] = f7p8 -  f9p10;
+                m[8][w] = f11p12 - f13p14;
+                m[9][w] = f15p16 - f17p18;
+
+                /* kinetic (ghost) modes */
+                m[10][w] = -2.* f1m2 +   f7m8 +  f9m10 + f11m12 + f13m14;
+                m[11][w] = -2.* f3m4 +   f7m8 -  f9m10 + f15m16 + f17m18;
+                m[12][w] = -2.* f5m6 + f11m12 - f13m14 + f15m16 - f17m18;
+                m[13][w] = f7m8 +  f9m10 - f11m12 - f13m14;
+                m[14][w] = -f7m8 +  f9m10 + f15m16 + f17m18;
+                m[15][w] = f11m12 - f13m14 - f15m16 + f17m18;
+                m[16][w] = f0 - 2.* (f1p2 + f3p4 + f5p6) +   f7p8 +  f9p10
+                + f11p12 + f13p14 + f15p16 + f17p18;
+                m[17][w] = -2.* f1p2 +   f3p4 +   f5p6 +   f7p8 +  f9p10 + f11p12
+                + f13p14 -    2.* (f15p16 + f17p18);
+                m[18][w] = -f3p4 +   f5p6 +   f7p8 +  f9p10 - f11p12 - f13p14;
+            }
         }
 
 /*******************************************************************************************/
 
         /* RELAXATION OF THE MOMENTS TO THEIR EQUILIBRIUM VALUES */
-        void LBSite::relaxMoments (real *m, bool _extForce, Real3D _f, std::vector<real> &_gamma) {
-            // moments on the site //
-            real _invTauLoc = 1. / LatticePar::getTauLoc();
-            Real3D jLoc(m[1], m[2], m[3]);
-            jLoc *= LatticePar::getALoc();
-            jLoc *= _invTauLoc;
-
-            // if we have external forces then modify the eq.fluxes //
-            if (_extForce) jLoc += 0.5 * _f; // when doing coupling, the flag is set to 1!
-
-            real _invRhoLoc = 1. / m[0];
-            real pi_eq[6];
-
-            pi_eq[0] =  jLoc.sqr()*_invRhoLoc;
-            pi_eq[1] =  (jLoc[0]*jLoc[0] - jLoc[1]*jLoc[1])*_invRhoLoc;
-            pi_eq[2] =  (3.*jLoc[0]*jLoc[0] - jLoc.sqr())*_invRhoLoc;
-            pi_eq[3] =  jLoc[0]*jLoc[1]*_invRhoLoc;
-            pi_eq[4] =  jLoc[0]*jLoc[2]*_invRhoLoc;
-            pi_eq[5] =  jLoc[1]*jLoc[2]*_invRhoLoc;
-
-            /* relax bulk mode */
-            m[4] = pi_eq[0] + _gamma[0] * (m[4] - pi_eq[0]);
-
-            /* relax shear modes */
-            m[5] = pi_eq[1] + _gamma[1] * (m[5] - pi_eq[1]);
-            m[6] = pi_eq[2] + _gamma[1] * (m[6] - pi_eq[2]);
-            m[7] = pi_eq[3] + _gamma[1] * (m[7] - pi_eq[3]);
-            m[8] = pi_eq[4] + _gamma[1] * (m[8] - pi_eq[4]);
-            m[9] = pi_eq[5] + _gamma[1] * (m[9] - pi_eq[5]);
-
-            /* relax odd modes */
-            m[10] *= _gamma[2]; m[11] *= _gamma[2]; 	m[12] *= _gamma[2];
-            m[13] *= _gamma[2]; m[14] *= _gamma[2]; 	m[15] *= _gamma[2];
-
-            /* relax even modes */
-            m[16] *= _gamma[3]; m[17] *= _gamma[3]; m[18] *= _gamma[3];
+        void LBSite::relaxMoments (int _n, bool _extForce, const Real3D *_f, std::vector<real> &_gamma) {
+            real _jScale = LatticePar::getALoc() / LatticePar::getTauLoc();
+            real _gb = _gamma[0], _gs = _gamma[1], _go = _gamma[2], _ge = _gamma[3];
+
+            for (int w = 0; w < _n; w++) {
+                // moments on the site //
+                real jx = m[1][w] * _jScale;
+                real jy = m[2][w] * _jScale;
+                real jz = m[3][w] * _jScale;
+
+                // if we have external forces then modify the eq.fluxes //
+                if (_extForce) {  // when doing coupling, the flag is set to 1!
+                    jx += 0.5 * _f[w][0];
+                    jy += 0.5 * _f[w][1];
+                    jz += 0.5 * _f[w][2];
+                }
+
+                real _invRhoLoc = 1. / m[0][w];
+                real _jSqr = jx*jx + jy*jy + jz*jz;
+                real pi_eq[6];
+
+                pi_eq[0] =  _jSqr*_invRhoLoc;
+                pi_eq[1] =  (jx*jx - jy*jy)*_invRhoLoc;
+                pi_eq[2] =  (3.*jx*jx - _jSqr)*_invRhoLoc;
+                pi_eq[3] =  jx*jy*_invRhoLoc;
+                pi_eq[4] =  jx*jz*_invRhoLoc;
+                pi_eq[5] =  jy*jz*_invRhoLoc;
+
+                /* relax bulk mode */
+                m[4][w] = pi_eq[0] + _gb * (m[4][w] - pi_eq[0]);
+
+                /* relax shear modes */
+                m[5][w] = pi_eq[1] + _gs * (m[5][w] - pi_eq[1]);
+                m[6][w] = pi_eq[2] + _gs * (m[6][w] - pi_eq[2]);
+                m[7][w] = pi_eq[3] + _gs * (m[7][w] - pi_eq[3]);
+                m[8][w] = pi_eq[4] + _gs * (m[8][w] - pi_eq[4]);
+                m[9][w] = pi_eq[5] + _gs * (m[9][w] - pi_eq[5]);
+
+                /* relax odd modes */
+                m[10][w] *= _go; m[11][w] *= _go; m[12][w] *= _go;
+                m[13][w] *= _go; m[14][w] *= _go; m[15][w] *= _go;
+
+                /* relax even modes */
+                m[16][w] *= _ge; m[17][w] *= _ge; m[18][w] *= _ge;
+            }
         }
 
 /*******************************************************************************************/
 
         /* ADDING THERMAL FLUCTUATIONS */
-        void LBSite::thermalFluct (real *m) {
+        void LBSite::thermalFluct (int _n, const esutil::Philox &_rng,
+                                   const uint32_t *_siteId, uint32_t _step) {
             /* values of PhiLoc were already set in LatticeBoltzmann.cpp */
             int _numVelsLoc = LatticePar::getNumVelsLoc();
-            real rootRhoLoc = sqrt(12.*m[0]); // factor 12. comes from usage of
-            // not gaussian but uniformly distributed random numbers
-
-//			real rootRhoLoc = sqrt(m[0]); // Gaussian version
 
-            for (int l = 4; l < _numVelsLoc; l++) {
-                m[l] += rootRhoLoc*getPhiLoc(l)*((*LatticePar::rng)() - 0.5);
-//				m[l] += rootRhoLoc*getPhiLoc(l)*((LatticePar::rng)->normal()); //Gaussian
+            for (int w = 0; w < _n; w++) {
+                real rootRhoLoc = sqrt(12.*m[0][w]); // factor 12. comes from usage of
+                // not gaussian but uniformly distributed random numbers
+
+                // the random numbers of a site only depend on its global index and
+                // on the time step, not on the decomposition or the number of threads
+                uint32_t ctr[4] = {_siteId[w], _step, 0, 0};
+                uint32_t rnd[4];
+                for (int l = 4; l < _numVelsLoc; l++) {
+                    int _r = (l - 4) % 4;
+                    if (_r == 0) {
+                        _rng(ctr, rnd);
+                        ++ctr[2];
+                    }
+                    m[l][w] += rootRhoLoc*getPhiLoc(l)*(esutil::Philox::toUniform(rnd[_r]) - 0.5);
+                }
             }
         }
 
 /*******************************************************************************************/
 
-        void LBSite::applyForces (real *m, Real3D _f, std::vector<real> &_gamma) {
-            // set velocity _u
-            Real3D _u = 0.5 * _f;
-            _u[0] += m[1]; 	_u[1] += m[2]; _u[2] += m[3];
-            _u /= m[0];
-
-            /* update momentum modes */
-            m[1] += _f[0];
-            m[2] += _f[1];
-            m[3] += _f[2];
-
-            /* update stress modes */
+        void LBSite::applyForces (int _n, const Real3D *_force, std::vector<real> &_gamma) {
             // See def. of _sigma (Eq.198) in B.Dünweg & A.J.C.Ladd in Adv.Poly.Sci. 221, 89-166 (2009)
-            real _sigma[6];
             real _gamma_sp = _gamma[1] + 1.;
             real _gamma_sph = 0.5 * _gamma_sp;
-
-            real _scalp = _u*_f;
-            real _secTerm = (1./3.)*(_gamma[0] - _gamma[1])*_scalp;
-
-            _sigma[0] = _gamma_sp*_u[0]*_f[0] + _secTerm;
-            _sigma[1] = _gamma_sp*_u[1]*_f[1] + _secTerm;
-            _sigma[2] = _gamma_sp*_u[2]*_f[2] + _secTerm;
-            _sigma[3] = _gamma_sph*(_u[0]*_f[1]+_u[1]*_f[0]);
-            _sigma[4] = _gamma_sph*(_u[0]*_f[2]+_u[2]*_f[0]);
-            _sigma[5] = _gamma_sph*(_u[1]*_f[2]+_u[2]*_f[1]);
-
-            m[4] += _sigma[0]+_sigma[1]+_sigma[2];
-            m[5] += 2.*_sigma[0]-_sigma[1]-_sigma[2];
-            m[6] += _sigma[1]-_sigma[2];
-            m[7] += _sigma[3];
-            m[8] += _sigma[4];
-            m[9] += _sigma[5];
+            real _thirdGbs = (1./3.)*(_gamma[0] - _gamma[1]);
+
+            for (int w = 0; w < _n; w++) {
+                Real3D _f = _force[w];
+
+                // set velocity _u
+                Real3D _u = 0.5 * _f;
+                _u[0] += m[1][w]; 	_u[1] += m[2][w]; _u[2] += m[3][w];
+                _u /= m[0][w];
+
+                /* update momentum modes */
+                m[1][w] += _f[0];
+                m[2][w] += _f[1];
+                m[3][w] += _f[2];
+
+                /* update stress modes */
+                real _sigma[6];
+
+                real _scalp = _u*_f;
+                real _secTerm = _thirdGbs*_scalp;
+
+                _sigma[0] = _gamma_sp*_u[0]*_f[0] + _secTerm;
+                _sigma[1] = _gamma_sp*_u[1]*_f[1] + _secTerm;
+                _sigma[2] = _gamma_sp*_u[2]*_f[2] + _secTerm;
+                _sigma[3] = _gamma_sph*(_u[0]*_f[1]+_u[1]*_f[0]);
+                _sigma[4] = _gamma_sph*(_u[0]*_f[2]+_u[2]*_f[0]);
+                _sigma[5] = _gamma_sph*(_u[1]*_f[2]+_u[2]*_f[1]);
+
+                m[4][w] += _sigma[0]+_sigma[1]+_sigma[2];
+                m[5][w] += 2.*_sigma[0]-_sigma[1]-_sigma[2];
+                m[6][w] += _sigma[1]-_sigma[2];
+                m[7][w] += _sigma[3];
+                m[8][w] += _sigma[4];
+                m[9][w] += _sigma[5];
+            }
         }
 
 /*******************************************************************************************/
 
-        void LBSite::btranMomToPop (real *m) {
+        void LBSite::btranMomToPop (int _n) {
             int _numVelsLoc = LatticePar::getNumVelsLoc();
+            real _invB[19], _eqW[19];
+            for (int i = 0; i < _numVelsLoc; i++) {
+                _invB[i] = LatticePar::getInvBLoc(i);
+                _eqW[i] = LatticePar::getEqWeightLoc(i);
+            }
 
             // scale modes with inversed coefficients
             for (int i = 0; i < _numVelsLoc; i++) {
-                m[i] *= LatticePar::getInvBLoc(i);
+                #pragma omp simd
+                for (int w = 0; w < _n; w++) {
+                    m[i][w] *= _invB[i];
+                }
             }
 
-            setF_i(0,m[0] -m[4] +m[16]);
-            setF_i(1,m[0] +m[1] + 2.* (m[5] -m[10] -m[16] -m[17]));
-            setF_i(2,m[0] -m[1] + 2.* (m[5] +m[10] -m[16] -m[17]));
-            setF_i(3,m[0] +m[2] -m[5] +m[6] - 2.* (m[11] +m[16]) +m[17] -m[18]);
-            setF_i(4,m[0] -m[2] -m[5] +m[6] + 2.* (m[11] -m[16]) +m[17] -m[18]);
-            setF_i(5,m[0] +m[3] -m[5] -m[6] - 2.* (m[12] +m[16]) +m[17] +m[18]);
-            setF_i(6,m[0] -m[3] -m[5] -m[6] + 2.* (m[12] -m[16]) +m[17] +m[18]);
-
-            setF_i(7,m[0] +m[1] +m[2] +m[4] +m[5] +m[6] +m[7] +m[10] +m[11]
-                         +m[13] -m[14] +m[16] +m[17] +m[18]);
-            setF_i(8,m[0] -m[1] -m[2] +m[4] +m[5] +m[6] +m[7] -m[10] -m[11]
-                         -m[13] +m[14] +m[16] +m[17] +m[18]);
-            setF_i(9,m[0] +m[1] -m[2] +m[4] +m[5] +m[6] -m[7] +m[10] -m[11]
-                         +m[13] +m[14] +m[16] +m[17] +m[18]);
-            setF_i(10,m[0] -m[1] +m[2] +m[4] +m[5] +m[6] -m[7] -m[10] +m[11]
-                         -m[13] -m[14] +m[16] +m[17] +m[18]);
-
-            setF_i(11,m[0] +m[1] +m[3] +m[4] +m[5] -m[6] +m[8] +m[10] +m[12]
-                         -m[13] +m[15] +m[16] +m[17] -m[18]);
-            setF_i(12,m[0] -m[1] -m[3] +m[4] +m[5] -m[6] +m[8] -m[10] -m[12]
-                         +m[13] -m[15] +m[16] +m[17] -m[18]);
-            setF_i(13,m[0] +m[1] -m[3] +m[4] +m[5] -m[6] -m[8] +m[10] -m[12]
-                         -m[13] -m[15] +m[16] +m[17] -m[18]);
-            setF_i(14,m[0] -m[1] +m[3] +m[4] +m[5] -m[6] -m[8] -m[10] +m[12]
-                         +m[13] +m[15] +m[16] +m[17] -m[18]);
-
-            setF_i(15,m[0] +m[2] +m[3] +m[4] - 2.*m[5] +m[9] +m[11] +m[12]
-                         +m[14] -m[15] +m[16] - 2.*m[17]);
-            setF_i(16,m[0] -m[2] -m[3] +m[4] - 2.*m[5] +m[9] -m[11] -m[12]
-                         -m[14] +m[15] +m[16] - 2.*m[17]);
-            setF_i(17,m[0] +m[2] -m[3] +m[4] - 2.*m[5] -m[9] +m[11] -m[12]
-                         +m[14] +m[15] +m[16] - 2.*m[17]);
-            setF_i(18,m[0] -m[2] +m[3] +m[4] - 2.*m[5] -m[9] -m[11] +m[12]
-                         -m[14] -m[15] +m[16] - 2.*m[17]);
+            #pragma omp simd
+            for (int w = 0; w < _n; w++) {
+                f[0][w] = m[0][w] -m[4][w] +m[16][w];
+                f[1][w] = m[0][w] +m[1][w] + 2.* (m[5][w] -m[10][w] -m[16][w] -m[17][w]);
+                f[2][w] = m[0][w] -m[1][w] + 2.* (m[5][w] +m[10][w] -m[16][w] -m[17][w]);
+                f[3][w] = m[0][w] +m[2][w] -m[5][w] +m[6][w] - 2.* (m[11][w] +m[16][w]) +m[17][w] -m[18][w];
+                f[4][w] = m[0][w] -m[2][w] -m[5][w] +m[6][w] + 2.* (m[11][w] -m[16][w]) +m[17][w] -m[18][w];
+                f[5][w] = m[0][w] +m[3][w] -m[5][w] -m[6][w] - 2.* (m[12][w] +m[16][w]) +m[17][w] +m[18][w];
+                f[6][w] = m[0][w] -m[3][w] -m[5][w] -m[6][w] + 2.* (m[12][w] -m[16][w]) +m[17][w] +m[18][w];
+
+                f[7][w] = m[0][w] +m[1][w] +m[2][w] +m[4][w] +m[5][w] +m[6][w] +m[7][w] +m[10][w] +m[11][w]
+                        +m[13][w] -m[14][w] +m[16][w] +m[17][w] +m[18][w];
+                f[8][w] = m[0][w] -m[1][w] -m[2][w] +m[4][w] +m[5][w] +m[6][w] +m[7][w] -m[10][w] -m[11][w]
+                        -m[13][w] +m[14][w] +m[16][w] +m[17][w] +m[18][w];
+                f[9][w] = m[0][w] +m[1][w] -m[2][w] +m[4][w] +m[5][w] +m[6][w] -m[7][w] +m[10][w] -m[11][w]
+                        +m[13][w] +m[14][w] +m[16][w] +m[17][w] +m[18][w];
+                f[10][w] = m[0][w] -m[1][w] +m[2][w] +m[4][w] +m[5][w] +m[6][w] -m[7][w] -m[10][w] +m[11][w]
+                        -m[13][w] -m[14][w] +m[16][w] +m[17][w] +m[18][w];
+
+                f[11][w] = m[0][w] +m[1][w] +m[3][w] +m[4][w] +m[5][w] -m[6][w] +m[8][w] +m[10][w] +m[12][w]
+                        -m[13][w] +m[15][w] +m[16][w] +m[17][w] -m[18][w];
+                f[12][w] = m[0][w] -m[1][w] -m[3][w] +m[4][w] +m[5][w] -m[6][w] +m[8][w] -m[10][w] -m[12][w]
+                        +m[13][w] -m[15][w] +m[16][w] +m[17][w] -m[18][w];
+                f[13][w] = m[0][w] +m[1][w] -m[3][w] +m[4][w] +m[5][w] -m[6][w] -m[8][w] +m[10][w] -m[12][w]
+                        -m[13][w] -m[15][w] +m[16][w] +m[17][w] -m[18][w];
+                f[14][w] = m[0][w] -m[1][w] +m[3][w] +m[4][w] +m[5][w] -m[6][w] -m[8][w] -m[10][w] +m[12][w]
+                        +m[13][w] +m[15][w] +m[16][w] +m[17][w] -m[18][w];
+
+                f[15][w] = m[0][w] +m[2][w] +m[3][w] +m[4][w] - 2.*m[5][w] +m[9][w] +m[11][w] +m[12][w]
+                        +m[14][w] -m[15][w] +m[16][w] - 2.*m[17][w];
+                f[16][w] = m[0][w] -m[2][w] -m[3][w] +m[4][w] - 2.*m[5][w] +m[9][w] -m[11][w] -m[12][w]
+                        -m[14][w] +m[15][w] +m[16][w] - 2.*m[17][w];
+                f[17][w] = m[0][w] +m[2][w] -m[3][w] +m[4][w] - 2.*m[5][w] -m[9][w] +m[11][w] -m[12][w]
+                        +m[14][w] +m[15][w] +m[16][w] - 2.*m[17][w];
+                f[18][w] = m[0][w] -m[2][w] +m[3][w] +m[4][w] - 2.*m[5][w] -m[9][w] -m[11][w] +m[12][w]
+                        -m[14][w] -m[15][w] +m[16][w] - 2.*m[17][w];
+            }
 
             /* scale populations with weights */
             for (int i = 0; i < _numVelsLoc; i++) {
-                scaleF_i (i, LatticePar::getEqWeightLoc(i));
+                #pragma omp simd
+                for (int w = 0; w < _n; w++) {
+                    f[i][w] *= _eqW[i];
+                }
             }
         }
 
@@ -277,6 +316,31 @@ namespace espressopp {
     LBSite::~LBSite() {
     }
 
+/*******************************************************************************************/
+
+    LBLattice::LBLattice (Int3D _size, int _numVels) {
+      size = _size;
+      numSites = size[0] * size[1] * size[2];
+      numVels = _numVels;
+      f = std::vector<real>(numVels * numSites, 0.);
+
+      // D3Q19 velocities in lattice units, in the order of LatticeBoltzmann::initLatticeModel()
+      static const int c[19][3] = {
+        { 0, 0, 0},
+        { 1, 0, 0}, {-1, 0, 0}, { 0, 1, 0}, { 0,-1, 0}, { 0, 0, 1}, { 0, 0,-1},
+        { 1, 1, 0}, {-1,-1, 0}, { 1,-1, 0}, {-1, 1, 0},
+        { 1, 0, 1}, {-1, 0,-1}, { 1, 0,-1}, {-1, 0, 1},
+        { 0, 1, 1}, { 0,-1,-1}, { 0, 1,-1}, { 0,-1, 1}};
+
+      neighbour = std::vector<int>(numVels, 0);
+      for (int l = 0; l < numVels && l < 19; l++) {
+        neighbour[l] = (c[l][0] * size[1] + c[l][1]) * size[2] + c[l][2];
+      }
+    }
+
+    LBLattice::~LBLattice() {
+    }
+
 /*******************************************************************************************/
 
     LBMom::LBMom () {
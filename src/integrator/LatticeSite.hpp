@@ -25,6 +25,8 @@
 #define _INTEGRATOR_LATTICEMODEL_HPP
 
 #include "Real3D.hpp"
+#include "Int3D.hpp"
+#include "esutil/Philox.hpp"
 
 namespace espressopp {
    namespace integrator {
@@ -32,52 +34,96 @@ namespace espressopp {
          /**
           * \brief Description of the properties of the LBSite class
           *
-          * This is a LBSite class for storing of the populations, ext and coupling forces on the lattice site. Through its methods this class handles everything that happens on the node during collision. It also sets the values to the D3Q19 model-related parameters on EVERY lattice site.
+          * This is a LBSite class for storing of the populations of a block of up to blockSize consecutive lattice sites along z. Through its methods this class handles everything that happens on the nodes during collision. The moment transforms run over all sites of the block at once, so that the compiler can vectorize them.
           *
-          * The normal lattice and its ghost counterpart are based on this LBSite class. They are defined in LatticeBoltzmann.*pp files.
+          * The populations themselves are stored in the LBLattice class below; an LBSite is a
+          * scratch copy of a block of sites that is loaded, collided and pushed back to the lattice.
           *
           * Please note that by default ESPResSo++ supports only D3Q19 lattice model.
           * However, you can code other lattice models, it should not be difficult.
           */
       public:
+         static const int blockSize = 8;								// number of sites in a block
+
          LBSite ();
          ~LBSite ();
 
          /* SET AND GET DECLARATION */
-         void setF_i (int _i, real _f);									// set f_i population to _f
-         real getF_i (int _i);												// get f_i population
-
-         void setPhiLoc (int _i, real _phi);							// set phi value to _phi
-         real getPhiLoc (int _i);											// get phi value
+         void setF_i (int _i, int _w, real _f) { f[_i][_w] = _f;}	// set f_i population of site _w
+         real getF_i (int _i, int _w) { return f[_i][_w];}			// get f_i population of site _w
 
-         /* HELPFUL OPERATIONS WITH POPULATIONS AND MOMENTS */
-         void scaleF_i (int _i, real _value);                  // scale population i by _value
+         static void setPhiLoc (int _i, real _phi);				// set phi value to _phi
+         static real getPhiLoc (int _i);									// get phi value
 
          /* FUNCTIONS DECLARATION */
-         void collision (bool _fluct, bool _extForce,
-                         bool _coupling, Real3D _f,
-                         std::vector<real> &_gamma);		  // perform collision step
+         void collision (int _n, bool _fluct, bool _extForce,
+                         bool _coupling, const Real3D *_f,
+                         std::vector<real> &_gamma,
+                         const esutil::Philox &_rng,
+                         const uint32_t *_siteId, uint32_t _step);	// perform collision step
 
-         void calcLocalMoments (real *m);								// calculate local moments
+         void calcLocalMoments (int _n);									// calculate local moments
 
-         void relaxMoments (real *m, bool _extForce,
-                            Real3D _f,
+         void relaxMoments (int _n, bool _extForce,
+                            const Real3D *_f,
                             std::vector<real> &_gamma);		// relax local moms to eq moms
 
-         void thermalFluct (real *m);										// apply thermal fluctuations
+         void thermalFluct (int _n, const esutil::Philox &_rng,
+                            const uint32_t *_siteId,
+                            uint32_t _step);								// apply thermal fluctuations
 
-         void applyForces (real *m, Real3D _f,
+         void applyForces (int _n, const Real3D *_f,
                            std::vector<real> &_gamma);		// apply ext and coupl forces
 
-         void btranMomToPop (real *m);										// back-transform moms to pops
+         void btranMomToPop (int _n);										// back-transform moms to pops
 
       private:
-         std::vector<real> f;														// populations on a site
+         real f[19][blockSize];													// populations of the sites
+         real m[19][blockSize];													// moments of the sites
          static std::vector<real> phiLoc;								// local fluct amplitudes
       };
 
       /*******************************************************************************************/
 
+      class LBLattice {
+         /**
+          * \brief Description of the properties of the LBLattice class
+          *
+          * This is a LBLattice class for storing of the populations of all lattice sites
+          * (including the halo) in one contiguous structure-of-arrays block: population _l
+          * of site _site lives at f[_l * numSites + _site], and the sites are numbered with
+          * the z-index running fastest. The normal lattice and its ghost counterpart are
+          * both LBLattices, see LatticeBoltzmann.*pp files.
+          */
+      public:
+         LBLattice (Int3D _size, int _numVels);
+         ~LBLattice ();
+
+         Int3D getSize () { return size;}
+         int getNumSites () { return numSites;}
+
+         int getSite (int _i, int _j, int _k) {					// linear index of a site
+            return (_i * size[1] + _j) * size[2] + _k;}
+         int getNeighbour (int _l) { return neighbour[_l];}	// site offset along c_l
+
+         void setF_i (int _site, int _l, real _f) { f[_l * numSites + _site] = _f;}
+         real getF_i (int _site, int _l) { return f[_l * numSites + _site];}
+
+         void setF_i (int _i, int _j, int _k, int _l, real _f) {
+            setF_i(getSite(_i, _j, _k), _l, _f);}
+         real getF_i (int _i, int _j, int _k, int _l) {
+            return getF_i(getSite(_i, _j, _k), _l);}
+
+      private:
+         Int3D size;																// number of sites in 3D
+         int numSites;															// total number of sites
+         int numVels;															// number of populations per site
+         std::vector<int> neighbour;									// site offsets of the D3Q19 vels
+         std::vector<real> f;													// populations, one block per vel
+      };
+
+      /*******************************************************************************************/
+
       class LBMom {
          /**
           * \brief Description of the properties of the LBMom class
@@ -0,0 +1,227 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <boost/mpi/collectives.hpp>
+#include "LoadBalancer.hpp"
+#include "VelocityVerlet.hpp"
+#include "System.hpp"
+#include "storage/DomainDecomposition.hpp"
+
+namespace espressopp {
+  namespace integrator {
+
+    using namespace espressopp::storage;
+
+    LOG4ESPP_LOGGER(LoadBalancer::theLogger, "LoadBalancer");
+
+    LoadBalancer::LoadBalancer(shared_ptr< System > system, int _interval, real _threshold, real _damping)
+      : Extension(system), threshold(_threshold), counter(0), lastComputeTime(0.0),
+        imbalance(0.0), numBalances(0) {
+      LOG4ESPP_INFO(theLogger, "construct LoadBalancer");
+      setInterval(_interval);
+      setDamping(_damping);
+      // throws if the storage is not a domain decomposition
+      getDomainDecomposition();
+    }
+
+    LoadBalancer::~LoadBalancer() {
+      disconnect();
+    }
+
+    void LoadBalancer::setInterval(int _interval) {
+      if (_interval <= 0) {
+        throw std::invalid_argument("LoadBalancer: interval has to be positive");
+      }
+      interval = _interval;
+    }
+
+    void LoadBalancer::setDamping(real _damping) {
+      if (_damping <= 0.0 || _damping > 1.0) {
+        throw std::invalid_argument("LoadBalancer: damping has to be in (0, 1]");
+      }
+      damping = _damping;
+    }
+
+    DomainDecomposition& LoadBalancer::getDomainDecomposition() {
+      DomainDecomposition* dd = dynamic_cast< DomainDecomposition* >(getSystem()->storage.get());
+      if (!dd) {
+        throw std::invalid_argument("LoadBalancer needs a DomainDecomposition storage");
+      }
+      return *dd;
+    }
+
+    void LoadBalancer::disconnect() {
+      _runInit.disconnect();
+      _aftIntP.disconnect();
+    }
+
+    void LoadBalancer::connect() {
+      // the integrator resets its timers at the start of each run
+      _runInit = integrator->runInit.connect(boost::bind(&LoadBalancer::resetTimer, this));
+      // after the positions are updated the particles get resorted anyway
+      _aftIntP = integrator->aftIntP.connect(boost::bind(&LoadBalancer::perform_action, this));
+      counter = 0;
+    }
+
+    void LoadBalancer::resetTimer() {
+      lastComputeTime = 0.0;
+    }
+
+    void LoadBalancer::perform_action() {
+      if (++counter % interval == 0) {
+        balance();
+      }
+    }
+
+    real LoadBalancer::measureLoad() {
+      shared_ptr< VelocityVerlet > vv = boost::dynamic_pointer_cast< VelocityVerlet >(integrator);
+      if (vv) {
+        real computeTime = vv->getComputeTime();
+        real load = computeTime - lastComputeTime;
+        lastComputeTime = computeTime;
+        return load;
+      }
+
+      // all CPUs use the same integrator, so they all count particles
+      return getSystem()->storage->getNRealParticles();
+    }
+
+    bool LoadBalancer::balance() {
+      System& system = getSystemRef();
+      DomainDecomposition& dd = getDomainDecomposition();
+      const NodeGrid& nodeGrid = dd.getNodeGrid();
+
+      std::vector< real > loads;
+      boost::mpi::all_gather(*system.comm, measureLoad(), loads);
+
+      real total = 0.0, maxLoad = 0.0;
+      for (size_t r = 0; r < loads.size(); ++r) {
+        total += loads[r];
+        maxLoad = std::max(maxLoad, loads[r]);
+      }
+      if (total <= 0.0) return false;
+      imbalance = maxLoad * loads.size() / total - 1.0;
+
+      LOG4ESPP_INFO(theLogger, "load imbalance " << imbalance);
+      if (imbalance <= threshold) return false;
+
+      real minWidth = system.maxCutoff + system.getSkin();
+      std::vector< real > bounds[3];
+      for (int axis = 0; axis < 3; ++axis) {
+        bounds[axis] = nodeGrid.getDomainBounds(axis);
+        if (nodeGrid.getGridSize(axis) == 1) continue;
+
+        std::vector< real > slabLoads(nodeGrid.getGridSize(axis), 0.0);
+        for (size_t r = 0; r < loads.size(); ++r) {
+          Int3D pos;
+          nodeGrid.mapIndexToPosition(pos, r);
+          slabLoads[pos[axis]] += loads[r];
+        }
+        bounds[axis] = balanceAxis(bounds[axis], slabLoads, minWidth);
+      }
+
+      dd.setDomainBounds(bounds);
+      ++numBalances;
+      return true;
+    }
+
+    std::vector< real > LoadBalancer::balanceAxis(const std::vector< real >& bounds,
+                                                  const std::vector< real >& slabLoads,
+                                                  real minWidth) const {
+      size_t n = slabLoads.size();
+      real total = 0.0;
+      for (size_t k = 0; k < n; ++k) total += slabLoads[k];
+
+      std::vector< real > newBounds(bounds);
+      if (total <= 0.0) return newBounds;
+
+      // invert the piecewise linear cumulative load at j/n of the total
+      size_t k = 0;
+      real below = 0.0; // load of the slabs left of slab k
+      for (size_t j = 1; j < n; ++j) {
+        real target = total * j / n;
+        while (k < n - 1 && below + slabLoads[k] < target) {
+          below += slabLoads[k];
+          ++k;
+        }
+        real fraction = slabLoads[k] > 0.0 ? (target - below) / slabLoads[k] : 0.5;
+        fraction = std::min(std::max(fraction, real(0.0)), real(1.0));
+        real balanced = bounds[k] + fraction * (bounds[k + 1] - bounds[k]);
+        newBounds[j] = bounds[j] + damping * (balanced - bounds[j]);
+      }
+
+      // keep every domain at least minWidth wide
+      for (size_t j = 1; j < n; ++j) {
+        newBounds[j] = std::max(newBounds[j], newBounds[j - 1] + minWidth);
+      }
+      for (size_t j = n - 1; j > 0; --j) {
+        newBounds[j] = std::min(newBounds[j], newBounds[j + 1] - minWidth);
+      }
+      return newBounds;
+    }
+
+    /****************************************************
+    ** REGISTRATION WITH PYTHON
+    ****************************************************/
+    namespace {
+      std::vector< real > toVector(python::object seq) {
+        std::vector< real > v(python::len(seq));
+        for (size_t j = 0; j < v.size(); ++j) {
+          v[j] = python::extract< real >(seq[j]);
+        }
+        return v;
+      }
+
+      python::list pyBalanceAxis(LoadBalancer& lb, python::object bounds,
+                                 python::object slabLoads, real minWidth) {
+        std::vector< real > b = toVector(bounds), l = toVector(slabLoads);
+        if (b.size() != l.size() + 1) {
+          throw std::invalid_argument("LoadBalancer: need one more boundary than slabs");
+        }
+        std::vector< real > newBounds = lb.balanceAxis(b, l, minWidth);
+        python::list result;
+        for (size_t j = 0; j < newBounds.size(); ++j) {
+          result.append(newBounds[j]);
+        }
+        return result;
+      }
+    }
+
+    void LoadBalancer::registerPython() {
+      using namespace espressopp::python;
+      class_< LoadBalancer, shared_ptr< LoadBalancer >, bases< Extension > >
+        ("integrator_LoadBalancer", init< shared_ptr< System >, int, real, real >())
+        .def("connect", &LoadBalancer::connect)
+        .def("disconnect", &LoadBalancer::disconnect)
+        .def("balance", &LoadBalancer::balance)
+        .def("balanceAxis", &pyBalanceAxis)
+        .add_property("interval", &LoadBalancer::getInterval, &LoadBalancer::setInterval)
+        .add_property("threshold", &LoadBalancer::getThreshold, &LoadBalancer::setThreshold)
+        .add_property("damping", &LoadBalancer::getDamping, &LoadBalancer::setDamping)
+        .add_property("imbalance", &LoadBalancer::getImbalance)
+        .add_property("numBalances", &LoadBalancer::getNumBalances)
+        ;
+    }
+  }
+}
@@ -0,0 +1,109 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _INTEGRATOR_LOADBALANCER_HPP
+#define _INTEGRATOR_LOADBALANCER_HPP
+
+#include <vector>
+#include "types.hpp"
+#include "logging.hpp"
+#include "Extension.hpp"
+#include "boost/signals2.hpp"
+
+namespace espressopp {
+  namespace storage {
+    class DomainDecomposition;
+  }
+
+  namespace integrator {
+
+    /** Dynamic load balancing for the domain decomposition.
+
+        Every interval steps, each CPU measures its load, i.e. the time
+        spent on forces and integration since the last balancing (with
+        VelocityVerlet, otherwise its number of particles). If the most
+        loaded CPU exceeds the average by more than threshold, the domain
+        boundaries are moved along each axis with more than one node:
+        the load of a slab of domains is assumed to be spread evenly over
+        its width, and the boundaries are moved towards the positions
+        that split the total load evenly, by the fraction damping of the
+        distance. No domain gets narrower than cutoff+skin.
+
+        The domains stay a rectilinear grid, so the neighbors of each
+        node do not change; the particles are sent to their new nodes by
+        the storage (DomainDecomposition::setDomainBounds).
+    */
+    class LoadBalancer : public Extension {
+      public:
+        LoadBalancer(shared_ptr< System > system, int _interval, real _threshold, real _damping);
+        virtual ~LoadBalancer();
+
+        /** measure the load and move the domain boundaries if needed,
+            collective. \return whether the boundaries were moved */
+        bool balance();
+
+        int getInterval() const { return interval; }
+        void setInterval(int _interval);
+        real getThreshold() const { return threshold; }
+        void setThreshold(real _threshold) { threshold = _threshold; }
+        real getDamping() const { return damping; }
+        void setDamping(real _damping);
+
+        /// max/mean - 1 of the loads measured at the last balancing
+        real getImbalance() const { return imbalance; }
+        /// number of times the boundaries were moved
+        int getNumBalances() const { return numBalances; }
+
+        /** new boundaries of one axis for the given loads of its slabs,
+            moved by damping and kept at least minWidth apart */
+        std::vector< real > balanceAxis(const std::vector< real >& bounds,
+                                        const std::vector< real >& slabLoads,
+                                        real minWidth) const;
+
+        /** Register this class so it can be used from Python. */
+        static void registerPython();
+
+      private:
+        boost::signals2::connection _runInit, _aftIntP;
+        void connect();
+        void disconnect();
+
+        void resetTimer();
+        void perform_action();
+        real measureLoad();
+
+        storage::DomainDecomposition& getDomainDecomposition();
+
+        int interval;
+        real threshold;
+        real damping;
+        int counter;
+        real lastComputeTime;
+        real imbalance;
+        int numBalances;
+
+        /** Logger */
+        static LOG4ESPP_DECL_LOGGER(theLogger);
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,121 @@
+#  Copyright (C) 2017
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+r"""
+**********************************
+espressopp.integrator.LoadBalancer
+**********************************
+
+Dynamic load balancing for :class:`espressopp.storage.DomainDecomposition`.
+
+Every `interval` steps each CPU measures its load: the time spent on force
+computation and integration since the last balancing (with
+:class:`espressopp.integrator.VelocityVerlet`, otherwise its number of
+particles). If the most loaded CPU is more than `threshold` above the
+average, the domain boundaries are moved towards the positions that split
+the load evenly along each axis with more than one CPU, and the particles
+are sent to their new CPUs. Inhomogeneous systems (droplets, interfaces,
+brushes) thus give the dense regions to more CPUs.
+
+The domains stay a rectilinear grid: along each axis all CPUs of a slab
+share their boundaries, so the load can only be balanced between slabs.
+Put the dense direction on an axis with several CPUs, e.g. with
+``nodeGrid=(8, 1, 1)`` for a slab along x. No domain gets narrower than
+cutoff+skin. The lattice Boltzmann integrator assumes equal domains and
+cannot be combined with this extension.
+
+  **Properties**
+
+* `interval`
+  Number of steps between two balancings. Default: 100
+
+* `threshold`
+  Relative imbalance (max/mean - 1) above which the boundaries are moved.
+  Default: 0.1
+
+* `damping`
+  Fraction of the computed shift that is applied at once, between 0 and 1.
+  Smaller values avoid oscillations when the timings are noisy.
+  Default: 0.5
+
+* `imbalance`
+  Relative imbalance measured at the last balancing. Read only.
+
+* `numBalances`
+  Number of times the boundaries were moved. Read only.
+
+Example:
+
+>>> balancer = espressopp.integrator.LoadBalancer(system, interval=500)
+>>> integrator.addExtension(balancer)
+>>> integrator.run(100000)
+>>> print system.storage.getDomainBounds(0)
+
+.. function:: espressopp.integrator.LoadBalancer(system, interval=100, threshold=0.1, damping=0.5)
+
+		:param system:
+		:param int interval:
+		:param real threshold:
+		:param real damping:
+
+.. function:: espressopp.integrator.LoadBalancer.balance()
+
+		Measures the load and moves the boundaries right away if needed.
+
+		:rtype: bool
+
+.. function:: espressopp.integrator.LoadBalancer.balanceAxis(bounds, slabLoads, minWidth)
+
+		Returns the boundaries of one axis that balancing would set for
+		the given loads of its slabs, with the current `damping`. Does not
+		change the domains.
+
+		:param bounds: the n+1 current boundaries of the axis
+		:param slabLoads: the n loads of the slabs between them
+		:param real minWidth: the minimal width of a domain
+		:rtype: list
+"""
+
+from espressopp.esutil import cxxinit
+from espressopp import pmi
+from espressopp.integrator.Extension import *
+from _espressopp import integrator_LoadBalancer
+
+class LoadBalancerLocal(ExtensionLocal, integrator_LoadBalancer):
+
+    def __init__(self, system, interval=100, threshold=0.1, damping=0.5):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            cxxinit(self, integrator_LoadBalancer, system, interval, threshold, damping)
+
+    def balance(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.balance(self)
+
+    def balanceAxis(self, bounds, slabLoads, minWidth):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.balanceAxis(self, bounds, slabLoads, minWidth)
+
+if pmi.isController :
+    class LoadBalancer(Extension):
+        __metaclass__ = pmi.Proxy
+        pmiproxydefs = dict(
+            cls =  'espressopp.integrator.LoadBalancerLocal',
+            pmicall = [ 'balance', 'balanceAxis' ],
+            pmiproperty = [ 'interval', 'threshold', 'damping', 'imbalance', 'numBalances' ]
+            )
@@ -92,6 +92,7 @@ namespace espressopp {
         boost::signals2::signal<void ()> aftCalcF; // after calcForces()
         boost::signals2::signal<void ()> befIntV; // before integrate2()
         boost::signals2::signal<void ()> aftIntV; // after  integrate2()
+        boost::signals2::signal<void ()> runEnd; // end of run()
 
 
         /** Register this class so it can be used from Python. */
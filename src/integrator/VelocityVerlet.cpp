@@ -53,17 +53,43 @@ namespace espressopp {
       LOG4ESPP_INFO(theLogger, "construct VelocityVerlet");
       resortFlag = true;
       maxDist    = 0.0;
+      extDist    = 0.0;
+      numResorts  = 0;
+      numRebuilds = 0;
+      overlapComm = false;
+
+      // the neighbor lists are rebuilt on both signals
+      if (system->storage) {
+        sigParticlesChanged = system->storage->onParticlesChanged.connect(
+            boost::bind(&VelocityVerlet::saveReferencePositions, this));
+        sigParticlesMoved = system->storage->onParticlesMoved.connect(
+            boost::bind(&VelocityVerlet::saveReferencePositions, this));
+      }
     }
 
     VelocityVerlet::~VelocityVerlet()
     {
       LOG4ESPP_INFO(theLogger, "free VelocityVerlet");
+      sigParticlesChanged.disconnect();
+      sigParticlesMoved.disconnect();
+    }
+
+    void VelocityVerlet::saveReferencePositions()
+    {
+      System& system = getSystemRef();
+      CellList realCells = system.storage->getRealCells();
+
+      refPositions.clear();
+      for(CellListIterator cit(realCells); !cit.isDone(); ++cit) {
+        refPositions.push_back(cit->position());
+      }
+      maxDist = 0.0;
+      extDist = 0.0;
     }
 
     void VelocityVerlet::run(int nsteps)
     {
       VT_TRACER("run");
-      int nResorts = 0;
       real time;
       timeIntegrate.reset();
       resetTimers();
@@ -82,6 +108,7 @@ namespace espressopp {
         storage.decompose();
         maxDist = 0.0;
         resortFlag = false;
+        numResorts++;
         // timeResort += timeIntegrate.getElapsedTime();
       }
 
@@ -114,7 +141,7 @@ namespace espressopp {
 
         time = timeIntegrate.getElapsedTime();
         LOG4ESPP_INFO(theLogger, "updating positions and velocities")
-        maxDist += integrate1();
+        maxDist = integrate1();
         timeInt1 += timeIntegrate.getElapsedTime() - time;
 
         /*
@@ -134,11 +161,15 @@ namespace espressopp {
         if (resortFlag) {
             VT_TRACER("resort1");
             time = timeIntegrate.getElapsedTime();
-            LOG4ESPP_INFO(theLogger, "step " << i << ": resort particles");
-            storage.decompose();
+            LOG4ESPP_INFO(theLogger, "step " << i << ": rebuild neighbor lists");
+            // particles are only redistributed if one of them left its cell
+            if (storage.rebuildNeighborLists()) {
+              numResorts++;
+            } else {
+              numRebuilds++;
+            }
             maxDist  = 0.0;
             resortFlag = false;
-            nResorts ++;
             timeResort += timeIntegrate.getElapsedTime() - time;
         }
 
@@ -156,6 +187,9 @@ namespace espressopp {
         aftIntV();
       }
 
+      // signal
+      runEnd();
+
       timeRun = timeIntegrate.getElapsedTime();
       timeLost = timeRun - (timeForceComp[0] + timeForceComp[1] + timeForceComp[2] +
                  timeComm1 + timeComm2 + timeInt1 + timeInt2 + timeResort);
@@ -241,6 +275,8 @@ namespace espressopp {
       // loop over all particles of the local cells
       int count = 0;
       real maxSqDist = 0.0; // maximal square distance a particle moves
+      real maxSqDisp = 0.0; // maximal square distance from the reference position
+      const int nRef = refPositions.size();
       for(CellListIterator cit(realCells); !cit.isDone(); ++cit) {
         real sqDist = 0.0;
         LOG4ESPP_INFO(theLogger, "updating first half step of velocities and full step of positions")
@@ -268,22 +304,35 @@ namespace espressopp {
         cit->position() += deltaP;
         sqDist += deltaP * deltaP;
 
+        if (count < nRef) {
+          Real3D disp = cit->position() - refPositions[count];
+          maxSqDisp = std::max(maxSqDisp, disp.sqr());
+        }
+
         count++;
 
         maxSqDist = std::max(maxSqDist, sqDist);
       }
-      
-      // signal
-      inIntP(maxSqDist);
 
-      real maxAllSqDist;
-      mpi::all_reduce(*system.comm, maxSqDist, maxAllSqDist, boost::mpi::maximum<real>());
+      // the particles do not match the reference, e.g. they were modified
+      // without a decompose, so force a rebuild
+      if (count != nRef) maxSqDisp = infinity;
+
+      // signal, extensions add the maximal square distance of their own moves
+      real extSqDist = 0.0;
+      inIntP(extSqDist);
+
+      real maxSq[2] = { maxSqDisp, extSqDist };
+      real maxAllSq[2];
+      mpi::all_reduce(*system.comm, maxSq, 2, maxAllSq, boost::mpi::maximum<real>());
+      extDist += sqrt(maxAllSq[1]);
 
       LOG4ESPP_INFO(theLogger, "moved " << count << " particles in integrate1" <<
 		    ", max move local = " << sqrt(maxSqDist) <<
-		    ", global = " << sqrt(maxAllSqDist));
-      
-      return sqrt(maxAllSqDist);
+		    ", max displacement global = " << sqrt(maxAllSq[0]) <<
+		    ", moves by extensions = " << extDist);
+
+      return sqrt(maxAllSq[0]) + extDist;
     }
 
     void VelocityVerlet::integrate2()
@@ -328,6 +377,11 @@ namespace espressopp {
 
     void VelocityVerlet::updateForces()
     {
+      if (overlapComm) {
+        updateForcesOverlapped();
+        return;
+      }
+
       LOG4ESPP_INFO(theLogger, "update ghosts, calculate forces and collect ghost forces")
       real time;
       storage::Storage& storage = *getSystemRef().storage;
@@ -351,6 +405,65 @@ namespace espressopp {
       aftCalcF();
     }
 
+    void VelocityVerlet::updateForcesOverlapped()
+    {
+      LOG4ESPP_INFO(theLogger, "calculate forces overlapped with the ghost communication")
+      real time;
+      System& sys = getSystemRef();
+      storage::Storage& storage = *sys.storage;
+      const InteractionList& srIL = sys.shortRangeInteractions;
+
+      time = timeIntegrate.getElapsedTime();
+      storage.updateGhostsBegin();
+      timeComm1 += timeIntegrate.getElapsedTime() - time;
+
+      // real particles only, the ghost positions are still in flight
+      time = timeIntegrate.getElapsedTime();
+      initForces();
+
+      // signal
+      aftInitF();
+
+      for (size_t i = 0; i < srIL.size(); i++) {
+        real t = timeIntegrate.getElapsedTime();
+        srIL[i]->addForcesReals(0);
+        timeForceComp[i] += timeIntegrate.getElapsedTime() - t;
+      }
+      timeForce += timeIntegrate.getElapsedTime() - time;
+
+      time = timeIntegrate.getElapsedTime();
+      storage.updateGhostsEnd();
+      timeComm1 += timeIntegrate.getElapsedTime() - time;
+
+      time = timeIntegrate.getElapsedTime();
+      for (size_t i = 0; i < srIL.size(); i++) {
+        real t = timeIntegrate.getElapsedTime();
+        srIL[i]->addForcesGhosts();
+        timeForceComp[i] += timeIntegrate.getElapsedTime() - t;
+      }
+      timeForce += timeIntegrate.getElapsedTime() - time;
+
+      time = timeIntegrate.getElapsedTime();
+      storage.collectGhostForcesBegin();
+      timeComm2 += timeIntegrate.getElapsedTime() - time;
+
+      // the other half of the real pairs, while the ghost forces are in flight
+      time = timeIntegrate.getElapsedTime();
+      for (size_t i = 0; i < srIL.size(); i++) {
+        real t = timeIntegrate.getElapsedTime();
+        srIL[i]->addForcesReals(1);
+        timeForceComp[i] += timeIntegrate.getElapsedTime() - t;
+      }
+      timeForce += timeIntegrate.getElapsedTime() - time;
+
+      time = timeIntegrate.getElapsedTime();
+      storage.collectGhostForcesEnd();
+      timeComm2 += timeIntegrate.getElapsedTime() - time;
+
+      // signal
+      aftCalcF();
+    }
+
     void VelocityVerlet::initForces()
     {
       // forces are initialized for real + ghost particles
@@ -419,6 +532,10 @@ namespace espressopp {
         ("integrator_VelocityVerlet", init< shared_ptr<System> >())
         .def("getTimers", &wrapGetTimers)
         .def("resetTimers", &VelocityVerlet::resetTimers)
+        .def("getNumResorts", &VelocityVerlet::getNumResorts)
+        .def("getNumRebuilds", &VelocityVerlet::getNumRebuilds)
+        .add_property("overlapCommunication", &VelocityVerlet::getOverlapCommunication,
+                      &VelocityVerlet::setOverlapCommunication)
         ;
     }
   }
@@ -27,6 +27,7 @@
 #define _INTEGRATOR_VELOCITYVERLET_HPP
 
 #include "types.hpp"
+#include "Real3D.hpp"
 #include "MDIntegrator.hpp"
 #include "esutil/Timer.hpp"
 #include <boost/signals2.hpp>
@@ -50,6 +51,23 @@ namespace espressopp {
 
         void resetTimers();
 
+        /** Time spent on force computation and integration since the
+            start of the current run, without the ghost and particle
+            communication; a measure of the local load. */
+        real getComputeTime() const { return timeForce + timeInt1 + timeInt2; }
+
+        /** Number of full redistributions of the particles (decompose) */
+        int getNumResorts() const { return numResorts; }
+
+        /** Number of neighbor list rebuilds without redistribution */
+        int getNumRebuilds() const { return numRebuilds; }
+
+        /** If true, the short range forces between real particles are
+            computed while the ghost positions and ghost forces are
+            communicated, see Storage::updateGhostsBegin(). */
+        void setOverlapCommunication(bool _overlapComm) { overlapComm = _overlapComm; }
+        bool getOverlapCommunication() const { return overlapComm; }
+
         /** Register this class so it can be used from Python. */
         static void registerPython();
 
@@ -59,8 +77,25 @@ namespace espressopp {
 
         real maxCut;
 
+        /** positions of the real particles, in cell order, when the
+            neighbor lists were built last */
+        std::vector< Real3D > refPositions;
+        /** accumulated moves reported by extensions since then */
+        real extDist;
+
+        int numResorts;
+        int numRebuilds;
+
+        bool overlapComm;
+
+        boost::signals2::connection sigParticlesChanged, sigParticlesMoved;
+
+        /** store the current positions as reference for the displacements */
+        void saveReferencePositions();
+
         /** Method updates particle positions and velocities.
-            \return maximal square distance a particle has moved.
+            \return maximal distance a particle has moved since the
+            neighbor lists were built.
         */
         real integrate1();
 
@@ -72,6 +107,10 @@ namespace espressopp {
 
         void calcForces();
 
+        /** updateForces() with the real-real short range forces
+            computed during the ghost communication */
+        void updateForcesOverlapped();
+
         void printPositions(bool withGhost);
 
         void printForces(bool withGhost);
@@ -29,6 +29,35 @@ espressopp.integrator.VelocityVerlet
 
 		:param system: 
 		:type system: 
+
+.. function:: espressopp.integrator.VelocityVerlet.getNumResorts()
+
+		Number of times the particles were redistributed over the
+		cells and CPUs (decompose) by this integrator.
+
+		:rtype: int
+
+.. function:: espressopp.integrator.VelocityVerlet.getNumRebuilds()
+
+		Number of times the neighbor lists were rebuilt without a
+		redistribution. The lists are rebuilt when a particle moved
+		more than half the skin since the last build; the particles
+		are only redistributed if one of them has left its cell.
+
+		:rtype: int
+
+.. attribute:: espressopp.integrator.VelocityVerlet.overlapCommunication
+
+		If True, the short range forces between pairs of real particles
+		are computed while the ghost positions are received and while
+		the ghost forces are sent back. Only interactions that can split
+		their work (Verlet list pair interactions) profit from this; it
+		needs the flatGhostComm buffers of the DomainDecomposition to
+		actually overlap. Extensions connected to the force initialization
+		run, as without overlap, before any pair force; the ghost positions
+		are not updated yet at that point. Default: False.
+
+		:type: bool
 """
 from espressopp.esutil import cxxinit
 from espressopp import pmi
@@ -47,6 +76,7 @@ if pmi.isController :
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
           cls =  'espressopp.integrator.VelocityVerletLocal',
-          pmicall = ['resetTimers'],
+          pmiproperty = ['overlapCommunication'],
+          pmicall = ['resetTimers', 'getNumResorts', 'getNumRebuilds'],
           pmiinvoke = ['getTimers']
         )
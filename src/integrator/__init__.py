@@ -54,6 +54,7 @@ from espressopp.integrator.LBInitPopWave import *
 from espressopp.integrator.ExtForce import *
 from espressopp.integrator.CapForce import *
 from espressopp.integrator.ExtAnalyze import *
+from espressopp.integrator.LoadBalancer import *
 from espressopp.integrator.Settle import *
 from espressopp.integrator.Rattle import *
 from espressopp.integrator.VelocityVerletOnRadius import *
@@ -54,6 +54,7 @@
 #include "ExtForce.hpp"
 #include "CapForce.hpp"
 #include "ExtAnalyze.hpp"
+#include "LoadBalancer.hpp"
 #include "Settle.hpp"
 #include "Rattle.hpp"
 #include "VelocityVerletOnRadius.hpp"
@@ -96,6 +97,7 @@ namespace espressopp {
       ExtForce::registerPython();
       CapForce::registerPython();
       ExtAnalyze::registerPython();
+      LoadBalancer::registerPython();
       Settle::registerPython();
       Rattle::registerPython();
       VelocityVerletOnRadius::registerPython();
@@ -91,7 +91,7 @@ namespace espressopp {
     addForces() {
       LOG4ESPP_INFO(theLogger, "add forces computed for all pairs in the cell lists");
 
-      for (iterator::CellListAllPairsIterator it(storage->getRealCells()); it.isValid(); ++it) {
+      for (iterator::CellListAllPairsIterator it(storage->getRealCells(), storage->getGhostCells()); it.isValid(); ++it) {
         Particle &p1 = *it->first;
         Particle &p2 = *it->second;
         const Potential &potential = getPotential(p1.type(), p2.type());
@@ -110,7 +110,7 @@ namespace espressopp {
       LOG4ESPP_INFO(theLogger, "compute energy by the Verlet List");
 
       real e = 0.0;
-      for (iterator::CellListAllPairsIterator it(storage->getRealCells()); it.isValid(); ++it) {
+      for (iterator::CellListAllPairsIterator it(storage->getRealCells(), storage->getGhostCells()); it.isValid(); ++it) {
         const Particle &p1 = *it->first;
         const Particle &p2 = *it->second;
         const Potential &potential = getPotential(p1.type(), p2.type());
@@ -157,7 +157,7 @@ namespace espressopp {
       LOG4ESPP_INFO(theLogger, "computed virial for all pairs in the cell lists");
      
       real w = 0.0;
-      for (iterator::CellListAllPairsIterator it(storage->getRealCells());
+      for (iterator::CellListAllPairsIterator it(storage->getRealCells(), storage->getGhostCells());
            it.isValid(); ++it) {
         Particle &p1 = *it->first;
         Particle &p2 = *it->second;
@@ -184,7 +184,7 @@ namespace espressopp {
       LOG4ESPP_INFO(theLogger, "computed virial tensor for all pairs in the cell lists");
 
       Tensor wlocal(0.0);
-      for (iterator::CellListAllPairsIterator it(storage->getRealCells());
+      for (iterator::CellListAllPairsIterator it(storage->getRealCells(), storage->getGhostCells());
            it.isValid(); ++it) {
         const Particle &p1 = *it->first;
         const Particle &p2 = *it->second;
@@ -210,7 +210,7 @@ namespace espressopp {
 
       Tensor wlocal(0.0);
       const bc::BC& bc = *storage->getSystemRef().bc;  // boundary conditions
-      for (iterator::CellListAllPairsIterator it(storage->getRealCells());
+      for (iterator::CellListAllPairsIterator it(storage->getRealCells(), storage->getGhostCells());
            it.isValid(); ++it) {
         const Particle &p1 = *it->first;
         const Particle &p2 = *it->second;
@@ -246,7 +246,7 @@ namespace espressopp {
       Real3D Li = bc.getBoxL();
       Tensor *wlocal = new Tensor[n];
       for(int i=0; i<n; i++) wlocal[i] = Tensor(0.0);
-      for (iterator::CellListAllPairsIterator it(storage->getRealCells());
+      for (iterator::CellListAllPairsIterator it(storage->getRealCells(), storage->getGhostCells());
            it.isValid(); ++it) {
         const Particle &p1 = *it->first;
         const Particle &p2 = *it->second;
@@ -40,7 +40,8 @@ namespace espressopp {
                      real _rcut,
                      int _interpolation
               ): system(_system), C_pref(_coulomb_prefactor), alpha(_alpha),
-                    M(_M), P(_P), rc(_rcut), interpolation(_interpolation){
+                    M(_M), P(_P), rc(_rcut), interpolation(_interpolation),
+                    plans_ready(false){
       
       // predefined assigned function coefficients
       af_coef[1][0][0] = 1.0;
@@ -192,10 +193,8 @@ namespace espressopp {
       af_coef[7][6][6] =     64./46080.;
       
       getParticleNumber();
+      // also does the first initialize
       preset();
-      
-      // first initialize
-      initialize();
         
       // This function calculates the square of all particle charges. It should be called ones,
       // if the total number of particles doesn't change.
@@ -224,13 +223,190 @@ namespace espressopp {
       clean_fftw();
     }
 
+    // all-to-all exchange of sendbuf into recvbuf, for the counts in
+    // sendcnt and recvcnt
+    void CoulombKSpaceP3M::exchange(){
+      int sendSize = 0, recvSize = 0;
+      for(int r=0; r<nNodes; r++){
+        sdispl[r] = sendSize;
+        sendSize += sendcnt[r];
+        rdispl[r] = recvSize;
+        recvSize += recvcnt[r];
+      }
+      // keep the buffers non-empty, so that their data pointers are valid
+      sendbuf.resize(std::max(sendSize, 1));
+      recvbuf.resize(std::max(recvSize, 1));
+    }
+
+    // the planes of the sub-mesh of this CPU go to the CPUs owning them,
+    // where the contributions of all CPUs are summed up
+    void CoulombKSpaceP3M::send_charges_to_slabs(){
+      // every CPU needs the sub-mesh ranges of the others to know what it gets
+      int range[2] = {sub_x0, sub_nx};
+      mpi::all_gather( *system -> comm, range, 2, sub_range );
+
+      for(int r=0; r<nNodes; r++){
+        sendcnt[r] = recvcnt[r] = 0;
+        for(int u = sub_range[2*r]; u < sub_range[2*r] + sub_range[2*r+1]; u++){
+          if (plane_owner[fold_plane(u)] == thisNode) recvcnt[r] += MYZ;
+        }
+      }
+      for(int u = sub_x0; u < sub_x0 + sub_nx; u++){
+        sendcnt[plane_owner[fold_plane(u)]] += MYZ;
+      }
+      exchange();
+
+      vector<int> pos(sdispl);
+      for(int u = sub_x0; u < sub_x0 + sub_nx; u++){
+        int &p = pos[plane_owner[fold_plane(u)]];
+        std::copy(&q_sub[(u - sub_x0) * MYZ], &q_sub[(u - sub_x0) * MYZ] + MYZ, &sendbuf[p]);
+        p += MYZ;
+      }
+
+      MPI_Comm comm = *system->comm;
+      MPI_Datatype type = mpi::get_mpi_datatype<real>();
+      MPI_Alltoallv(&sendbuf[0], &sendcnt[0], &sdispl[0], type,
+                    &recvbuf[0], &recvcnt[0], &rdispl[0], type, comm);
+
+      std::fill(QQQ.begin(), QQQ.end(), dcomplex(0.0));
+      for(int r=0; r<nNodes; r++){
+        const real *plane = &recvbuf[rdispl[r]];
+        for(int u = sub_range[2*r]; u < sub_range[2*r] + sub_range[2*r+1]; u++){
+          int x = fold_plane(u);
+          if (plane_owner[x] != thisNode) continue;
+          dcomplex *q = &QQQ[(x - x0[thisNode]) * MYZ];
+          for(int i=0; i<MYZ; i++) q[i] += plane[i];
+          plane += MYZ;
+        }
+      }
+    }
+
+    // the reverse of send_charges_to_slabs: the field of the own x-planes
+    // goes to the sub-meshes of all CPUs that cover them
+    void CoulombKSpaceP3M::get_field_from_slabs(){
+      for(int r=0; r<nNodes; r++){
+        sendcnt[r] = recvcnt[r] = 0;
+        for(int u = sub_range[2*r]; u < sub_range[2*r] + sub_range[2*r+1]; u++){
+          if (plane_owner[fold_plane(u)] == thisNode) sendcnt[r] += 3 * MYZ;
+        }
+      }
+      for(int u = sub_x0; u < sub_x0 + sub_nx; u++){
+        recvcnt[plane_owner[fold_plane(u)]] += 3 * MYZ;
+      }
+      exchange();
+
+      real *f = &sendbuf[0];
+      for(int r=0; r<nNodes; r++){
+        for(int u = sub_range[2*r]; u < sub_range[2*r] + sub_range[2*r+1]; u++){
+          int x = fold_plane(u);
+          if (plane_owner[x] != thisNode) continue;
+          int offset = (x - x0[thisNode]) * MYZ;
+          for(int i=0; i<MYZ; i++){
+            for(int l=0; l<3; l++) *f++ = phi_r[l][offset + i].real();
+          }
+        }
+      }
+
+      MPI_Comm comm = *system->comm;
+      MPI_Datatype type = mpi::get_mpi_datatype<real>();
+      MPI_Alltoallv(&sendbuf[0], &sendcnt[0], &sdispl[0], type,
+                    &recvbuf[0], &recvcnt[0], &rdispl[0], type, comm);
+
+      f_sub.resize(3 * sub_nx * MYZ);
+      vector<int> pos(rdispl);
+      for(int u = sub_x0; u < sub_x0 + sub_nx; u++){
+        int &p = pos[plane_owner[fold_plane(u)]];
+        std::copy(&recvbuf[p], &recvbuf[p] + 3 * MYZ, &f_sub[3 * (u - sub_x0) * MYZ]);
+        p += 3 * MYZ;
+      }
+    }
+
+    // from the x-planes [x][y][z] of this CPU to its y-rows [y][z][x]
+    void CoulombKSpaceP3M::transpose_planes_to_rows(const vector<dcomplex> &planes,
+                                                     vector<dcomplex> &rows){
+      for(int r=0; r<nNodes; r++){
+        sendcnt[r] = 2 * nx[thisNode] * ny[r] * M[2];
+        recvcnt[r] = 2 * nx[r] * ny[thisNode] * M[2];
+      }
+      exchange();
+
+      real *b = &sendbuf[0];
+      for(int r=0; r<nNodes; r++){
+        for(int x=0; x<nx[thisNode]; x++){
+          for(int y=y0[r]; y<y0[r]+ny[r]; y++){
+            const dcomplex *q = &planes[(x * M[1] + y) * M[2]];
+            for(int z=0; z<M[2]; z++){
+              *b++ = q[z].real();
+              *b++ = q[z].imag();
+            }
+          }
+        }
+      }
+
+      MPI_Comm comm = *system->comm;
+      MPI_Datatype type = mpi::get_mpi_datatype<real>();
+      MPI_Alltoallv(&sendbuf[0], &sendcnt[0], &sdispl[0], type,
+                    &recvbuf[0], &recvcnt[0], &rdispl[0], type, comm);
+
+      for(int r=0; r<nNodes; r++){
+        const real *b = &recvbuf[rdispl[r]];
+        for(int x=x0[r]; x<x0[r]+nx[r]; x++){
+          for(int y=0; y<ny[thisNode]; y++){
+            for(int z=0; z<M[2]; z++, b+=2){
+              rows[(y * M[2] + z) * M[0] + x] = dcomplex(b[0], b[1]);
+            }
+          }
+        }
+      }
+    }
+
+    // from the y-rows [y][z][x] of this CPU back to its x-planes [x][y][z]
+    void CoulombKSpaceP3M::transpose_rows_to_planes(const vector<dcomplex> &rows,
+                                                     vector<dcomplex> &planes){
+      for(int r=0; r<nNodes; r++){
+        sendcnt[r] = 2 * nx[r] * ny[thisNode] * M[2];
+        recvcnt[r] = 2 * nx[thisNode] * ny[r] * M[2];
+      }
+      exchange();
+
+      real *b = &sendbuf[0];
+      for(int r=0; r<nNodes; r++){
+        for(int x=x0[r]; x<x0[r]+nx[r]; x++){
+          for(int y=0; y<ny[thisNode]; y++){
+            for(int z=0; z<M[2]; z++){
+              const dcomplex &q = rows[(y * M[2] + z) * M[0] + x];
+              *b++ = q.real();
+              *b++ = q.imag();
+            }
+          }
+        }
+      }
+
+      MPI_Comm comm = *system->comm;
+      MPI_Datatype type = mpi::get_mpi_datatype<real>();
+      MPI_Alltoallv(&sendbuf[0], &sendcnt[0], &sdispl[0], type,
+                    &recvbuf[0], &recvcnt[0], &rdispl[0], type, comm);
+
+      for(int r=0; r<nNodes; r++){
+        const real *b = &recvbuf[rdispl[r]];
+        for(int x=0; x<nx[thisNode]; x++){
+          for(int y=y0[r]; y<y0[r]+ny[r]; y++){
+            dcomplex *q = &planes[(x * M[1] + y) * M[2]];
+            for(int z=0; z<M[2]; z++, b+=2){
+              q[z] = dcomplex(b[0], b[1]);
+            }
+          }
+        }
+      }
+    }
+
     //////////////////////////////////////////////////
     // REGISTRATION WITH PYTHON
     //////////////////////////////////////////////////
     void CoulombKSpaceP3M::registerPython() {
       using namespace espressopp::python;
 
-      class_< CoulombKSpaceP3M, bases< Potential > >
+      class_< CoulombKSpaceP3M, bases< Potential >, boost::noncopyable >
       ("interaction_CoulombKSpaceP3M", 
               init< shared_ptr<System>, real, real, Int3D, int, real, int >() )
     	.add_property("prefactor", &CoulombKSpaceP3M::getPrefactor, 
@@ -26,6 +26,7 @@
 
 #include <cmath>
 #include <boost/signals2.hpp>
+#include <boost/noncopyable.hpp>
 
 #include <fftw3.h>
 
@@ -62,11 +63,18 @@ namespace espressopp {
      *  M. Deserno, C.Holm, J.Chem. Phys, 109[18] (1998) 7694
      */
     
-    // TODO this version is still under development. not parallel. doesn't work for several
-    // CPUs
+    // The mesh is distributed over the CPUs in slabs of x-planes. Each CPU
+    // assigns the charges of its own particles to a sub-mesh that covers just
+    // the x-planes their stencils reach, and sends these planes to the CPUs
+    // owning them. The 3D FFT is done as 2D FFTs of the own x-planes, a
+    // transposition into slabs of y-rows and 1D FFTs along x, so that every
+    // CPU holds only its part of the k-space mesh. The field takes the way
+    // back, and each CPU interpolates the forces from its sub-mesh.
     // TODO should be optimized (force, energy and virial calculate the same stuff)
     
-    class CoulombKSpaceP3M : public PotentialTemplate< CoulombKSpaceP3M > {
+    // not copyable, the FFTW plans point into the mesh arrays of the object
+    class CoulombKSpaceP3M : public PotentialTemplate< CoulombKSpaceP3M >,
+                             private boost::noncopyable {
     private:
       shared_ptr< System > system; // we need the system object to be able to access the box
                                    // dimensions, communicator, number of particles, signals
@@ -83,6 +91,7 @@ namespace espressopp {
                         // function
       
       int MMM;  // MMM = M[0]*M[1]*M[2]
+      int MYZ;  // MYZ = M[1]*M[2], the size of an x-plane
       
       // Brillouin zones for the optimal influence function
       static const int brillouin = 1;
@@ -93,20 +102,41 @@ namespace espressopp {
       
       vector< vector<real> > d_op; 
       
-      //vector< vector< vector<real> > >gf; // influence function
-      vector<real> gf; // influence function
+      // slab decomposition of the mesh: the first x-plane and the number of
+      // x-planes of every CPU, the same for the y-rows of the transposed mesh
+      int nNodes, thisNode;
+      vector< int > x0, nx;
+      vector< int > y0, ny;
+      vector< int > plane_owner; // CPU of every x-plane
       
-      //vector< vector< vector< dcomplex > > > QQQ;
+      // influence function on the own y-rows, [y][z][x]
+      vector<real> gf;
+      
+      // charge mesh on the own x-planes, [x][y][z], and its transform on the
+      // own y-rows, [y][z][x]
       vector<  dcomplex > QQQ;
+      vector<  dcomplex > QQQ_k;
       
+      // the three components of the field on the own y-rows and, transformed
+      // back, on the own x-planes
       vector<vector<dcomplex> > phi;
-        
-      // reference points in the lattice, needed for the charge assignment
-      vector<Int3D> g_ca;
-      // mesh contributions of the charged particles
-      vector< vector< real > > q_l;
-      
-      vector< vector< vector< int > > > map_indx;
+      vector<vector<dcomplex> > phi_r;
+        
+      // assignment stencil of every local particle, in the order of the real
+      // cells: P^3 sub-mesh indices and weights (charge included) per
+      // particle, filled during the charge assignment and reused for the forces
+      vector< int > stencil_indx;
+      vector< real > stencil_w;
+      // sub-mesh of the local particles: the (unfolded) x-planes
+      // [sub_x0, sub_x0 + sub_nx), with all y-rows and z-points
+      int sub_x0, sub_nx;
+      vector< int > sub_range; // sub_x0 and sub_nx of every CPU
+      vector< real > q_sub;    // charges
+      vector< real > f_sub;    // field, three components per mesh point
+      
+      // buffers of the all-to-all exchanges
+      vector< int > sendcnt, sdispl, recvcnt, rdispl;
+      vector< real > sendbuf, recvbuf;
       
       int nParticles;  // number of particles in system
       Real3D sysL;     // system size
@@ -114,10 +144,13 @@ namespace espressopp {
       
       real af_coef[8][7][7]; // matrix of predefined assigned function coefficients
       
-      // fftw elements
-      fftw_complex *in_array;
-      fftw_plan plan;
-      int MM[3]; // auxiliary array for plan generation
+      // fftw elements, the plans work in place: plan_frw[0] on the x-planes
+      // of QQQ, plan_frw[1] on the y-rows of QQQ_k; plan_bcw[l][0] on the
+      // y-rows of phi[l], plan_bcw[l][1] on the x-planes of phi_r[l].
+      // A plan is NULL if the CPU owns no plane or no row.
+      fftw_plan plan_frw[2];
+      fftw_plan plan_bcw[3][2];
+      bool plans_ready;
       
       //real oddeven1, oddeven2; // supporting variables odd/even interpolation order
     public:
@@ -138,25 +171,12 @@ namespace espressopp {
       void preset(){
         sysL = system -> bc -> getBoxL();
         MMM = M[0] * M[1] * M[2];
-        for(int i=0; i<3; i++) MM[i] = M[i];
-        
-        // map xpos, ypos and zpos to index = zpos + M[2] * (ypos + M[1] * xpos)
-        map_indx = vector< vector< vector<int> > > (M[0],
-                           vector< vector<int> >   (M[1],
-                                   vector<int>     (M[2], 0) ));
-        for(int i=0; i<M[0]; i++){
-          int mi = M[1] * i;
-          for(int j=0; j<M[1]; j++){
-            int mj = M[2] * (j + mi);
-            for(int k=0; k<M[2]; k++){
-              map_indx[i][j][k] = k + mj;
-            }
-          }
-        }
+        MYZ = M[1] * M[2];
         
         precalc_interp_caf = vector< vector<real> > (P, vector<real>(2*interpolation+1, 0.0) );
         precalc_interpol_charge_assignment_f();
         
+        initialize();
       }
       
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -193,10 +213,10 @@ namespace espressopp {
       int getInterpolation() const { return interpolation; }
 /////////////////////////////////////////////////////////////////////////////////////////
 
+      // mesh dependent arrays and the influence function, recalculated only
+      // when the box or the parameters change
       void initialize(){
         
-        set_fftw_array();
-        
         mesh_shift = vector< vector<real> >(3, vector<real>() );
         d_op = vector< vector<real> >(3, vector<real>() );
         for(int i=0;i<3;i++){
@@ -208,24 +228,53 @@ namespace espressopp {
         
         calc_differential_operator();
         
-        gf = vector<real>(MMM, 0.0);
+        decompose_mesh();
+        int slabSize = nx[thisNode] * MYZ;
+        int rowsSize = ny[thisNode] * M[2] * M[0];
+        
+        gf = vector<real>(rowsSize, 0.0);
         
         calc_opt_influence_function();
         
         // -----------------------------------------
         // charge assignment
-        QQQ = vector<dcomplex>(MMM, 0.0);
-        
-        
-        // TODO check double use in common part
-        g_ca = vector<Int3D>(0, Int3D(0) );
-
-        q_l = vector< vector<real> > (nParticles, vector<real>(MMM, 0.0) );
+        QQQ = vector<dcomplex>(slabSize, 0.0);
+        QQQ_k = vector<dcomplex>(rowsSize, 0.0);
         
         // force specific
-        phi = vector<vector<dcomplex> > (3, vector<dcomplex> (MMM, dcomplex(0.0) ));
+        phi = vector<vector<dcomplex> > (3, vector<dcomplex> (rowsSize, dcomplex(0.0) ));
+        phi_r = vector<vector<dcomplex> > (3, vector<dcomplex> (slabSize, dcomplex(0.0) ));
+
+        make_plans();
+      }
+      
+      // distributes the x-planes and the y-rows of the mesh over the CPUs
+      void decompose_mesh(){
+        nNodes = system->comm->size();
+        thisNode = system->comm->rank();
+        x0 = nx = y0 = ny = vector<int>(nNodes, 0);
+        plane_owner = vector<int>(M[0], 0);
+        for(int r=0, x=0, y=0; r<nNodes; r++){
+          x0[r] = x;
+          nx[r] = M[0] / nNodes + (r < M[0] % nNodes ? 1 : 0);
+          for(int i=0; i<nx[r]; i++) plane_owner[x++] = r;
+          y0[r] = y;
+          ny[r] = M[1] / nNodes + (r < M[1] % nNodes ? 1 : 0);
+          y += ny[r];
+        }
+        sendcnt = sdispl = recvcnt = rdispl = vector<int>(nNodes, 0);
       }
       
+      // the folded index of an unfolded x-plane
+      int fold_plane(int u) const { return ((u % M[0]) + M[0]) % M[0]; }
+      
+      // MPI exchanges of the distributed mesh, see the .cpp
+      void exchange();
+      void send_charges_to_slabs();
+      void get_field_from_slabs();
+      void transpose_planes_to_rows(const vector<dcomplex> &planes, vector<dcomplex> &rows);
+      void transpose_rows_to_planes(const vector<dcomplex> &rows, vector<dcomplex> &planes);
+      
       // get the current particle number on the current node
       // and set the auxiliary arrays
       void getParticleNumber() {
@@ -280,7 +329,7 @@ namespace espressopp {
       void assign_charge_for_single_particle(real q, Real3D particle_pos){
       }
       
-      // calculates the optimal influence function
+      // calculates the optimal influence function on the own y-rows
       void calc_opt_influence_function(){
         
         real coef  = 2.0 * MMM / (sysL[0]*sysL[1]);
@@ -288,10 +337,10 @@ namespace espressopp {
         real denom;
         Real3D nom, D;
         Int3D i;
-        for ( i[0] = 0; i[0] < M[0]; i[0]++){
-          for ( i[1] = 0; i[1] < M[1]; i[1]++){
-            for ( i[2] = 0; i[2] < M[2]; i[2]++){
-              int indx = map_indx[i[0]][i[1]][i[2]];
+        for ( i[1] = y0[thisNode]; i[1] < y0[thisNode] + ny[thisNode]; i[1]++){
+          for ( i[2] = 0; i[2] < M[2]; i[2]++){
+            for ( i[0] = 0; i[0] < M[0]; i[0]++){
+              int indx = i[0] + M[0] * (i[2] + M[2] * (i[1] - y0[thisNode]));
               if ( i == Int3D(0) )
                 gf[ indx ] = 0.0;
               else{
@@ -410,19 +459,44 @@ namespace espressopp {
         return out;
       }
       
-      void set_fftw_array(){
-        in_array = (fftw_complex*) fftw_malloc( MMM * sizeof(fftw_complex));
+      // the 2D transforms of nx[thisNode] x-planes
+      fftw_plan plan_planes(vector<dcomplex> &a, int sign){
+        if (nx[thisNode] == 0) return NULL;
+        int n[2] = {M[1], M[2]};
+        fftw_complex *data = reinterpret_cast<fftw_complex*>( &a[0] );
+        return fftw_plan_many_dft(2, n, nx[thisNode], data, NULL, 1, MYZ,
+                                  data, NULL, 1, MYZ, sign, FFTW_ESTIMATE);
       }
-      void set_plan_frw(){
-        plan = fftw_plan_dft(3, MM, in_array, in_array, FFTW_FORWARD, FFTW_ESTIMATE);
+      // the 1D transforms along x of ny[thisNode]*M[2] rows
+      fftw_plan plan_rows(vector<dcomplex> &a, int sign){
+        if (ny[thisNode] == 0) return NULL;
+        int n[1] = {M[0]};
+        fftw_complex *data = reinterpret_cast<fftw_complex*>( &a[0] );
+        return fftw_plan_many_dft(1, n, ny[thisNode] * M[2], data, NULL, 1, M[0],
+                                  data, NULL, 1, M[0], sign, FFTW_ESTIMATE);
       }
-      void set_plan_bcw(){
-        plan = fftw_plan_dft(3, MM, in_array, in_array, FFTW_BACKWARD, FFTW_ESTIMATE);
+      void execute(fftw_plan plan){
+        if (plan) fftw_execute(plan);
+      }
+      
+      // the arrays must not be reallocated while the plans exist
+      void make_plans(){
+        clean_fftw();
+        plan_frw[0] = plan_planes(QQQ, FFTW_FORWARD);
+        plan_frw[1] = plan_rows(QQQ_k, FFTW_FORWARD);
+        for(int l=0; l<3; l++){
+          plan_bcw[l][0] = plan_rows(phi[l], FFTW_BACKWARD);
+          plan_bcw[l][1] = plan_planes(phi_r[l], FFTW_BACKWARD);
+        }
+        plans_ready = true;
       }
       void clean_fftw(){
-        fftw_destroy_plan(plan);
-        in_array = NULL;
-        fftw_free(in_array);
+        if (!plans_ready) return;
+        for(int i=0; i<2; i++){
+          if (plan_frw[i]) fftw_destroy_plan(plan_frw[i]);
+          for(int l=0; l<3; l++) if (plan_bcw[l][i]) fftw_destroy_plan(plan_bcw[l][i]);
+        }
+        plans_ready = false;
       }
       
       
@@ -430,11 +504,13 @@ namespace espressopp {
         
         common_part(realCells, 1);
         
-        real energy = 0.0;
+        real node_energy = 0.0;
         
-        for (int i=0; i<MMM; i++){
-          energy += gf[i] * norm( QQQ[i] );
+        for (size_t i=0; i<QQQ_k.size(); i++){
+          node_energy += gf[i] * norm( QQQ_k[i] );
         }
+        real energy = 0.0;
+        mpi::all_reduce( *system -> comm, node_energy, energy, plus<real>() );
         
         // TODO sysL[0]?? what about [1] and [2]?
         energy *= ( C_pref * sysL[0] / (4.0*MMM*M_PIl) );
@@ -448,11 +524,8 @@ namespace espressopp {
       
       // TODO get rid of iii at the end
       void common_part(CellList realCells, int iii){
-        initialize();
-        
         real _2interp = 2.0 * interpolation;
-        // TODO assignshift probably should be [3]
-        int assignshift = M[0]- floor((real)(P-1)/2.0);
+        int assignshift = (int)floor((real)(P-1)/2.0);
         
         real  modadd1, modadd2;
         // odd and even interpolation order
@@ -463,30 +536,47 @@ namespace espressopp {
             { modadd1 = 0.0; modadd2 =  0.5;} break;
         }
 
-        g_ca.clear();
-        g_ca = vector<Int3D>(nParticles, Int3D(0) );
-        QQQ.clear();
-        QQQ = vector<dcomplex>(MMM, dcomplex(0.0));
+        getParticleNumber();
+        int P3 = P * P * P;
+        stencil_indx.resize(P3 * nParticles);
+        stencil_w.resize(P3 * nParticles);
         
-        Int3D Gi, arg;
+        // the x-planes reached by the stencils of the own particles
+        int x_lo = 0, x_hi = 0;
+        bool first = true;
         for(iterator::CellListIterator it(realCells); it.isValid(); ++it){
+          real d1 = it->position()[0] * M[0] / sysL[0] + modadd1;
+          int u = (int)floor( d1 + modadd2 ) - assignshift;
+          if (first || u < x_lo) x_lo = u;
+          if (first || u + P > x_hi) x_hi = u + P;
+          first = false;
+        }
+        sub_x0 = x_lo;
+        sub_nx = x_hi - x_lo;
+        q_sub.assign(sub_nx * MYZ, 0.0);
+        
+        Int3D Gi, arg;
+        int pi = 0;
+        for(iterator::CellListIterator it(realCells); it.isValid(); ++it, ++pi){
           Particle &p = *it;
           Real3D ppos = p.position();
           
           Real3D d1;
           for(int i=0; i<3; i++){
             d1[i] = ppos[i] * M[i] / sysL[i] + modadd1;
+            // the first plane of the stencil, unfolded in x and folded
+            // (positive) in y and z
+            Gi[i] = (int)floor( d1[i] + modadd2 ) - assignshift - (i == 0 ? sub_x0 : -M[i]);
           }
-          Gi  = Int3D(d1 + modadd2) + assignshift;
           arg = Int3D( (d1 - dround(d1) + 0.5)*_2interp );
 
-          // specific for force !!!!!!!!
-          g_ca[p.id()] = Gi;
+          int *s_indx = &stencil_indx[P3 * pi];
+          real *s_w = &stencil_w[P3 * pi];
           
           // Calculate the mesh based charges
           real T1,T2,T3;
           for (int i = 0; i < P; i++) {
-            int xpos = (Gi[0] + i) % M[0];
+            int xpos = Gi[0] + i;
             T1 = p.q() * precalc_interp_caf[i][arg[0]];
             for (int j = 0; j < P; j++) {
               int ypos = (Gi[1] + j) % M[1];
@@ -495,21 +585,25 @@ namespace espressopp {
                 int zpos = (Gi[2] + k) % M[2];
                 T3 = T2 * precalc_interp_caf[k][arg[2]];
                 
-                int indx = map_indx[xpos][ypos][zpos];
+                int indx = zpos + M[2] * (ypos + M[1] * xpos);
                 
                 // specific for force !!!!!!!!
-                q_l[p.id()][indx] = T3;
+                *s_indx++ = indx;
+                *s_w++ = T3;
                 
-                QQQ[indx] += dcomplex(T3, 0.0);
+                q_sub[indx] += T3;
               }
             }
           }
 
         }
+        
+        // sum up the sub-meshes of all CPUs on the own x-planes
+        send_charges_to_slabs();
  
-        in_array = reinterpret_cast<fftw_complex*>( &QQQ[0] );
-        set_plan_frw();
-        fftw_execute(plan);
+        execute(plan_frw[0]);
+        transpose_planes_to_rows(QQQ, QQQ_k);
+        execute(plan_frw[1]);
       }
 
       // @TODO this function could be void, 
@@ -517,13 +611,13 @@ namespace espressopp {
 
         common_part(realCells, 0);
         
-        // Calculate the supporting arrays phi_?_??:
+        // Calculate the supporting arrays phi_?_?? on the own y-rows:
         Int3D i;
-        for ( i[0]=0; i[0]<M[0]; i[0]++){
-          for ( i[1]=0; i[1]<M[1]; i[1]++){
-            for ( i[2]=0; i[2]<M[2]; i[2]++) {  
-              int indx = map_indx[i[0]][i[1]][i[2]];
-              dcomplex phi_aux = gf[indx] * swap_complex( conj( QQQ[indx] ) );
+        int indx = 0;
+        for ( i[1]=y0[thisNode]; i[1]<y0[thisNode]+ny[thisNode]; i[1]++){
+          for ( i[2]=0; i[2]<M[2]; i[2]++){
+            for ( i[0]=0; i[0]<M[0]; i[0]++, indx++) {  
+              dcomplex phi_aux = gf[indx] * swap_complex( conj( QQQ_k[indx] ) );
               
               for (int ii=0; ii<3; ii++) phi[ii][indx] = d_op[ii][i[ii]] * phi_aux;
             }
@@ -531,33 +625,30 @@ namespace espressopp {
         }
 
         for(int l=0; l<3; l++){
-          in_array = reinterpret_cast<fftw_complex*>( &phi[l][0] );
-          set_plan_bcw();
-          fftw_execute(plan);
+          execute(plan_bcw[l][0]);
+          transpose_rows_to_planes(phi[l], phi_r[l]);
+          execute(plan_bcw[l][1]);
         }
         
+        // the field on the x-planes of the own sub-mesh
+        get_field_from_slabs();
+        
         real C_MMM_inv = C_pref / (real)MMM;
-        for(iterator::CellListIterator it(realCells); it.isValid(); ++it){
+        int P3 = P * P * P;
+        int pi = 0;
+        for(iterator::CellListIterator it(realCells); it.isValid(); ++it, ++pi){
           Particle &p = *it;
           
-          int iii = p.id();
+          // the stencil of the charge assignment
+          const int *s_indx = &stencil_indx[P3 * pi];
+          const real *s_w = &stencil_w[P3 * pi];
           Real3D ff(0.0);
-          for (int i = 0; i < P; i++) {
-            int xpos = (g_ca[iii][0] + i) % M[0];
-            for (int j = 0; j < P; j++) {
-              int ypos = (g_ca[iii][1] + j) % M[1];
-              for (int k = 0; k < P; k++) {
-                int zpos = (g_ca[iii][2] + k) % M[2];
-                
-                int indx = map_indx[xpos][ypos][zpos];
-                
-                Real3D f_add( phi[0][indx].real(),
-                              phi[1][indx].real(),
-                              phi[2][indx].real());
+          for (int l = 0; l < P3; l++) {
+            const real *f_point = &f_sub[3 * s_indx[l]];
+            
+            Real3D f_add( f_point[0], f_point[1], f_point[2] );
 
-                ff += C_MMM_inv * q_l[iii][indx]  *  f_add ;
-              }
-            }
+            ff += C_MMM_inv * s_w[l]  *  f_add ;
           }
 
           p.force() -= ff;
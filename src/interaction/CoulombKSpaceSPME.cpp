@@ -0,0 +1,366 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include <cmath>
+#include <sstream>
+#include "CoulombKSpaceSPME.hpp"
+#include "CellListAllParticlesInteractionTemplate.hpp"
+#include "iterator/CellListIterator.hpp"
+#include "storage/Storage.hpp"
+#include "bc/BC.hpp"
+#include "System.hpp"
+
+namespace espressopp {
+  namespace interaction {
+
+    typedef class CellListAllParticlesInteractionTemplate <CoulombKSpaceSPME>
+    CellListCoulombKSpaceSPME;
+
+    CoulombKSpaceSPME::
+    CoulombKSpaceSPME(shared_ptr< System > _system, real _prefactor,
+                      real _alpha, Int3D _M, int _P)
+      : system(_system), prefactor(_prefactor), alpha(_alpha), M(_M), P(_P),
+        MMM(0), sum_q2(0.0), plans_ready(false) {
+      if (P < 3) {
+        throw std::invalid_argument("CoulombKSpaceSPME: the B-spline order has to be at least 3");
+      }
+      preset();
+
+      count_charges(system->storage->getRealCells());
+
+      // make a connection to boundary conditions to recalculate the influence function if box dimensions change
+      connectionRecalc = system->bc->onBoxDimensionsChanged.
+              connect(boost::bind(&CoulombKSpaceSPME::preset, this));
+      // make a connection to storage to recount the charges
+      connectionCountCharges = system->storage->onParticlesChanged.
+              connect(boost::bind(&CoulombKSpaceSPME::count_charges, this,
+                                  boost::bind(&storage::Storage::getRealCells, system->storage.get())));
+    }
+
+    CoulombKSpaceSPME::~CoulombKSpaceSPME() {
+      connectionRecalc.disconnect();
+      connectionCountCharges.disconnect();
+      cleanPlans();
+    }
+
+    void CoulombKSpaceSPME::setOrder(int _P) {
+      if (_P < 3) {
+        throw std::invalid_argument("CoulombKSpaceSPME: the B-spline order has to be at least 3");
+      }
+      P = _P;
+      preset();
+    }
+
+    void CoulombKSpaceSPME::preset() {
+      for (int d = 0; d < 3; ++d) {
+        if (M[d] < P) {
+          throw std::invalid_argument("CoulombKSpaceSPME: the mesh has to have at least P points per direction");
+        }
+      }
+
+      L = system->bc->getBoxL();
+      MMM = M[0] * M[1] * M[2];
+
+      std::vector< real > bsp[3];
+      for (int d = 0; d < 3; ++d) {
+        calcBSplineModuli(M[d], bsp[d]);
+        recip[d].resize(M[d]);
+        for (int k = 0; k < M[d]; ++k) {
+          int m = (k < (M[d] + 1) / 2) ? k : k - M[d];
+          recip[d][k] = m / L[d];
+        }
+      }
+
+      real V = L[0] * L[1] * L[2];
+      real fac = M_PI * M_PI / (alpha * alpha);
+      bc.resize(MMM);
+      for (int i = 0; i < M[0]; ++i) {
+        for (int j = 0; j < M[1]; ++j) {
+          for (int k = 0; k < M[2]; ++k) {
+            int indx = k + M[2] * (j + M[1] * i);
+            real m2 = recip[0][i] * recip[0][i] + recip[1][j] * recip[1][j]
+                    + recip[2][k] * recip[2][k];
+            if (indx == 0) {
+              bc[indx] = 0.0;
+            } else {
+              bc[indx] = exp(-fac * m2) / (M_PI * V * m2) * bsp[0][i] * bsp[1][j] * bsp[2][k];
+            }
+          }
+        }
+      }
+
+      q_mesh.assign(MMM, 0.0);
+      q_mesh_sum.assign(MMM, 0.0);
+      QQQ.assign(MMM, dcomplex(0.0));
+      phi.assign(MMM, dcomplex(0.0));
+      makePlans();
+    }
+
+    void CoulombKSpaceSPME::count_charges(CellList realcells) {
+      real node_sum_q2 = 0.0;
+      for (iterator::CellListIterator it(realcells); !it.isDone(); ++it) {
+        node_sum_q2 += it->q() * it->q();
+      }
+      sum_q2 = 0.0;
+      mpi::all_reduce(*system->comm, node_sum_q2, sum_q2, std::plus<real>());
+    }
+
+    void CoulombKSpaceSPME::makePlans() {
+      cleanPlans();
+      int MM[3] = { M[0], M[1], M[2] };
+      plan_frw = fftw_plan_dft(3, MM, reinterpret_cast<fftw_complex*>(&QQQ[0]),
+                               reinterpret_cast<fftw_complex*>(&QQQ[0]), FFTW_FORWARD, FFTW_ESTIMATE);
+      plan_bcw = fftw_plan_dft(3, MM, reinterpret_cast<fftw_complex*>(&phi[0]),
+                               reinterpret_cast<fftw_complex*>(&phi[0]), FFTW_BACKWARD, FFTW_ESTIMATE);
+      plans_ready = true;
+    }
+
+    void CoulombKSpaceSPME::cleanPlans() {
+      if (!plans_ready) return;
+      fftw_destroy_plan(plan_frw);
+      fftw_destroy_plan(plan_bcw);
+      plans_ready = false;
+    }
+
+    /* theta[i] = M_P(w + P - 1 - i) belongs to the mesh point floor(u) - P + 1 + i,
+       where w = u - floor(u); dtheta are the derivatives with respect to u. */
+    void CoulombKSpaceSPME::fillBSpline(real w, real *theta, real *dtheta) const {
+      // order 2
+      theta[P - 1] = 0.0;
+      theta[1] = w;
+      theta[0] = 1.0 - w;
+      // up to order P - 1
+      for (int j = 3; j < P; ++j) {
+        real div = 1.0 / (j - 1);
+        theta[j - 1] = div * w * theta[j - 2];
+        for (int k = 1; k <= j - 2; ++k) {
+          theta[j - k - 1] = div * ((w + k) * theta[j - k - 2] + (j - k - w) * theta[j - k - 1]);
+        }
+        theta[0] = div * (1.0 - w) * theta[0];
+      }
+      // derivatives from order P - 1
+      dtheta[0] = -theta[0];
+      for (int j = 1; j < P; ++j) {
+        dtheta[j] = theta[j - 1] - theta[j];
+      }
+      // order P
+      real div = 1.0 / (P - 1);
+      theta[P - 1] = div * w * theta[P - 2];
+      for (int k = 1; k <= P - 2; ++k) {
+        theta[P - k - 1] = div * ((w + k) * theta[P - k - 2] + (P - k - w) * theta[P - k - 1]);
+      }
+      theta[0] = div * (1.0 - w) * theta[0];
+    }
+
+    void CoulombKSpaceSPME::calcBSplineModuli(int K, std::vector< real > &bsp) const {
+      std::vector< real > theta(P), dtheta(P);
+      // theta[P - 2 - k] = M_P(k + 1)
+      fillBSpline(0.0, &theta[0], &dtheta[0]);
+
+      std::vector< real > denom(K);
+      for (int m = 0; m < K; ++m) {
+        real re = 0.0, im = 0.0;
+        for (int k = 0; k <= P - 2; ++k) {
+          real arg = 2.0 * M_PI * m * k / K;
+          re += theta[P - 2 - k] * cos(arg);
+          im += theta[P - 2 - k] * sin(arg);
+        }
+        denom[m] = re * re + im * im;
+      }
+      // the modulus vanishes at m = K/2 for odd orders, interpolate there
+      for (int m = 0; m < K; ++m) {
+        if (denom[m] < 1e-7) {
+          denom[m] = 0.5 * (denom[(m - 1 + K) % K] + denom[(m + 1) % K]);
+        }
+      }
+      bsp.resize(K);
+      for (int m = 0; m < K; ++m) {
+        bsp[m] = 1.0 / denom[m];
+      }
+    }
+
+    void CoulombKSpaceSPME::spreadCharges(CellList realcells) {
+      int nParticles = system->storage->getNRealParticles();
+      stencil_base.resize(3 * nParticles);
+      stencil_theta.resize(3 * P * nParticles);
+      stencil_dtheta.resize(3 * P * nParticles);
+      std::fill(q_mesh.begin(), q_mesh.end(), 0.0);
+
+      int pi = 0;
+      for (iterator::CellListIterator it(realcells); !it.isDone(); ++it, ++pi) {
+        Particle &p = *it;
+        const Real3D &pos = p.position();
+
+        int *base = &stencil_base[3 * pi];
+        real *theta = &stencil_theta[3 * P * pi];
+        real *dtheta = &stencil_dtheta[3 * P * pi];
+        for (int d = 0; d < 3; ++d) {
+          real u = pos[d] * M[d] / L[d];
+          real fl = floor(u);
+          int b = ((int)fl - P + 1) % M[d];
+          base[d] = (b < 0) ? b + M[d] : b;
+          fillBSpline(u - fl, theta + d * P, dtheta + d * P);
+        }
+
+        real q = p.q();
+        if (q == 0.0) continue;
+        for (int i = 0; i < P; ++i) {
+          int xpos = base[0] + i;
+          if (xpos >= M[0]) xpos -= M[0];
+          real T1 = q * theta[i];
+          for (int j = 0; j < P; ++j) {
+            int ypos = base[1] + j;
+            if (ypos >= M[1]) ypos -= M[1];
+            real T2 = T1 * theta[P + j];
+            int offset = M[2] * (ypos + M[1] * xpos);
+            for (int k = 0; k < P; ++k) {
+              int zpos = base[2] + k;
+              if (zpos >= M[2]) zpos -= M[2];
+              q_mesh[offset + zpos] += T2 * theta[2 * P + k];
+            }
+          }
+        }
+      }
+
+      // sum up the charge meshes of all CPUs
+      mpi::all_reduce(*system->comm, &q_mesh[0], MMM, &q_mesh_sum[0], std::plus<real>());
+      for (int i = 0; i < MMM; ++i) {
+        QQQ[i] = dcomplex(q_mesh_sum[i], 0.0);
+      }
+      fftw_execute(plan_frw);
+    }
+
+    real CoulombKSpaceSPME::_computeEnergy(CellList realcells) {
+      spreadCharges(realcells);
+
+      real energy = 0.0;
+      for (int i = 0; i < MMM; ++i) {
+        energy += bc[i] * norm(QQQ[i]);
+      }
+      energy *= 0.5;
+
+      /* self energy correction */
+      energy -= sum_q2 * alpha / sqrt(M_PI);
+
+      // the mesh is the same on all CPUs, so is the energy
+      return prefactor * energy;
+    }
+
+    bool CoulombKSpaceSPME::_computeForce(CellList realcells) {
+      spreadCharges(realcells);
+
+      // convolution with the influence function
+      for (int i = 0; i < MMM; ++i) {
+        phi[i] = bc[i] * QQQ[i];
+      }
+      fftw_execute(plan_bcw);
+
+      Real3D scale(M[0] / L[0], M[1] / L[1], M[2] / L[2]);
+      int pi = 0;
+      for (iterator::CellListIterator it(realcells); !it.isDone(); ++it, ++pi) {
+        Particle &p = *it;
+        real q = p.q();
+        if (q == 0.0) continue;
+
+        const int *base = &stencil_base[3 * pi];
+        const real *theta = &stencil_theta[3 * P * pi];
+        const real *dtheta = &stencil_dtheta[3 * P * pi];
+        real fx = 0.0, fy = 0.0, fz = 0.0;
+        for (int i = 0; i < P; ++i) {
+          int xpos = base[0] + i;
+          if (xpos >= M[0]) xpos -= M[0];
+          for (int j = 0; j < P; ++j) {
+            int ypos = base[1] + j;
+            if (ypos >= M[1]) ypos -= M[1];
+            int offset = M[2] * (ypos + M[1] * xpos);
+            for (int k = 0; k < P; ++k) {
+              int zpos = base[2] + k;
+              if (zpos >= M[2]) zpos -= M[2];
+              real ph = phi[offset + zpos].real();
+              fx += dtheta[i] * theta[P + j] * theta[2 * P + k] * ph;
+              fy += theta[i] * dtheta[P + j] * theta[2 * P + k] * ph;
+              fz += theta[i] * theta[P + j] * dtheta[2 * P + k] * ph;
+            }
+          }
+        }
+        real qpref = prefactor * q;
+        p.force() -= Real3D(qpref * fx * scale[0], qpref * fy * scale[1], qpref * fz * scale[2]);
+      }
+      return true;
+    }
+
+    real CoulombKSpaceSPME::_computeVirial(CellList realcells) {
+      Tensor w = _computeVirialTensor(realcells);
+      return w[0] + w[1] + w[2];
+    }
+
+    Tensor CoulombKSpaceSPME::_computeVirialTensor(CellList realcells) {
+      spreadCharges(realcells);
+
+      // the same tensor as for Ewald: delta_ij - 2 (1 + pi^2 m^2 / alpha^2) m_i m_j / m^2
+      real fac = M_PI * M_PI / (alpha * alpha);
+      Tensor virialTensor(0.0);
+      for (int i = 0; i < M[0]; ++i) {
+        for (int j = 0; j < M[1]; ++j) {
+          for (int k = 0; k < M[2]; ++k) {
+            int indx = k + M[2] * (j + M[1] * i);
+            if (indx == 0) continue;
+            Real3D m(recip[0][i], recip[1][j], recip[2][k]);
+            real m2 = m.sqr();
+            real e = 0.5 * bc[indx] * norm(QQQ[indx]);
+            real b = 2.0 * (1.0 + fac * m2) / m2;
+            virialTensor += Tensor(e * (1.0 - b * m[0] * m[0]),
+                                   e * (1.0 - b * m[1] * m[1]),
+                                   e * (1.0 - b * m[2] * m[2]),
+                                   -e * b * m[0] * m[1],
+                                   -e * b * m[0] * m[2],
+                                   -e * b * m[1] * m[2]);
+          }
+        }
+      }
+      return prefactor * virialTensor;
+    }
+
+    //////////////////////////////////////////////////
+    // REGISTRATION WITH PYTHON
+    //////////////////////////////////////////////////
+    void CoulombKSpaceSPME::registerPython() {
+      using namespace espressopp::python;
+
+      class_< CoulombKSpaceSPME, bases< Potential >, boost::noncopyable >
+        ("interaction_CoulombKSpaceSPME",
+              init< shared_ptr< System >, real, real, Int3D, int >())
+        .add_property("prefactor", &CoulombKSpaceSPME::getPrefactor, &CoulombKSpaceSPME::setPrefactor)
+        .add_property("alpha", &CoulombKSpaceSPME::getAlpha, &CoulombKSpaceSPME::setAlpha)
+        .add_property("mesh", &CoulombKSpaceSPME::getMesh, &CoulombKSpaceSPME::setMesh)
+        .add_property("order", &CoulombKSpaceSPME::getOrder, &CoulombKSpaceSPME::setOrder)
+      ;
+
+      class_< CellListCoulombKSpaceSPME, bases< Interaction > >
+        ("interaction_CellListCoulombKSpaceSPME",
+              init< shared_ptr< storage::Storage >,
+                    shared_ptr< CoulombKSpaceSPME > >())
+        .def("getPotential", &CellListCoulombKSpaceSPME::getPotential)
+      ;
+    }
+
+  }
+}
@@ -0,0 +1,161 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _INTERACTION_COULOMBKSPACESPME_HPP
+#define _INTERACTION_COULOMBKSPACESPME_HPP
+
+#include <complex>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/signals2.hpp>
+
+#include <fftw3.h>
+
+#include "mpi.hpp"
+#include "Potential.hpp"
+#include "CellListAllParticlesInteractionTemplate.hpp"
+#include "Int3D.hpp"
+#include "Tensor.hpp"
+#include "esutil/Error.hpp"
+
+namespace espressopp {
+  namespace interaction {
+    /** This class provides methods to compute forces, energies and the
+     *  virial of the `K` space part of the Coulomb interaction with the
+     *  smooth particle mesh Ewald method (U. Essmann et al.,
+     *  J. Chem. Phys. 103 (1995) 8577). The charges are spread with
+     *  cardinal B-splines of order P onto a mesh of M[0] x M[1] x M[2]
+     *  points and the reciprocal sum is evaluated with FFTs; the forces are
+     *  the analytic derivatives of the B-splines.
+     *
+     *  It uses the same conventions as CoulombKSpaceEwald and needs the
+     *  CoulombRSpace part with the same alpha. Works for cubic and
+     *  rectangular boxes. The mesh is replicated on all CPUs; each CPU
+     *  spreads the charges of its own particles and the meshes are summed.
+     */
+    // not copyable, the FFTW plans point into the mesh arrays of the object
+    class CoulombKSpaceSPME : public PotentialTemplate< CoulombKSpaceSPME >,
+                              private boost::noncopyable {
+    private:
+      typedef std::complex< real > dcomplex;
+
+      shared_ptr< System > system; // box dimensions, communicator, signals
+
+      real prefactor;
+      real alpha; // Ewald splitting parameter
+      Int3D M; // number of mesh points per direction
+      int P; // order of the B-splines
+
+      int MMM; // M[0]*M[1]*M[2]
+      Real3D L; // box size
+      real sum_q2; // sum of squared charges, for the self energy
+
+      // influence function B(m) * C(m) for every mesh point, 0 for m = 0
+      std::vector< real > bc;
+      // reciprocal vectors m/L of the mesh points, per direction
+      std::vector< real > recip[3];
+
+      // charge mesh, its sum over all CPUs and the transformed mesh
+      std::vector< real > q_mesh;
+      std::vector< real > q_mesh_sum;
+      std::vector< dcomplex > QQQ;
+      // the electrostatic potential on the mesh, for the forces
+      std::vector< dcomplex > phi;
+
+      // B-spline stencil of every local particle, in the order of the
+      // real cells: first mesh point per direction, then P weights and
+      // P derivatives per direction
+      std::vector< int > stencil_base;
+      std::vector< real > stencil_theta;
+      std::vector< real > stencil_dtheta;
+
+      fftw_plan plan_frw;
+      fftw_plan plan_bcw;
+      bool plans_ready;
+
+    public:
+      static void registerPython();
+
+      CoulombKSpaceSPME(shared_ptr< System > _system, real _prefactor,
+                        real _alpha, Int3D _M, int _P);
+
+      ~CoulombKSpaceSPME();
+
+      /// recalculate the influence function, e.g. after the box changed
+      void preset();
+
+      /// sum of the squared charges over all CPUs
+      void count_charges(CellList realcells);
+
+      void setPrefactor(real _prefactor) { prefactor = _prefactor; }
+      real getPrefactor() const { return prefactor; }
+      void setAlpha(real _alpha) {
+        alpha = _alpha;
+        preset();
+      }
+      real getAlpha() const { return alpha; }
+      void setMesh(Int3D _M) {
+        M = _M;
+        preset();
+      }
+      Int3D getMesh() const { return M; }
+      void setOrder(int _P);
+      int getOrder() const { return P; }
+
+      real _computeEnergy(CellList realcells);
+      bool _computeForce(CellList realcells);
+      real _computeVirial(CellList realcells);
+      Tensor _computeVirialTensor(CellList realcells);
+
+      real _computeEnergySqrRaw(real /*distSqr*/) const {
+        esutil::Error err(system->comm);
+        std::stringstream msg;
+        msg << "There is no sense to call this function for SPME";
+        err.setException( msg.str() );
+        return 0.0;
+      }
+      bool _computeForceRaw(Real3D& /*force*/, const Real3D& /*dist*/, real /*distSqr*/) const {
+        esutil::Error err(system->comm);
+        std::stringstream msg;
+        msg << "There is no sense to call this function for SPME";
+        err.setException( msg.str() );
+        return false;
+      }
+
+    protected:
+      /// spread the charges onto the mesh, sum it over all CPUs and transform it
+      void spreadCharges(CellList realcells);
+      /// B-spline weights and derivatives of order P at fractional position w
+      void fillBSpline(real w, real *theta, real *dtheta) const;
+      /// squared modulus of the B-spline factor b(m) for one direction
+      void calcBSplineModuli(int K, std::vector< real > &bsp) const;
+      void makePlans();
+      void cleanPlans();
+
+      // it's responsible for the influence function recalculation when the box size changes
+      boost::signals2::connection connectionRecalc;
+      // --||-- for the charges when the particles change
+      boost::signals2::connection connectionCountCharges;
+    };
+  }
+}
+
+#endif
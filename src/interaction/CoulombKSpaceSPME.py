@@ -0,0 +1,142 @@
+#  Copyright (C) 2017
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+r"""
+****************************************
+espressopp.interaction.CoulombKSpaceSPME
+****************************************
+
+Coulomb potential and interaction Objects (`K` space part)
+
+This is the `K` space part of the Coulomb long range interaction computed with
+the smooth particle mesh Ewald method [Essmann95]_. The charges are spread onto a
+mesh with cardinal B-splines, the reciprocal sum of CoulombKSpaceEwald_ is
+evaluated with FFTs and the forces are the analytic derivatives of the splines.
+The cost grows as :math:`N \log N` instead of the :math:`N^{3/2}` of the Ewald sums.
+
+Example:
+
+    >>> spme_pot = espressopp.interaction.CoulombKSpaceSPME(system, coulomb_prefactor, alpha, mesh, order)
+    >>> spme_int = espressopp.interaction.CellListCoulombKSpaceSPME(system.storage, spme_pot)
+    >>> system.addInteraction(spme_int)
+
+**!IMPORTANT** Coulomb interaction needs `R` space part as well CoulombRSpace_, with the same alpha.
+
+.. _CoulombRSpace: espressopp.interaction.CoulombRSpace.html
+.. _CoulombKSpaceEwald: espressopp.interaction.CoulombKSpaceEwald.html
+
+Definition:
+
+    It provides potential object *CoulombKSpaceSPME* and interaction object
+    *CellListCoulombKSpaceSPME* based on all particles list.
+
+    The *potential* is based on the system information (System_) and parameters:
+    Coulomb prefactor (coulomb_prefactor), Ewald parameter (alpha), the number of
+    mesh points per direction (mesh, an Int3D) and the order of the B-splines
+    (order, at least 3). The mesh needs at least `order` points per direction.
+
+.. _System: espressopp.System.html
+
+    Potential Properties:
+
+    *   *spme_pot.prefactor*
+
+        The property 'prefactor' defines the Coulomb prefactor.
+
+    *   *spme_pot.alpha*
+
+        The property 'alpha' defines the Ewald parameter :math:`\\alpha`.
+
+    *   *spme_pot.mesh*
+
+        The property 'mesh' defines the number of mesh points per direction.
+
+    *   *spme_pot.order*
+
+        The property 'order' defines the order of the B-splines.
+
+    The energy, virial and virial tensor follow the conventions of
+    CoulombKSpaceEwald_ and are the same on all CPUs.
+
+References:
+
+.. [Essmann95] U. Essmann, L. Perera, M.L. Berkowitz, T. Darden, H. Lee, L.G. Pedersen, *J. Chem. Phys.*, 103(19), **1995**, p.8577
+
+.. function:: espressopp.interaction.CoulombKSpaceSPME(system, prefactor, alpha, mesh, order)
+
+		:param system:
+		:param prefactor:
+		:param alpha:
+		:param mesh:
+		:param order:
+		:type system:
+		:type prefactor: real
+		:type alpha: real
+		:type mesh: Int3D
+		:type order: int
+
+.. function:: espressopp.interaction.CellListCoulombKSpaceSPME(storage, potential)
+
+		:param storage:
+		:param potential:
+		:type storage:
+		:type potential:
+
+.. function:: espressopp.interaction.CellListCoulombKSpaceSPME.getPotential()
+
+		:rtype:
+"""
+
+
+from espressopp import pmi
+from espressopp.esutil import *
+from espressopp import toInt3DFromVector
+
+from espressopp.interaction.Potential import *
+from espressopp.interaction.Interaction import *
+from _espressopp import interaction_CoulombKSpaceSPME, \
+                      interaction_CellListCoulombKSpaceSPME
+
+class CoulombKSpaceSPMELocal(PotentialLocal, interaction_CoulombKSpaceSPME):
+    def __init__(self, system, prefactor, alpha, mesh, order):
+      if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+        cxxinit(self, interaction_CoulombKSpaceSPME, system, prefactor, alpha, toInt3DFromVector(mesh), order)
+
+class CellListCoulombKSpaceSPMELocal(InteractionLocal, interaction_CellListCoulombKSpaceSPME):
+    def __init__(self, storage, potential):
+      if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+        cxxinit(self, interaction_CellListCoulombKSpaceSPME, storage, potential)
+
+    def getPotential(self):
+      if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+        return self.cxxclass.getPotential(self)
+
+if pmi.isController:
+  class CoulombKSpaceSPME(Potential):
+    pmiproxydefs = dict(
+      cls = 'espressopp.interaction.CoulombKSpaceSPMELocal',
+      pmiproperty = ['prefactor', 'alpha', 'mesh', 'order']
+      )
+
+  class CellListCoulombKSpaceSPME(Interaction):
+    __metaclass__ = pmi.Proxy
+    pmiproxydefs = dict(
+      cls =  'espressopp.interaction.CellListCoulombKSpaceSPMELocal',
+      pmicall = ['getPotential']
+      )
@@ -40,6 +40,14 @@ namespace espressopp {
     public:
       virtual ~Interaction() {};
       virtual void addForces() = 0;
+
+      /** Force computation split for overlapping it with the ghost
+          communication (see VelocityVerlet.overlapCommunication).
+          addForcesReals(0) and addForcesReals(1) each add one half of
+          the forces that need real particles only, addForcesGhosts adds
+          all the others. The default does everything in addForcesGhosts. */
+      virtual void addForcesReals(int /*part*/) {}
+      virtual void addForcesGhosts() { addForces(); }
       virtual real computeEnergy() = 0;
       virtual real computeEnergyDeriv() = 0;
       virtual real computeEnergyAA() = 0;
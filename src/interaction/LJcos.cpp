@@ -22,6 +22,7 @@
 #include "LJcos.hpp"
 #include "Tabulated.hpp"
 #include "VerletListInteractionTemplate.hpp"
+#include "PackedVerletListBlockedInteractionTemplate.hpp"
 #include "VerletListAdressInteractionTemplate.hpp"
 #include "VerletListHadressInteractionTemplate.hpp"
 #include "CellListAllPairsInteractionTemplate.hpp"
@@ -32,6 +33,8 @@ namespace espressopp {
 		
 		typedef class VerletListInteractionTemplate <LJcos>
 		VerletListLJcos;
+		typedef class PackedVerletListBlockedInteractionTemplate <LJcos>
+		PackedVerletListLJcos;
 		typedef class VerletListAdressInteractionTemplate <LJcos, Tabulated>
 		VerletListAdressLJcos;
 		typedef class VerletListHadressInteractionTemplate <LJcos, Tabulated>
@@ -61,6 +64,13 @@ namespace espressopp {
 			.def("getPotential", &VerletListLJcos::getPotential, return_value_policy< reference_existing_object >())
 			;
 			
+			class_< PackedVerletListLJcos, bases< Interaction > >
+			("interaction_PackedVerletListLJcos", init< shared_ptr<PackedVerletList> >())
+			.def("getVerletList", &PackedVerletListLJcos::getVerletList)
+			.def("setPotential", &PackedVerletListLJcos::setPotential)
+			.def("getPotential", &PackedVerletListLJcos::getPotentialPtr)
+			;
+
 			class_< VerletListAdressLJcos, bases< Interaction > >
 			("interaction_VerletListAdressLJcos",
 			 init< shared_ptr<VerletListAdress>, shared_ptr<FixedTupleListAdress> >())
@@ -138,6 +138,29 @@ namespace espressopp {
             force = dist * ffactor;
             return true;
          }
+
+         /// parameters of the blocked kernel, see PackedVerletListBlockedInteractionTemplate
+         struct KernelParams {
+            real cutoffSqr;
+            real sqr_r_min, auxCoef, ff1, ff2;
+            real alpha, beta, alpha_phi;
+         };
+
+         KernelParams getKernelParams() const {
+            KernelParams p = { cutoffSqr, sqr_r_min, auxCoef, ff1, ff2, alpha, beta, alpha_phi };
+            return p;
+         }
+
+         /// branch-free force factor F/r for a vectorized loop, 0 beyond the cutoff
+         static real _computeForceFactor(const KernelParams &p, real distSqr) {
+            // evaluate both branches and select, so the loop can be vectorized
+            real frac2 = p.auxCoef / distSqr;
+            real frac6 = frac2 * frac2 * frac2;
+            real ffWCA = frac6 * (p.ff1 * frac6 - p.ff2) * frac2;
+            real ffCos = p.alpha_phi * sin(p.alpha * distSqr + p.beta);
+            real ffactor = (distSqr <= p.sqr_r_min) ? ffWCA : ffCos;
+            return (distSqr <= p.cutoffSqr) ? ffactor : 0.0;
+         }
       private:
          real phi;
          
@@ -71,6 +71,15 @@ else:
 		:type type2: 
 		:type potential: 
 
+.. function:: espressopp.interaction.PackedVerletListLJcos(vl)
+
+		Same as VerletListLJcos, but on a
+		:class:`espressopp.PackedVerletList`, with a blocked force
+		kernel that the compiler can vectorize (cmake option WITH_SIMD).
+
+		:param vl:
+		:type vl: espressopp.PackedVerletList
+
 .. function:: espressopp.interaction.VerletListAdressLJcos(vl, fixedtupleList)
 
 		:param vl: 
@@ -165,6 +174,7 @@ from espressopp.interaction.Potential import *
 from espressopp.interaction.Interaction import *
 from _espressopp import interaction_LJcos, \
                       interaction_VerletListLJcos, \
+                      interaction_PackedVerletListLJcos, \
                       interaction_VerletListAdressLJcos, \
                       interaction_VerletListHadressLJcos, \
                       interaction_CellListLJcos, \
@@ -195,6 +205,24 @@ class VerletListLJcosLocal(InteractionLocal, interaction_VerletListLJcos):
         if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
             return self.cxxclass.getVerletList(self)
 
+class PackedVerletListLJcosLocal(InteractionLocal, interaction_PackedVerletListLJcos):
+
+    def __init__(self, vl):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            cxxinit(self, interaction_PackedVerletListLJcos, vl)
+
+    def setPotential(self, type1, type2, potential):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            self.cxxclass.setPotential(self, type1, type2, potential)
+
+    def getPotential(self, type1, type2):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getPotential(self, type1, type2)
+
+    def getVerletListLocal(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getVerletList(self)
+
 class VerletListAdressLJcosLocal(InteractionLocal, interaction_VerletListAdressLJcos):
 
     def __init__(self, vl, fixedtupleList):
@@ -267,6 +295,13 @@ if pmi.isController:
             pmicall = ['setPotential', 'getPotential', 'getVerletList']
             )
 
+    class PackedVerletListLJcos(Interaction):
+        __metaclass__ = pmi.Proxy
+        pmiproxydefs = dict(
+            cls =  'espressopp.interaction.PackedVerletListLJcosLocal',
+            pmicall = ['setPotential', 'getPotential', 'getVerletList']
+            )
+
     class VerletListAdressLJcos(Interaction):
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
@@ -24,6 +24,8 @@
 #include "LennardJones.hpp"
 #include "Tabulated.hpp"
 #include "VerletListInteractionTemplate.hpp"
+#include "VerletListThreadedInteractionTemplate.hpp"
+#include "PackedVerletListBlockedInteractionTemplate.hpp"
 #include "VerletListAdressInteractionTemplate.hpp"
 #include "VerletListHadressInteractionTemplate.hpp"
 #include "CellListAllPairsInteractionTemplate.hpp"
@@ -35,6 +37,10 @@ namespace espressopp {
 
     typedef class VerletListInteractionTemplate <LennardJones>
         VerletListLennardJones;
+    typedef class VerletListThreadedInteractionTemplate <LennardJones>
+        VerletListThreadedLennardJones;
+    typedef class PackedVerletListBlockedInteractionTemplate <LennardJones>
+        PackedVerletListLennardJones;
     typedef class VerletListAdressInteractionTemplate <LennardJones, Tabulated>
         VerletListAdressLennardJones;
     typedef class VerletListAdressInteractionTemplate <LennardJones, LennardJones>
@@ -75,6 +81,22 @@ namespace espressopp {
         .def("getPotential", &VerletListLennardJones::getPotentialPtr)
       ;
 
+      class_< VerletListThreadedLennardJones, bases< Interaction > >
+        ("interaction_VerletListThreadedLennardJones", init< shared_ptr<VerletList> >())
+        .def("getVerletList", &VerletListThreadedLennardJones::getVerletList)
+        .def("setPotential", &VerletListThreadedLennardJones::setPotential)
+        .def("getPotential", &VerletListThreadedLennardJones::getPotentialPtr)
+        .add_property("numThreads", &VerletListThreadedLennardJones::getNumThreads,
+                      &VerletListThreadedLennardJones::setNumThreads)
+      ;
+
+      class_< PackedVerletListLennardJones, bases< Interaction > >
+        ("interaction_PackedVerletListLennardJones", init< shared_ptr<PackedVerletList> >())
+        .def("getVerletList", &PackedVerletListLennardJones::getVerletList)
+        .def("setPotential", &PackedVerletListLennardJones::setPotential)
+        .def("getPotential", &PackedVerletListLennardJones::getPotentialPtr)
+      ;
+
       class_< VerletListAdressLennardJones, bases< Interaction > >
         ("interaction_VerletListAdressLennardJones",
            init< shared_ptr<VerletListAdress>,
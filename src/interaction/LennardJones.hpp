@@ -167,6 +167,26 @@ namespace espressopp {
           
           }*/
       }
+
+      /// parameters of the blocked kernel, see PackedVerletListBlockedInteractionTemplate
+      struct KernelParams {
+        real cutoffSqr;
+        real ff1, ff2;
+      };
+
+      KernelParams getKernelParams() const {
+        KernelParams p = { cutoffSqr, ff1, ff2 };
+        return p;
+      }
+
+      /// branch-free force factor F/r for a vectorized loop, 0 beyond the cutoff
+      static real _computeForceFactor(const KernelParams &p, real distSqr) {
+        real frac2 = 1.0 / distSqr;
+        real frac6 = frac2 * frac2 * frac2;
+        real ffactor = frac6 * (p.ff1 * frac6 - p.ff2) * frac2;
+        return (distSqr <= p.cutoffSqr) ? ffactor : 0.0;
+      }
+
       static LOG4ESPP_DECL_LOGGER(theLogger);
     };
 
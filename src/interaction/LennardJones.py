@@ -71,6 +71,34 @@ espressopp.interaction.LennardJones
 		:type type2:
 		:type potential:
 
+.. function:: espressopp.interaction.VerletListThreadedLennardJones(vl)
+
+		Same as VerletListLennardJones, but the pair loop is split over
+		OpenMP threads (hybrid MPI + threads). Each thread sums its forces
+		into a private buffer, which avoids write races. Requires a
+		DomainDecomposition storage, whose particle arrays are enabled
+		automatically. Without the cmake option WITH_OPENMP it runs on
+		one thread.
+
+		:param vl:
+		:type vl:
+
+.. attribute:: espressopp.interaction.VerletListThreadedLennardJones.numThreads
+
+		Number of threads for the pair loop; 0 (default) uses the OpenMP
+		default, e.g. from OMP_NUM_THREADS.
+
+		:type: int
+
+.. function:: espressopp.interaction.PackedVerletListLennardJones(vl)
+
+		Same as VerletListLennardJones, but on a
+		:class:`espressopp.PackedVerletList`, whose compact neighbor
+		index list halves the memory traffic of the pair loop.
+
+		:param vl:
+		:type vl: espressopp.PackedVerletList
+
 .. function:: espressopp.interaction.VerletListAdressLennardJones(vl, fixedtupleList)
 
 		:param vl:
@@ -219,6 +247,8 @@ from espressopp.interaction.Potential import *
 from espressopp.interaction.Interaction import *
 from _espressopp import interaction_LennardJones, \
                       interaction_VerletListLennardJones, \
+                      interaction_VerletListThreadedLennardJones, \
+                      interaction_PackedVerletListLennardJones, \
                       interaction_VerletListAdressLennardJones, \
                       interaction_VerletListAdressLennardJones2, \
                       interaction_VerletListHadressLennardJones, \
@@ -258,6 +288,42 @@ class VerletListLennardJonesLocal(InteractionLocal, interaction_VerletListLennar
         if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
             return self.cxxclass.getVerletList(self)
 
+class VerletListThreadedLennardJonesLocal(InteractionLocal, interaction_VerletListThreadedLennardJones):
+
+    def __init__(self, vl):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            cxxinit(self, interaction_VerletListThreadedLennardJones, vl)
+
+    def setPotential(self, type1, type2, potential):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            self.cxxclass.setPotential(self, type1, type2, potential)
+
+    def getPotential(self, type1, type2):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getPotential(self, type1, type2)
+
+    def getVerletListLocal(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getVerletList(self)
+
+class PackedVerletListLennardJonesLocal(InteractionLocal, interaction_PackedVerletListLennardJones):
+
+    def __init__(self, vl):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            cxxinit(self, interaction_PackedVerletListLennardJones, vl)
+
+    def setPotential(self, type1, type2, potential):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            self.cxxclass.setPotential(self, type1, type2, potential)
+
+    def getPotential(self, type1, type2):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getPotential(self, type1, type2)
+
+    def getVerletListLocal(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getVerletList(self)
+
 class VerletListAdressLennardJonesLocal(InteractionLocal, interaction_VerletListAdressLennardJones):
 
     def __init__(self, vl, fixedtupleList):
@@ -383,6 +449,21 @@ if pmi.isController:
             pmicall = ['setPotential', 'getPotential', 'getVerletList']
             )
 
+    class VerletListThreadedLennardJones(Interaction):
+        __metaclass__ = pmi.Proxy
+        pmiproxydefs = dict(
+            cls =  'espressopp.interaction.VerletListThreadedLennardJonesLocal',
+            pmicall = ['setPotential', 'getPotential', 'getVerletList'],
+            pmiproperty = ['numThreads']
+            )
+
+    class PackedVerletListLennardJones(Interaction):
+        __metaclass__ = pmi.Proxy
+        pmiproxydefs = dict(
+            cls =  'espressopp.interaction.PackedVerletListLennardJonesLocal',
+            pmicall = ['setPotential', 'getPotential', 'getVerletList']
+            )
+
     class VerletListAdressLennardJones(Interaction):
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
@@ -24,6 +24,7 @@
 #include "LennardJonesGeneric.hpp"
 #include "Tabulated.hpp"
 #include "VerletListInteractionTemplate.hpp"
+#include "PackedVerletListBlockedInteractionTemplate.hpp"
 #include "VerletListAdressInteractionTemplate.hpp"
 #include "VerletListHadressInteractionTemplate.hpp"
 #include "CellListAllPairsInteractionTemplate.hpp"
@@ -34,6 +35,8 @@ namespace espressopp {
 
     typedef class VerletListInteractionTemplate <LennardJonesGeneric>
         VerletListLennardJonesGeneric;
+    typedef class PackedVerletListBlockedInteractionTemplate <LennardJonesGeneric>
+        PackedVerletListLennardJonesGeneric;
     typedef class VerletListAdressInteractionTemplate <LennardJonesGeneric, Tabulated>
         VerletListAdressLennardJonesGeneric;
     typedef class VerletListAdressInteractionTemplate <LennardJonesGeneric, LennardJonesGeneric>
@@ -72,6 +75,13 @@ namespace espressopp {
         .def("getPotential", &VerletListLennardJonesGeneric::getPotentialPtr)
       ;
 
+      class_< PackedVerletListLennardJonesGeneric, bases< Interaction > >
+        ("interaction_PackedVerletListLennardJonesGeneric", init< shared_ptr<PackedVerletList> >())
+        .def("getVerletList", &PackedVerletListLennardJonesGeneric::getVerletList)
+        .def("setPotential", &PackedVerletListLennardJonesGeneric::setPotential)
+        .def("getPotential", &PackedVerletListLennardJonesGeneric::getPotentialPtr)
+      ;
+
       class_< VerletListAdressLennardJonesGeneric, bases< Interaction > >
         ("interaction_VerletListAdressLennardJonesGeneric",
            init< shared_ptr<VerletListAdress>,
@@ -133,6 +133,26 @@ namespace espressopp {
         return true;
       }
 
+      /// parameters of the blocked kernel, see PackedVerletListBlockedInteractionTemplate
+      struct KernelParams {
+        real cutoffSqr;
+        real ff1, ff2;
+        real halfA, halfB; // (a+2)/2 and (b+2)/2, the exponents of 1/r^2
+      };
+
+      KernelParams getKernelParams() const {
+        KernelParams p = { cutoffSqr, 4.0 * epsilon * ff1, 4.0 * epsilon * ff2,
+                           0.5 * (a + 2), 0.5 * (b + 2) };
+        return p;
+      }
+
+      /// branch-free force factor F/r for a vectorized loop, 0 beyond the cutoff
+      static real _computeForceFactor(const KernelParams &p, real distSqr) {
+        real logInv = -log(distSqr);
+        real ffactor = p.ff1 * exp(p.halfA * logInv) - p.ff2 * exp(p.halfB * logInv);
+        return (distSqr <= p.cutoffSqr) ? ffactor : 0.0;
+      }
+
       static LOG4ESPP_DECL_LOGGER(theLogger);
     };
 
@@ -78,6 +78,15 @@ a generic Lennard Jones potential with arbitrary integers a and b.
 		:type type2: 
 		:type potential: 
 
+.. function:: espressopp.interaction.PackedVerletListLennardJonesGeneric(vl)
+
+		Same as VerletListLennardJonesGeneric, but on a
+		:class:`espressopp.PackedVerletList`, with a blocked force
+		kernel that the compiler can vectorize (cmake option WITH_SIMD).
+
+		:param vl:
+		:type vl: espressopp.PackedVerletList
+
 .. function:: espressopp.interaction.VerletListAdressLennardJonesGeneric(vl, fixedtupleList)
 
 		:param vl: 
@@ -228,6 +237,7 @@ from espressopp.interaction.Potential import *
 from espressopp.interaction.Interaction import *
 from _espressopp import interaction_LennardJonesGeneric, \
                       interaction_VerletListLennardJonesGeneric, \
+                      interaction_PackedVerletListLennardJonesGeneric, \
                       interaction_VerletListAdressLennardJonesGeneric, \
                       interaction_VerletListAdressLennardJonesGeneric2, \
                       interaction_VerletListHadressLennardJonesGeneric, \
@@ -268,6 +278,24 @@ class VerletListLennardJonesGenericLocal(InteractionLocal, interaction_VerletLis
         if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
             return self.cxxclass.getVerletList(self)
 
+class PackedVerletListLennardJonesGenericLocal(InteractionLocal, interaction_PackedVerletListLennardJonesGeneric):
+
+    def __init__(self, vl):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            cxxinit(self, interaction_PackedVerletListLennardJonesGeneric, vl)
+
+    def setPotential(self, type1, type2, potential):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            self.cxxclass.setPotential(self, type1, type2, potential)
+
+    def getPotential(self, type1, type2):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getPotential(self, type1, type2)
+
+    def getVerletListLocal(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getVerletList(self)
+
 class VerletListAdressLennardJonesGenericLocal(InteractionLocal, interaction_VerletListAdressLennardJonesGeneric):
 
     def __init__(self, vl, fixedtupleList):
@@ -372,6 +400,13 @@ if pmi.isController:
             pmicall = ['setPotential', 'getPotential', 'getVerletList']
             )
 
+    class PackedVerletListLennardJonesGeneric(Interaction):
+        __metaclass__ = pmi.Proxy
+        pmiproxydefs = dict(
+            cls =  'espressopp.interaction.PackedVerletListLennardJonesGenericLocal',
+            pmicall = ['setPotential', 'getPotential', 'getVerletList']
+            )
+
     class VerletListAdressLennardJonesGeneric(Interaction):
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
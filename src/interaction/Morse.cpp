@@ -24,6 +24,7 @@
 #include "Morse.hpp"
 #include "Tabulated.hpp"
 #include "VerletListInteractionTemplate.hpp"
+#include "PackedVerletListBlockedInteractionTemplate.hpp"
 #include "VerletListAdressInteractionTemplate.hpp"
 #include "VerletListHadressInteractionTemplate.hpp"
 #include "CellListAllPairsInteractionTemplate.hpp"
@@ -33,6 +34,8 @@ namespace espressopp {
   namespace interaction {
     typedef class VerletListInteractionTemplate< Morse >
     VerletListMorse;
+    typedef class PackedVerletListBlockedInteractionTemplate< Morse >
+    PackedVerletListMorse;
     typedef class VerletListAdressInteractionTemplate< Morse, Tabulated >
     VerletListAdressMorse;
     typedef class VerletListHadressInteractionTemplate< Morse, Tabulated >
@@ -64,6 +67,13 @@ namespace espressopp {
         .def("getPotential", &VerletListMorse::getPotentialPtr)
       ;
 
+      class_< PackedVerletListMorse, bases< Interaction > >
+        ("interaction_PackedVerletListMorse", init< shared_ptr<PackedVerletList> >())
+        .def("getVerletList", &PackedVerletListMorse::getVerletList)
+        .def("setPotential", &PackedVerletListMorse::setPotential)
+        .def("getPotential", &PackedVerletListMorse::getPotentialPtr)
+      ;
+
       class_< VerletListAdressMorse, bases< Interaction > >
         ("interaction_VerletListAdressMorse",
                 init< shared_ptr<VerletListAdress>, shared_ptr<FixedTupleListAdress> >())
@@ -97,6 +97,25 @@ namespace espressopp {
         force = dist * ffactor;
         return true;
       }
+
+      /// parameters of the blocked kernel, see PackedVerletListBlockedInteractionTemplate
+      struct KernelParams {
+        real cutoffSqr;
+        real epsilon, alpha, rMin;
+      };
+
+      KernelParams getKernelParams() const {
+        KernelParams p = { cutoffSqr, epsilon, alpha, rMin };
+        return p;
+      }
+
+      /// branch-free force factor F/r for a vectorized loop, 0 beyond the cutoff
+      static real _computeForceFactor(const KernelParams &p, real distSqr) {
+        real r = sqrt(distSqr);
+        real e1 = exp(-p.alpha * (r - p.rMin));
+        real ffactor = 2.0 * p.epsilon * p.alpha * (e1 * e1 - e1) / r;
+        return (distSqr <= p.cutoffSqr) ? ffactor : 0.0;
+      }
     };
 
     // provide pickle support
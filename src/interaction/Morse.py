@@ -71,6 +71,15 @@ the Morse potential.
 		:type type2: 
 		:type potential: 
 
+.. function:: espressopp.interaction.PackedVerletListMorse(vl)
+
+		Same as VerletListMorse, but on a
+		:class:`espressopp.PackedVerletList`, with a blocked force
+		kernel that the compiler can vectorize (cmake option WITH_SIMD).
+
+		:param vl:
+		:type vl: espressopp.PackedVerletList
+
 .. function:: espressopp.interaction.VerletListAdressMorse(vl, fixedtupleList)
 
 		:param vl: 
@@ -156,6 +165,7 @@ from espressopp.interaction.Potential import *
 from espressopp.interaction.Interaction import *
 from _espressopp import interaction_Morse, \
                       interaction_VerletListMorse, \
+                      interaction_PackedVerletListMorse, \
                       interaction_VerletListAdressMorse, \
                       interaction_VerletListHadressMorse, \
                       interaction_CellListMorse, \
@@ -188,6 +198,24 @@ class VerletListMorseLocal(InteractionLocal, interaction_VerletListMorse):
         if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
             return self.cxxclass.getPotential(self, type1, type2)
         
+class PackedVerletListMorseLocal(InteractionLocal, interaction_PackedVerletListMorse):
+
+    def __init__(self, vl):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            cxxinit(self, interaction_PackedVerletListMorse, vl)
+
+    def setPotential(self, type1, type2, potential):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            self.cxxclass.setPotential(self, type1, type2, potential)
+
+    def getPotential(self, type1, type2):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getPotential(self, type1, type2)
+
+    def getVerletListLocal(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getVerletList(self)
+
 class VerletListAdressMorseLocal(InteractionLocal, interaction_VerletListAdressMorse):
 
     def __init__(self, vl, fixedtupleList):
@@ -251,6 +279,13 @@ if pmi.isController:
             pmicall = ['setPotential','getPotential']
             )
 
+    class PackedVerletListMorse(Interaction):
+        __metaclass__ = pmi.Proxy
+        pmiproxydefs = dict(
+            cls =  'espressopp.interaction.PackedVerletListMorseLocal',
+            pmicall = ['setPotential', 'getPotential', 'getVerletList']
+            )
+
     class VerletListAdressMorse(Interaction):
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
@@ -0,0 +1,176 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _INTERACTION_PACKEDVERLETLISTBLOCKEDINTERACTIONTEMPLATE_HPP
+#define _INTERACTION_PACKEDVERLETLISTBLOCKEDINTERACTIONTEMPLATE_HPP
+
+#include "PackedVerletListInteractionTemplate.hpp"
+
+namespace espressopp {
+  namespace interaction {
+    /** PackedVerletList interaction with a blocked force kernel.
+
+        The neighbors of a row particle are processed in blocks: the
+        distance vectors and potential parameters are first gathered into
+        small local arrays, the force factors are then computed in a loop
+        without branches or calls through the potential table, which the
+        compiler vectorizes (see the cmake option WITH_SIMD), and the
+        neighbor forces are finally scattered back to the force arrays.
+        Without vectorization the same loops run as plain scalar code.
+
+        The potential has to provide a KernelParams struct, a const
+        getKernelParams() and a static, branch-free
+        _computeForceFactor(const KernelParams&, real distSqr) that returns
+        F/r and 0 beyond the cutoff. Energies and virials are computed by
+        the scalar loops of the base class.
+    */
+    template < typename _Potential >
+    class PackedVerletListBlockedInteractionTemplate
+      : public PackedVerletListInteractionTemplate< _Potential > {
+
+    protected:
+      typedef _Potential Potential;
+      typedef typename _Potential::KernelParams KernelParams;
+      typedef PackedVerletListInteractionTemplate< _Potential > Super;
+
+      /// number of pairs gathered into one block
+      static const int blockSize = 64;
+
+    public:
+      PackedVerletListBlockedInteractionTemplate(shared_ptr< PackedVerletList > _verletList)
+        : Super(_verletList), noneParams(Potential().getKernelParams()),
+          paramTableValid(false) {
+        // types without a potential are mapped to this entry
+        noneParams.cutoffSqr = -1.0;
+      }
+
+      virtual ~PackedVerletListBlockedInteractionTemplate() {};
+
+      /// also marks the kernel parameters for an update before the next addForces
+      void setPotential(int type1, int type2, const Potential &potential) {
+        Super::setPotential(type1, type2, potential);
+        paramTableValid = false;
+      }
+
+      virtual void addForces();
+
+    protected:
+      /// kernel parameters of all type pairs, plus one entry that never interacts,
+      /// rebuilt only after setPotential
+      void updateParamTable();
+
+      KernelParams noneParams;
+      bool paramTableValid;
+      std::vector< KernelParams > paramTable;
+    };
+
+    //////////////////////////////////////////////////
+    // INLINE IMPLEMENTATION
+    //////////////////////////////////////////////////
+    template < typename _Potential > inline void
+    PackedVerletListBlockedInteractionTemplate < _Potential >::
+    updateParamTable() {
+      int ntypes = this->ntypes;
+      if (paramTableValid && paramTable.size() == size_t(ntypes * ntypes + 1))
+        return;
+
+      paramTable.resize(ntypes * ntypes + 1);
+      for (int t1 = 0; t1 < ntypes; ++t1) {
+        for (int t2 = 0; t2 < ntypes; ++t2) {
+          paramTable[t1 * ntypes + t2] = this->getPotential(t1, t2).getKernelParams();
+        }
+      }
+      paramTable[ntypes * ntypes] = noneParams;
+      paramTableValid = true;
+    }
+
+    template < typename _Potential > inline void
+    PackedVerletListBlockedInteractionTemplate < _Potential >::
+    addForces() {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over packed verlet list and add forces in blocks");
+
+      storage::ParticleArrays &pa = this->verletList->getSystem()->storage->getParticleArrays();
+      pa.clearForces();
+      updateParamTable();
+
+      const int ntypes = this->ntypes;
+      const int noneIdx = ntypes * ntypes;
+      const KernelParams *params = paramTable.data();
+      const std::vector< longint > &offsets = this->verletList->getOffsets();
+      const int *nb = this->verletList->getNeighbors().data();
+      const longint nrows = offsets.size() - 1;
+      const real *x = pa.x.data(), *y = pa.y.data(), *z = pa.z.data();
+      const int *type = pa.type.data();
+      real *fx = pa.fx.data(), *fy = pa.fy.data(), *fz = pa.fz.data();
+
+      real dx[blockSize], dy[blockSize], dz[blockSize], ff[blockSize];
+      int pidx[blockSize];
+
+      for (longint i = 0; i < nrows; ++i) {
+        const int ti = type[i];
+        if (ti >= ntypes) continue;
+        const int rowIdx = ti * ntypes;
+        const real xi = x[i], yi = y[i], zi = z[i];
+        real fxi = 0.0, fyi = 0.0, fzi = 0.0;
+
+        for (longint kb = offsets[i], kend = offsets[i + 1]; kb < kend; kb += blockSize) {
+          const int n = std::min(longint(blockSize), kend - kb);
+          const int *nbb = nb + kb;
+
+          // gather
+          for (int l = 0; l < n; ++l) {
+            const int j = nbb[l];
+            dx[l] = xi - x[j];
+            dy[l] = yi - y[j];
+            dz[l] = zi - z[j];
+            pidx[l] = (type[j] < ntypes) ? rowIdx + type[j] : noneIdx;
+          }
+
+          // compute
+          #pragma omp simd reduction(+:fxi,fyi,fzi)
+          for (int l = 0; l < n; ++l) {
+            const real distSqr = dx[l] * dx[l] + dy[l] * dy[l] + dz[l] * dz[l];
+            const real f = Potential::_computeForceFactor(params[pidx[l]], distSqr);
+            ff[l] = f;
+            fxi += f * dx[l];
+            fyi += f * dy[l];
+            fzi += f * dz[l];
+          }
+
+          // scatter
+          for (int l = 0; l < n; ++l) {
+            const int j = nbb[l];
+            fx[j] -= ff[l] * dx[l];
+            fy[j] -= ff[l] * dy[l];
+            fz[j] -= ff[l] * dz[l];
+          }
+        }
+
+        fx[i] += fxi;
+        fy[i] += fyi;
+        fz[i] += fzi;
+      }
+
+      pa.addForcesToParticles();
+    }
+  }
+}
+#endif
@@ -0,0 +1,466 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _INTERACTION_PACKEDVERLETLISTINTERACTIONTEMPLATE_HPP
+#define _INTERACTION_PACKEDVERLETLISTINTERACTIONTEMPLATE_HPP
+
+#include "types.hpp"
+#include "Interaction.hpp"
+#include "Real3D.hpp"
+#include "Tensor.hpp"
+#include "PackedVerletList.hpp"
+#include "esutil/Array2D.hpp"
+
+#include "storage/Storage.hpp"
+#include "storage/ParticleArrays.hpp"
+
+namespace espressopp {
+  namespace interaction {
+    /** Pair interaction over a PackedVerletList.
+
+        The loop runs over the rows of the packed list. Position, type and
+        accumulated force of the row particle stay in local variables for
+        all its neighbors, and only the neighbor forces are written to the
+        force arrays of the ParticleArrays, which are added to the
+        particles at the end.
+
+        Only potentials whose force depends on the distance vector alone
+        can be used here. Type pairs without a potential do not interact.
+    */
+    template < typename _Potential >
+    class PackedVerletListInteractionTemplate: public Interaction {
+
+    protected:
+      typedef _Potential Potential;
+
+    public:
+      PackedVerletListInteractionTemplate
+          (shared_ptr< PackedVerletList > _verletList)
+          : verletList(_verletList) {
+        potentialArray = esutil::Array2D<Potential, esutil::enlarge>(0, 0, Potential());
+        ntypes = 0;
+      }
+
+      virtual ~PackedVerletListInteractionTemplate() {};
+
+      void
+      setVerletList(shared_ptr< PackedVerletList > _verletList) {
+        verletList = _verletList;
+      }
+
+      shared_ptr< PackedVerletList > getVerletList() {
+        return verletList;
+      }
+
+      void
+      setPotential(int type1, int type2, const Potential &potential) {
+        // typeX+1 because i<ntypes
+        ntypes = std::max(ntypes, std::max(type1+1, type2+1));
+        potentialArray.at(type1, type2) = potential;
+        LOG4ESPP_INFO(_Potential::theLogger, "added potential for type1=" << type1 << " type2=" << type2);
+        if (type1 != type2) { // add potential in the other direction
+           potentialArray.at(type2, type1) = potential;
+           LOG4ESPP_INFO(_Potential::theLogger, "automatically added the same potential for type1=" << type2 << " type2=" << type1);
+        }
+      }
+
+      Potential &getPotential(int type1, int type2) {
+        return potentialArray.at(type1, type2);
+      }
+
+      // this is mainly used to access the potential from Python (e.g. to change parameters of the potential)
+      shared_ptr<Potential> getPotentialPtr(int type1, int type2) {
+        return make_shared<Potential>(potentialArray.at(type1, type2));
+      }
+
+      virtual void addForces();
+      virtual real computeEnergy();
+      virtual real computeEnergyDeriv();
+      virtual real computeEnergyAA();
+      virtual real computeEnergyCG();
+      virtual void computeVirialX(std::vector<real> &p_xx_total, int bins);
+      virtual real computeVirial();
+      virtual void computeVirialTensor(Tensor& w);
+      virtual void computeVirialTensor(Tensor& w, real z);
+      virtual void computeVirialTensor(Tensor *w, int n);
+      virtual real getMaxCutoff();
+      virtual int bondType() { return Nonbonded; }
+
+    protected:
+      /// resolve the potentials of all type pairs into a flat row-major table
+      void updatePotentialTable();
+
+      int ntypes;
+      shared_ptr< PackedVerletList > verletList;
+      esutil::Array2D<Potential, esutil::enlarge> potentialArray;
+      std::vector< const Potential* > potentialTable;
+    };
+
+    //////////////////////////////////////////////////
+    // INLINE IMPLEMENTATION
+    //////////////////////////////////////////////////
+    template < typename _Potential > inline void
+    PackedVerletListInteractionTemplate < _Potential >::
+    updatePotentialTable() {
+      potentialTable.resize(ntypes * ntypes);
+      for (int t1 = 0; t1 < ntypes; ++t1) {
+        for (int t2 = 0; t2 < ntypes; ++t2) {
+          potentialTable[t1 * ntypes + t2] = &getPotential(t1, t2);
+        }
+      }
+    }
+
+    template < typename _Potential > inline void
+    PackedVerletListInteractionTemplate < _Potential >::
+    addForces() {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over packed verlet list and add forces");
+
+      storage::ParticleArrays &pa = verletList->getSystem()->storage->getParticleArrays();
+      pa.clearForces();
+      updatePotentialTable();
+
+      const std::vector< longint > &offsets = verletList->getOffsets();
+      const int *nb = verletList->getNeighbors().data();
+      const longint nrows = offsets.size() - 1;
+      const real *x = pa.x.data(), *y = pa.y.data(), *z = pa.z.data();
+      const int *type = pa.type.data();
+      real *fx = pa.fx.data(), *fy = pa.fy.data(), *fz = pa.fz.data();
+
+      for (longint i = 0; i < nrows; ++i) {
+        const int ti = type[i];
+        if (ti >= ntypes) continue;
+        const Potential * const *row = &potentialTable[ti * ntypes];
+        const real xi = x[i], yi = y[i], zi = z[i];
+        real fxi = 0.0, fyi = 0.0, fzi = 0.0;
+
+        for (longint k = offsets[i], kend = offsets[i + 1]; k < kend; ++k) {
+          const int j = nb[k];
+          if (type[j] >= ntypes) continue;
+          Real3D dist(xi - x[j], yi - y[j], zi - z[j]);
+          Real3D force;
+          if (row[type[j]]->_computeForce(force, dist)) {
+            fxi += force[0];
+            fyi += force[1];
+            fzi += force[2];
+            fx[j] -= force[0];
+            fy[j] -= force[1];
+            fz[j] -= force[2];
+          }
+        }
+
+        fx[i] += fxi;
+        fy[i] += fyi;
+        fz[i] += fzi;
+      }
+
+      pa.addForcesToParticles();
+    }
+
+    template < typename _Potential > inline real
+    PackedVerletListInteractionTemplate < _Potential >::
+    computeEnergy() {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over packed verlet list and sum up potential energies");
+
+      storage::ParticleArrays &pa = verletList->getSystem()->storage->getParticleArrays();
+      pa.updatePositions();
+      updatePotentialTable();
+
+      const std::vector< longint > &offsets = verletList->getOffsets();
+      const int *nb = verletList->getNeighbors().data();
+      const longint nrows = offsets.size() - 1;
+      const real *x = pa.x.data(), *y = pa.y.data(), *z = pa.z.data();
+      const int *type = pa.type.data();
+
+      real es = 0.0;
+      for (longint i = 0; i < nrows; ++i) {
+        const int ti = type[i];
+        if (ti >= ntypes) continue;
+        const Potential * const *row = &potentialTable[ti * ntypes];
+        const real xi = x[i], yi = y[i], zi = z[i];
+        for (longint k = offsets[i], kend = offsets[i + 1]; k < kend; ++k) {
+          const int j = nb[k];
+          if (type[j] >= ntypes) continue;
+          Real3D dist(xi - x[j], yi - y[j], zi - z[j]);
+          es += row[type[j]]->_computeEnergy(dist);
+        }
+      }
+
+      // reduce over all CPUs
+      real esum;
+      boost::mpi::all_reduce(*verletList->getSystem()->comm, es, esum, std::plus<real>());
+      return esum;
+    }
+
+    template < typename _Potential > inline real
+    PackedVerletListInteractionTemplate < _Potential >::
+    computeEnergyDeriv() {
+      LOG4ESPP_WARN(_Potential::theLogger, "Warning! computeEnergyDeriv() is not yet implemented.");
+      return 0.0;
+    }
+
+    template < typename _Potential > inline real
+    PackedVerletListInteractionTemplate < _Potential >::
+    computeEnergyAA() {
+      LOG4ESPP_WARN(_Potential::theLogger, "Warning! computeEnergyAA() is not yet implemented.");
+      return 0.0;
+    }
+
+    template < typename _Potential > inline real
+    PackedVerletListInteractionTemplate < _Potential >::
+    computeEnergyCG() {
+      LOG4ESPP_WARN(_Potential::theLogger, "Warning! computeEnergyCG() is not yet implemented.");
+      return 0.0;
+    }
+
+    template < typename _Potential > inline void
+    PackedVerletListInteractionTemplate < _Potential >::
+    computeVirialX(std::vector<real> &p_xx_total, int bins) {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over packed verlet list and sum up p_xx in slabs along x");
+
+      Real3D Li = verletList->getSystemRef().bc->getBoxL();
+      real Delta_x = Li[0] / real(bins);
+      real Volume = Li[1] * Li[2] * Delta_x;
+
+      storage::ParticleArrays &pa = verletList->getSystem()->storage->getParticleArrays();
+      pa.updatePositions();
+      updatePotentialTable();
+
+      const std::vector< longint > &offsets = verletList->getOffsets();
+      const int *nb = verletList->getNeighbors().data();
+      const longint nrows = offsets.size() - 1;
+      const real *x = pa.x.data(), *y = pa.y.data(), *z = pa.z.data();
+      const int *type = pa.type.data();
+
+      // half of the virial of a pair goes to the slab of each particle,
+      // ghosts outside the box are folded back into it
+      std::vector< real > p_xx_local(bins, 0.0);
+      for (longint i = 0; i < nrows; ++i) {
+        const int ti = type[i];
+        if (ti >= ntypes) continue;
+        const Potential * const *row = &potentialTable[ti * ntypes];
+        const real xi = x[i], yi = y[i], zi = z[i];
+        for (longint k = offsets[i], kend = offsets[i + 1]; k < kend; ++k) {
+          const int j = nb[k];
+          if (type[j] >= ntypes) continue;
+          Real3D dist(xi - x[j], yi - y[j], zi - z[j]);
+          Real3D force;
+          if (!row[type[j]]->_computeForce(force, dist)) continue;
+          real vir_temp = 0.5 * dist[0] * force[0];
+
+          int bin1 = (int)floor((xi - floor(xi / Li[0]) * Li[0]) / Delta_x);
+          int bin2 = (int)floor((x[j] - floor(x[j] / Li[0]) * Li[0]) / Delta_x);
+          p_xx_local[std::max(0, std::min(bin1, bins - 1))] += vir_temp;
+          p_xx_local[std::max(0, std::min(bin2, bins - 1))] += vir_temp;
+        }
+      }
+
+      // reduce over all CPUs
+      std::vector< real > p_xx_sum(bins, 0.0);
+      boost::mpi::all_reduce(*mpiWorld, p_xx_local.data(), bins, p_xx_sum.data(), std::plus<real>());
+      for (int b = 0; b < bins; ++b) {
+        p_xx_total[b] += p_xx_sum[b] / Volume;
+      }
+    }
+
+    template < typename _Potential > inline real
+    PackedVerletListInteractionTemplate < _Potential >::
+    computeVirial() {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over packed verlet list and sum up virial");
+
+      Tensor w(0.0);
+      computeVirialTensor(w);
+      return w[0] + w[1] + w[2];
+    }
+
+    template < typename _Potential > inline void
+    PackedVerletListInteractionTemplate < _Potential >::
+    computeVirialTensor(Tensor& w) {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over packed verlet list and sum up virial tensor");
+
+      storage::ParticleArrays &pa = verletList->getSystem()->storage->getParticleArrays();
+      pa.updatePositions();
+      updatePotentialTable();
+
+      const std::vector< longint > &offsets = verletList->getOffsets();
+      const int *nb = verletList->getNeighbors().data();
+      const longint nrows = offsets.size() - 1;
+      const real *x = pa.x.data(), *y = pa.y.data(), *z = pa.z.data();
+      const int *type = pa.type.data();
+
+      Tensor wlocal(0.0);
+      for (longint i = 0; i < nrows; ++i) {
+        const int ti = type[i];
+        if (ti >= ntypes) continue;
+        const Potential * const *row = &potentialTable[ti * ntypes];
+        const real xi = x[i], yi = y[i], zi = z[i];
+        for (longint k = offsets[i], kend = offsets[i + 1]; k < kend; ++k) {
+          const int j = nb[k];
+          if (type[j] >= ntypes) continue;
+          Real3D dist(xi - x[j], yi - y[j], zi - z[j]);
+          Real3D force;
+          if (row[type[j]]->_computeForce(force, dist)) {
+            wlocal += Tensor(dist, force);
+          }
+        }
+      }
+
+      // reduce over all CPUs
+      Tensor wsum(0.0);
+      boost::mpi::all_reduce(*mpiWorld, (double*)&wlocal, 6, (double*)&wsum, std::plus<double>());
+      w += wsum;
+    }
+
+    template < typename _Potential > inline void
+    PackedVerletListInteractionTemplate < _Potential >::
+    computeVirialTensor(Tensor& w, real z) {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over packed verlet list and sum up virial tensor over one z-layer");
+
+      Real3D Li = verletList->getSystemRef().bc->getBoxL();
+      real rc_cutoff = verletList->getVerletCutoff();
+
+      // boundaries should be taken into account
+      bool ghost_layer = false;
+      real zghost = -100.0;
+      if (z < rc_cutoff) {
+        zghost = z + Li[2];
+        ghost_layer = true;
+      } else if (z >= Li[2] - rc_cutoff) {
+        zghost = z - Li[2];
+        ghost_layer = true;
+      }
+
+      storage::ParticleArrays &pa = verletList->getSystem()->storage->getParticleArrays();
+      pa.updatePositions();
+      updatePotentialTable();
+
+      const std::vector< longint > &offsets = verletList->getOffsets();
+      const int *nb = verletList->getNeighbors().data();
+      const longint nrows = offsets.size() - 1;
+      const real *x = pa.x.data(), *y = pa.y.data(), *zp = pa.z.data();
+      const int *type = pa.type.data();
+
+      Tensor wlocal(0.0);
+      for (longint i = 0; i < nrows; ++i) {
+        const int ti = type[i];
+        if (ti >= ntypes) continue;
+        const Potential * const *row = &potentialTable[ti * ntypes];
+        const real xi = x[i], yi = y[i], zi = zp[i];
+        for (longint k = offsets[i], kend = offsets[i + 1]; k < kend; ++k) {
+          const int j = nb[k];
+          if (type[j] >= ntypes) continue;
+          const real zj = zp[j];
+          if ((zi > z && zj < z) || (zi < z && zj > z) ||
+              (ghost_layer && ((zi > zghost && zj < zghost) || (zi < zghost && zj > zghost)))) {
+            Real3D dist(xi - x[j], yi - y[j], zi - zj);
+            Real3D force;
+            if (row[type[j]]->_computeForce(force, dist)) {
+              wlocal += Tensor(dist, force) / fabs(dist[2]);
+            }
+          }
+        }
+      }
+
+      // reduce over all CPUs
+      Tensor wsum(0.0);
+      boost::mpi::all_reduce(*mpiWorld, (double*)&wlocal, 6, (double*)&wsum, std::plus<double>());
+      w += wsum;
+    }
+
+    // the pressure in n layers along z, the first one at 0, the last one at Lz - Lz/n
+    template < typename _Potential > inline void
+    PackedVerletListInteractionTemplate < _Potential >::
+    computeVirialTensor(Tensor *w, int n) {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over packed verlet list and sum up virial tensor in bins along z-direction");
+
+      Real3D Li = verletList->getSystemRef().bc->getBoxL();
+      real z_dist = Li[2] / real(n);  // distance between two layers
+
+      storage::ParticleArrays &pa = verletList->getSystem()->storage->getParticleArrays();
+      pa.updatePositions();
+      updatePotentialTable();
+
+      const std::vector< longint > &offsets = verletList->getOffsets();
+      const int *nb = verletList->getNeighbors().data();
+      const longint nrows = offsets.size() - 1;
+      const real *x = pa.x.data(), *y = pa.y.data(), *z = pa.z.data();
+      const int *type = pa.type.data();
+
+      std::vector< Tensor > wlocal(n, Tensor(0.0));
+      for (longint i = 0; i < nrows; ++i) {
+        const int ti = type[i];
+        if (ti >= ntypes) continue;
+        const Potential * const *row = &potentialTable[ti * ntypes];
+        const real xi = x[i], yi = y[i], zi = z[i];
+        for (longint k = offsets[i], kend = offsets[i + 1]; k < kend; ++k) {
+          const int j = nb[k];
+          if (type[j] >= ntypes) continue;
+          Real3D dist(xi - x[j], yi - y[j], zi - z[j]);
+          Real3D force;
+          if (!row[type[j]]->_computeForce(force, dist)) continue;
+          Tensor ww = Tensor(dist, force) / fabs(dist[2]);
+
+          int position1 = (int)(zi / z_dist);
+          int position2 = (int)(z[j] / z_dist);
+          int maxpos = std::max(position1, position2);
+          int minpos = std::min(position1, position2);
+
+          // the pair crosses the periodic boundary if one of them is a ghost outside the box
+          bool boundaries = false;
+          if (minpos < 0) {
+            minpos += n;
+            boundaries = true;
+          }
+          if (maxpos >= n) {
+            maxpos -= n;
+            boundaries = true;
+          }
+
+          if (boundaries) {
+            for (int b = 0; b <= maxpos; ++b) wlocal[b] += ww;
+            for (int b = minpos + 1; b < n; ++b) wlocal[b] += ww;
+          } else {
+            for (int b = minpos + 1; b <= maxpos; ++b) wlocal[b] += ww;
+          }
+        }
+      }
+
+      // reduce over all CPUs, a Tensor is 6 reals
+      std::vector< Tensor > wsum(n, Tensor(0.0));
+      boost::mpi::all_reduce(*mpiWorld, (double*)wlocal.data(), 6 * n, (double*)wsum.data(), std::plus<double>());
+      for (int b = 0; b < n; ++b) {
+        w[b] += wsum[b];
+      }
+    }
+
+    template < typename _Potential > inline real
+    PackedVerletListInteractionTemplate< _Potential >::
+    getMaxCutoff() {
+      real cutoff = 0.0;
+      for (int i = 0; i < ntypes; i++) {
+        for (int j = 0; j < ntypes; j++) {
+            cutoff = std::max(cutoff, getPotential(i, j).getCutoff());
+        }
+      }
+      return cutoff;
+    }
+  }
+}
+#endif
@@ -89,6 +89,8 @@ namespace espressopp {
 
 
       virtual void addForces();
+      virtual void addForcesReals(int part);
+      virtual void addForcesGhosts();
       virtual real computeEnergy();
       virtual real computeEnergyDeriv();
       virtual real computeEnergyAA();
@@ -102,6 +104,9 @@ namespace espressopp {
       virtual int bondType() { return Nonbonded; }
 
     protected:
+      /// add the forces of the pairs [begin, end) of the Verlet list
+      void addForcesRange(size_t begin, size_t end);
+
       int ntypes;
       shared_ptr<VerletList> verletList;
       esutil::Array2D<Potential, esutil::enlarge> potentialArray;
@@ -115,10 +120,36 @@ namespace espressopp {
     VerletListInteractionTemplate < _Potential >::
     addForces() {
       LOG4ESPP_DEBUG(_Potential::theLogger, "loop over verlet list pairs and add forces");
+      addForcesRange(0, verletList->getPairs().size());
+    }
 
-      for (PairList::Iterator it(verletList->getPairs()); it.isValid(); ++it) {
-        Particle &p1 = *it->first;
-        Particle &p2 = *it->second;
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesReals(int part) {
+      // the real pairs are at the front of the list
+      size_t half = verletList->getNumRealPairs() / 2;
+      LOG4ESPP_DEBUG(_Potential::theLogger, "add forces of real pairs, part " << part);
+      if (part == 0) {
+        addForcesRange(0, half);
+      } else {
+        addForcesRange(half, verletList->getNumRealPairs());
+      }
+    }
+
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesGhosts() {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "add forces of pairs with ghosts");
+      addForcesRange(verletList->getNumRealPairs(), verletList->getPairs().size());
+    }
+
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesRange(size_t begin, size_t end) {
+      PairList &pairs = verletList->getPairs();
+      for (size_t k = begin; k < end; ++k) {
+        Particle &p1 = *pairs[k].first;
+        Particle &p2 = *pairs[k].second;
         int type1 = p1.type();
         int type2 = p2.type();
         const Potential &potential = getPotential(type1, type2);
@@ -0,0 +1,300 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _INTERACTION_VERLETLISTTHREADEDINTERACTIONTEMPLATE_HPP
+#define _INTERACTION_VERLETLISTTHREADEDINTERACTIONTEMPLATE_HPP
+
+#include "VerletListInteractionTemplate.hpp"
+#include "esutil/OpenMP.hpp"
+#include "storage/ParticleArrays.hpp"
+
+namespace espressopp {
+  namespace interaction {
+    /** Verlet list interaction that splits the pair loop over OpenMP threads.
+
+        The pairs of the Verlet list are translated once per rebuild into
+        index pairs of the storage's ParticleArrays. Each thread adds its
+        forces to a private force buffer, and the buffers are summed per
+        particle afterwards, so there are no write races. Energies and
+        virials use thread-local sums.
+
+        Only potentials whose force depends on the distance vector alone
+        can be used here, since the kernel works on the positions of the
+        particle arrays. Type pairs without a potential do not interact.
+    */
+    template < typename _Potential >
+    class VerletListThreadedInteractionTemplate
+      : public VerletListInteractionTemplate< _Potential > {
+
+    protected:
+      typedef _Potential Potential;
+      typedef VerletListInteractionTemplate< _Potential > Super;
+
+    public:
+      VerletListThreadedInteractionTemplate(shared_ptr< VerletList > _verletList)
+        : Super(_verletList), numThreads(0), pairBuilds(-1) {
+        _verletList->getSystem()->storage->setUseParticleArrays(true);
+      }
+
+      virtual ~VerletListThreadedInteractionTemplate() {};
+
+      /// number of threads for the pair loop, 0 means the OpenMP default
+      void setNumThreads(int _numThreads) { numThreads = _numThreads; }
+      int getNumThreads() const { return numThreads; }
+
+      virtual void addForces();
+      // the threaded loop is not split, everything is done with the ghosts
+      virtual void addForcesReals(int part) {}
+      virtual void addForcesGhosts() { addForces(); }
+      virtual real computeEnergy();
+      virtual real computeVirial();
+      virtual void computeVirialTensor(Tensor& w);
+      using Super::computeVirialTensor;
+
+    protected:
+      struct IndexPair {
+        longint i, j;
+      };
+
+      /// translate the Verlet list into index pairs if it was rebuilt
+      void updatePairIndex(storage::ParticleArrays &pa);
+      /// resolve the potentials of all type pairs, so the threads only read them
+      void updatePotentialTable();
+
+      const Potential *lookupPotential(int type1, int type2) const {
+        if (type1 >= this->ntypes || type2 >= this->ntypes) return 0;
+        return potentialTable[type1 * this->ntypes + type2];
+      }
+
+      int numThreads;
+      int pairBuilds;
+      std::vector< IndexPair > indexPairs;
+      std::vector< const Potential* > potentialTable;
+      std::vector< real > threadForces;
+    };
+
+    //////////////////////////////////////////////////
+    // INLINE IMPLEMENTATION
+    //////////////////////////////////////////////////
+    template < typename _Potential > inline void
+    VerletListThreadedInteractionTemplate < _Potential >::
+    updatePairIndex(storage::ParticleArrays &pa) {
+      PairList &pairs = this->verletList->getPairs();
+      if (pairBuilds == this->verletList->getBuilds() &&
+          indexPairs.size() == pairs.size()) {
+        return;
+      }
+
+      indexPairs.resize(pairs.size());
+      for (size_t k = 0; k < pairs.size(); ++k) {
+        indexPairs[k].i = pa.indexOf(pairs[k].first);
+        indexPairs[k].j = pa.indexOf(pairs[k].second);
+      }
+      pairBuilds = this->verletList->getBuilds();
+      LOG4ESPP_DEBUG(_Potential::theLogger, "translated " << indexPairs.size() << " pairs to array indices");
+    }
+
+    template < typename _Potential > inline void
+    VerletListThreadedInteractionTemplate < _Potential >::
+    updatePotentialTable() {
+      int ntypes = this->ntypes;
+      potentialTable.resize(ntypes * ntypes);
+      for (int t1 = 0; t1 < ntypes; ++t1) {
+        for (int t2 = 0; t2 < ntypes; ++t2) {
+          potentialTable[t1 * ntypes + t2] = &this->getPotential(t1, t2);
+        }
+      }
+    }
+
+    template < typename _Potential > inline void
+    VerletListThreadedInteractionTemplate < _Potential >::
+    addForces() {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over verlet list pairs and add forces on "
+                     << esutil::getNumThreads(numThreads) << " threads");
+
+      storage::ParticleArrays &pa = this->verletList->getSystem()->storage->getParticleArrays();
+      updatePairIndex(pa);
+      updatePotentialTable();
+
+      const longint n = pa.size();
+      const longint npairs = indexPairs.size();
+      const int nthreads = esutil::getNumThreads(numThreads);
+      threadForces.resize(3 * n * nthreads);
+
+      const real *x = pa.x.data(), *y = pa.y.data(), *z = pa.z.data();
+      const int *type = pa.type.data();
+      const IndexPair *ip = indexPairs.data();
+      real *tf = threadForces.data();
+      real *fx = pa.fx.data(), *fy = pa.fy.data(), *fz = pa.fz.data();
+
+      #pragma omp parallel num_threads(nthreads)
+      {
+        real *f = tf + 3 * n * esutil::getThreadNum();
+        std::fill(f, f + 3 * n, 0.0);
+
+        #pragma omp for schedule(static)
+        for (longint k = 0; k < npairs; ++k) {
+          const longint i = ip[k].i;
+          const longint j = ip[k].j;
+          const Potential *potential = lookupPotential(type[i], type[j]);
+          if (!potential) continue;
+
+          Real3D dist(x[i] - x[j], y[i] - y[j], z[i] - z[j]);
+          Real3D force;
+          if (potential->_computeForce(force, dist)) {
+            f[3 * i]     += force[0];
+            f[3 * i + 1] += force[1];
+            f[3 * i + 2] += force[2];
+            f[3 * j]     -= force[0];
+            f[3 * j + 1] -= force[1];
+            f[3 * j + 2] -= force[2];
+          }
+        }
+
+        // implicit barrier above, now sum up the thread buffers per particle
+        #pragma omp for schedule(static)
+        for (longint i = 0; i < n; ++i) {
+          real sx = 0.0, sy = 0.0, sz = 0.0;
+          for (int t = 0; t < nthreads; ++t) {
+            const real *ft = tf + 3 * n * t + 3 * i;
+            sx += ft[0];
+            sy += ft[1];
+            sz += ft[2];
+          }
+          fx[i] = sx;
+          fy[i] = sy;
+          fz[i] = sz;
+        }
+      }
+
+      pa.addForcesToParticles();
+    }
+
+    template < typename _Potential > inline real
+    VerletListThreadedInteractionTemplate < _Potential >::
+    computeEnergy() {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over verlet list pairs and sum up potential energies");
+
+      storage::ParticleArrays &pa = this->verletList->getSystem()->storage->getParticleArrays();
+      pa.updatePositions();
+      updatePairIndex(pa);
+      updatePotentialTable();
+
+      const longint npairs = indexPairs.size();
+      const real *x = pa.x.data(), *y = pa.y.data(), *z = pa.z.data();
+      const int *type = pa.type.data();
+      const IndexPair *ip = indexPairs.data();
+
+      real es = 0.0;
+      #pragma omp parallel for schedule(static) reduction(+:es) num_threads(esutil::getNumThreads(numThreads))
+      for (longint k = 0; k < npairs; ++k) {
+        const longint i = ip[k].i;
+        const longint j = ip[k].j;
+        const Potential *potential = lookupPotential(type[i], type[j]);
+        if (!potential) continue;
+        Real3D dist(x[i] - x[j], y[i] - y[j], z[i] - z[j]);
+        es += potential->_computeEnergy(dist);
+      }
+
+      // reduce over all CPUs
+      real esum;
+      boost::mpi::all_reduce(*this->verletList->getSystem()->comm, es, esum, std::plus<real>());
+      return esum;
+    }
+
+    template < typename _Potential > inline real
+    VerletListThreadedInteractionTemplate < _Potential >::
+    computeVirial() {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over verlet list pairs and sum up virial");
+
+      storage::ParticleArrays &pa = this->verletList->getSystem()->storage->getParticleArrays();
+      pa.updatePositions();
+      updatePairIndex(pa);
+      updatePotentialTable();
+
+      const longint npairs = indexPairs.size();
+      const real *x = pa.x.data(), *y = pa.y.data(), *z = pa.z.data();
+      const int *type = pa.type.data();
+      const IndexPair *ip = indexPairs.data();
+
+      real w = 0.0;
+      #pragma omp parallel for schedule(static) reduction(+:w) num_threads(esutil::getNumThreads(numThreads))
+      for (longint k = 0; k < npairs; ++k) {
+        const longint i = ip[k].i;
+        const longint j = ip[k].j;
+        const Potential *potential = lookupPotential(type[i], type[j]);
+        if (!potential) continue;
+        Real3D dist(x[i] - x[j], y[i] - y[j], z[i] - z[j]);
+        Real3D force;
+        if (potential->_computeForce(force, dist)) {
+          w += dist * force;
+        }
+      }
+
+      // reduce over all CPUs
+      real wsum;
+      boost::mpi::all_reduce(*mpiWorld, w, wsum, std::plus<real>());
+      return wsum;
+    }
+
+    template < typename _Potential > inline void
+    VerletListThreadedInteractionTemplate < _Potential >::
+    computeVirialTensor(Tensor& w) {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over verlet list pairs and sum up virial tensor");
+
+      storage::ParticleArrays &pa = this->verletList->getSystem()->storage->getParticleArrays();
+      pa.updatePositions();
+      updatePairIndex(pa);
+      updatePotentialTable();
+
+      const longint npairs = indexPairs.size();
+      const real *x = pa.x.data(), *y = pa.y.data(), *z = pa.z.data();
+      const int *type = pa.type.data();
+      const IndexPair *ip = indexPairs.data();
+
+      Tensor wlocal(0.0);
+      #pragma omp parallel num_threads(esutil::getNumThreads(numThreads))
+      {
+        Tensor wthread(0.0);
+        #pragma omp for schedule(static)
+        for (longint k = 0; k < npairs; ++k) {
+          const longint i = ip[k].i;
+          const longint j = ip[k].j;
+          const Potential *potential = lookupPotential(type[i], type[j]);
+          if (!potential) continue;
+          Real3D dist(x[i] - x[j], y[i] - y[j], z[i] - z[j]);
+          Real3D force;
+          if (potential->_computeForce(force, dist)) {
+            wthread += Tensor(dist, force);
+          }
+        }
+        #pragma omp critical
+        wlocal += wthread;
+      }
+
+      // reduce over all CPUs
+      Tensor wsum(0.0);
+      boost::mpi::all_reduce(*mpiWorld, (double*)&wlocal, 6, (double*)&wsum, std::plus<double>());
+      w += wsum;
+    }
+  }
+}
+#endif
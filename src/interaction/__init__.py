@@ -86,6 +86,7 @@ from espressopp.interaction.TersoffPairTerm import *
 from espressopp.interaction.TersoffTripleTerm import *
 
 from espressopp.interaction.CoulombKSpaceP3M import *
+from espressopp.interaction.CoulombKSpaceSPME import *
 
 from espressopp.interaction.SingleParticlePotential import *
 from espressopp.interaction.HarmonicTrap import *
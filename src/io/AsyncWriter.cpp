@@ -0,0 +1,93 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <exception>
+#include <stdexcept>
+#include "AsyncWriter.hpp"
+
+namespace espressopp {
+  namespace io {
+
+    AsyncWriter::AsyncWriter(size_t _maxPending)
+      : maxPending(_maxPending > 0 ? _maxPending : 1), busy(false), stop(false),
+        thread(&AsyncWriter::work, this) {}
+
+    AsyncWriter::~AsyncWriter() {
+      {
+        std::unique_lock< std::mutex > lock(mutex);
+        stop = true;
+      }
+      jobAvailable.notify_one();
+      thread.join(); // the worker drains the queue before it quits
+    }
+
+    void AsyncWriter::submit(Job job) {
+      std::unique_lock< std::mutex > lock(mutex);
+      jobDone.wait(lock, [this] { return jobs.size() < maxPending || !error.empty(); });
+      rethrow();
+      jobs.push_back(job);
+      lock.unlock();
+      jobAvailable.notify_one();
+    }
+
+    void AsyncWriter::flush() {
+      std::unique_lock< std::mutex > lock(mutex);
+      jobDone.wait(lock, [this] { return (jobs.empty() && !busy) || !error.empty(); });
+      rethrow();
+    }
+
+    // called with the mutex locked
+    void AsyncWriter::rethrow() {
+      if (error.empty()) return;
+      std::string msg = error;
+      error.clear();
+      jobs.clear();
+      throw std::runtime_error(msg);
+    }
+
+    void AsyncWriter::work() {
+      std::unique_lock< std::mutex > lock(mutex);
+      while (true) {
+        jobAvailable.wait(lock, [this] { return !jobs.empty() || stop; });
+        if (jobs.empty()) break; // stop requested and nothing left
+
+        Job job = jobs.front();
+        jobs.pop_front();
+        busy = true;
+        lock.unlock();
+        jobDone.notify_all(); // a slot in the queue is free
+
+        std::string msg;
+        try {
+          job();
+        } catch (std::exception& e) {
+          msg = e.what();
+        } catch (...) {
+          msg = "AsyncWriter: unknown error in an output job";
+        }
+
+        lock.lock();
+        busy = false;
+        if (!msg.empty() && error.empty()) error = msg;
+        jobDone.notify_all();
+      }
+    }
+  }
+}
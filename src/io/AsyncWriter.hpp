@@ -0,0 +1,80 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _IO_ASYNCWRITER_HPP
+#define _IO_ASYNCWRITER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace espressopp {
+  namespace io {
+
+    /** Runs output jobs (formatting and writing a gathered frame) in a
+        background thread, in the order they were submitted.
+
+        At most maxPending jobs wait in the queue; submit() blocks while
+        the queue is full, which bounds the memory held by snapshots that
+        are not written yet. With maxPending = 1 one frame is written
+        while the next one is collected (double buffering).
+
+        An exception thrown by a job is rethrown by the next call of
+        submit() or flush() in the submitting thread. The jobs must not
+        call MPI or Python.
+    */
+    class AsyncWriter {
+    public:
+      typedef std::function< void () > Job;
+
+      explicit AsyncWriter(size_t _maxPending = 1);
+      /// waits for the pending jobs, errors are dropped
+      ~AsyncWriter();
+
+      /// queues a job, blocks while maxPending jobs are waiting
+      void submit(Job job);
+
+      /// blocks until all submitted jobs are done
+      void flush();
+
+      size_t getMaxPending() const { return maxPending; }
+
+    private:
+      void work();
+      void rethrow();
+
+      size_t maxPending;
+      std::deque< Job > jobs;
+      bool busy; // a job is running
+      bool stop;
+      std::string error; // message of a failed job, empty if none
+
+      std::mutex mutex;
+      std::condition_variable jobAvailable;
+      std::condition_variable jobDone;
+      std::thread thread; // started last, after the state above
+    };
+  }
+}
+
+#endif
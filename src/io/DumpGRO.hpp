@@ -28,9 +28,12 @@
 
 #include "mpi.hpp"
 #include <boost/serialization/map.hpp>
+#include <boost/bind.hpp>
 #include "types.hpp"
 #include "System.hpp"
 #include "io/FileBackup.hpp"
+#include "io/AsyncWriter.hpp"
+#include "analysis/ConfigurationExt.hpp"
 #include "ParticleAccess.hpp"
 #include "integrator/MDIntegrator.hpp"
 #include "storage/Storage.hpp"
@@ -59,7 +62,8 @@ namespace espressopp {
                         file_name( _file_name ),
                         unfolded(_unfolded),
                         length_factor(_length_factor),
-                        append(_append){ 
+                        append(_append),
+                        asynchronous(false){ 
         setLengthUnit(_length_unit);
         
 
@@ -96,21 +100,41 @@ namespace espressopp {
         if( system->comm->rank()==0 && !append){
           FileBackup backup(file_name); //backup trajectory if it already exists
         }
+
+        // frames written in the background must be on disk when run() returns
+        connectionFlush = integrator->runEnd.connect(boost::bind(&DumpGRO::flush, this));
+      }
+      ~DumpGRO() {
+        connectionFlush.disconnect();
       }
-      ~DumpGRO() { }
 
       void perform_action(){
         dump();
       }
       
       void dump();
+
+      /// waits until the frames handed to the background writer are written
+      void flush(){
+        if (writer) writer->flush();
+      }
       
       std::string getFilename(){return file_name;}
-      void setFilename(std::string v){file_name = v;}
+      void setFilename(std::string v){flush(); file_name = v;}
       bool getUnfolded(){return unfolded;}
       void setUnfolded(bool v){unfolded = v;}
       bool getAppend(){return append;}
       void setAppend(bool v){append = v;}
+      bool getAsynchronous(){return asynchronous;}
+      void setAsynchronous(bool v){
+        asynchronous = v;
+        if (!v) {
+          flush();
+          writer.reset();
+        } else if (!writer && getSystem()->comm->rank() == 0) {
+          writer = make_shared<AsyncWriter>();
+        }
+      }
 
       std::string getLengthUnit(){return length_unit;}
       void setLengthUnit(std::string v){
@@ -122,10 +146,11 @@ namespace espressopp {
           err.checkException();
         }
         
+        flush();
         length_unit = v;
       }
       real getLengthFactor(){return length_factor;}
-      void setLengthFactor(real v){length_factor = v;}
+      void setLengthFactor(real v){flush(); length_factor = v;}
       
       static void registerPython();
     
@@ -134,6 +159,9 @@ namespace espressopp {
       //static LOG4ESPP_DECL_LOGGER(logger);
 
     private:
+
+      /// formats and writes a gathered frame, rank 0 only
+      void write(analysis::ConfigurationExtPtr conf_real, long long step, Real3D Li);
       
       // integrator we need to know an integration step
       shared_ptr<integrator::MDIntegrator> integrator;
@@ -148,6 +176,10 @@ namespace espressopp {
       bool append; //append to existing trajectory file or create a new one
       real length_factor;  // for example 
       std::string length_unit; // length unit: {could be LJ, nm, A} it is just for user info
+
+      bool asynchronous; // write in a background thread
+      shared_ptr<AsyncWriter> writer; // the background writer, only on rank 0
+      boost::signals2::connection connectionFlush;
     };
   }
 }
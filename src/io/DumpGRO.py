@@ -45,6 +45,14 @@ espressopp.io.DumpGRO
 
 * `length_unit`
   It is length unit. Can be LJ, nm or A. By default - LJ
+
+* `asynchronous`
+  True if the frames are formatted and written by a background thread on
+  CPU 0, while the integration continues. All frames are on disk at the
+  end of integrator.run() or after flush(). By default - False
+
+* `flush()`
+  waits until all frames are written.
   
 usage:
 
@@ -92,6 +100,10 @@ will produce trj.gro with in nanometers
 .. function:: espressopp.io.DumpGRO.dump()
 
 		:rtype: 
+
+.. function:: espressopp.io.DumpGRO.flush()
+
+		:rtype: 
 """
 
 from espressopp.esutil import cxxinit
@@ -108,6 +120,10 @@ class DumpGROLocal(ParticleAccessLocal, io_DumpGRO):
   def dump(self):
     if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
       self.cxxclass.dump(self)
+
+  def flush(self):
+    if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+      self.cxxclass.flush(self)
   
   
 if pmi.isController :
@@ -115,6 +131,6 @@ if pmi.isController :
     __metaclass__ = pmi.Proxy
     pmiproxydefs = dict(
       cls =  'espressopp.io.DumpGROLocal',
-      pmicall = [ 'dump' ],
-      pmiproperty = ['filename', 'unfolded', 'length_factor', 'length_unit', 'append']
+      pmicall = [ 'dump', 'flush' ],
+      pmiproperty = ['filename', 'unfolded', 'length_factor', 'length_unit', 'append', 'asynchronous']
     )
@@ -0,0 +1,473 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "DumpH5MD.hpp"
+#include "FileBackup.hpp"
+#include "Version.hpp"
+#include "storage/Storage.hpp"
+#include "iterator/CellListIterator.hpp"
+#include "bc/BC.hpp"
+
+using namespace espressopp;
+using namespace espressopp::iterator;
+
+namespace espressopp {
+  namespace io {
+
+    namespace {
+      // particles per chunk if the user did not choose a chunk size
+      const hsize_t defaultChunkSize = 65536;
+      // frames per chunk of the step and time datasets
+      const hsize_t timeChunkSize = 128;
+
+      void check(herr_t status, const char* what) {
+        if (status < 0) {
+          std::stringstream msg;
+          msg << "DumpH5MD: " << what << " failed";
+          throw std::runtime_error(msg.str());
+        }
+      }
+
+      hid_t checkId(hid_t id, const char* what) {
+        check(id < 0 ? -1 : 0, what);
+        return id;
+      }
+
+      /* writes n copies of the string value as attribute name of obj,
+         a scalar attribute if n is 0 */
+      void writeStringAttribute(hid_t obj, const char* name,
+                                const char* value, hsize_t n = 0) {
+        size_t len = strlen(value) + 1;
+        hid_t type = H5Tcopy(H5T_C_S1);
+        H5Tset_size(type, len);
+        H5Tset_strpad(type, H5T_STR_NULLTERM);
+        hid_t space = n ? H5Screate_simple(1, &n, NULL) : H5Screate(H5S_SCALAR);
+        std::vector<char> buf(len * std::max<hsize_t>(n, 1));
+        for (size_t i = 0; i < buf.size(); i += len)
+          memcpy(&buf[i], value, len);
+        hid_t attr = checkId(H5Acreate2(obj, name, type, space, H5P_DEFAULT, H5P_DEFAULT),
+                             "creating an attribute");
+        check(H5Awrite(attr, type, &buf[0]), "writing an attribute");
+        H5Aclose(attr);
+        H5Sclose(space);
+        H5Tclose(type);
+      }
+
+      void writeIntAttribute(hid_t obj, const char* name, const int* value, hsize_t n) {
+        hid_t space = n ? H5Screate_simple(1, &n, NULL) : H5Screate(H5S_SCALAR);
+        hid_t attr = checkId(H5Acreate2(obj, name, H5T_STD_I32LE, space, H5P_DEFAULT, H5P_DEFAULT),
+                             "creating an attribute");
+        check(H5Awrite(attr, H5T_NATIVE_INT, value), "writing an attribute");
+        H5Aclose(attr);
+        H5Sclose(space);
+      }
+    }
+
+    DumpH5MD::DumpH5MD(shared_ptr<System> system,
+                       shared_ptr<integrator::MDIntegrator> _integrator,
+                       std::string _file_name,
+                       bool _unfolded,
+                       real _length_factor,
+                       bool _store_velocities,
+                       bool _store_forces,
+                       bool _store_species,
+                       int _chunk_size,
+                       int _compression,
+                       bool _append) :
+                        ParticleAccess(system),
+                        integrator(_integrator),
+                        file_name(_file_name),
+                        unfolded(_unfolded),
+                        length_factor(_length_factor),
+                        store_velocities(_store_velocities),
+                        store_forces(_store_forces),
+                        store_species(_store_species),
+                        chunk_size(_chunk_size),
+                        compression(_compression),
+                        append(_append),
+                        file(-1), dxpl(-1),
+                        particlesGroup(-1), boxGroup(-1) {
+
+      if (chunk_size < 0 || compression < 0 || compression > 9)
+        throw std::runtime_error("DumpH5MD: chunk_size must be >= 0 and compression between 0 and 9");
+
+      realType = (sizeof(real) == sizeof(double)) ? H5T_NATIVE_DOUBLE : H5T_NATIVE_FLOAT;
+
+      long long nLocal = system->storage->getNRealParticles();
+      boost::mpi::all_reduce(*system->comm, nLocal, numParticles, std::plus<long long>());
+      if (numParticles == 0)
+        throw std::runtime_error("DumpH5MD: No particles found in the system - make sure particles are added first before Dumper is initialized");
+
+      bool exists = false;
+      if (system->comm->rank() == 0) {
+        exists = boost::filesystem::exists(file_name);
+        if (exists && !append)
+          FileBackup backup(file_name);
+      }
+      boost::mpi::broadcast(*system->comm, exists, 0);
+
+      dxpl = H5Pcreate(H5P_DATASET_XFER);
+      check(H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE), "setting collective transfers");
+
+      if (append && exists)
+        openFile();
+      else
+        createFile();
+    }
+
+    DumpH5MD::~DumpH5MD() {
+      try {
+        close();
+      } catch (std::exception&) {
+        // a destructor must not throw; the file may be incomplete
+      }
+    }
+
+    void DumpH5MD::createFile() {
+      hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+      check(H5Pset_fapl_mpio(fapl, *getSystem()->comm, MPI_INFO_NULL), "setting the MPI-IO driver");
+      file = H5Fcreate(file_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+      H5Pclose(fapl);
+      if (file < 0) {
+        std::stringstream msg;
+        msg << "DumpH5MD: can not create file " << file_name;
+        throw std::runtime_error(msg.str());
+      }
+
+      // metadata required by the H5MD specification
+      int version[2] = {1, 1};
+      hid_t h5md = H5Gcreate2(file, "h5md", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      writeIntAttribute(h5md, "version", version, 2);
+      hid_t author = H5Gcreate2(h5md, "author", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      writeStringAttribute(author, "name", "unknown");
+      H5Gclose(author);
+      hid_t creator = H5Gcreate2(h5md, "creator", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      std::stringstream creatorVersion;
+      creatorVersion << MAJORVERSION << "." << MINORVERSION << "." << PATCHLEVEL;
+      writeStringAttribute(creator, "name", "ESPResSo++");
+      writeStringAttribute(creator, "version", creatorVersion.str().c_str());
+      H5Gclose(creator);
+      H5Gclose(h5md);
+
+      hid_t particles = H5Gcreate2(file, "particles", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      particlesGroup = checkId(H5Gcreate2(particles, "all", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+                               "creating /particles/all");
+      H5Gclose(particles);
+
+      int dimension = 3;
+      boxGroup = H5Gcreate2(particlesGroup, "box", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      writeIntAttribute(boxGroup, "dimension", &dimension, 0);
+      writeStringAttribute(boxGroup, "boundary", "periodic", 3);
+
+      createElement(edges, boxGroup, "edges", realType, 3, 0);
+      createElement(position, particlesGroup, "position", realType, numParticles, 3);
+      createElement(id, particlesGroup, "id", H5T_STD_I64LE, numParticles, 0);
+      if (store_velocities)
+        createElement(velocity, particlesGroup, "velocity", realType, numParticles, 3);
+      if (store_forces)
+        createElement(force, particlesGroup, "force", realType, numParticles, 3);
+      if (store_species)
+        createElement(species, particlesGroup, "species", H5T_STD_I32LE, numParticles, 0);
+    }
+
+    void DumpH5MD::openFile() {
+      hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+      check(H5Pset_fapl_mpio(fapl, *getSystem()->comm, MPI_INFO_NULL), "setting the MPI-IO driver");
+      file = H5Fopen(file_name.c_str(), H5F_ACC_RDWR, fapl);
+      H5Pclose(fapl);
+      if (file < 0) {
+        std::stringstream msg;
+        msg << "DumpH5MD: can not open file " << file_name;
+        throw std::runtime_error(msg.str());
+      }
+
+      particlesGroup = checkId(H5Gopen2(file, "particles/all", H5P_DEFAULT),
+                               "opening /particles/all");
+      boxGroup = checkId(H5Gopen2(particlesGroup, "box", H5P_DEFAULT), "opening the box");
+
+      openElement(edges, boxGroup, "edges");
+      openElement(position, particlesGroup, "position");
+      openElement(id, particlesGroup, "id");
+      if (store_velocities)
+        openElement(velocity, particlesGroup, "velocity");
+      if (store_forces)
+        openElement(force, particlesGroup, "force");
+      if (store_species)
+        openElement(species, particlesGroup, "species");
+
+      hsize_t dims[3];
+      hid_t space = H5Dget_space(position.value);
+      H5Sget_simple_extent_dims(space, dims, NULL);
+      H5Sclose(space);
+      if ((long long)dims[1] != numParticles) {
+        std::stringstream msg;
+        msg << "DumpH5MD: can not append to " << file_name << ", it holds "
+            << dims[1] << " particles per frame instead of " << numParticles;
+        throw std::runtime_error(msg.str());
+      }
+    }
+
+    void DumpH5MD::createElement(H5MDElement& el, hid_t parent, const char* name,
+                                 hid_t type, hsize_t rows, int dim) {
+      el.group = checkId(H5Gcreate2(parent, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+                         "creating an element");
+
+      hsize_t zero = 0, unlimited = H5S_UNLIMITED;
+      hid_t space = H5Screate_simple(1, &zero, &unlimited);
+      hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+      H5Pset_chunk(dcpl, 1, &timeChunkSize);
+      el.step = checkId(H5Dcreate2(el.group, "step", H5T_STD_I64LE, space,
+                                   H5P_DEFAULT, dcpl, H5P_DEFAULT), "creating step");
+      el.time = checkId(H5Dcreate2(el.group, "time", H5T_IEEE_F64LE, space,
+                                   H5P_DEFAULT, dcpl, H5P_DEFAULT), "creating time");
+      H5Pclose(dcpl);
+      H5Sclose(space);
+
+      // frame x rows (x dim)
+      int rank = dim > 0 ? 3 : 2;
+      hsize_t dims[3] = {0, rows, (hsize_t)dim};
+      hsize_t maxDims[3] = {H5S_UNLIMITED, rows, (hsize_t)dim};
+      hsize_t chunk[3] = {1, std::min(rows, chunk_size > 0 ? (hsize_t)chunk_size : defaultChunkSize),
+                          (hsize_t)dim};
+      space = H5Screate_simple(rank, dims, maxDims);
+      dcpl = H5Pcreate(H5P_DATASET_CREATE);
+      H5Pset_chunk(dcpl, rank, chunk);
+      if (compression > 0) {
+        H5Pset_shuffle(dcpl);
+        H5Pset_deflate(dcpl, compression);
+      }
+      el.value = checkId(H5Dcreate2(el.group, "value", type, space,
+                                    H5P_DEFAULT, dcpl, H5P_DEFAULT), "creating value");
+      H5Pclose(dcpl);
+      H5Sclose(space);
+    }
+
+    void DumpH5MD::openElement(H5MDElement& el, hid_t parent, const char* name) {
+      el.group = H5Gopen2(parent, name, H5P_DEFAULT);
+      if (el.group < 0) {
+        std::stringstream msg;
+        msg << "DumpH5MD: can not append to " << file_name << ", element "
+            << name << " is missing";
+        throw std::runtime_error(msg.str());
+      }
+      el.step = checkId(H5Dopen2(el.group, "step", H5P_DEFAULT), "opening step");
+      el.time = checkId(H5Dopen2(el.group, "time", H5P_DEFAULT), "opening time");
+      el.value = checkId(H5Dopen2(el.group, "value", H5P_DEFAULT), "opening value");
+    }
+
+    void DumpH5MD::closeElement(H5MDElement& el) {
+      if (el.group < 0) return;
+      H5Dclose(el.value);
+      H5Dclose(el.time);
+      H5Dclose(el.step);
+      H5Gclose(el.group);
+      el = H5MDElement();
+    }
+
+    hsize_t DumpH5MD::appendFrame(H5MDElement& el, long long step, double time) {
+      hsize_t frame;
+      hid_t fileSpace = H5Dget_space(el.step);
+      H5Sget_simple_extent_dims(fileSpace, &frame, NULL);
+      H5Sclose(fileSpace);
+
+      hsize_t newFrames = frame + 1;
+      check(H5Dset_extent(el.step, &newFrames), "extending step");
+      check(H5Dset_extent(el.time, &newFrames), "extending time");
+
+      hsize_t dims[3];
+      fileSpace = H5Dget_space(el.value);
+      H5Sget_simple_extent_dims(fileSpace, dims, NULL);
+      H5Sclose(fileSpace);
+      dims[0] = newFrames;
+      check(H5Dset_extent(el.value, dims), "extending value");
+
+      // the writes are collective, but only rank 0 contributes data
+      hsize_t one = 1;
+      hid_t memSpace = H5Screate_simple(1, &one, NULL);
+      hid_t stepSpace = H5Dget_space(el.step);
+      hid_t timeSpace = H5Dget_space(el.time);
+      if (getSystem()->comm->rank() == 0) {
+        H5Sselect_hyperslab(stepSpace, H5S_SELECT_SET, &frame, NULL, &one, NULL);
+        H5Sselect_hyperslab(timeSpace, H5S_SELECT_SET, &frame, NULL, &one, NULL);
+      } else {
+        H5Sselect_none(memSpace);
+        H5Sselect_none(stepSpace);
+        H5Sselect_none(timeSpace);
+      }
+      check(H5Dwrite(el.step, H5T_NATIVE_LLONG, memSpace, stepSpace, dxpl, &step), "writing step");
+      check(H5Dwrite(el.time, H5T_NATIVE_DOUBLE, memSpace, timeSpace, dxpl, &time), "writing time");
+      H5Sclose(timeSpace);
+      H5Sclose(stepSpace);
+      H5Sclose(memSpace);
+
+      return frame;
+    }
+
+    void DumpH5MD::writeRows(H5MDElement& el, hsize_t frame, hid_t memType,
+                             const void* buf, hsize_t offset, hsize_t nRows, int dim) {
+      hsize_t start[3] = {frame, offset, 0};
+      hsize_t count[3] = {1, nRows, (hsize_t)dim};
+      hsize_t memSize = std::max<hsize_t>(nRows * std::max(dim, 1), 1);
+
+      hid_t memSpace = H5Screate_simple(1, &memSize, NULL);
+      hid_t fileSpace = H5Dget_space(el.value);
+      if (nRows > 0) {
+        H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start, NULL, count, NULL);
+      } else {
+        H5Sselect_none(memSpace);
+        H5Sselect_none(fileSpace);
+      }
+      check(H5Dwrite(el.value, memType, memSpace, fileSpace, dxpl, buf), "writing value");
+      H5Sclose(fileSpace);
+      H5Sclose(memSpace);
+    }
+
+    void DumpH5MD::dump() {
+      if (file < 0)
+        throw std::runtime_error("DumpH5MD: the file is closed");
+
+      shared_ptr<System> system = getSystem();
+      CellList realCells = system->storage->getRealCells();
+      Real3D L = system->bc->getBoxL();
+
+      long long nLocal = system->storage->getNRealParticles();
+      long long nTotal;
+      boost::mpi::all_reduce(*system->comm, nLocal, nTotal, std::plus<long long>());
+      if (nTotal != numParticles) {
+        std::stringstream msg;
+        msg << "DumpH5MD: the number of particles changed from " << numParticles
+            << " to " << nTotal << ", H5MD requires a fixed number per file";
+        throw std::runtime_error(msg.str());
+      }
+
+      // first row of my particles: rows are ordered by rank
+      long long offset = 0;
+      MPI_Exscan(&nLocal, &offset, 1, MPI_LONG_LONG, MPI_SUM, *system->comm);
+      if (system->comm->rank() == 0) offset = 0;
+
+      long long step = integrator->getStep();
+      double time = step * integrator->getTimeStep();
+
+      // the box, from rank 0
+      real box[3] = {L[0] * length_factor, L[1] * length_factor, L[2] * length_factor};
+      hsize_t frame = appendFrame(edges, step, time);
+      writeRows(edges, frame, realType, box, 0, system->comm->rank() == 0 ? 3 : 0, 0);
+
+      // at least one element, H5Dwrite wants a buffer even for an empty selection
+      std::vector<real> vec(3 * std::max(nLocal, 1LL));
+      std::vector<long long> ids(std::max(nLocal, 1LL));
+      std::vector<int> types(std::max(nLocal, 1LL));
+
+      size_t i = 0;
+      for (CellListIterator cit(realCells); !cit.isDone(); ++cit, ++i) {
+        Real3D pos = cit->position();
+        if (unfolded) {
+          Int3D& img = cit->image();
+          for (int d = 0; d < 3; d++) pos[d] += img[d] * L[d];
+        }
+        for (int d = 0; d < 3; d++) vec[3 * i + d] = length_factor * pos[d];
+        ids[i] = cit->id();
+        types[i] = cit->type();
+      }
+
+      frame = appendFrame(position, step, time);
+      writeRows(position, frame, realType, vec.data(), offset, nLocal, 3);
+      frame = appendFrame(id, step, time);
+      writeRows(id, frame, H5T_NATIVE_LLONG, ids.data(), offset, nLocal, 0);
+
+      if (store_velocities) {
+        i = 0;
+        for (CellListIterator cit(realCells); !cit.isDone(); ++cit, ++i)
+          for (int d = 0; d < 3; d++) vec[3 * i + d] = length_factor * cit->velocity()[d];
+        frame = appendFrame(velocity, step, time);
+        writeRows(velocity, frame, realType, vec.data(), offset, nLocal, 3);
+      }
+      if (store_forces) {
+        i = 0;
+        for (CellListIterator cit(realCells); !cit.isDone(); ++cit, ++i)
+          for (int d = 0; d < 3; d++) vec[3 * i + d] = cit->force()[d];
+        frame = appendFrame(force, step, time);
+        writeRows(force, frame, realType, vec.data(), offset, nLocal, 3);
+      }
+      if (store_species) {
+        frame = appendFrame(species, step, time);
+        writeRows(species, frame, H5T_NATIVE_INT, types.data(), offset, nLocal, 0);
+      }
+
+      // keep the file readable if the run is killed
+      check(H5Fflush(file, H5F_SCOPE_GLOBAL), "flushing the file");
+    }
+
+    void DumpH5MD::close() {
+      if (file < 0) return;
+      closeElement(species);
+      closeElement(force);
+      closeElement(velocity);
+      closeElement(id);
+      closeElement(position);
+      closeElement(edges);
+      H5Gclose(boxGroup);
+      H5Gclose(particlesGroup);
+      H5Pclose(dxpl);
+      H5Fclose(file);
+      file = -1;
+    }
+
+    // Python wrapping
+    void DumpH5MD::registerPython() {
+
+      using namespace espressopp::python;
+
+      class_<DumpH5MD, bases<ParticleAccess>, boost::noncopyable >
+      ("io_DumpH5MD", init< shared_ptr< System >,
+                            shared_ptr< integrator::MDIntegrator >,
+                            std::string,
+                            bool,
+                            real,
+                            bool,
+                            bool,
+                            bool,
+                            int,
+                            int,
+                            bool>())
+        .add_property("filename", &DumpH5MD::getFilename)
+        .add_property("unfolded", &DumpH5MD::getUnfolded,
+                                  &DumpH5MD::setUnfolded)
+        .add_property("length_factor", &DumpH5MD::getLengthFactor,
+                                       &DumpH5MD::setLengthFactor)
+        .add_property("store_velocities", &DumpH5MD::getStoreVelocities)
+        .add_property("store_forces", &DumpH5MD::getStoreForces)
+        .add_property("store_species", &DumpH5MD::getStoreSpecies)
+        .add_property("chunk_size", &DumpH5MD::getChunkSize)
+        .add_property("compression", &DumpH5MD::getCompression)
+        .add_property("append", &DumpH5MD::getAppend)
+        .def("dump", &DumpH5MD::dump)
+        .def("close", &DumpH5MD::close)
+      ;
+    }
+  }
+}
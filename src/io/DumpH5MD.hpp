@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _IO_DUMPH5MD_HPP
+#define _IO_DUMPH5MD_HPP
+
+#include <hdf5.h>
+#include <string>
+
+#include "mpi.hpp"
+#include "types.hpp"
+#include "System.hpp"
+#include "integrator/MDIntegrator.hpp"
+#include "ParticleAccess.hpp"
+
+namespace espressopp {
+  namespace io {
+
+    /** Writes the trajectory in the H5MD format (P. de Buyl et al.,
+        Comput. Phys. Commun. 185 (2014) 1546) with parallel HDF5.
+
+        Unlike the other dumpers the particles are not gathered on rank 0:
+        every CPU writes the rows of its own real particles into the
+        shared datasets with one collective call per dataset. The rows of
+        a frame are ordered by CPU, so particle ``i`` of one frame is not
+        necessarily particle ``i`` of the next one; the ``id`` element
+        holds the particle ids of every row.
+    */
+    class DumpH5MD : public ParticleAccess {
+
+    public:
+
+      DumpH5MD(shared_ptr<System> system,
+               shared_ptr<integrator::MDIntegrator> _integrator,
+               std::string _file_name,
+               bool _unfolded,
+               real _length_factor,
+               bool _store_velocities,
+               bool _store_forces,
+               bool _store_species,
+               int _chunk_size,
+               int _compression,
+               bool _append);
+      ~DumpH5MD();
+
+      void perform_action() {
+        dump();
+      }
+
+      /// appends the current configuration as a new frame
+      void dump();
+
+      /// flushes and closes the file; no frames can be written afterwards
+      void close();
+
+      std::string getFilename() { return file_name; }
+      bool getUnfolded() { return unfolded; }
+      void setUnfolded(bool v) { unfolded = v; }
+      real getLengthFactor() { return length_factor; }
+      void setLengthFactor(real v) { length_factor = v; }
+      bool getStoreVelocities() { return store_velocities; }
+      bool getStoreForces() { return store_forces; }
+      bool getStoreSpecies() { return store_species; }
+      int getChunkSize() { return chunk_size; }
+      int getCompression() { return compression; }
+      bool getAppend() { return append; }
+
+      static void registerPython();
+
+    private:
+
+      // a time-dependent H5MD element: a group with the step, time and
+      // value datasets, the first dimension of all three is the frame
+      struct H5MDElement {
+        hid_t group, step, time, value;
+        H5MDElement() : group(-1), step(-1), time(-1), value(-1) {}
+      };
+
+      void createFile();
+      void openFile();
+      void createElement(H5MDElement& el, hid_t parent, const char* name,
+                         hid_t type, hsize_t rows, int dim);
+      void openElement(H5MDElement& el, hid_t parent, const char* name);
+      void closeElement(H5MDElement& el);
+
+      /// extends the element by one frame and writes step and time from rank 0
+      hsize_t appendFrame(H5MDElement& el, long long step, double time);
+      /** writes nRows rows of dim values each, starting at row offset,
+          into frame of the element; collective */
+      void writeRows(H5MDElement& el, hsize_t frame, hid_t memType,
+                     const void* buf, hsize_t offset, hsize_t nRows, int dim);
+
+      // integrator we need to know an integration step
+      shared_ptr<integrator::MDIntegrator> integrator;
+
+      std::string file_name;
+      bool unfolded;
+      real length_factor;
+      bool store_velocities;
+      bool store_forces;
+      bool store_species;
+      int chunk_size; // particles per chunk, 0 picks a default
+      int compression; // deflate level, 0 disables the filter
+      bool append;
+
+      long long numParticles; // total number of particles of every frame
+
+      hid_t file;
+      hid_t dxpl; // collective transfer property list
+      hid_t realType; // HDF5 type of real
+      hid_t particlesGroup, boxGroup;
+      H5MDElement edges, position, velocity, force, id, species;
+    };
+  }
+}
+
+#endif
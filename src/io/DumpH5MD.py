@@ -0,0 +1,140 @@
+#  Copyright (C) 2017
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+r"""
+**********************
+espressopp.io.DumpH5MD
+**********************
+
+* `dump()`
+
+  appends the current configuration to an H5MD trajectory file. By default
+  filename is ``out.h5``, coordinates are folded.
+
+* `close()`
+
+  flushes and closes the file. Every frame is flushed by `dump()` anyway,
+  but the file should be closed before it is read by another program in
+  the same script.
+
+Contrary to the other dumpers the particles are not collected on one CPU:
+every CPU writes its own particles into the file with parallel HDF5
+(collective MPI-IO). Building this class requires a parallel HDF5 library
+and ``cmake -DWITH_H5MD=ON``.
+
+The file follows the H5MD 1.1 specification. The elements
+``/particles/all/position``, ``id`` (and ``velocity``, ``force``,
+``species`` if requested) hold one frame of ``N`` rows per dump, together
+with the ``step`` and ``time`` of the frame. The rows of a frame are
+ordered by CPU, not by particle id; use the ``id`` element to identify
+the particles. The box is stored in ``/particles/all/box/edges``.
+
+  **Properties**
+
+* `filename`
+  Name of trajectory file. By default trajectory file name is ``out.h5``
+
+* `unfolded`
+  False if coordinates are folded, True if unfolded. By default - False
+
+* `length_factor`
+  Factor applied to the positions, velocities and box edges. Default: 1.0
+
+* `store_velocities`, `store_forces`, `store_species`
+  Which elements are written besides position and id. By default
+  velocities and species are written, forces are not.
+
+* `chunk_size`
+  Number of particles per HDF5 chunk. 0 (default) takes 65536 or the number
+  of particles if it is smaller. Read only.
+
+* `compression`
+  Deflate level between 0 (no compression, default) and 9. Compressed
+  parallel writes require HDF5 1.10.2 or newer. Read only.
+
+* `append`
+  True if the frames are appended to an existing file with the same
+  number of particles. Otherwise an existing file is backed up.
+  By default - False
+
+usage:
+
+>>> dump_h5md = espressopp.io.DumpH5MD(system, integrator, filename='trajectory.h5',
+>>>                                    store_forces=True, compression=1)
+>>> ext_analyze = espressopp.integrator.ExtAnalyze(dump_h5md, 100)
+>>> integrator.addExtension(ext_analyze)
+>>> integrator.run(10000)
+>>> dump_h5md.close()
+
+.. function:: espressopp.io.DumpH5MD(system, integrator, filename='out.h5', unfolded=False,\
+                                     length_factor=1.0, store_velocities=True, store_forces=False,\
+                                     store_species=True, chunk_size=0, compression=0, append=False)
+
+	:param system:
+	:param integrator:
+	:param filename:
+	:param bool unfolded:
+	:param real length_factor:
+	:param bool store_velocities:
+	:param bool store_forces:
+	:param bool store_species:
+	:param int chunk_size:
+	:param int compression:
+	:param bool append:
+	:type system:
+	:type integrator:
+	:type filename:
+
+.. function:: espressopp.io.DumpH5MD.dump()
+
+		:rtype:
+
+.. function:: espressopp.io.DumpH5MD.close()
+
+		:rtype:
+"""
+
+from espressopp.esutil import cxxinit
+from espressopp import pmi
+
+from espressopp.ParticleAccess import *
+from _espressopp import io_DumpH5MD
+
+class DumpH5MDLocal(ParticleAccessLocal, io_DumpH5MD):
+
+  def __init__(self, system, integrator, filename='out.h5', unfolded=False, length_factor=1.0, store_velocities=True, store_forces=False, store_species=True, chunk_size=0, compression=0, append=False):
+    cxxinit(self, io_DumpH5MD, system, integrator, filename, unfolded, length_factor, store_velocities, store_forces, store_species, chunk_size, compression, append)
+
+  def dump(self):
+    if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+      self.cxxclass.dump(self)
+
+  def close(self):
+    if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+      self.cxxclass.close(self)
+
+
+if pmi.isController :
+  class DumpH5MD(ParticleAccess):
+    __metaclass__ = pmi.Proxy
+    pmiproxydefs = dict(
+      cls =  'espressopp.io.DumpH5MDLocal',
+      pmicall = [ 'dump', 'close' ],
+      pmiproperty = ['filename', 'unfolded', 'length_factor', 'store_velocities', 'store_forces', 'store_species', 'chunk_size', 'compression', 'append']
+    )
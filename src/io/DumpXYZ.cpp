@@ -48,53 +48,62 @@ namespace espressopp {
 
       if( system->comm->rank()==0 ){
         ConfigurationExtPtr conf_real = conf.back();
+        long long step = integrator->getStep();
+        Real3D Li = system->bc->getBoxL();
+
+        // the gathered frame is not touched by the integrator any more,
+        // so the formatting can overlap with the next steps
+        if (writer)
+          writer->submit(boost::bind(&DumpXYZ::write, this, conf_real, step, Li));
+        else
+          write(conf_real, step, Li);
+      }
+    }
 
-        int num_of_particles = conf_real->getSize();
-
-        char *ch_f_name = new char[file_name.length() + 1];
-        strcpy(ch_f_name, file_name.c_str());
-        ofstream myfile (ch_f_name, ios::out | ios::app);
-        if (myfile.is_open()){
-          myfile << num_of_particles << endl;
-
-          Real3D Li = system->bc->getBoxL();
-
-          // for noncubic simulation boxes
-          myfile << Li[0] * length_factor << "  0.0  0.0  0.0  "<<
-                  Li[1] * length_factor << "  0.0  0.0  0.0  "<< Li[2] * length_factor;
-          // additional info to comment line
-          myfile << "  currentStep " << integrator->getStep() << "  lengthUnit "<< length_unit << endl;
-
-          ConfigurationExtIterator cei = conf_real-> getIterator();
-          std::streamsize p = myfile.precision();
-          for (size_t i=0; i<num_of_particles; i++) {
-
-                if (store_pids)  {
-                    myfile << cei.currentId() << " ";
-                }
-
-                myfile << particleIDToType.find(cei.currentId())->second <<
-                       " " << fixed << setprecision(10) << length_factor * cei.currentProperties()[0] << " "
-                       << length_factor * cei.currentProperties()[1] <<
-                       " " << length_factor * cei.currentProperties()[2];
-
-                if (store_velocities) {
-                  myfile << " " << length_factor * cei.currentProperties()[3] << " " << length_factor * cei.currentProperties()[4] <<
-                  " " << length_factor * cei.currentProperties()[5];
-                }
-                myfile << endl;
-                myfile.unsetf(ios_base::fixed);
-                myfile << setprecision(p);
-
-                cei.incrementIterator();
-          }
-
-          myfile.close();
+    void DumpXYZ::write(ConfigurationExtPtr conf_real, long long step, Real3D Li){
+      int num_of_particles = conf_real->getSize();
+
+      char *ch_f_name = new char[file_name.length() + 1];
+      strcpy(ch_f_name, file_name.c_str());
+      ofstream myfile (ch_f_name, ios::out | ios::app);
+      if (myfile.is_open()){
+        myfile << num_of_particles << endl;
+
+        // for noncubic simulation boxes
+        myfile << Li[0] * length_factor << "  0.0  0.0  0.0  "<<
+                Li[1] * length_factor << "  0.0  0.0  0.0  "<< Li[2] * length_factor;
+        // additional info to comment line
+        myfile << "  currentStep " << step << "  lengthUnit "<< length_unit << endl;
+
+        ConfigurationExtIterator cei = conf_real-> getIterator();
+        std::streamsize p = myfile.precision();
+        for (size_t i=0; i<num_of_particles; i++) {
+
+              if (store_pids)  {
+                  myfile << cei.currentId() << " ";
+              }
+
+              myfile << particleIDToType.find(cei.currentId())->second <<
+                     " " << fixed << setprecision(10) << length_factor * cei.currentProperties()[0] << " "
+                     << length_factor * cei.currentProperties()[1] <<
+                     " " << length_factor * cei.currentProperties()[2];
+
+              if (store_velocities) {
+                myfile << " " << length_factor * cei.currentProperties()[3] << " " << length_factor * cei.currentProperties()[4] <<
+                " " << length_factor * cei.currentProperties()[5];
+              }
+              myfile << '\n';
+              myfile.unsetf(ios_base::fixed);
+              myfile << setprecision(p);
+
+              cei.incrementIterator();
         }
-        else cout << "Unable to open file: "<< file_name <<endl;
 
-        delete [] ch_f_name;
+        myfile.close();
       }
+      else cout << "Unable to open file: "<< file_name <<endl;
+
+      delete [] ch_f_name;
     }
 
     // Python wrapping
@@ -126,7 +135,10 @@ namespace espressopp {
                                      &DumpXYZ::setStoreVelocities)
         .add_property("append", &DumpXYZ::getAppend,
                                   &DumpXYZ::setAppend)
+        .add_property("asynchronous", &DumpXYZ::getAsynchronous,
+                                      &DumpXYZ::setAsynchronous)
         .def("dump", &DumpXYZ::dump)
+        .def("flush", &DumpXYZ::flush)
       ;
     }
   }
@@ -31,7 +31,10 @@
 #include "System.hpp"
 #include "integrator/MDIntegrator.hpp"
 #include "io/FileBackup.hpp"
+#include "io/AsyncWriter.hpp"
+#include "analysis/ConfigurationExt.hpp"
 #include <boost/serialization/map.hpp>
+#include <boost/bind.hpp>
 #include "esutil/Error.hpp"
 #include "ParticleAccess.hpp"
 #include "storage/Storage.hpp"
@@ -61,7 +64,8 @@ namespace espressopp {
                         length_factor(_length_factor),
                         store_pids(_store_pids),
                         store_velocities(_store_velocities),
-                        append(_append){
+                        append(_append),
+                        asynchronous(false){
           setLengthUnit(_length_unit);
 
           //get local particle ID map
@@ -92,8 +96,13 @@ namespace espressopp {
 
         if (system->comm->rank() == 0  && !append)
           FileBackup backup(file_name);
+
+        // frames written in the background must be on disk when run() returns
+        connectionFlush = integrator->runEnd.connect(boost::bind(&DumpXYZ::flush, this));
+      }
+      ~DumpXYZ() {
+        connectionFlush.disconnect();
       }
-      ~DumpXYZ() {}
 
       void perform_action(){
         dump();
@@ -101,16 +110,31 @@ namespace espressopp {
 
       void dump();
 
+      /// waits until the frames handed to the background writer are written
+      void flush(){
+        if (writer) writer->flush();
+      }
+
       std::string getFilename(){return file_name;}
-      void setFilename(std::string v){file_name = v;}
+      void setFilename(std::string v){flush(); file_name = v;}
       bool getUnfolded(){return unfolded;}
       void setUnfolded(bool v){unfolded = v;}
       bool getStorePids(){return store_pids;}
-      void setStorePids(bool v){store_pids = v;}
+      void setStorePids(bool v){flush(); store_pids = v;}
       bool getStoreVelocities(){return store_velocities;}
-      void setStoreVelocities(bool v){store_velocities = v;}
+      void setStoreVelocities(bool v){flush(); store_velocities = v;}
       bool getAppend(){return append;}
       void setAppend(bool v){append = v;}
+      bool getAsynchronous(){return asynchronous;}
+      void setAsynchronous(bool v){
+        asynchronous = v;
+        if (!v) {
+          flush();
+          writer.reset();
+        } else if (!writer && getSystem()->comm->rank() == 0) {
+          writer = make_shared<AsyncWriter>();
+        }
+      }
 
       std::string getLengthUnit(){return length_unit;}
       void setLengthUnit(std::string v){
@@ -122,10 +146,11 @@ namespace espressopp {
           err.checkException();
         }
 
+        flush();
         length_unit = v;
       }
       real getLengthFactor(){return length_factor;}
-      void setLengthFactor(real v){length_factor = v;}
+      void setLengthFactor(real v){flush(); length_factor = v;}
 
       static void registerPython();
 
@@ -135,6 +160,9 @@ namespace espressopp {
 
     private:
 
+      /// formats and writes a gathered frame, rank 0 only
+      void write(analysis::ConfigurationExtPtr conf_real, long long step, Real3D Li);
+
       // integrator we need to know an integration step
       shared_ptr<integrator::MDIntegrator> integrator;
 
@@ -149,6 +177,10 @@ namespace espressopp {
       bool store_velocities;
       real length_factor;
       std::string length_unit; // length unit: {could be LJ, nm, A} it is just for user info
+
+      bool asynchronous; // write in a background thread
+      shared_ptr<AsyncWriter> writer; // the background writer, only on rank 0
+      boost::signals2::connection connectionFlush;
     };
   }
 }
@@ -58,6 +58,18 @@ espressopp.io.DumpXYZ
     True if you want to store velocities. False otherwise (XYZ doesn't require it)
     Default: False
 
+* `asynchronous`
+    True if the frames are formatted and written by a background thread on
+    CPU 0, while the integration continues. The configuration is still
+    gathered in `dump()`; at most one further frame waits for the writer.
+    All frames are on disk at the end of ``integrator.run()`` or after
+    `flush()`. Default: False
+
+* `flush()`
+
+  waits until all frames are written. Only needed in asynchronous mode if
+  the file is read before the next ``integrator.run()`` returns.
+
 usage:
 
 writing down trajectory
@@ -108,6 +120,10 @@ will produce trj.xyz with in nanometers
 .. function:: espressopp.io.DumpXYZ.dump()
 
 		:rtype:
+
+.. function:: espressopp.io.DumpXYZ.flush()
+
+		:rtype:
         
 """
 
@@ -126,12 +142,16 @@ class DumpXYZLocal(ParticleAccessLocal, io_DumpXYZ):
     if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
       self.cxxclass.dump(self)
 
+  def flush(self):
+    if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+      self.cxxclass.flush(self)
+
 
 if pmi.isController :
   class DumpXYZ(ParticleAccess):
     __metaclass__ = pmi.Proxy
     pmiproxydefs = dict(
       cls =  'espressopp.io.DumpXYZLocal',
-      pmicall = [ 'dump' ],
-      pmiproperty = ['filename', 'unfolded', 'length_factor', 'length_unit', 'store_pids', 'store_velocities', 'append']
+      pmicall = [ 'dump', 'flush' ],
+      pmiproperty = ['filename', 'unfolded', 'length_factor', 'length_unit', 'store_pids', 'store_velocities', 'append', 'asynchronous']
     )
@@ -33,3 +33,8 @@ try:
 except ImportError:
     pass
 
+try:
+    from espressopp.io.DumpH5MD import *
+except ImportError:
+    pass
+
@@ -32,6 +32,10 @@
 #include "DumpXTC.hpp"
 #endif
 
+#ifdef HAS_H5MD
+#include "DumpH5MD.hpp"
+#endif
+
 namespace espressopp {
   namespace io{
     void registerPython() {
@@ -40,6 +44,9 @@ namespace espressopp {
       DumpGROAdress::registerPython();
 #ifdef HAS_GROMACS
       DumpXTC::registerPython();
+#endif
+#ifdef HAS_H5MD
+      DumpH5MD::registerPython();
 #endif
     }
   }
@@ -31,10 +31,21 @@
 
 namespace espressopp {
   namespace iterator {
+    /** Iterates over the pairs of particles of a cell list: the pairs
+        within each cell, and the pairs with the neighbor cells that are
+        not marked useForAllPairs.
+
+        The second constructor also takes the ghost cells. For these only
+        the pairs with their neighbor cells are visited, not the pairs
+        within a ghost cell. Ghost cells only have neighbors if the
+        decomposition assigns ghost-ghost cell pairs to this node, as with
+        an eighth-shell ghost import; otherwise both give the same pairs.
+    */
     class CellListAllPairsIterator {
     public:
       CellListAllPairsIterator();
       CellListAllPairsIterator(CellList &cl); 
+      CellListAllPairsIterator(CellList &realCells, CellList &ghostCells);
       
       CellListAllPairsIterator &operator++();
       
@@ -47,10 +58,22 @@ namespace espressopp {
     private:
       static LOG4ESPP_DECL_LOGGER(theLogger);
 
+      void init(CellList &cl);
+      // skip to the next cell with pairs, starting at cit
+      bool enterCell();
+      // go to the next neighbor cell, or the next cell
+      bool nextPartnerCell();
+      // advance npit to the next pair, starting at the current npit
+      void findPair();
+
       ParticlePair current;
 
       bool inSelfLoop;
 
+      // ghost cells to visit after the cell list, or 0
+      CellList *ghostCells;
+      bool inGhostCells;
+
       // current cell
       CellList::Iterator cit;
       // current particle
@@ -71,53 +94,101 @@ namespace espressopp {
 
     inline 
     CellListAllPairsIterator::
-    CellListAllPairsIterator(CellList &cl) {
+    CellListAllPairsIterator(CellList &cl)
+      : ghostCells(0) {
+      init(cl);
+    }
+
+    inline 
+    CellListAllPairsIterator::
+    CellListAllPairsIterator(CellList &realCells, CellList &_ghostCells)
+      : ghostCells(&_ghostCells) {
+      init(realCells);
+    }
+
+    inline void
+    CellListAllPairsIterator::
+    init(CellList &cl) {
+      inGhostCells = false;
       cit = CellList::Iterator(cl);
-      if (cit.isDone()) return;
-      inSelfLoop = true;
+      if (!enterCell()) return;
+
       pit = ParticleList::Iterator((*cit)->particles);
-      while (pit.isDone()) {
-        ++cit;
-        if (cit.isDone()) return;
-        pit = ParticleList::Iterator((*cit)->particles);
+      if (inSelfLoop) {
+        npit = pit;
+        ++npit;
+      } else {
+        npit = ParticleList::Iterator(ncit->cell->particles);
       }
-      
-      npit = pit; 
-      this->operator++();
+      findPair();
     }
 
-    inline CellListAllPairsIterator &
+    inline bool
     CellListAllPairsIterator::
-    operator++() {
-      ++npit;
-      while (npit.isDone()) {
-        ++pit;
-        while (pit.isDone()) {
-          if (inSelfLoop) {
-            LOG4ESPP_TRACE(theLogger, "pit.isDone(), inSelfLoop, starting neighbor loop");
-            inSelfLoop = false;
-            ncit = NeighborCellList::Iterator((*cit)->neighborCells);
-          } else {
-            LOG4ESPP_TRACE(theLogger, "pit.isDone(), !inSelfLoop, continuing neighbor loop");
-            ++ncit;
+    enterCell() {
+      while (true) {
+        if (cit.isDone()) {
+          if (!ghostCells || inGhostCells) {
+            LOG4ESPP_TRACE(theLogger, "cit.isDone(), LOOP FINISHED");
+            return false;
           }
+          LOG4ESPP_TRACE(theLogger, "cit.isDone(), continuing with the ghost cells");
+          inGhostCells = true;
+          cit = CellList::Iterator(*ghostCells);
+          continue;
+        }
 
+        if (!(*cit)->particles.empty()) {
+          if (!inGhostCells) {
+            inSelfLoop = true;
+            return true;
+          }
+          // no self loop for ghost cells, start with the first neighbor
+          inSelfLoop = false;
+          ncit = NeighborCellList::Iterator((*cit)->neighborCells);
           while (ncit.isValid() && ncit->useForAllPairs)
             ++ncit;
+          if (ncit.isValid())
+            return true;
+        }
+        ++cit;
+      }
+    }
 
-          if (ncit.isDone()) {
-            LOG4ESPP_TRACE(theLogger, "ncit.isDone(), go to next cell");
-            ++cit;
-            if (cit.isDone()) {
-              LOG4ESPP_TRACE(theLogger, "cit.isDone(), LOOP FINISHED");
-              return *this;
-            }
-            inSelfLoop = true;
-          }
-          //assert(inSelfLoop || ncit.isValid());
-          pit = ParticleList::Iterator((*cit)->particles);
+    inline bool
+    CellListAllPairsIterator::
+    nextPartnerCell() {
+      if (inSelfLoop) {
+        LOG4ESPP_TRACE(theLogger, "pit.isDone(), inSelfLoop, starting neighbor loop");
+        inSelfLoop = false;
+        ncit = NeighborCellList::Iterator((*cit)->neighborCells);
+      } else {
+        LOG4ESPP_TRACE(theLogger, "pit.isDone(), !inSelfLoop, continuing neighbor loop");
+        ++ncit;
+      }
+
+      while (ncit.isValid() && ncit->useForAllPairs)
+        ++ncit;
+
+      if (ncit.isDone()) {
+        LOG4ESPP_TRACE(theLogger, "ncit.isDone(), go to next cell");
+        ++cit;
+        if (!enterCell())
+          return false;
+      }
+      pit = ParticleList::Iterator((*cit)->particles);
+      return true;
+    }
+
+    inline void
+    CellListAllPairsIterator::
+    findPair() {
+      while (npit.isDone()) {
+        ++pit;
+        while (pit.isDone()) {
+          if (!nextPartnerCell())
+            return;
         }
-        //assert(pit.isValid());
 
         if (inSelfLoop) {
           npit = pit;
@@ -134,6 +205,13 @@ namespace espressopp {
              "current pair: (" << current.first->id() <<
              ", " << current.second->id() << ")"
              );
+    }
+
+    inline CellListAllPairsIterator &
+    CellListAllPairsIterator::
+    operator++() {
+      ++npit;
+      findPair();
       return *this;
     }
 
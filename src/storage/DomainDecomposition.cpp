@@ -25,6 +25,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <map>
 #include <sstream>
 #include "log4espp.hpp"
 #include "System.hpp"
@@ -48,6 +49,16 @@ namespace espressopp {
 
 
   const int DD_COMM_TAG = 0xab;
+  // tags of the flat ghost buffers, one per direction for positions and forces
+  const int DD_FLAT_POSITION_TAG = 0xb0;
+  const int DD_FLAT_FORCE_TAG = 0xb8;
+  // direct particle migration, alternating between two tags
+  const int DD_MIGRATE_TAG = 0xc0;
+
+  // reals per particle in the flat buffers: position, radius, extVar
+  const int FLAT_POSITION_SIZE = 5;
+  // force and fradius
+  const int FLAT_FORCE_SIZE = 4;
 
   LOG4ESPP_LOGGER(DomainDecomposition::logger, "DomainDecomposition");
 
@@ -69,22 +80,39 @@ namespace espressopp {
   DomainDecomposition(shared_ptr< System > _system,
           const Int3D& _nodeGrid,
           const Int3D& _cellGrid)
-    : Storage(_system), exchangeBufferSize(0) {
+    : Storage(_system), exchangeBufferSize(0), sortInterval(0), decomposeCount(0), cellSubdivision(1),
+      directMigration(false), migrationCount(0),
+      eighthShell(false), flatGhostComm(false), flatGhostCommReady(false), flatInFlight(false), flatStep(0),
+      flatNumPending(0), sharedGhostComm(false), nodeComm(MPI_COMM_NULL), sharedWinReady(false) {
     LOG4ESPP_INFO(logger, "node grid = "
           << _nodeGrid[0] << "x" << _nodeGrid[1] << "x" << _nodeGrid[2]
           << " cell grid = "
           << _cellGrid[0] << "x" << _cellGrid[1] << "x" << _cellGrid[2]);
 
+    for (int dir = 0; dir < 6; ++dir) {
+      for (int k = 0; k < 2; ++k) {
+        flatPositions[dir].requests[k] = MPI_REQUEST_NULL;
+        flatForces[dir].requests[k] = MPI_REQUEST_NULL;
+      }
+    }
+
     createCellGrid(_nodeGrid, _cellGrid);
     initCellInteractions();
     prepareGhostCommunication();
     LOG4ESPP_DEBUG(logger, "done");
   }
 
-  void DomainDecomposition:: createCellGrid(const Int3D& _nodeGrid, const Int3D& _cellGrid) {
-    real myLeft[3];
-    real myRight[3];
+  DomainDecomposition::~DomainDecomposition() {
+    freeFlatGhostComm();
+
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized && nodeComm != MPI_COMM_NULL) {
+      MPI_Comm_free(&nodeComm);
+    }
+  }
 
+  void DomainDecomposition:: createCellGrid(const Int3D& _nodeGrid, const Int3D& _cellGrid) {
     nodeGrid = NodeGrid(_nodeGrid, getSystem()->comm->rank(), getSystem()->bc->getBoxL());
 
     if (nodeGrid.getNumberOfCells() != getSystem()->comm->size()) {
@@ -105,12 +133,20 @@ namespace espressopp {
            << nodeGrid.getNodeNeighborIndex(4) << "<->"
            << nodeGrid.getNodeNeighborIndex(5));
 
+    createLocalCellGrid(_cellGrid);
+  }
+
+  void DomainDecomposition::createLocalCellGrid(const Int3D& _cellGrid) {
+    real myLeft[3];
+    real myRight[3];
+
     for (int i = 0; i < 3; ++i) {
       myLeft[i] = nodeGrid.getMyLeft(i);
       myRight[i] = nodeGrid.getMyRight(i);
     }
 
-    cellGrid = CellGrid(_cellGrid, myLeft, myRight, 1);
+    // pairs reach over cellSubdivision cells, so the ghost frame is as wide
+    cellGrid = CellGrid(_cellGrid, myLeft, myRight, cellSubdivision);
 
     LOG4ESPP_INFO(logger, "local box "
           << myLeft[0] << "-" << myRight[0] << ", "
@@ -167,7 +203,7 @@ namespace espressopp {
     real maxCut = getSystem() -> maxCutoff;
     real skinL = getSystem() -> getSkin();
     real cs = maxCut + skinL;
-    if( cs > s*cellGrid.getSmallestCellDiameter() ){
+    if( cs > s*cellSubdivision*cellGrid.getSmallestCellDiameter() ){
       Real3D Li = getSystem() -> bc -> getBoxL(); // getting the system size
       real minL = min(Li[0], min(Li[1],Li[2]));
       if(cs > minL){
@@ -192,7 +228,7 @@ namespace espressopp {
     real maxCut = getSystem() -> maxCutoff;
     real skinL = getSystem() -> getSkin();
     real cs = maxCut + skinL;
-    real cellD = cellGrid.getSmallestCellDiameter();
+    real cellD = cellSubdivision * cellGrid.getSmallestCellDiameter();
     
     real r0 = s[0]*cellD;
     real r1 = s[1]*cellD;
@@ -229,21 +265,67 @@ namespace espressopp {
                 );
   }
 
+  Int3D DomainDecomposition::calcLocalCellGrid() {
+    real rc_skin = getSystem() -> maxCutoff + getSystem() -> getSkin();
+    return Int3D((int)(nodeGrid.getLocalBoxSize(0) / rc_skin) * cellSubdivision,
+                 (int)(nodeGrid.getLocalBoxSize(1) / rc_skin) * cellSubdivision,
+                 (int)(nodeGrid.getLocalBoxSize(2) / rc_skin) * cellSubdivision);
+  }
+
   void DomainDecomposition::cellAdjust(){
-    // create an appropriate cell grid
+    // nodeGrid is already defined, but may still have the old box size
     Real3D box_sizeL = getSystem() -> bc -> getBoxL();
-    real skinL = getSystem() -> getSkin();
-    real maxCutoffL = getSystem() -> maxCutoff;
-            
-    // nodeGrid is already defined
-    Int3D _nodeGrid(nodeGrid.getGridSize());
-    // new cellGrid
-    real rc_skin = maxCutoffL + skinL;
-    int ix = (int)(box_sizeL[0] / (rc_skin * _nodeGrid[0]));
-    int iy = (int)(box_sizeL[1] / (rc_skin * _nodeGrid[1]));
-    int iz = (int)(box_sizeL[2] / (rc_skin * _nodeGrid[2]));
-    Int3D _newCellGrid(ix, iy, iz);
+    Real3D s;
+    for (int i = 0; i < 3; ++i) {
+      s[i] = box_sizeL[i] / nodeGrid.getDomainBounds(i).back();
+    }
+    nodeGrid.scaleVolume(s);
+
+    // create an appropriate cell grid
+    rebuildCellGrid(calcLocalCellGrid());
+  }
+
+  void DomainDecomposition::setDomainBounds(const std::vector<real> bounds[3]) {
+    real rc_skin = getSystem() -> maxCutoff + getSystem() -> getSkin();
+    for (int i = 0; i < 3; ++i) {
+      if (static_cast<longint>(bounds[i].size()) != nodeGrid.getGridSize(i) + 1) {
+        stringstream msg;
+        msg << "need " << nodeGrid.getGridSize(i) + 1 << " domain boundaries along axis "
+            << i << ", got " << bounds[i].size();
+        throw std::invalid_argument(msg.str());
+      }
+      for (size_t j = 1; j < bounds[i].size(); ++j) {
+        if (bounds[i][j] - bounds[i][j - 1] < rc_skin) {
+          stringstream msg;
+          msg << "domain " << j - 1 << " along axis " << i << " is "
+              << bounds[i][j] - bounds[i][j - 1] << " wide, smaller than cutoff+skin " << rc_skin;
+          throw std::invalid_argument(msg.str());
+        }
+      }
+    }
+    bool changed[3];
+    for (int i = 0; i < 3; ++i) {
+      changed[i] = (bounds[i] != nodeGrid.getDomainBounds(i));
+      nodeGrid.setDomainBounds(i, bounds[i]);
+    }
+    if (!changed[0] && !changed[1] && !changed[2]) return;
+
+    LOG4ESPP_INFO(logger, "new local box "
+          << nodeGrid.getMyLeft(0) << "-" << nodeGrid.getMyRight(0) << ", "
+          << nodeGrid.getMyLeft(1) << "-" << nodeGrid.getMyRight(1) << ", "
+          << nodeGrid.getMyLeft(2) << "-" << nodeGrid.getMyRight(2));
 
+    /* the cell counts only depend on the width of the slab along each
+       axis, so neighboring domains agree on the size of their common
+       faces. Axes that did not change keep their cells. */
+    Int3D newCellGrid = calcLocalCellGrid();
+    for (int i = 0; i < 3; ++i) {
+      if (!changed[i]) newCellGrid[i] = cellGrid.getGridSize(i);
+    }
+    rebuildCellGrid(newCellGrid);
+  }
+
+  void DomainDecomposition::rebuildCellGrid(const Int3D& _newCellGrid) {
     // save all particles to temporary vector
     std::vector<ParticleList> tmp_pl;
     size_t _N = realCells.size();
@@ -253,6 +335,7 @@ namespace espressopp {
     }
     
     // reset all cells info
+    particleArrays.invalidate();
     invalidateGhosts();
     cells.clear();
     localCells.clear();
@@ -264,11 +347,12 @@ namespace espressopp {
     }
     
     // creating new grids
-    createCellGrid(_nodeGrid, _newCellGrid);
+    createLocalCellGrid(_newCellGrid);
     initCellInteractions();
     prepareGhostCommunication();
     
-    // pushing the particles back to the empty cell ("do we have to check particles?")
+    // pushing the particles back to the empty cells, particles outside
+    // of the local domain are kept in the border cells for now
     for(int i=0; i<tmp_pl.size(); i++){
       for (size_t p = 0; p < tmp_pl[i].size(); ++p) {
         Particle& part = tmp_pl[i][p];
@@ -281,14 +365,53 @@ namespace espressopp {
     for(CellList::Iterator it(realCells); it.isValid(); ++it) {
       updateLocalParticles((*it)->particles);
     }
-    
+
+    // and sent to their node here, if the domains have changed
+    decomposeRealParticles();
     exchangeGhosts();
     onParticlesChanged();
   }
 
+  bool DomainDecomposition::isInteractingOffset(int dm, int dn, int dp) const {
+    /* the cells are at least (cutoff+skin)/cellSubdivision wide, so the
+       grid supports pairs up to cellSubdivision times the smallest cell
+       size. Cells whose closest points are further apart never hold a
+       pair; with one cell per cutoff, this keeps all 26 neighbors. */
+    real range = cellSubdivision * std::min(std::min(cellGrid.getCellSize(0),
+                                                     cellGrid.getCellSize(1)),
+                                            cellGrid.getCellSize(2));
+    int d[3] = { dm, dn, dp };
+    real distSqr = 0.0;
+    for (int i = 0; i < 3; ++i) {
+      real gap = std::max(std::abs(d[i]) - 1, 0) * cellGrid.getCellSize(i);
+      distSqr += gap * gap;
+    }
+    // tolerate rounding for cells exactly at the range
+    return distSqr <= range * range * (1.0 + 1e-10);
+  }
+
   void DomainDecomposition::initCellInteractions() {
+    if (eighthShell) {
+      initEighthShellInteractions();
+      return;
+    }
+
     LOG4ESPP_DEBUG(logger, "setting up neighbors for " << cells.size() << " cells");
 
+    // neighbor offsets up to the frame width, without the cells out of range
+    int w = cellGrid.getFrameWidth();
+    std::vector<Int3D> stencil;
+    for (int p = -w; p <= w; ++p) {
+      for (int q = -w; q <= w; ++q) {
+        for (int r = -w; r <= w; ++r) {
+          if ((p != 0 || q != 0 || r != 0) && isInteractingOffset(r, q, p)) {
+            stencil.push_back(Int3D(r, q, p));
+          }
+        }
+      }
+    }
+    LOG4ESPP_DEBUG(logger, "stencil of " << stencil.size() << " neighbor cells");
+
     for (int o = cellGrid.getInnerCellsBegin(2); o < cellGrid.getInnerCellsEnd(2); ++o) {
       for (int n = cellGrid.getInnerCellsBegin(1); n < cellGrid.getInnerCellsEnd(1); ++n) {
         for (int m = cellGrid.getInnerCellsBegin(0); m < cellGrid.getInnerCellsEnd(0); ++m) {
@@ -298,23 +421,86 @@ namespace espressopp {
           LOG4ESPP_TRACE(logger, "setting up neighbors for cell " << cell - getFirstCell()
                 << " @ " << m << " " << n << " " << o);
 
-          // there should be always 26 neighbors
-          cell->neighborCells.reserve(26);
+          // 26 neighbors with one cell per cutoff
+          cell->neighborCells.reserve(stencil.size());
 
           // loop all neighbor cells
-          for (int p = o - 1; p <= o + 1; ++p) {
-            for (int q = n - 1; q <= n + 1; ++q) {
-              for (int r = m - 1; r <= m + 1; ++r) {
-                if (p != o || q != n || r != m) {
-                  longint cell2Idx = cellGrid.mapPositionToIndex(r, q, p);
-                  Cell *cell2 = &cells[cell2Idx];
-                  cell->neighborCells.push_back(NeighborCellInfo(cell2, (cell2Idx<cellIdx)));
-
-                  LOG4ESPP_TRACE(logger, "neighbor cell " << cell2 - getFirstCell()
-                        << " @ " << r << " " << q << " " << p << ((cell2Idx<cellIdx) ? " is" : " is not") << " taken" );
-                }
-              }
+          for (size_t k = 0; k < stencil.size(); ++k) {
+            int r = m + stencil[k][0];
+            int q = n + stencil[k][1];
+            int p = o + stencil[k][2];
+            longint cell2Idx = cellGrid.mapPositionToIndex(r, q, p);
+            Cell *cell2 = &cells[cell2Idx];
+            cell->neighborCells.push_back(NeighborCellInfo(cell2, (cell2Idx<cellIdx)));
+
+            LOG4ESPP_TRACE(logger, "neighbor cell " << cell2 - getFirstCell()
+                  << " @ " << r << " " << q << " " << p << ((cell2Idx<cellIdx) ? " is" : " is not") << " taken" );
+          }
+        }
+      }
+    }
+
+    LOG4ESPP_DEBUG(logger, "done");
+  }
+
+  void DomainDecomposition::initEighthShellInteractions() {
+    LOG4ESPP_DEBUG(logger, "setting up eighth-shell neighbors for " << cells.size() << " cells");
+
+    /* a pair of neighboring cells is handled by the node that owns the
+       cell at its lower corner, i.e. at the componentwise minimum of
+       the two grid positions. Seen from this corner cell c, the pair is
+       c + a, c + b with a, b in {0..w}^3 and no axis on which both are
+       nonzero, w being the frame width. These pairs only touch c and
+       cells above it, which are real or in the upper ghost frame, but
+       both cells may be ghosts. Per axis, digit 0 of code means
+       a = b = 0, 1..w means a = digit, and w+1..2w means b = digit - w;
+       swapping a and b shifts the digits by w, so we keep the codes
+       whose first nonzero digit is at most w. With w = 1 these are the
+       13 pairs of a 2x2x2 block. */
+    int w = cellGrid.getFrameWidth();
+    int base = 2 * w + 1;
+    std::vector<Int3D> shell[2];
+    for (int code = 1; code < base * base * base; ++code) {
+      int digit[3] = { code % base, (code / base) % base, code / (base * base) };
+      int first = (digit[0] != 0) ? digit[0] : ((digit[1] != 0) ? digit[1] : digit[2]);
+      if (first > w) continue;
+      Int3D a, b;
+      for (int i = 0; i < 3; ++i) {
+        a[i] = (digit[i] <= w) ? digit[i] : 0;
+        b[i] = (digit[i] > w) ? digit[i] - w : 0;
+      }
+      if (!isInteractingOffset(b[0] - a[0], b[1] - a[1], b[2] - a[2])) continue;
+      shell[0].push_back(a);
+      shell[1].push_back(b);
+    }
+    int nPairs = shell[0].size();
+    LOG4ESPP_DEBUG(logger, "stencil of " << nPairs << " cell pairs");
+
+    for (int o = cellGrid.getInnerCellsBegin(2); o < cellGrid.getInnerCellsEnd(2); ++o) {
+      for (int n = cellGrid.getInnerCellsBegin(1); n < cellGrid.getInnerCellsEnd(1); ++n) {
+        for (int m = cellGrid.getInnerCellsBegin(0); m < cellGrid.getInnerCellsEnd(0); ++m) {
+          cells[cellGrid.mapPositionToIndex(m, n, o)].neighborCells.reserve(nPairs);
+
+          for (int k = 0; k < nPairs; ++k) {
+            int pos[2][3];
+            bool real[2];
+            for (int c = 0; c < 2; ++c) {
+              pos[c][0] = m + shell[c][k][0];
+              pos[c][1] = n + shell[c][k][1];
+              pos[c][2] = o + shell[c][k][2];
+              real[c] = pos[c][0] < cellGrid.getInnerCellsEnd(0) &&
+                        pos[c][1] < cellGrid.getInnerCellsEnd(1) &&
+                        pos[c][2] < cellGrid.getInnerCellsEnd(2);
             }
+            // the pair loops visit the real cells first, so prefer these
+            int c1 = (real[0] || !real[1]) ? 0 : 1;
+            int c2 = 1 - c1;
+            Cell *cell = &cells[cellGrid.mapPositionToIndex(pos[c1][0], pos[c1][1], pos[c1][2])];
+            Cell *cell2 = &cells[cellGrid.mapPositionToIndex(pos[c2][0], pos[c2][1], pos[c2][2])];
+            cell->neighborCells.push_back(NeighborCellInfo(cell2, false));
+
+            LOG4ESPP_TRACE(logger, "cell pair " << cell - getFirstCell() << " - " << cell2 - getFirstCell()
+                  << " handled by cell @ " << m << " " << n << " " << o);
           }
         }
       }
@@ -379,6 +565,21 @@ namespace espressopp {
   }
 
   void DomainDecomposition::decomposeRealParticles() {
+    if (directMigration) {
+      migrateRealParticles();
+    } else {
+      shiftRealParticles();
+    }
+
+    if (sortInterval > 0 && ++decomposeCount >= sortInterval) {
+      sortRealCells();
+      decomposeCount = 0;
+    }
+
+    LOG4ESPP_DEBUG(logger, "done");
+  }
+
+  void DomainDecomposition::shiftRealParticles() {
 
       //std::cout << getSystem()->comm->rank() << ": " << " decomposeRealParticles\n";
 
@@ -533,29 +734,365 @@ namespace espressopp {
                                  recvBufR.capacity()))));
 
     LOG4ESPP_DEBUG(logger, "finished exchanging particles, new send/recv buffer size " << exchangeBufferSize);
+  }
 
-    LOG4ESPP_DEBUG(logger, "done");
+  void DomainDecomposition::migrateRealParticles() {
+    LOG4ESPP_DEBUG(logger, "migrating particles directly to their nodes");
+
+    MPI_Comm comm = *getSystem()->comm;
+    longint myRank = getSystem()->comm->rank();
+    const bc::BC &bc = *getSystem()->bc;
+
+    /* a node can be at most one migration ahead of another one, since
+       it cannot pass the barrier of the next migration alone. With two
+       tags, it never mixes its messages into a migration still running
+       on a slower node. */
+    int tag = DD_MIGRATE_TAG + (migrationCount++ & 1);
+
+    // the particles that leave, by destination node
+    std::map< longint, ParticleList > sendLists;
+
+    for (std::vector<Cell*>::iterator it = realCells.begin(),
+      end = realCells.end(); it != end; ++it) {
+      Cell &cell = **it;
+
+      // do not use an iterator here, since we need to take out particles during the loop
+      for (size_t p = 0; p < cell.particles.size(); ++p) {
+        Particle &part = cell.particles[p];
+        Real3D &pos = part.position();
+
+        // isnan function is C99 only, x != x is only true if x == nan
+        if (pos[0] != pos[0] || pos[1] != pos[1] || pos[2] != pos[2]) {
+          LOG4ESPP_ERROR(logger, "particle " << part.id() <<
+                  " has moved to outer space (one or more coordinates are nan)");
+          continue;
+        }
+
+        bool inside = true;
+        for (int coord = 0; coord < 3; ++coord) {
+          if (nodeGrid.getGridSize(coord) == 1) {
+            bc.foldCoordinate(pos, part.image(), coord);
+          } else if (pos[coord] - nodeGrid.getMyLeft(coord) < -ROUND_ERROR_PREC ||
+                     pos[coord] - nodeGrid.getMyRight(coord) >= ROUND_ERROR_PREC) {
+            inside = false;
+          }
+        }
+
+        if (!inside) {
+          bc.foldPosition(pos, part.image());
+          longint node = nodeGrid.mapPositionToNodeClipped(pos);
+          if (node != myRank) {
+            LOG4ESPP_TRACE(logger, "send particle " << part.id() << " to node " << node);
+            moveIndexedParticle(sendLists[node], cell.particles, p);
+            --p;
+            continue;
+          }
+        }
+
+        Cell *sortCell = mapPositionToCellClipped(pos);
+        if (sortCell != &cell) {
+          moveIndexedParticle(sortCell->particles, cell.particles, p);
+          --p;
+        }
+      }
+    }
+
+    /* pack one message per destination: the whole particles, serialized
+       like in the neighbor exchange, followed by the tuple data */
+    OutBuffer &data = outBuffer;
+    data.reset();
+    std::vector< longint > destinations;
+    std::vector< int > offsets(1, 0);
+    for (std::map< longint, ParticleList >::iterator it = sendLists.begin(),
+      end = sendLists.end(); it != end; ++it) {
+      ParticleList &list = it->second;
+      int size = list.size();
+      data.write(size);
+      for (ParticleList::Iterator pit(list); pit.isValid(); ++pit) {
+        removeFromLocalParticles(&(*pit));
+        data.write(*pit);
+      }
+      beforeSendParticles(list, data);
+
+      destinations.push_back(it->first);
+      offsets.push_back(data.getSize());
+    }
+
+    // synchronous sends: completed once the destination has matched them
+    std::vector< MPI_Request > sends(destinations.size());
+    for (size_t i = 0; i < destinations.size(); ++i) {
+      MPI_Issend(data.getData() + offsets[i], offsets[i + 1] - offsets[i], MPI_CHAR,
+                 destinations[i], tag, comm, &sends[i]);
+    }
+
+    /* receive whatever arrives until all nodes had their sends matched,
+       which the barrier tells once every node has entered it. */
+    std::vector< char > recvData;
+    ParticleList recvList;
+    MPI_Request barrier = MPI_REQUEST_NULL;
+    bool done = false;
+    while (!done) {
+      int arrived;
+      MPI_Status status;
+      MPI_Iprobe(MPI_ANY_SOURCE, tag, comm, &arrived, &status);
+      if (arrived) {
+        int bytes;
+        MPI_Get_count(&status, MPI_CHAR, &bytes);
+        recvData.resize(std::max(bytes, 1));
+        MPI_Recv(&recvData[0], bytes, MPI_CHAR, status.MPI_SOURCE, tag, comm, MPI_STATUS_IGNORE);
+
+        InBuffer &in = inBuffer;
+        in.assign(&recvData[0], bytes);
+        int size;
+        in.read(size);
+        LOG4ESPP_DEBUG(logger, "got " << size << " particles from node " << status.MPI_SOURCE);
+
+        recvList.resize(size);
+        for (int i = 0; i < size; ++i) {
+          Particle *p = &recvList[i];
+          in.read(*p);
+          updateInLocalParticles(p);
+        }
+        afterRecvParticles(recvList, in);
+
+        // already folded by the sender
+        for (ParticleList::iterator pit = recvList.begin(), pend = recvList.end(); pit != pend; ++pit) {
+          longint cell;
+          if (cellGrid.mapPositionToCellCheckedAndClipped(cell, pit->position())) {
+            LOG4ESPP_DEBUG(logger, "particle " << pit->id() << " @ " << pit->position()
+                    << " is not inside node domain, clipped");
+          }
+          appendIndexedParticle(cells[cell].particles, *pit);
+        }
+        recvList.resize(0);
+      }
+
+      if (barrier == MPI_REQUEST_NULL) {
+        int sent;
+        MPI_Testall(sends.size(), sends.data(), &sent, MPI_STATUSES_IGNORE);
+        if (sent) {
+          MPI_Ibarrier(comm, &barrier);
+        }
+      } else {
+        int reached;
+        MPI_Test(&barrier, &reached, MPI_STATUS_IGNORE);
+        done = reached;
+      }
+    }
+
+    LOG4ESPP_DEBUG(logger, "sent particles to " << destinations.size() << " nodes");
+  }
+
+  namespace {
+    /// insert two zero bits between each of the lower 21 bits of v
+    inline unsigned long long spreadBits(unsigned long long v) {
+      v &= 0x1fffffULL;
+      v = (v | (v << 32)) & 0x1f00000000ffffULL;
+      v = (v | (v << 16)) & 0x1f0000ff0000ffULL;
+      v = (v | (v << 8))  & 0x100f00f00f00f00fULL;
+      v = (v | (v << 4))  & 0x10c30c30c30c30c3ULL;
+      v = (v | (v << 2))  & 0x1249249249249249ULL;
+      return v;
+    }
+  }
+
+  void DomainDecomposition::sortRealCells() {
+    LOG4ESPP_DEBUG(logger, "sort the real cells and their particles along a Morton curve");
+
+    /* the cells by the key of their position in the local grid, so that
+       the particles in cell order follow the curve across the domain */
+    std::vector< std::pair< unsigned long long, Cell* > > cellKeys(realCells.size());
+    for (size_t c = 0; c < realCells.size(); ++c) {
+      Int3D pos;
+      cellGrid.mapIndexToPosition(pos, realCells[c] - getFirstCell());
+      unsigned long long key = 0;
+      for (int d = 0; d < 3; ++d) {
+        key |= spreadBits(pos[d] - cellGrid.getInnerCellsBegin(d)) << d;
+      }
+      cellKeys[c] = std::make_pair(key, realCells[c]);
+    }
+    std::sort(cellKeys.begin(), cellKeys.end());
+    for (size_t c = 0; c < cellKeys.size(); ++c) {
+      realCells[c] = cellKeys[c].second;
+    }
+
+    // quantize the positions to 21 bits per direction over the local domain
+    const real nbins = real(1 << 21);
+    real scale[3];
+    for (int d = 0; d < 3; ++d) {
+      scale[d] = nbins / (cellGrid.getMyRight(d) - cellGrid.getMyLeft(d));
+    }
+
+    std::vector< std::pair< unsigned long long, size_t > > keys;
+    ParticleList sorted;
+    for (std::vector<Cell*>::iterator it = realCells.begin(),
+           end = realCells.end(); it != end; ++it) {
+      ParticleList &pl = (*it)->particles;
+      if (pl.size() < 2) continue;
+
+      keys.resize(pl.size());
+      for (size_t p = 0; p < pl.size(); ++p) {
+        const Real3D &pos = pl[p].position();
+        unsigned long long key = 0;
+        for (int d = 0; d < 3; ++d) {
+          real q = (pos[d] - cellGrid.getMyLeft(d)) * scale[d];
+          q = std::min(std::max(q, real(0.0)), nbins - 1);
+          key |= spreadBits(static_cast< unsigned long long >(q)) << d;
+        }
+        keys[p] = std::make_pair(key, p);
+      }
+      std::sort(keys.begin(), keys.end());
+
+      sorted.clear();
+      sorted.reserve(pl.size());
+      for (size_t p = 0; p < keys.size(); ++p) {
+        sorted.push_back(pl[keys[p].second]);
+      }
+      pl.swap(sorted);
+      updateLocalParticles(pl);
+    }
+  }
+
+  bool DomainDecomposition::checkParticlesLeftCells() {
+    bool left = false;
+    for (std::vector<Cell*>::iterator it = realCells.begin(),
+           end = realCells.end(); it != end && !left; ++it) {
+      Cell *cell = *it;
+      for (ParticleList::iterator pit = cell->particles.begin(),
+             pend = cell->particles.end(); pit != pend; ++pit) {
+        // this also catches particles that left the node or the box
+        if (mapPositionToCellChecked(pit->position()) != cell) {
+          LOG4ESPP_DEBUG(logger, "particle " << pit->id() << " left its cell");
+          left = true;
+          break;
+        }
+      }
+    }
+
+    bool anyLeft;
+    mpi::all_reduce(*getSystem()->comm, left, anyLeft, std::logical_or<bool>());
+    return anyLeft;
   }
 
   void DomainDecomposition::exchangeGhosts() {
 
     LOG4ESPP_DEBUG(logger, "exchangeGhosts -> ghost communication sizes first, real->ghost");
     doGhostCommunication(true, true, dataOfExchangeGhosts);
+
+    if (flatGhostComm) {
+      setupFlatGhostComm();
+    }
+
+    if (useParticleArrays) {
+      particleArrays.rebuild(realCells, ghostCells);
+    }
   }
 
   void DomainDecomposition::updateGhosts() {
+    updateGhostsBegin();
+    updateGhostsEnd();
+  }
+
+  void DomainDecomposition::updateGhostsBegin() {
     LOG4ESPP_DEBUG(logger, "updateGhosts -> ghost communication no sizes, real->ghost");
-    doGhostCommunication(false, true, dataOfUpdateGhosts);
+    if (flatGhostCommReady) {
+      beginFlatGhostComm(true);
+    } else {
+      doGhostCommunication(false, true, dataOfUpdateGhosts);
+    }
+  }
+
+  void DomainDecomposition::updateGhostsEnd() {
+    if (flatGhostCommReady) {
+      endFlatGhostComm(true);
+    }
+
+    if (useParticleArrays) {
+      particleArrays.updatePositions();
+    }
   }
 
   void DomainDecomposition::updateGhostsV() {
     LOG4ESPP_DEBUG(logger, "updateGhostsV -> ghost communication no sizes, real->ghost velocities");
     doGhostCommunication(false, true, 2); // 2 is the bitflag for particle momentum
+
+    if (useParticleArrays) {
+      particleArrays.updateVelocities();
+    }
   }
 
   void DomainDecomposition::collectGhostForces() {
+    collectGhostForcesBegin();
+    collectGhostForcesEnd();
+  }
+
+  void DomainDecomposition::collectGhostForcesBegin() {
     LOG4ESPP_DEBUG(logger, "collectGhosts -> ghost communication no sizes, ghost->real");
-    doGhostCommunication(false, false);
+    if (flatGhostCommReady) {
+      beginFlatGhostComm(false);
+    } else {
+      doGhostCommunication(false, false);
+    }
+  }
+
+  void DomainDecomposition::collectGhostForcesEnd() {
+    if (flatGhostCommReady) {
+      endFlatGhostComm(false);
+    }
+  }
+
+  void DomainDecomposition::setFlatGhostComm(bool _flatGhostComm) {
+    if (!_flatGhostComm && sharedGhostComm) {
+      throw std::invalid_argument("switch off sharedGhostComm before flatGhostComm");
+    }
+    flatGhostComm = _flatGhostComm;
+    // the buffers are sized at the next ghost exchange
+    if (!flatGhostComm) {
+      freeFlatGhostComm();
+    }
+  }
+
+  void DomainDecomposition::setSharedGhostComm(bool _sharedGhostComm) {
+    // only the flat buffers can be shared
+    if (_sharedGhostComm && !flatGhostComm) {
+      throw std::invalid_argument("sharedGhostComm needs flatGhostComm");
+    }
+    sharedGhostComm = _sharedGhostComm;
+    // the send buffers move at the next ghost exchange
+    freeFlatGhostComm();
+  }
+
+  void DomainDecomposition::setEighthShell(bool _eighthShell) {
+    if (eighthShell == _eighthShell) return;
+    // the lists that need all ghosts throw here, on all CPUs alike
+    if (_eighthShell) beforePartialGhostShell();
+    eighthShell = _eighthShell;
+    // same cells, but other neighbor cells, communication and ghosts
+    rebuildCellGrid(Int3D(cellGrid.getGridSize(0), cellGrid.getGridSize(1), cellGrid.getGridSize(2)));
+  }
+
+  void DomainDecomposition::setCellSubdivision(int _cellSubdivision) {
+    if (_cellSubdivision < 1) {
+      throw std::invalid_argument("cellSubdivision has to be at least 1");
+    }
+    if (_cellSubdivision == cellSubdivision) return;
+
+    // as many cutoff-sized cells as before, each split _cellSubdivision times per axis
+    Int3D newCellGrid;
+    for (int i = 0; i < 3; ++i) {
+      newCellGrid[i] = std::max(cellGrid.getGridSize(i) / cellSubdivision, 1) * _cellSubdivision;
+    }
+    cellSubdivision = _cellSubdivision;
+    rebuildCellGrid(newCellGrid);
+  }
+
+  void DomainDecomposition::setUseParticleArrays(bool _useParticleArrays) {
+    useParticleArrays = _useParticleArrays;
+    if (useParticleArrays) {
+      particleArrays.rebuild(realCells, ghostCells);
+    } else {
+      particleArrays.invalidate();
+    }
   }
 
   void DomainDecomposition::fillCells(std::vector<Cell *> &cv,
@@ -604,7 +1141,8 @@ namespace espressopp {
         for (int offset = 1; offset <= 2; ++offset) {
             int otherCoord = (coord + offset) % 3;
             if (otherCoord < coord) {
-                leftBoundary[otherCoord] = 0;
+                // the lower ghost frame stays empty with the eighth shell
+                leftBoundary[otherCoord] = eighthShell ? cellGrid.getInnerCellsBegin(otherCoord) : 0;
                 rightBoundary[otherCoord] = cellGrid.getFrameGridSize(otherCoord);
             } else {
                 leftBoundary[otherCoord] = cellGrid.getInnerCellsBegin(otherCoord);
@@ -612,8 +1150,10 @@ namespace espressopp {
             }
         }
 
-        //  lr loop: left right - loop
-        for (int lr = 0; lr < 2; ++lr) {
+        /* lr loop: left right - loop. With the eighth shell, only the
+           reals at the left boundary go to the upper ghost frame of the
+           left neighbor */
+        for (int lr = 0; lr < (eighthShell ? 1 : 2); ++lr) {
             int dir = 2 * coord + lr;
 
             /* participating real particles from this node */
@@ -649,9 +1189,8 @@ namespace espressopp {
            << (realToGhosts ? "reals to ghosts " : "ghosts to reals ") << extradata);
 
     /* direction loop: x, y, z.
-   Here we could in principle build in a one sided ghost
-   communication, simply by taking the lr loop only over one
-   value. */
+   The one sided ghost communication of the eighth shell simply
+   takes the lr loop only over one value. */
     for (int _coord = 0; _coord < 3; ++_coord) {
       /* inverted processing order for ghost force communication,
         since the corner ghosts have to be collected via several
@@ -663,7 +1202,7 @@ namespace espressopp {
       real curCoordBoxL = getSystem()->bc->getBoxL()[coord];
 
       // lr loop: left right
-      for (int lr = 0; lr < 2; ++lr) {
+      for (int lr = 0; lr < (eighthShell ? 1 : 2); ++lr) {
         int dir         = 2 * coord + lr;
         int oppositeDir = 2 * coord + (1 - lr);
 
@@ -767,9 +1306,389 @@ namespace espressopp {
     LOG4ESPP_DEBUG(logger, "ghost communication finished");
   }
 
+  void DomainDecomposition::setupFlatGhostComm() {
+    freeFlatGhostComm();
+
+    MPI_Comm comm = *getSystem()->comm;
+    MPI_Datatype type = mpi::get_mpi_datatype<real>();
+
+    for (int coord = 0; coord < 3; ++coord) {
+      for (int lr = 0; lr < 2; ++lr) {
+        int dir = 2 * coord + lr;
+        flatPositions[dir].sendCount = flatPositions[dir].recvCount = 0;
+        flatForces[dir].sendCount = flatForces[dir].recvCount = 0;
+        flatPositions[dir].sharedRecv = flatForces[dir].sharedRecv = 0;
+        flatPositions[dir].sharedSend = flatForces[dir].sharedSend = false;
+        if (nodeGrid.getGridSize(coord) == 1) {
+          // local copies, no buffers needed
+          continue;
+        }
+
+        longint nReals = 0, nGhosts = 0;
+        for (int i = 0, end = commCells[dir].reals.size(); i < end; ++i) {
+          nReals += commCells[dir].reals[i]->particles.size();
+        }
+        for (int i = 0, end = commCells[dir].ghosts.size(); i < end; ++i) {
+          nGhosts += commCells[dir].ghosts[i]->particles.size();
+        }
+
+        // positions go from our reals to the ghosts of the neighbor in dir
+        FlatCommBuffers &pos = flatPositions[dir];
+        pos.sendCount = FLAT_POSITION_SIZE * nReals;
+        pos.recvCount = FLAT_POSITION_SIZE * nGhosts;
+        // never hand out a null pointer for empty buffers
+        pos.recv.resize(std::max(pos.recvCount, longint(1)));
+
+        // forces go back the opposite way, from our ghosts to their reals
+        FlatCommBuffers &force = flatForces[dir];
+        force.sendCount = FLAT_FORCE_SIZE * nGhosts;
+        force.recvCount = FLAT_FORCE_SIZE * nReals;
+        force.recv.resize(std::max(force.recvCount, longint(1)));
+      }
+    }
+
+    // the send buffers, in the shared window or in our own memory
+    if (sharedGhostComm) {
+      setupSharedGhostWindow();
+    } else {
+      for (int dir = 0; dir < 6; ++dir) {
+        FlatCommBuffers *bufs[2] = { &flatPositions[dir], &flatForces[dir] };
+        for (int k = 0; k < 2; ++k) {
+          bufs[k]->send.resize(std::max(bufs[k]->sendCount, longint(1)));
+          bufs[k]->sendData = &bufs[k]->send[0];
+        }
+      }
+    }
+
+    for (int coord = 0; coord < 3; ++coord) {
+      if (nodeGrid.getGridSize(coord) == 1) continue;
+      for (int lr = 0; lr < 2; ++lr) {
+        int dir         = 2 * coord + lr;
+        int oppositeDir = 2 * coord + (1 - lr);
+        int right = nodeGrid.getNodeNeighborIndex(dir);
+        int left = nodeGrid.getNodeNeighborIndex(oppositeDir);
+
+        /* no messages with the neighbors on our node, they read our send
+           buffers in place, and we theirs. If we read from the neighbor
+           on the left, the neighbor on the right reads from us. */
+        FlatCommBuffers &pos = flatPositions[dir];
+        if (!pos.sharedSend) {
+          MPI_Send_init(pos.sendData, pos.sendCount, type, right,
+                        DD_FLAT_POSITION_TAG + dir, comm, &pos.requests[0]);
+        }
+        if (!pos.sharedRecv) {
+          MPI_Recv_init(&pos.recv[0], pos.recvCount, type, left,
+                        DD_FLAT_POSITION_TAG + dir, comm, &pos.requests[1]);
+        }
+
+        FlatCommBuffers &force = flatForces[dir];
+        if (!force.sharedSend) {
+          MPI_Send_init(force.sendData, force.sendCount, type, left,
+                        DD_FLAT_FORCE_TAG + dir, comm, &force.requests[0]);
+        }
+        if (!force.sharedRecv) {
+          MPI_Recv_init(&force.recv[0], force.recvCount, type, right,
+                        DD_FLAT_FORCE_TAG + dir, comm, &force.requests[1]);
+        }
+      }
+    }
+    flatGhostCommReady = true;
+    LOG4ESPP_DEBUG(logger, "flat ghost buffers set up");
+  }
+
+  void DomainDecomposition::setupSharedGhostWindow() {
+    MPI_Comm comm = *getSystem()->comm;
+    if (nodeComm == MPI_COMM_NULL) {
+      MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodeComm);
+    }
+
+    /* our segment holds the offsets of the 12 send buffers (positions
+       and forces per direction), followed by the buffers themselves */
+    const int nBufs = 12;
+    FlatCommBuffers *bufs[nBufs];
+    for (int dir = 0; dir < 6; ++dir) {
+      bufs[2 * dir] = &flatPositions[dir];
+      bufs[2 * dir + 1] = &flatForces[dir];
+    }
+    MPI_Aint offsets[nBufs];
+    MPI_Aint size = 0;
+    for (int k = 0; k < nBufs; ++k) {
+      offsets[k] = size;
+      size += std::max(bufs[k]->sendCount, longint(1));
+    }
+    const MPI_Aint headerBytes = nBufs * sizeof(MPI_Aint);
+
+    char *base;
+    MPI_Win_allocate_shared(headerBytes + size * sizeof(real), 1, MPI_INFO_NULL,
+                            nodeComm, &base, &sharedWin);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, sharedWin);
+    sharedWinReady = true;
+
+    MPI_Aint *header = reinterpret_cast<MPI_Aint *>(base);
+    real *data = reinterpret_cast<real *>(base + headerBytes);
+    for (int k = 0; k < nBufs; ++k) {
+      header[k] = offsets[k];
+      bufs[k]->sendData = data + offsets[k];
+    }
+
+    // publish the offsets to the other ranks of the node
+    MPI_Win_sync(sharedWin);
+    MPI_Barrier(nodeComm);
+    MPI_Win_sync(sharedWin);
+
+    MPI_Group group, nodeGroup;
+    MPI_Comm_group(comm, &group);
+    MPI_Comm_group(nodeComm, &nodeGroup);
+    int nShared = 0;
+    for (int coord = 0; coord < 3; ++coord) {
+      if (nodeGrid.getGridSize(coord) == 1) continue;
+      for (int lr = 0; lr < 2; ++lr) {
+        int dir         = 2 * coord + lr;
+        int oppositeDir = 2 * coord + (1 - lr);
+        // MPI_UNDEFINED for neighbors on other nodes
+        int ranks[2] = { nodeGrid.getNodeNeighborIndex(dir), nodeGrid.getNodeNeighborIndex(oppositeDir) };
+        int nodeRanks[2];
+        MPI_Group_translate_ranks(group, 2, ranks, nodeGroup, nodeRanks);
+
+        // the buffers of dir in the segments of these neighbors
+        const real *remote[2] = { 0, 0 };
+        for (int c = 0; c < 2; ++c) {
+          if (nodeRanks[c] == MPI_UNDEFINED) continue;
+          MPI_Aint segSize;
+          int dispUnit;
+          char *segBase;
+          MPI_Win_shared_query(sharedWin, nodeRanks[c], &segSize, &dispUnit, &segBase);
+          const MPI_Aint *segHeader = reinterpret_cast<const MPI_Aint *>(segBase);
+          const real *segData = reinterpret_cast<const real *>(segBase + headerBytes);
+          // forces of dir come from the right, positions of dir from the left
+          int k = (c == 0) ? 2 * dir + 1 : 2 * dir;
+          remote[c] = segData + segHeader[k];
+          ++nShared;
+        }
+
+        flatPositions[dir].sharedSend = (nodeRanks[0] != MPI_UNDEFINED);
+        flatPositions[dir].sharedRecv = remote[1];
+        flatForces[dir].sharedSend = (nodeRanks[1] != MPI_UNDEFINED);
+        flatForces[dir].sharedRecv = remote[0];
+      }
+    }
+    MPI_Group_free(&group);
+    MPI_Group_free(&nodeGroup);
+
+    LOG4ESPP_DEBUG(logger, nShared << " ghost buffers are read from shared memory");
+  }
+
+  void DomainDecomposition::freeFlatGhostComm() {
+    if (!flatGhostCommReady) return;
+    flatGhostCommReady = false;
+
+    // the storage may outlive MPI at interpreter shutdown
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (finalized) return;
+
+    for (int dir = 0; dir < 6; ++dir) {
+      for (int k = 0; k < 2; ++k) {
+        if (flatPositions[dir].requests[k] != MPI_REQUEST_NULL) {
+          MPI_Request_free(&flatPositions[dir].requests[k]);
+        }
+        if (flatForces[dir].requests[k] != MPI_REQUEST_NULL) {
+          MPI_Request_free(&flatForces[dir].requests[k]);
+        }
+      }
+    }
+
+    if (sharedWinReady) {
+      sharedWinReady = false;
+      MPI_Win_unlock_all(sharedWin);
+      MPI_Win_free(&sharedWin);
+    }
+  }
+
+  void DomainDecomposition::beginFlatGhostComm(bool realToGhosts) {
+    LOG4ESPP_DEBUG(logger, "begin flat ghost communication "
+           << (realToGhosts ? "reals to ghosts" : "ghosts to reals"));
+
+    flatInFlight = false;
+    for (flatStep = 0; flatStep < 3; ++flatStep) {
+      // same inverted order for the forces as in doGhostCommunication
+      int coord = realToGhosts ? flatStep : (2 - flatStep);
+      if (nodeGrid.getGridSize(coord) == 1) {
+        copyFlatGhostsLocal(coord, realToGhosts);
+      } else {
+        startFlatGhostComm(coord, realToGhosts);
+        flatInFlight = true;
+        return;
+      }
+    }
+  }
+
+  void DomainDecomposition::endFlatGhostComm(bool realToGhosts) {
+    if (!flatInFlight) return;
+
+    // the later coordinates need the data of the earlier ones, no overlap here
+    for (; flatStep < 3; ++flatStep) {
+      int coord = realToGhosts ? flatStep : (2 - flatStep);
+      if (nodeGrid.getGridSize(coord) == 1) {
+        copyFlatGhostsLocal(coord, realToGhosts);
+      } else {
+        if (!flatInFlight) {
+          startFlatGhostComm(coord, realToGhosts);
+        }
+        finishFlatGhostComm(coord, realToGhosts);
+        flatInFlight = false;
+      }
+    }
+    LOG4ESPP_DEBUG(logger, "flat ghost communication finished");
+  }
+
+  void DomainDecomposition::copyFlatGhostsLocal(int coord, bool realToGhosts) {
+    real curCoordBoxL = getSystem()->bc->getBoxL()[coord];
+    for (int lr = 0; lr < 2; ++lr) {
+      int dir = 2 * coord + lr;
+      Real3D shift(0, 0, 0);
+      shift[coord] = nodeGrid.getBoundary(dir) * curCoordBoxL;
+      for (int i = 0, end = commCells[dir].ghosts.size(); i < end; ++i) {
+        if (realToGhosts) {
+          copyRealsToGhosts(*commCells[dir].reals[i], *commCells[dir].ghosts[i], dataOfUpdateGhosts, shift);
+        } else {
+          addGhostForcesToReals(*commCells[dir].ghosts[i], *commCells[dir].reals[i]);
+        }
+      }
+    }
+  }
+
+  void DomainDecomposition::startFlatGhostComm(int coord, bool realToGhosts) {
+    real curCoordBoxL = getSystem()->bc->getBoxL()[coord];
+
+    /* both directions of one coordinate touch disjoint cells on the
+       sending side, so they can be in flight at the same time. */
+    flatNumPending = 0;
+    for (int lr = 0; lr < 2; ++lr) {
+      int dir = 2 * coord + lr;
+      FlatCommBuffers &buf = realToGhosts ? flatPositions[dir] : flatForces[dir];
+      real *out = buf.sendData;
+      longint n = 0;
+
+      if (realToGhosts) {
+        real shift = nodeGrid.getBoundary(dir) * curCoordBoxL;
+        for (int i = 0, end = commCells[dir].reals.size(); i < end; ++i) {
+          ParticleList &reals = commCells[dir].reals[i]->particles;
+          n += FLAT_POSITION_SIZE * reals.size();
+          if (n > buf.sendCount) break;
+          for (ParticleList::iterator p = reals.begin(), pend = reals.end(); p != pend; ++p) {
+            const Real3D &pos = p->position();
+            out[0] = pos[0];
+            out[1] = pos[1];
+            out[2] = pos[2];
+            out[coord] += shift;
+            out[3] = p->radius();
+            out[4] = p->extVar();
+            out += FLAT_POSITION_SIZE;
+          }
+        }
+      } else {
+        for (int i = 0, end = commCells[dir].ghosts.size(); i < end; ++i) {
+          ParticleList &ghosts = commCells[dir].ghosts[i]->particles;
+          n += FLAT_FORCE_SIZE * ghosts.size();
+          if (n > buf.sendCount) break;
+          for (ParticleList::iterator p = ghosts.begin(), pend = ghosts.end(); p != pend; ++p) {
+            const Real3D &f = p->force();
+            out[0] = f[0];
+            out[1] = f[1];
+            out[2] = f[2];
+            out[3] = p->fradius();
+            out += FLAT_FORCE_SIZE;
+          }
+        }
+      }
+      if (n != buf.sendCount) {
+        throw std::runtime_error("DomainDecomposition::startFlatGhostComm: particle numbers changed since the last ghost exchange");
+      }
+      // no requests for the neighbors that share our memory
+      for (int k = 0; k < 2; ++k) {
+        if (buf.requests[k] != MPI_REQUEST_NULL) {
+          flatPending[flatNumPending++] = buf.requests[k];
+        }
+      }
+    }
+
+    MPI_Startall(flatNumPending, flatPending);
+  }
+
+  void DomainDecomposition::finishFlatGhostComm(int coord, bool realToGhosts) {
+    MPI_Waitall(flatNumPending, flatPending, MPI_STATUSES_IGNORE);
+
+    /* the ranks of the node packed their send buffers for this
+       coordinate. Every rank takes part in the barriers, also without
+       neighbors on the node, so that all ranks of a node stay in step. */
+    if (sharedWinReady) {
+      MPI_Win_sync(sharedWin);
+      MPI_Barrier(nodeComm);
+      MPI_Win_sync(sharedWin);
+    }
+
+    for (int lr = 0; lr < 2; ++lr) {
+      int dir = 2 * coord + lr;
+      FlatCommBuffers &buf = realToGhosts ? flatPositions[dir] : flatForces[dir];
+      const real *in = buf.sharedRecv ? buf.sharedRecv : &buf.recv[0];
+
+      if (realToGhosts) {
+        for (int i = 0, end = commCells[dir].ghosts.size(); i < end; ++i) {
+          ParticleList &ghosts = commCells[dir].ghosts[i]->particles;
+          for (ParticleList::iterator p = ghosts.begin(), pend = ghosts.end(); p != pend; ++p) {
+            p->position() = Real3D(in[0], in[1], in[2]);
+            p->radius() = in[3];
+            p->extVar() = in[4];
+            in += FLAT_POSITION_SIZE;
+          }
+        }
+      } else {
+        for (int i = 0, end = commCells[dir].reals.size(); i < end; ++i) {
+          ParticleList &reals = commCells[dir].reals[i]->particles;
+          for (ParticleList::iterator p = reals.begin(), pend = reals.end(); p != pend; ++p) {
+            p->force() += Real3D(in[0], in[1], in[2]);
+            p->fradius() += in[3];
+            in += FLAT_FORCE_SIZE;
+          }
+        }
+      }
+    }
+
+    // the neighbors may overwrite their send buffers from now on
+    if (sharedWinReady) {
+      MPI_Barrier(nodeComm);
+    }
+  }
+
   //////////////////////////////////////////////////
   // REGISTRATION WITH PYTHON
   //////////////////////////////////////////////////
+  namespace {
+    std::vector<real> toBounds(python::object seq) {
+      std::vector<real> bounds(python::len(seq));
+      for (size_t j = 0; j < bounds.size(); ++j) {
+        bounds[j] = python::extract<real>(seq[j]);
+      }
+      return bounds;
+    }
+
+    void pySetDomainBounds(DomainDecomposition& dd, python::object x,
+                           python::object y, python::object z) {
+      std::vector<real> bounds[3] = { toBounds(x), toBounds(y), toBounds(z) };
+      dd.setDomainBounds(bounds);
+    }
+
+    python::list pyGetDomainBounds(DomainDecomposition& dd, int axis) {
+      python::list bounds;
+      const std::vector<real>& b = dd.getNodeGrid().getDomainBounds(axis);
+      for (size_t j = 0; j < b.size(); ++j) {
+        bounds.append(b[j]);
+      }
+      return bounds;
+    }
+  }
+
   void DomainDecomposition::registerPython() {
     using namespace espressopp::python;
     class_< DomainDecomposition, bases< Storage >, boost::noncopyable >
@@ -778,6 +1697,15 @@ namespace espressopp {
     .def("getCellGrid", &DomainDecomposition::getInt3DCellGrid)
     .def("getNodeGrid", &DomainDecomposition::getInt3DNodeGrid)
     .def("cellAdjust", &DomainDecomposition::cellAdjust)
+    .def("setDomainBounds", &pySetDomainBounds)
+    .def("getDomainBounds", &pyGetDomainBounds)
+    .add_property("useParticleArrays", &Storage::getUseParticleArrays, &DomainDecomposition::setUseParticleArrays)
+    .add_property("sortInterval", &DomainDecomposition::getSortInterval, &DomainDecomposition::setSortInterval)
+    .add_property("flatGhostComm", &DomainDecomposition::getFlatGhostComm, &DomainDecomposition::setFlatGhostComm)
+    .add_property("eighthShell", &DomainDecomposition::getEighthShell, &DomainDecomposition::setEighthShell)
+    .add_property("cellSubdivision", &DomainDecomposition::getCellSubdivision, &DomainDecomposition::setCellSubdivision)
+    .add_property("sharedGhostComm", &DomainDecomposition::getSharedGhostComm, &DomainDecomposition::setSharedGhostComm)
+    .add_property("directMigration", &DomainDecomposition::getDirectMigration, &DomainDecomposition::setDirectMigration)
     ;
   }
 
@@ -43,7 +43,7 @@ namespace espressopp {
               const Int3D& _nodeGrid,
 			  const Int3D& _cellGrid);
 
-      virtual ~DomainDecomposition() {}
+      virtual ~DomainDecomposition();
 
       virtual void scaleVolume(real s, bool particleCoordinates);
       virtual void scaleVolume(Real3D s, bool particleCoordinates);
@@ -57,6 +57,14 @@ namespace espressopp {
       // as a consequence of the system resizing
       virtual void cellAdjust();
 
+      /** move the boundaries of the domains, e.g. for load balancing.
+          bounds[i] holds the getGridSize(i) + 1 increasing boundaries
+          along axis i, from 0 to the box length; every domain has to be
+          at least cutoff+skin wide. The cell grids are rebuilt for the
+          new domains and the particles are sent to their new nodes.
+          Collective, all nodes have to pass the same boundaries. */
+      void setDomainBounds(const std::vector<real> bounds[3]);
+
       virtual Cell *mapPositionToCell(const Real3D& pos);
       virtual Cell *mapPositionToCellClipped(const Real3D& pos);
       virtual Cell *mapPositionToCellChecked(const Real3D& pos);
@@ -77,6 +85,75 @@ namespace espressopp {
       virtual void updateGhostsV();
       virtual void collectGhostForces();
 
+      /** with flat ghost buffers, the first non-local coordinate is in
+          flight between begin and end; the rest is done in the end call. */
+      virtual void updateGhostsBegin();
+      virtual void updateGhostsEnd();
+      virtual void collectGhostForcesBegin();
+      virtual void collectGhostForcesEnd();
+
+      virtual bool checkParticlesLeftCells();
+
+      /** reorder the real cells and the particles in each of them along
+          a Morton (Z-order) curve every sortInterval-th decomposition,
+          so that the cell loops, the particle arrays and the neighbor
+          lists visit particles close in space one after the other.
+          0 (default) disables the sorting. */
+      void setSortInterval(int _sortInterval) { sortInterval = _sortInterval; }
+      int getSortInterval() const { return sortInterval; }
+
+      /** send ghost positions and forces as flat arrays of reals through
+          persistent MPI requests, instead of serializing particle data
+          on every step. The buffer layout is fixed at each ghost exchange. */
+      void setFlatGhostComm(bool _flatGhostComm);
+      bool getFlatGhostComm() const { return flatGhostComm; }
+
+      /** with flat ghost buffers, put the send buffers into an MPI-3
+          shared memory window of the ranks on the same node. Ghosts from
+          neighbors on the same node are then read in place after a node
+          barrier instead of being sent; other neighbors keep the MPI
+          messages. Throws if flatGhostComm is off, which in turn cannot
+          be switched off while this is on. */
+      void setSharedGhostComm(bool _sharedGhostComm);
+      bool getSharedGhostComm() const { return sharedGhostComm; }
+
+      /** import ghosts only from the upper neighbors along x, y and z
+          (eighth shell) instead of from all 26. The ghost frame and the
+          ghost messages are about half as large; in exchange, pairs of
+          two ghost cells are assigned to this node as well, namely all
+          cell pairs whose lower corner cell is real here. Only the pair
+          iterations over the cells (Verlet lists, cell list
+          interactions) support this; bonds, triples and AdResS need the
+          full shell, so this throws while such lists exist, and they
+          cannot be created with the eighth shell on (see
+          Storage::requireFullGhostShell). Collective, rebuilds the cell
+          structure. */
+      void setEighthShell(bool _eighthShell);
+      bool getEighthShell() const { return eighthShell; }
+      virtual bool getFullGhostShell() const { return !eighthShell; }
+
+      /** split each cell of cutoff+skin into cellSubdivision^3 smaller
+          cells. The neighbor cells reach over cellSubdivision cells and
+          skip the cells that are out of range, so the pair searches test
+          fewer particles outside of the cutoff sphere. The ghost frame is
+          cellSubdivision cells wide. Collective, rebuilds the cell
+          structure. */
+      void setCellSubdivision(int _cellSubdivision);
+      int getCellSubdivision() const { return cellSubdivision; }
+
+      /** send each particle that left the domain directly to the node
+          that owns its folded position, in a single round of messages
+          with a nonblocking consensus (NBX) instead of shifting the
+          particles along x, y and z until a global reduction reports
+          that all have arrived. Needs MPI-3. */
+      void setDirectMigration(bool _directMigration) { directMigration = _directMigration; }
+      bool getDirectMigration() const { return directMigration; }
+
+      /** keep the structure-of-arrays copy of the local particles up to
+          date; it is rebuilt after each ghost exchange and its positions
+          are refreshed on every ghost update. */
+      virtual void setUseParticleArrays(bool _useParticleArrays);
+
       static void registerPython();
 
     protected:
@@ -90,10 +167,41 @@ namespace espressopp {
 
       void prepareGhostCommunication();
 
+      /// size the flat ghost buffers and set up their persistent requests
+      void setupFlatGhostComm();
+      /// release the persistent requests of the flat ghost buffers
+      void freeFlatGhostComm();
+      /** allocate the send buffers in the shared window and find the
+          send buffers of the neighbors on the same node */
+      void setupSharedGhostWindow();
+      /** positions (realToGhosts) or forces (ghosts to reals) through the
+          flat buffers: begin does the local copies up to the first
+          coordinate that needs communication and starts it, end
+          completes that and all remaining coordinates. */
+      void beginFlatGhostComm(bool realToGhosts);
+      void endFlatGhostComm(bool realToGhosts);
+      /// copy to/from the ghosts of a coordinate with only one node
+      void copyFlatGhostsLocal(int coord, bool realToGhosts);
+      /// pack both directions of a coordinate and start their requests
+      void startFlatGhostComm(int coord, bool realToGhosts);
+      /// wait for the requests of a coordinate and unpack them
+      void finishFlatGhostComm(int coord, bool realToGhosts);
+
       /// init global Verlet list
       void initCellInteractions();
+      /// neighbor cells for the eighth-shell ghost import
+      void initEighthShellInteractions();
+      /// true if cells this many cells apart can hold a pair within the cutoff
+      bool isInteractingOffset(int dm, int dn, int dp) const;
       /// set the grids and allocate space accordingly
       void createCellGrid(const Int3D& nodeGrid, const Int3D& cellGrid);
+      /// set the cell grid of the current local domain and allocate space accordingly
+      void createLocalCellGrid(const Int3D& cellGrid);
+      /// the largest cell grid of the local domain with cells of at least cutoff+skin
+      Int3D calcLocalCellGrid();
+      /** replace the cell grid by a new one for the current node grid
+          and redistribute the particles, also between the nodes */
+      void rebuildCellGrid(const Int3D& cellGrid);
       /// sort cells into local/ghost cell arrays
       void markCells();
       /// fill a list of cells with the cells from a certain region of the domain grid
@@ -108,6 +216,14 @@ namespace espressopp {
       */
       bool appendParticles(ParticleList &, int dir);
 
+      /// move the particles to the neighbors along x, y and z until all have arrived
+      void shiftRealParticles();
+      /// send the particles in one round directly to their nodes, see setDirectMigration
+      void migrateRealParticles();
+
+      /// sort the real cells and the particles of each cell by their Morton keys
+      void sortRealCells();
+
       /// spatial domain decomposition of nodes
       NodeGrid nodeGrid;
 
@@ -117,6 +233,19 @@ namespace espressopp {
       /// expected capacity of send/recv buffers for neighbor communication
       size_t exchangeBufferSize;
 
+      /// sort the cells every sortInterval-th decomposition, 0 means never
+      int sortInterval;
+      /// number of decompositions since the last sort
+      int decomposeCount;
+
+      /// number of cells per cutoff+skin, also the width of the ghost frame
+      int cellSubdivision;
+
+      /// see setDirectMigration
+      bool directMigration;
+      /// number of direct migrations, selects one of two message tags
+      int migrationCount;
+
       /** which cells to send and receive during one communication step.
 	  In case this is a communication with ourselves, the send-cells
 	  are transferred to the recv-cells. */
@@ -129,6 +258,46 @@ namespace espressopp {
       */
       CommCells commCells[6];
 
+      /** flat send/recv arrays of one direction and their persistent
+          requests, valid until the next ghost exchange. */
+      struct FlatCommBuffers {
+        std::vector<real> send;
+        std::vector<real> recv;
+        longint sendCount;
+        longint recvCount;
+        MPI_Request requests[2];
+        /// the data to send, in send or in the shared window
+        real *sendData;
+        /// send data of a neighbor on the same node, read in place, or 0
+        const real *sharedRecv;
+        /// the receiver is on the same node and reads sendData in place
+        bool sharedSend;
+      };
+      /// ghosts only from the upper neighbors, see setEighthShell
+      bool eighthShell;
+
+      /// use the flat buffers for updateGhosts and collectGhostForces
+      bool flatGhostComm;
+      /// true if the requests below are set up
+      bool flatGhostCommReady;
+      FlatCommBuffers flatPositions[6];
+      FlatCommBuffers flatForces[6];
+      /// true between beginFlatGhostComm and endFlatGhostComm if requests are active
+      bool flatInFlight;
+      /// coordinate step (0..2) that is in flight
+      int flatStep;
+      /// the requests started for the coordinate in flight
+      MPI_Request flatPending[4];
+      int flatNumPending;
+
+      /// keep the flat send buffers in a shared window of the node
+      bool sharedGhostComm;
+      /// the ranks on our node, MPI_COMM_NULL until needed
+      MPI_Comm nodeComm;
+      /// shared window with the flat send buffers
+      MPI_Win sharedWin;
+      bool sharedWinReady;
+
       static LOG4ESPP_DECL_LOGGER(logger);
     };
   }
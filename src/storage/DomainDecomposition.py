@@ -41,6 +41,109 @@ espressopp.storage.DomainDecomposition
 .. function:: espressopp.storage.DomainDecomposition.getNodeGrid()
 
 		:rtype: 
+
+.. function:: espressopp.storage.DomainDecomposition.getDomainBounds(axis)
+
+		Boundaries of the domains along axis (0, 1 or 2), from 0 to the
+		box length. All domains in a slab along an axis share the same
+		boundaries; initially they are equally spaced.
+
+		:param int axis:
+		:rtype: list of float
+
+.. function:: espressopp.storage.DomainDecomposition.setDomainBounds(x, y, z)
+
+		Moves the domain boundaries, e.g. to give the CPUs with a dense
+		region a smaller part of the box. Each argument lists the
+		getNodeGrid()[i] + 1 increasing boundaries along one axis from 0 to
+		the box length; each domain has to be at least cutoff+skin wide.
+		The cell grids are rebuilt and the particles are sent to their new
+		CPUs. See also :class:`espressopp.integrator.LoadBalancer`.
+
+		:param x:
+		:param y:
+		:param z:
+		:type x: list of float
+		:type y: list of float
+		:type z: list of float
+
+.. attribute:: espressopp.storage.DomainDecomposition.useParticleArrays
+
+		If True, the storage keeps a structure-of-arrays copy of the local
+		particles (positions, velocities, forces, types and ids in contiguous
+		arrays) up to date. It is rebuilt after every decomposition and its
+		positions are refreshed on every ghost update. Default: False.
+
+		:type: bool
+
+.. attribute:: espressopp.storage.DomainDecomposition.sortInterval
+
+		If larger than 0, the real cells and the particles in each cell
+		are reordered along a Morton (Z-order) space-filling curve every
+		sortInterval-th decomposition. Loops over the particles and the
+		particle arrays then follow the curve through the whole domain,
+		which keeps spatial neighbors close in memory over long runs.
+		Default: 0 (no sorting).
+
+		:type: int
+
+.. attribute:: espressopp.storage.DomainDecomposition.flatGhostComm
+
+		If True, ghost positions and ghost forces are sent as flat arrays
+		of reals through persistent MPI requests instead of serialized
+		particle buffers. The buffers are sized at each decomposition, so
+		this only affects the ghost updates in between. Default: False.
+
+		:type: bool
+
+.. attribute:: espressopp.storage.DomainDecomposition.sharedGhostComm
+
+		If True, the flat send buffers of flatGhostComm are placed in an
+		MPI-3 shared memory window, and CPUs on the same node read the
+		ghost data of their neighbors directly from it instead of
+		receiving a message. Neighbors on other nodes still exchange
+		messages. Requires an MPI-3 library. Setting it without
+		flatGhostComm, or switching flatGhostComm off while it is set,
+		raises an error. Default: False.
+
+		:type: bool
+
+.. attribute:: espressopp.storage.DomainDecomposition.eighthShell
+
+		If True, each CPU imports ghosts only from its upper neighbors
+		along x, y and z (eighth shell) instead of from all sides, which
+		roughly halves the number of ghosts and the size of the ghost
+		messages. The pairs between two ghost cells are then computed
+		here as well, so the forces stay the same. Only nonbonded pair
+		interactions through Verlet lists or cell lists support this;
+		bonds, angles, dihedrals, triple Verlet lists and AdResS need the
+		full ghost shell, so setting it raises an error while such lists
+		exist, and creating one raises an error while it is set.
+		Setting it rebuilds the cell structure. Default: False.
+
+		:type: bool
+
+.. attribute:: espressopp.storage.DomainDecomposition.cellSubdivision
+
+		Number of cells per cutoff+skin along each axis. With 2 or 3, the
+		Verlet list builds and the cell list interactions search through
+		smaller cells and skip the neighbor cells that are out of range,
+		so they test fewer pairs beyond the cutoff; the ghost frame gets
+		as many cells wide. Setting it rebuilds the cell structure.
+		Default: 1.
+
+		:type: int
+
+.. attribute:: espressopp.storage.DomainDecomposition.directMigration
+
+		If True, particles that left the domain are sent directly to
+		the CPU that owns their new position, in a single round of
+		messages that ends with a nonblocking barrier. By default they
+		are passed on to the neighbors along x, y and z, repeated until
+		a global reduction reports that all particles have arrived.
+		Requires an MPI-3 library. Default: False.
+
+		:type: bool
 """
 from espressopp import pmi
 from espressopp.esutil import cxxinit
@@ -65,12 +168,21 @@ class DomainDecompositionLocal(StorageLocal, storage_DomainDecomposition):
     def getNodeGrid(self):
         if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
             return self.cxxclass.getNodeGrid(self)
+
+    def getDomainBounds(self, axis):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getDomainBounds(self, axis)
+
+    def setDomainBounds(self, x, y, z):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            self.cxxclass.setDomainBounds(self, x, y, z)
           
 if pmi.isController:
     class DomainDecomposition(Storage):
         pmiproxydefs = dict(
           cls = 'espressopp.storage.DomainDecompositionLocal',  
-          pmicall = ['getCellGrid', 'getNodeGrid', 'cellAdjust']
+          pmicall = ['getCellGrid', 'getNodeGrid', 'cellAdjust', 'getDomainBounds', 'setDomainBounds'],
+          pmiproperty = ['useParticleArrays', 'sortInterval', 'flatGhostComm', 'eighthShell', 'cellSubdivision', 'sharedGhostComm', 'directMigration']
         )
         def __init__(self, system, 
                      nodeGrid='auto', 
@@ -20,6 +20,9 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>. 
 */
 
+#include <algorithm>
+#include <sstream>
+
 #include "log4espp.hpp"
 
 #include "Real3D.hpp"
@@ -43,13 +46,39 @@ namespace espressopp {
         throw NodeGridIllegal();
       }
 
+      calcNodeNeighbors(nodeId);
+
+      localBoxSize = domainSize;
       for(int i = 0; i < 3; ++i) {
-        localBoxSize[i] = domainSize[i]/static_cast<real>(getGridSize(i));
-        invLocalBoxSize[i] = 1.0/localBoxSize[i];
+        // equally spaced to start with
+        real width = domainSize[i]/static_cast<real>(getGridSize(i));
+        std::vector<real> bounds(getGridSize(i) + 1);
+        for (size_t j = 0; j < bounds.size(); ++j) {
+          bounds[j] = j*width;
+        }
+        bounds.back() = domainSize[i];
+        setDomainBounds(i, bounds);
       }
-      smallestLocalBoxDiameter = std::min(std::min(localBoxSize[0], localBoxSize[1]), localBoxSize[2]);
+    }
 
-      calcNodeNeighbors(nodeId);
+    void NodeGrid::setDomainBounds(int axis, const std::vector<real>& bounds)
+    {
+      if (static_cast<longint>(bounds.size()) != getGridSize(axis) + 1) {
+        std::ostringstream msg;
+        msg << "need " << getGridSize(axis) + 1 << " domain boundaries along axis "
+            << axis << ", got " << bounds.size();
+        throw std::invalid_argument(msg.str());
+      }
+      for (size_t j = 1; j < bounds.size(); ++j) {
+        if (!(bounds[j] > bounds[j - 1])) {
+          throw std::invalid_argument("domain boundaries have to be increasing");
+        }
+      }
+
+      domainBounds[axis] = bounds;
+      localBoxSize[axis] = getMyRight(axis) - getMyLeft(axis);
+      invLocalBoxSize[axis] = 1.0/localBoxSize[axis];
+      smallestLocalBoxDiameter = std::min(std::min(localBoxSize[0], localBoxSize[1]), localBoxSize[2]);
     }
 
     longint NodeGrid::
@@ -58,13 +87,11 @@ namespace espressopp {
       Int3D cpos;
     
       for (int i = 0; i < 3; ++i) {
-        cpos[i] = static_cast< int >(pos[i]*invLocalBoxSize[i]);
-        if (cpos[i] < 0) {
-          cpos[i] = 0;
-        }
-        else if (cpos[i] >= getGridSize(i)) {
-          cpos[i] = getGridSize(i) - 1;
-        }
+        // the first inner boundary above pos; outside positions end up
+        // in the first or last domain
+        const std::vector<real>& bounds = domainBounds[i];
+        cpos[i] = std::upper_bound(bounds.begin() + 1, bounds.end() - 1, pos[i])
+          - (bounds.begin() + 1);
       }
       return mapPositionToIndex(cpos);
     }
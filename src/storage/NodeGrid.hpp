@@ -29,6 +29,7 @@
 */
 
 #include <stdexcept>
+#include <vector>
 #include "types.hpp"
 #include "logging.hpp"
 #include "esutil/Grid.hpp"
@@ -45,6 +46,10 @@ namespace espressopp {
     /** Node grid point. This represents the node grid of the domain
 	decomposition, as well as the location of this processor in the
 	grid.
+
+	The domains form a rectilinear grid: along each axis, the
+	domain boundaries are shared by all nodes, but they need not be
+	equally spaced (see setDomainBounds).
     */
     class NodeGrid: public esutil::Grid
     {
@@ -79,13 +84,13 @@ namespace espressopp {
       real getInverseLocalBoxSize(int axis) const { return invLocalBoxSize[axis]; }
 
       /// calculate start of local box
-      real getMyLeft(int axis) const { return nodePos[axis]*localBoxSize[axis]; }
+      real getMyLeft(int axis) const { return domainBounds[axis][nodePos[axis]]; }
       Real3D getMyLeft() const { 
         return Real3D(getMyLeft(0), getMyLeft(1), getMyLeft(2));
       }
 
       /// calculate end of local box
-      real getMyRight(int axis) const { return (nodePos[axis] + 1)*localBoxSize[axis]; }
+      real getMyRight(int axis) const { return domainBounds[axis][nodePos[axis] + 1]; }
       Real3D getMyRight() const { 
         return Real3D(getMyRight(0), getMyRight(1), getMyRight(2));
       }
@@ -116,11 +121,23 @@ namespace espressopp {
 
       static const int numNodeNeighbors = Back + 1;
 
+      /** boundaries of the domains along axis: getGridSize(axis) + 1
+          increasing values from 0 to the box length */
+      const std::vector<real>& getDomainBounds(int axis) const
+      { return domainBounds[axis]; }
+
+      /** move the domain boundaries along axis. Only the grid is
+          changed, the particles have to be redistributed by the caller. */
+      void setDomainBounds(int axis, const std::vector<real>& bounds);
+
       void scaleVolume(real s) {
         if (s > 0) {
           for (int i=0; i<3; ++i) {
             localBoxSize[i] *= s;
             invLocalBoxSize[i] /= s;
+            for (size_t j = 0; j < domainBounds[i].size(); ++j) {
+              domainBounds[i][j] *= s;
+            }
           }
           smallestLocalBoxDiameter *= s;
         }
@@ -134,6 +151,9 @@ namespace espressopp {
           for (int i=0; i<3; ++i) {
             localBoxSize[i] *= s[i];
             invLocalBoxSize[i] /= s[i];
+            for (size_t j = 0; j < domainBounds[i].size(); ++j) {
+              domainBounds[i][j] *= s[i];
+            }
           }
           smallestLocalBoxDiameter = std::min(std::min(localBoxSize[0], localBoxSize[1]), localBoxSize[2]);
         }
@@ -153,7 +173,10 @@ namespace espressopp {
       /// where to fold particles that leave local box in direction i
       int boundaries[6];
 
-      /// cell size
+      /// boundaries of the domains along each axis
+      std::vector<real> domainBounds[3];
+
+      /// size of the local box
       Real3D localBoxSize;
       /// inverse domain size
       Real3D invLocalBoxSize;
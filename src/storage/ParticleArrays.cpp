@@ -0,0 +1,165 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include "ParticleArrays.hpp"
+
+namespace espressopp {
+  namespace storage {
+
+    LOG4ESPP_LOGGER(ParticleArrays::logger, "ParticleArrays");
+
+    ParticleArrays::ParticleArrays() : nReal(0), valid(false) {}
+
+    void ParticleArrays::invalidate() {
+      x.clear(); y.clear(); z.clear();
+      vx.clear(); vy.clear(); vz.clear();
+      fx.clear(); fy.clear(); fz.clear();
+      type.clear();
+      id.clear();
+      cellRanges.clear();
+      addressRanges.clear();
+      nReal = 0;
+      valid = false;
+    }
+
+    void ParticleArrays::rebuild(CellList &realCells, CellList &ghostCells) {
+      invalidate();
+
+      longint n = 0;
+      for (CellList::Iterator it(realCells); it.isValid(); ++it) {
+        n += (*it)->particles.size();
+      }
+      nReal = n;
+      for (CellList::Iterator it(ghostCells); it.isValid(); ++it) {
+        n += (*it)->particles.size();
+      }
+
+      x.reserve(n); y.reserve(n); z.reserve(n);
+      vx.reserve(n); vy.reserve(n); vz.reserve(n);
+      type.reserve(n);
+      id.reserve(n);
+
+      appendCells(realCells);
+      appendCells(ghostCells);
+
+      fx.assign(n, 0.0);
+      fy.assign(n, 0.0);
+      fz.assign(n, 0.0);
+
+      std::sort(addressRanges.begin(), addressRanges.end());
+      valid = true;
+
+      LOG4ESPP_DEBUG(logger, "rebuilt arrays for " << nReal << " real and "
+                     << (n - nReal) << " ghost particles");
+    }
+
+    void ParticleArrays::appendCells(CellList &cells) {
+      for (CellList::Iterator it(cells); it.isValid(); ++it) {
+        ParticleList &pl = (*it)->particles;
+        if (pl.empty()) continue;
+
+        CellRange cr = { *it, static_cast< longint >(x.size()) };
+        cellRanges.push_back(cr);
+        AddressRange ar = { &pl.front(), &pl.front() + pl.size(), cr.offset };
+        addressRanges.push_back(ar);
+
+        for (ParticleList::Iterator pit(pl); pit.isValid(); ++pit) {
+          const Real3D &pos = pit->position();
+          const Real3D &vel = pit->velocity();
+          x.push_back(pos[0]); y.push_back(pos[1]); z.push_back(pos[2]);
+          vx.push_back(vel[0]); vy.push_back(vel[1]); vz.push_back(vel[2]);
+          type.push_back(pit->type());
+          id.push_back(pit->id());
+        }
+      }
+    }
+
+    void ParticleArrays::updatePositions() {
+      for (std::vector< CellRange >::iterator it = cellRanges.begin(),
+             end = cellRanges.end(); it != end; ++it) {
+        ParticleList &pl = it->cell->particles;
+        longint i = it->offset;
+        for (ParticleList::iterator pit = pl.begin(), pend = pl.end(); pit != pend; ++pit, ++i) {
+          const Real3D &pos = pit->position();
+          x[i] = pos[0];
+          y[i] = pos[1];
+          z[i] = pos[2];
+        }
+      }
+    }
+
+    void ParticleArrays::updateVelocities() {
+      for (std::vector< CellRange >::iterator it = cellRanges.begin(),
+             end = cellRanges.end(); it != end; ++it) {
+        ParticleList &pl = it->cell->particles;
+        longint i = it->offset;
+        for (ParticleList::iterator pit = pl.begin(), pend = pl.end(); pit != pend; ++pit, ++i) {
+          const Real3D &vel = pit->velocity();
+          vx[i] = vel[0];
+          vy[i] = vel[1];
+          vz[i] = vel[2];
+        }
+      }
+    }
+
+    void ParticleArrays::clearForces() {
+      std::fill(fx.begin(), fx.end(), 0.0);
+      std::fill(fy.begin(), fy.end(), 0.0);
+      std::fill(fz.begin(), fz.end(), 0.0);
+    }
+
+    void ParticleArrays::addForcesToParticles() {
+      for (std::vector< CellRange >::iterator it = cellRanges.begin(),
+             end = cellRanges.end(); it != end; ++it) {
+        ParticleList &pl = it->cell->particles;
+        longint i = it->offset;
+        for (ParticleList::iterator pit = pl.begin(), pend = pl.end(); pit != pend; ++pit, ++i) {
+          Real3D &f = pit->force();
+          f[0] += fx[i];
+          f[1] += fy[i];
+          f[2] += fz[i];
+        }
+      }
+    }
+
+    Particle &ParticleArrays::particle(longint i) {
+      // bisect for the last cell range whose offset is not larger than i
+      longint lo = 0, hi = cellRanges.size();
+      while (hi - lo > 1) {
+        longint mid = (lo + hi) / 2;
+        if (cellRanges[mid].offset <= i) lo = mid; else hi = mid;
+      }
+      const CellRange &cr = cellRanges[lo];
+      return cr.cell->particles[i - cr.offset];
+    }
+
+    longint ParticleArrays::indexOf(const Particle *p) const {
+      AddressRange key = { p, p, 0 };
+      std::vector< AddressRange >::const_iterator it =
+        std::upper_bound(addressRanges.begin(), addressRanges.end(), key);
+      if (it == addressRanges.begin()) return -1;
+      --it;
+      if (p >= it->end) return -1;
+      return it->offset + (p - it->begin);
+    }
+
+  }
+}
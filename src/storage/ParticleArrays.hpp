@@ -0,0 +1,110 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _STORAGE_PARTICLEARRAYS_HPP
+#define _STORAGE_PARTICLEARRAYS_HPP
+
+#include <vector>
+#include "types.hpp"
+#include "log4espp.hpp"
+#include "Cell.hpp"
+
+namespace espressopp {
+  namespace storage {
+
+    /** Structure-of-arrays view of the particles in the local cells.
+
+        Positions, velocities, forces, types and ids are stored in
+        contiguous per-rank arrays, so that force kernels can stream
+        through them instead of loading complete Particle objects.
+        Real particles come first, in the order of the real cells,
+        followed by the ghosts in the order of the ghost cells.
+
+        The Particle structs in the cells remain the master copy. The
+        arrays are rebuilt whenever particle pointers change (i.e. after
+        the ghost exchange of a decomposition), positions are refreshed
+        on every ghost update, and kernels add their forces back to the
+        particles with addForcesToParticles().
+    */
+    class ParticleArrays {
+    public:
+      ParticleArrays();
+
+      /// rebuild the index and copy all particle data
+      void rebuild(CellList &realCells, CellList &ghostCells);
+      /// drop all data, e.g. because the cells were modified
+      void invalidate();
+      bool isValid() const { return valid; }
+
+      /// copy the positions from the particles into the arrays
+      void updatePositions();
+      /// copy the velocities from the particles into the arrays
+      void updateVelocities();
+
+      /// set the array forces to zero
+      void clearForces();
+      /// add the array forces to the forces of the particles
+      void addForcesToParticles();
+
+      /// number of real and ghost particles
+      longint size() const { return x.size(); }
+      /// number of real particles, these are stored first
+      longint getNReal() const { return nReal; }
+
+      /// proxy back to the particle at array index i
+      Particle &particle(longint i);
+
+      /// array index of a particle in the local cells, -1 if it is not stored here
+      longint indexOf(const Particle *p) const;
+
+      std::vector< real > x, y, z;
+      std::vector< real > vx, vy, vz;
+      std::vector< real > fx, fy, fz;
+      std::vector< int > type;
+      std::vector< longint > id;
+
+    private:
+      /// a cell and the array index of its first particle
+      struct CellRange {
+        Cell *cell;
+        longint offset;
+      };
+
+      /// particle address range of one cell, sorted by address for indexOf
+      struct AddressRange {
+        const Particle *begin;
+        const Particle *end;
+        longint offset;
+        bool operator<(const AddressRange &other) const { return begin < other.begin; }
+      };
+
+      void appendCells(CellList &cells);
+
+      std::vector< CellRange > cellRanges;
+      std::vector< AddressRange > addressRanges;
+      longint nReal;
+      bool valid;
+
+      static LOG4ESPP_DECL_LOGGER(logger);
+    };
+  }
+}
+#endif
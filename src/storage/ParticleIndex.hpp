@@ -0,0 +1,117 @@
+/*
+  Copyright (C) 2017
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _STORAGE_PARTICLEINDEX_HPP
+#define _STORAGE_PARTICLEINDEX_HPP
+
+#include <algorithm>
+#include <vector>
+#include <boost/unordered_map.hpp>
+#include "types.hpp"
+
+namespace espressopp {
+  namespace storage {
+
+    /** Maps particle ids to the Particle of this node.
+
+        Ids in [0, denseLimit) are stored in a flat array indexed by the
+        id, which makes a lookup a single load. The array grows on demand
+        up to denseLimit entries, so it costs at most one pointer per id
+        of that range on every node. All other ids go to a hash table,
+        which is the only table used with the default denseLimit = 0.
+    */
+    class ParticleIndex {
+    public:
+      ParticleIndex() : denseLimit(0), denseCount(0) {}
+
+      Particle* find(longint id) const {
+        if (id >= 0 && id < static_cast< longint >(dense.size())) {
+          return dense[id];
+        }
+        if (sparse.empty()) return 0;
+        Sparse::const_iterator it = sparse.find(id);
+        return (it != sparse.end()) ? it->second : 0;
+      }
+
+      void set(longint id, Particle* p) {
+        if (id >= 0 && id < denseLimit) {
+          if (id >= static_cast< longint >(dense.size())) {
+            // grow geometrically to keep the amortized cost constant
+            longint size = std::max< longint >(id + 1, 2 * dense.size());
+            dense.resize(std::min(size, denseLimit), 0);
+          }
+          if (!dense[id]) ++denseCount;
+          dense[id] = p;
+        } else {
+          sparse[id] = p;
+        }
+      }
+
+      void erase(longint id) {
+        if (id >= 0 && id < static_cast< longint >(dense.size())) {
+          if (dense[id]) --denseCount;
+          dense[id] = 0;
+        } else {
+          sparse.erase(id);
+        }
+      }
+
+      void clear() {
+        // keep the capacity, the node usually gets about as many particles again
+        std::fill(dense.begin(), dense.end(), static_cast< Particle* >(0));
+        denseCount = 0;
+        sparse.clear();
+      }
+
+      /// number of indexed particles
+      longint size() const { return denseCount + sparse.size(); }
+
+      longint getDenseLimit() const { return denseLimit; }
+
+      /// changes the range of the flat array and moves the entries accordingly
+      void setDenseLimit(longint limit) {
+        std::vector< std::pair< longint, Particle* > > entries;
+        entries.reserve(size());
+        for (longint id = 0; id < static_cast< longint >(dense.size()); ++id) {
+          if (dense[id]) entries.push_back(std::make_pair(id, dense[id]));
+        }
+        entries.insert(entries.end(), sparse.begin(), sparse.end());
+
+        denseLimit = std::max< longint >(limit, 0);
+        std::vector< Particle* >().swap(dense);
+        denseCount = 0;
+        sparse.clear();
+        for (size_t i = 0; i < entries.size(); ++i) {
+          set(entries[i].first, entries[i].second);
+        }
+      }
+
+    private:
+      typedef boost::unordered_map< longint, Particle* > Sparse;
+
+      longint denseLimit;
+      longint denseCount;
+      std::vector< Particle* > dense;
+      Sparse sparse;
+    };
+  }
+}
+
+#endif
@@ -35,8 +35,12 @@
 #include "Particle.hpp"
 #include "Buffer.hpp"
 #include "esutil/Error.hpp"
+#include "esutil/PyBuffer.hpp"
 
 #include <iostream>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
 #include <boost/unordered/unordered_map.hpp>
 using namespace std;
 
@@ -56,7 +60,8 @@ namespace espressopp {
     Storage::Storage(shared_ptr< System > system)
       : SystemAccess(system),
         inBuffer(*system->comm),
-        outBuffer(*system->comm)
+        outBuffer(*system->comm),
+        useParticleArrays(false)
     {
       //logger.setLevel(log4espp::Logger::TRACE);
       LOG4ESPP_INFO(logger, "Created new storage object for a system, has buffers");
@@ -111,16 +116,45 @@ namespace espressopp {
       return pids;
     }
 
+    ParticleArrays &Storage::getParticleArrays() {
+      if (!particleArrays.isValid()) {
+        particleArrays.rebuild(realCells, ghostCells);
+      }
+      return particleArrays;
+    }
+
+    python::list Storage::getParticleArraysData() {
+      python::list entries;
+      if (!particleArrays.isValid()) return entries;
+
+      const ParticleArrays &pa = particleArrays;
+      for (longint i = 0; i < pa.size(); ++i) {
+        entries.append(python::make_tuple(pa.id[i],
+                                          Real3D(pa.x[i], pa.y[i], pa.z[i]),
+                                          Real3D(pa.vx[i], pa.vy[i], pa.vz[i]),
+                                          i >= pa.getNReal()));
+      }
+      return entries;
+    }
+
+    void Storage::setUseParticleArrays(bool _useParticleArrays) {
+      if (_useParticleArrays) {
+        throw std::runtime_error("this storage does not support particle arrays");
+      }
+      useParticleArrays = false;
+    }
+
     // TODO find out why python crashes if inlined
     //inline
     void Storage::removeFromLocalParticles(Particle *p, bool weak) {
       /* no pointer left, can happen for ghosts when the real particle
 	 e has already been removed */
-      if (localParticles.find(p->id()) == localParticles.end()){
+      Particle *current = localParticles.find(p->id());
+      if (!current) {
         return;
       }
 
-      if (!weak || localParticles[p->id()] == p) {
+      if (!weak || current == p) {
         LOG4ESPP_TRACE(logger, "removing local pointer for particle id="
                   << p->id() << " @ " << p);
         localParticles.erase(p->id());
@@ -128,7 +162,7 @@ namespace espressopp {
       else {
         LOG4ESPP_TRACE(logger, "NOT removing local pointer for particle id="
                   << p->id() << " @ " << p << " since pointer is @ "
-                  << localParticles[p->id()]);
+                  << current);
       }
     }
 
@@ -187,12 +221,12 @@ namespace espressopp {
     // TODO find out why python crashes if inlined
     //inline
     void Storage::updateInLocalParticles(Particle *p, bool weak) {
-      if (!weak || localParticles.find(p->id()) == localParticles.end()) {
+      if (!weak || !localParticles.find(p->id())) {
           LOG4ESPP_TRACE(logger, "updating local pointer for particle id="
 		       << p->id() << " @ " << p);
 
 
-          localParticles[p->id()] = p;
+          localParticles.set(p->id(), p);
 
           /*
           // AdResS testing TODO
@@ -223,7 +257,7 @@ namespace espressopp {
       else {
           LOG4ESPP_TRACE(logger, "NOT updating local pointer for particle id="
 		       << p->id() << " @ " << p << " has already pointer @ "
-		       << localParticles[p->id()]);
+		       << localParticles.find(p->id()));
       }
     }
 
@@ -261,6 +295,8 @@ namespace espressopp {
       Cell *cell;
 
       Particle n;
+      particleArrays.invalidate();
+
       n.init();
       n.id() = id;
       n.position()= p;
@@ -281,10 +317,102 @@ namespace espressopp {
       return &cell->particles.back();
     }
     
+    longint Storage::addParticlesArray(python::dict arrays) {
+      typedef long long Int;
+      using esutil::PyBuffer;
+
+      PyBuffer< Int > id(arrays.get("id"), "id", 1);
+      PyBuffer< real > pos(arrays.get("pos"), "pos", 3);
+      PyBuffer< Int > type(arrays.get("type"), "type", 1);
+      PyBuffer< real > mass(arrays.get("mass"), "mass", 1);
+      PyBuffer< real > q(arrays.get("q"), "q", 1);
+      PyBuffer< real > v(arrays.get("v"), "v", 3);
+      PyBuffer< real > f(arrays.get("f"), "f", 3);
+      PyBuffer< real > radius(arrays.get("radius"), "radius", 1);
+      PyBuffer< real > fradius(arrays.get("fradius"), "fradius", 1);
+      PyBuffer< real > vradius(arrays.get("vradius"), "vradius", 1);
+      PyBuffer< real > lambda(arrays.get("lambda_adr"), "lambda_adr", 1);
+      PyBuffer< real > lambdaDeriv(arrays.get("lambda_adrd"), "lambda_adrd", 1);
+      PyBuffer< Int > state(arrays.get("state"), "state", 1);
+
+      if (!id.valid() || !pos.valid())
+        throw std::invalid_argument("addParticlesArray: id and pos are mandatory");
+
+      const char* known[] = {"id", "pos", "type", "mass", "q", "v", "f", "radius", "fradius",
+                             "vradius", "lambda_adr", "lambda_adrd", "state"};
+      python::list keys = arrays.keys();
+      for (int k = 0; k < python::len(keys); ++k) {
+        std::string key = python::extract< std::string >(keys[k]);
+        if (std::find(known, known + sizeof(known) / sizeof(known[0]), key) ==
+            known + sizeof(known) / sizeof(known[0]))
+          throw std::invalid_argument("addParticlesArray: unknown particle property " + key);
+      }
+
+      longint n = id.size();
+      if (pos.size() != n ||
+          (type.valid() && type.size() != n) || (mass.valid() && mass.size() != n) ||
+          (q.valid() && q.size() != n) || (v.valid() && v.size() != n) ||
+          (f.valid() && f.size() != n) || (radius.valid() && radius.size() != n) ||
+          (fradius.valid() && fradius.size() != n) || (vradius.valid() && vradius.size() != n) ||
+          (lambda.valid() && lambda.size() != n) ||
+          (lambdaDeriv.valid() && lambdaDeriv.size() != n) ||
+          (state.valid() && state.size() != n))
+        throw std::invalid_argument("addParticlesArray: all arrays need the same number of particles");
+
+      // nothing is added if one of the ids exists on any node
+      esutil::Error err(getSystem()->comm);
+      for (longint i = 0; i < n; ++i) {
+        if (lookupRealParticle(*id[i])) {
+          std::ostringstream msg;
+          msg << "addParticlesArray: particle " << *id[i] << " already exists";
+          err.setException(msg.str());
+          break;
+        }
+      }
+      err.checkException();
+
+      shared_ptr< bc::BC > bc = getSystem()->bc;
+      particleArrays.invalidate();
+
+      longint added = 0;
+      for (longint i = 0; i < n; ++i) {
+        const real* x = pos[i];
+        Real3D p(x[0], x[1], x[2]);
+        if (!checkIsRealParticle(*id[i], p)) continue;
+
+        Particle part;
+        part.init();
+        part.id() = *id[i];
+        part.position() = p;
+        part.image() = Int3D(0);
+        bc->foldPosition(part.position(), part.image());
+
+        if (type.valid()) part.type() = *type[i];
+        if (mass.valid()) part.mass() = *mass[i];
+        if (q.valid()) part.q() = *q[i];
+        if (v.valid()) part.velocity() = Real3D(v[i][0], v[i][1], v[i][2]);
+        if (f.valid()) part.force() = Real3D(f[i][0], f[i][1], f[i][2]);
+        if (radius.valid()) part.radius() = *radius[i];
+        if (fradius.valid()) part.fradius() = *fradius[i];
+        if (vradius.valid()) part.vradius() = *vradius[i];
+        if (lambda.valid()) part.lambda() = *lambda[i];
+        if (lambdaDeriv.valid()) part.lambdaDeriv() = *lambdaDeriv[i];
+        if (state.valid()) part.state() = *state[i];
+
+        Cell *cell = mapPositionToCellClipped(part.position());
+        appendIndexedParticle(cell->particles, part);
+        ++added;
+      }
+
+      LOG4ESPP_INFO(logger, "added " << added << " of " << n << " particles");
+      return added;
+    }
+
     int Storage::removeParticle(longint id){
       Particle* p = lookupRealParticle(id);
       if(p){
         Cell *cell = mapPositionToCellChecked(p->position());
+        particleArrays.invalidate();
         
         removeFromLocalParticles( p );
 
@@ -313,6 +441,7 @@ namespace espressopp {
     }
     
     void Storage::removeAllParticles(){
+      particleArrays.invalidate();
       localParticles.clear();
       for (CellList::iterator it = localCells.begin(), end = localCells.end(); it != end; ++it) {
         (*it)->particles.clear();
@@ -321,6 +450,20 @@ namespace espressopp {
     }
     
 
+    namespace {
+      void refusePartialGhostShell(const std::string& user) {
+        throw std::runtime_error(user + " needs the ghosts of all neighbor cells, "
+                                 "which is incompatible with eighthShell");
+      }
+    }
+
+    boost::signals2::connection Storage::requireFullGhostShell(const std::string& user) {
+      if (!getFullGhostShell()) {
+        refusePartialGhostShell(user);
+      }
+      return beforePartialGhostShell.connect(boost::bind(&refusePartialGhostShell, user));
+    }
+
     Particle* Storage::addAdrATParticle(longint id, const Real3D& p, const Real3D& _vpp) {
 
       if (!checkIsRealParticle(id, _vpp)) {
@@ -486,6 +629,20 @@ namespace espressopp {
       }
     }
 
+    void Storage::insertParticles(ParticleList &pl)
+    {
+      particleArrays.invalidate();
+      for (ParticleList::Iterator it(pl); it.isValid(); ++it) {
+        Cell *nc = mapPositionToCellClipped(it->position());
+        appendUnindexedParticle(nc->particles, *it);
+      }
+
+      // update localParticles, the cells might have been reallocated
+      for(CellList::Iterator it(realCells); it.isValid(); ++it) {
+        updateLocalParticles((*it)->particles);
+      }
+    }
+
     void Storage::sendParticles(ParticleList &list, longint node)
     {
       LOG4ESPP_DEBUG(logger, "send " << list.size() << " particles to " << node);
@@ -553,12 +710,28 @@ namespace espressopp {
     }
 
     void Storage::decompose() {
+      particleArrays.invalidate();
       invalidateGhosts();
       decomposeRealParticles();
       exchangeGhosts();
       onParticlesChanged();
     }
 
+    bool Storage::rebuildNeighborLists() {
+      if (checkParticlesLeftCells()) {
+        decompose();
+        return true;
+      }
+      LOG4ESPP_DEBUG(logger, "all particles are still in their cells, rebuild neighbor lists in place");
+      updateGhosts();
+      onParticlesMoved();
+      return false;
+    }
+
+    bool Storage::checkParticlesLeftCells() {
+      return true;
+    }
+
     void Storage::packPositionsEtc(OutBuffer &buf,
 				   Cell &_reals, int extradata, const Real3D& shift) {
       ParticleList &reals  = _reals.particles;
@@ -755,6 +928,7 @@ namespace espressopp {
 	    .def("savePosition", &Storage::savePosition)
 	    .def("restorePositions", &Storage::restorePositions)
 	    .def("addParticle", &Storage::addParticle, return_value_policy< reference_existing_object >())
+	    .def("addParticlesArray", &Storage::addParticlesArray)
 	    .def("removeParticle", &Storage::removeParticle)
 	    .def("removeAllParticles", &Storage::removeAllParticles)
         .def("addAdrATParticle", &Storage::addAdrATParticle, return_value_policy< reference_existing_object >())
@@ -764,7 +938,9 @@ namespace espressopp {
 	    .def("lookupRealParticle", &Storage::lookupRealParticle, return_value_policy< reference_existing_object >())
 	    .def("decompose", &Storage::decompose)
 	    .def("getRealParticleIDs", &Storage::getRealParticleIDs)
+	    .def("getParticleArraysData", &Storage::getParticleArraysData)
         .add_property("system", &Storage::getSystem)
+        .add_property("denseIdLimit", &Storage::getDenseIdLimit, &Storage::setDenseIdLimit)
 	    ;
     }
   }
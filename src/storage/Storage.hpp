@@ -37,6 +37,8 @@
 #include "Cell.hpp"
 #include "Buffer.hpp"
 #include "types.hpp"
+#include "ParticleArrays.hpp"
+#include "ParticleIndex.hpp"
 
 namespace espressopp {
 
@@ -81,6 +83,16 @@ namespace espressopp {
       */
       Particle* addParticle(longint id, const Real3D& pos);
 
+      /** add many particles at once. arrays maps property names (id, pos,
+          type, mass, q, v, f, radius, fradius, vradius, lambda_adr,
+          lambda_adrd, state) to C-contiguous objects with the buffer
+          protocol, e.g. NumPy arrays, with one value (three for vectors)
+          per particle; id and pos are mandatory. Like addParticle, only
+          the particles of this node are added, directly into their cells.
+          \return the number of particles added on this node
+      */
+      longint addParticlesArray(python::dict arrays);
+
       // remove particle from the system
       int removeParticle(longint id);
       
@@ -107,13 +119,12 @@ namespace espressopp {
       /** lookup whether data for a given particle is available on this node,
 	  either as real or as ghost particle. */
       Particle* lookupLocalParticle(longint id) {
-        IdParticleMap::iterator it = localParticles.find(id);
-        return (it != localParticles.end()) ? it->second : 0;
+        return localParticles.find(id);
       }
 
       Particle* lookupGhostParticle(longint id) {
-        IdParticleMap::iterator it = localParticles.find(id);
-        return (it != localParticles.end() && it->second->ghost() ) ? it->second : 0;
+        Particle* p = localParticles.find(id);
+        return (p && p->ghost()) ? p : 0;
       }
 
       /** Lookup whether data for a given particle is available on this node. 
@@ -130,11 +141,11 @@ namespace espressopp {
       /** Lookup whether data for a given particle is available on this node.
       \return 0 if the particle wasn't available, the pointer to the Particle, if it was. */
       Particle* lookupRealParticle(longint id) {
-        IdParticleMap::iterator it = localParticles.find(id);
+        Particle* p = localParticles.find(id);
 
         // for AdResS
-        if (it != localParticles.end() && !(it->second->ghost())) {
-            return it->second;
+        if (p && !(p->ghost())) {
+            return p;
         }
         else {
             return lookupAdrATParticle(id);
@@ -161,6 +172,13 @@ namespace espressopp {
       //returns number of atomistic adress particles
       longint getNAdressParticles() const;
 
+      /** append the given particles to the local cells, whatever their
+          position, e.g. when reading a checkpoint written with another
+          number of CPUs. decompose() has to be called afterwards to move
+          them to the right CPUs.
+      */
+      void insertParticles(ParticleList &);
+
       /** insert the particles in the given storage into the current one.
 	  This is mainly used to switch from one storage to another.
       */
@@ -172,6 +190,27 @@ namespace espressopp {
 
       python::list getRealParticleIDs();
 
+      /** structure-of-arrays copy of the local particles. If the arrays
+          were invalidated since the last decomposition, they are rebuilt
+          from the cells. */
+      ParticleArrays &getParticleArrays();
+
+      /** the entries of the particle arrays as (id, position, velocity,
+          ghost) tuples, reals first. Empty if the arrays are not valid;
+          unlike getParticleArrays(), this does not rebuild them. */
+      python::list getParticleArraysData();
+
+      /** whether the storage keeps the particle arrays up to date during
+          decomposition and ghost updates. */
+      bool getUseParticleArrays() const { return useParticleArrays; }
+      virtual void setUseParticleArrays(bool _useParticleArrays);
+
+      /** particle ids below this limit are looked up in a flat array
+          instead of a hash table, see ParticleIndex. 0 (default) disables
+          the array. */
+      longint getDenseIdLimit() const { return localParticles.getDenseLimit(); }
+      void setDenseIdLimit(longint limit) { localParticles.setDenseLimit(limit); }
+
       const Cell* getFirstCell() const { return &(cells[0]); }
 
       /** map a position to a valid cell on this node. Used for AdResS */
@@ -203,6 +242,23 @@ namespace espressopp {
       */
       virtual void decompose();
 
+      /** rebuild the neighbor lists after particles moved more than
+	  half the skin. A full decompose() is only done if a real
+	  particle on any CPU left its cell. Otherwise the particle
+	  pointers stay valid, so only the ghost positions are updated
+	  and onParticlesMoved is signalled.
+
+	  \return true if the particles had to be redistributed
+      */
+      bool rebuildNeighborLists();
+
+      /** check whether some real particle on some CPU is no longer
+	  located inside the cell in which it is stored. The default
+	  implementation always reports true, which makes
+	  rebuildNeighborLists() equivalent to decompose().
+      */
+      virtual bool checkParticlesLeftCells();
+
       /** copy minimal information from the real to the ghost
 	  particles.  Typically this copies the positions and maybe the
 	  velocities from real to ghost particles. Particle order is
@@ -228,6 +284,30 @@ namespace espressopp {
       */
       virtual void collectGhostForces() = 0;
 
+      /** split-phase versions of updateGhosts() and
+	  collectGhostForces(), to overlap the communication with
+	  computation. Between begin and end of the ghost update only the
+	  real particles may be read; between begin and end of the force
+	  collection only the forces of real particles may be changed.
+	  The default implementations do all the work in the begin call.
+      */
+      virtual void updateGhostsBegin() { updateGhosts(); }
+      virtual void updateGhostsEnd() {}
+      virtual void collectGhostForcesBegin() { collectGhostForces(); }
+      virtual void collectGhostForcesEnd() {}
+
+      /** whether the ghosts of all neighbor cells are imported, see
+          DomainDecomposition::setEighthShell */
+      virtual bool getFullGhostShell() const { return true; }
+
+      /** For classes that need the ghosts of all neighbor cells, like
+          tuple lists over several nodes and AdResS. Throws if the ghost
+          shell is not full; otherwise, switching to a partial shell
+          throws as long as the returned connection is connected.
+          Call it before connecting to any other signal.
+      */
+      boost::signals2::connection requireFullGhostShell(const std::string& user);
+
       /** Ths signal will be called whenever the storage was modified
 	  such that particle pointers have become invalid, e.g. at the
 	  end of decompose().  Classes that connect to this signal can
@@ -235,16 +315,30 @@ namespace espressopp {
 	  lookupLocalParticle() and lookupRealParticle().
        */
       boost::signals2::signal<void ()> onParticlesChanged;
+      /** This signal will be called when particles have moved so far
+	  that neighbor lists have to be rebuilt, but the particle
+	  pointers are still valid, see rebuildNeighborLists().
+       */
+      boost::signals2::signal<void ()> onParticlesMoved;
       boost::signals2::signal<void (ParticleList&, class OutBuffer&)>
         beforeSendParticles;
       boost::signals2::signal<void (ParticleList&, class InBuffer&)>
         afterRecvParticles;
+      /** Packs the same data as beforeSendParticles, but the tuples stay
+          in the lists, e.g. for a checkpoint (System::checkpoint). Every
+          class connected to beforeSendParticles connects here as well. */
+      boost::signals2::signal<void (ParticleList&, class OutBuffer&)>
+        beforeSaveParticles;
 
 
       // for AdResS
       // this is exactly the same as onParticlesChanged, but only used to rebuild tuples
       boost::signals2::signal<void ()> onTuplesChanged;
 
+      /** This signal is called before the storage stops importing the
+          ghosts of all neighbor cells; see requireFullGhostShell. */
+      boost::signals2::signal<void ()> beforePartialGhostShell;
+
 
       // for AdResS
       void setFixedTuplesAdress(shared_ptr<FixedTupleListAdress> _fixedtupleList){
@@ -402,6 +496,10 @@ namespace espressopp {
       InBuffer inBuffer;
       OutBuffer outBuffer;
 
+      /// SoA mirror of the particles in the local cells
+      ParticleArrays particleArrays;
+      bool useParticleArrays;
+
 
       // used for AdResS
       shared_ptr<FixedTupleListAdress> fixedtupleList;
@@ -418,7 +516,7 @@ namespace espressopp {
 
     private:
       // map particle id to Particle * for all particles on this node
-      boost::unordered_map<longint, Particle*> localParticles;
+      ParticleIndex localParticles;
 
 
       // AdResS atomistic particles (they are not stored in cells!)
@@ -75,6 +75,27 @@ All derived classes implement at least the following methods:
    
    >>> addParticles([[id, pos, type, ... ], ...], 'id', 'pos', 'type', ...)
 
+* `addParticlesArray(**arrays)`:
+
+   Adds many particles at once from NumPy arrays (or anything numpy.asarray
+   accepts), one keyword per property: ``id`` and ``pos`` (shape (N, 3))
+   are mandatory, ``type``, ``mass``, ``q``, ``v``, ``f``, ``radius``,
+   ``fradius``, ``vradius``, ``lambda_adr``, ``lambda_adrd`` and ``state``
+   are optional. The particles are copied into the cells in C++ without
+   creating a Python object per particle, which makes this much faster
+   than `addParticles` for large systems. Nothing is added if one of the
+   ids already exists. AdResS AT particles are not supported.
+
+   All arrays are sent to every CPU, so for very large systems it is
+   better to call this in chunks of e.g. a million particles. As with
+   `addParticles`, call `decompose()` when all particles are added.
+
+   Example:
+
+   >>> pos = numpy.random.random((N, 3)) * L
+   >>> system.storage.addParticlesArray(id=numpy.arange(N), pos=pos, type=numpy.zeros(N, dtype=int))
+   >>> system.storage.decompose()
+
 * `modifyParticle(pid, property, value, decompose='yes')`
     
    This routine allows to modify any properties of an already existing particle.
@@ -87,10 +108,26 @@ All derived classes implement at least the following methods:
 
    This routine removes all particles from the storage.
    
+* `getParticleArraysData()`:
+
+   Returns per CPU the entries of the structure-of-arrays particle copy
+   (see the ``useParticleArrays`` property of DomainDecomposition) as
+   ``(id, pos, v, ghost)`` tuples, real particles first. The list of a
+   CPU is empty while its arrays are not up to date.
+
 * 'system':
 
   The property 'system' returns the System object of the storage.
 
+* 'denseIdLimit':
+
+  Particle ids below this limit are looked up in a flat array instead of
+  a hash table. This makes the lookups of bonded interactions and ghost
+  updates faster, but costs one pointer per id below the limit on every
+  CPU, e.g. 80 MB for 10 million ids. Set it to the number of particles
+  when the ids are (roughly) 0 ... N-1. The default 0 uses the hash table
+  only.
+
 Examples:
 
 >>> s.storage.addParticles([[1, espressopp.Real3D(3,3,3)], [2, espressopp.Real3D(4,4,4)]],'id','pos')
@@ -123,6 +160,11 @@ Examples:
 		:type \*properties: 
 		:rtype: 
 
+.. function:: espressopp.storage.Storage.addParticlesArray(\*\*arrays)
+
+		:param \*\*arrays: property name and array of the values of all particles
+		:rtype: int
+
 .. function:: espressopp.storage.Storage.clearSavedPositions()
 
 		:rtype: 
@@ -349,6 +391,19 @@ class StorageLocal(object):
                     if index_state >= 0:
                         storedParticle.state = particle[index_state]
  
+    def addParticlesArray(self, **arrays):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            import numpy
+            integerProperties = ('id', 'type', 'state')
+            data = {}
+            for name, values in arrays.items():
+                name = name.lower()
+                if name in integerProperties:
+                    data[name] = numpy.ascontiguousarray(values, dtype=numpy.int64)
+                else:
+                    data[name] = numpy.ascontiguousarray(values, dtype=numpy.float64)
+            return self.cxxclass.addParticlesArray(self, data)
+
     def modifyParticle(self, pid, property, value):
         if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
           
@@ -399,6 +454,10 @@ class StorageLocal(object):
       if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
         return self.cxxclass.getRealParticleIDs(self)
     
+    def getParticleArraysData(self):
+      if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+        return self.cxxclass.getParticleArraysData(self)
+
     def printRealParticles(self):
       if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
         for pid in self.getRealParticleIDs():
@@ -409,9 +468,9 @@ if pmi.isController:
     class Storage(object):
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
-            pmicall = [ "decompose", "addParticles", "setFixedTuplesAdress", "removeAllParticles"],
-            pmiproperty = [ "system" ],
-            pmiinvoke = ["getRealParticleIDs", "printRealParticles"]
+            pmicall = [ "decompose", "addParticles", "addParticlesArray", "setFixedTuplesAdress", "removeAllParticles"],
+            pmiproperty = [ "system", "denseIdLimit" ],
+            pmiinvoke = ["getRealParticleIDs", "printRealParticles", "getParticleArraysData"]
             )
 
         def particleExists(self, pid):
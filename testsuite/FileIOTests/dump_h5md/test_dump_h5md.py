@@ -0,0 +1,109 @@
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research & JGU Mainz
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+import os
+import random
+import espressopp
+import unittest
+
+try:
+    import h5py
+except ImportError:
+    h5py = None
+
+filename = 'test_dump_h5md.h5'
+box = (20, 20, 20)
+num_particles = 50
+
+
+class TestDumpH5MD(unittest.TestCase):
+    def setUp(self):
+        if h5py is None:
+            self.skipTest('h5py is needed to read the file back')
+        system, integrator = espressopp.standard_system.LennardJones(0, box)
+
+        random.seed(4321)
+        particle_list = []
+        for pid in range(1, num_particles + 1):
+            pos = espressopp.Real3D(*[random.uniform(0., L) for L in box])
+            v = espressopp.Real3D(*[random.gauss(0., 1.) for L in box])
+            particle_list.append((pid, pid % 3, pos, v))
+        system.storage.addParticles(particle_list, 'id', 'type', 'pos', 'v')
+        system.storage.decompose()
+
+        self.system = system
+        self.integrator = integrator
+
+    # the configuration in the file order, taken from the storage
+    def configuration(self):
+        parts = [self.system.storage.getParticle(pid) for pid in range(1, num_particles + 1)]
+        return dict((p.id, ((p.pos[0], p.pos[1], p.pos[2]), (p.v[0], p.v[1], p.v[2]), p.type))
+                    for p in parts)
+
+    # the frame of the file, by particle id
+    def read_frame(self, f, frame):
+        group = f['particles/all']
+        ids = group['id/value'][frame]
+        pos = group['position/value'][frame]
+        vel = group['velocity/value'][frame]
+        species = group['species/value'][frame]
+        return dict((int(ids[i]), (tuple(pos[i]), tuple(vel[i]), int(species[i])))
+                    for i in range(len(ids)))
+
+    def compare(self, frame, reference):
+        self.assertEqual(sorted(frame.keys()), sorted(reference.keys()))
+        for pid, (pos, vel, species) in frame.items():
+            ref_pos, ref_vel, ref_species = reference[pid]
+            for k in range(3):
+                self.assertAlmostEqual(pos[k], ref_pos[k], places=10)
+                self.assertAlmostEqual(vel[k], ref_vel[k], places=10)
+            self.assertEqual(species, ref_species)
+
+    def test_round_trip(self):
+        dump_h5md = espressopp.io.DumpH5MD(self.system, self.integrator, filename=filename)
+        dump_h5md.dump()
+        first = self.configuration()
+
+        self.integrator.run(10)
+        dump_h5md.dump()
+        second = self.configuration()
+        dump_h5md.close()
+
+        # append a third frame to the closed file
+        self.integrator.run(5)
+        dump_h5md = espressopp.io.DumpH5MD(self.system, self.integrator, filename=filename, append=True)
+        dump_h5md.dump()
+        third = self.configuration()
+        dump_h5md.close()
+
+        f = h5py.File(filename, 'r')
+        self.assertEqual(list(f['particles/all/position/step']), [0, 10, 15])
+        for frame, reference in enumerate([first, second, third]):
+            self.compare(self.read_frame(f, frame), reference)
+            for k in range(3):
+                self.assertAlmostEqual(f['particles/all/box/edges/value'][frame][k], box[k], places=10)
+        f.close()
+
+    def tearDown(self):
+        if os.path.exists(filename):
+            os.remove(filename)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -132,6 +132,23 @@ class TestDumpXYZ(unittest.TestCase):
         self.assertTrue(filecmp.cmp(file_xyz, expected_files[2], shallow = False), "!!! Error! Files are not equal!! They should be equal!")
 
 
+    def test_asynchronous_xyz(self):
+        particle_list = [
+            (1, espressopp.Real3D(2.2319834598, 3.5858734534, 4.7485623451), espressopp.Real3D(2.2319834598, 1.5556734534, 4.7485623451), 0),
+            (2, espressopp.Real3D(6.3459834598, 9.5858734534, 16.7485623451), espressopp.Real3D(3.2319834598, 1.5858734534, 1.7485623451), 0),
+            (3, espressopp.Real3D(2.2319834598, 15.5858734534, 5.7485623451), espressopp.Real3D(4.2319834598, 2.5858734534, 2.7485623451), 2),
+            (4, espressopp.Real3D(8.2319834598, 7.9958734534, 14.5325623451), espressopp.Real3D(5.2319834598, 6.5858734534, 18.7485623451), 3),
+            (5, espressopp.Real3D(3.2319834598, 19.5858734534, 4.7485623451), espressopp.Real3D(6.2319834598, 8.5858734534, 7.7485623451), 1),
+        ]
+        self.system.storage.addParticles(particle_list, 'id', 'pos', 'v', 'type')
+        file_xyz = "test_asynchronous_dumpXYZ.xyz"
+        dump_xyz = espressopp.io.DumpXYZ(self.system, self.integrator, filename=file_xyz, unfolded = False, length_factor = 1.0, length_unit = 'LJ', append = False)
+        dump_xyz.asynchronous = True
+        dump_xyz.dump()
+        dump_xyz.flush()
+        self.assertTrue(filecmp.cmp(file_xyz, expected_files[0], shallow = False), "!!! Error! Files are not equal!! They should be equal!")
+
+
     def tearDown(self):
         remove_all_xyz_files()
 
@@ -0,0 +1,143 @@
+#  Copyright (C) 2017
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+import unittest
+
+import numpy
+
+import espressopp
+
+box = (10., 10., 10.)
+num_particles = 200
+
+
+class TestAddParticlesArray(unittest.TestCase):
+    def setUp(self):
+        rng = numpy.random.RandomState(42)
+        self.pid = numpy.arange(1, num_particles + 1)
+        # some positions outside of the box, they are folded
+        self.pos = rng.uniform(-5.0, 15.0, (num_particles, 3))
+        self.type = rng.randint(0, 3, num_particles)
+        self.mass = rng.uniform(1.0, 2.0, num_particles)
+        self.v = rng.normal(0.0, 1.0, (num_particles, 3))
+
+    def test_same_as_add_particles(self):
+        system, integrator = espressopp.standard_system.Minimal(0, box)
+        system.storage.addParticlesArray(id=self.pid, pos=self.pos, type=self.type,
+                                         mass=self.mass, v=self.v)
+        system.storage.decompose()
+
+        ref_system, ref_integrator = espressopp.standard_system.Minimal(0, box)
+        particle_list = [
+            (int(self.pid[i]), espressopp.Real3D(*self.pos[i]), int(self.type[i]),
+             self.mass[i], espressopp.Real3D(*self.v[i]))
+            for i in range(num_particles)]
+        ref_system.storage.addParticles(particle_list, 'id', 'pos', 'type', 'mass', 'v')
+        ref_system.storage.decompose()
+
+        self.assertEqual(int(espressopp.analysis.NPart(system).compute()), num_particles)
+        for pid in self.pid:
+            p = system.storage.getParticle(int(pid))
+            ref = ref_system.storage.getParticle(int(pid))
+            self.assertEqual(p.type, ref.type)
+            self.assertEqual(p.mass, ref.mass)
+            self.assertEqual(tuple(p.pos), tuple(ref.pos))
+            self.assertEqual(tuple(p.imageBox), tuple(ref.imageBox))
+            self.assertEqual(tuple(p.v), tuple(ref.v))
+
+    def test_existing_particle(self):
+        system, integrator = espressopp.standard_system.Minimal(0, box)
+        system.storage.addParticlesArray(id=self.pid, pos=self.pos)
+        with self.assertRaises(RuntimeError):
+            system.storage.addParticlesArray(id=[num_particles, num_particles + 1],
+                                             pos=[(1.0, 1.0, 1.0), (2.0, 2.0, 2.0)])
+        system.storage.decompose()
+        self.assertEqual(int(espressopp.analysis.NPart(system).compute()), num_particles)
+
+    def test_missing_position(self):
+        system, integrator = espressopp.standard_system.Minimal(0, box)
+        with self.assertRaises(ValueError):
+            system.storage.addParticlesArray(id=self.pid)
+
+
+class TestAddTuplesArray(unittest.TestCase):
+    def setUp(self):
+        self.system, integrator = espressopp.standard_system.Minimal(0, box)
+        num_chain = 20
+        pid = numpy.arange(num_chain)
+        pos = numpy.column_stack((numpy.full(num_chain, 5.0), numpy.full(num_chain, 5.0),
+                                  0.4 * pid + 0.1))
+        self.system.storage.addParticlesArray(id=pid, pos=pos)
+        self.system.storage.decompose()
+        self.bonds = numpy.column_stack((pid[:-1], pid[1:]))
+        self.triples = numpy.column_stack((pid[:-2], pid[1:-1], pid[2:]))
+
+    def test_add_bonds_array(self):
+        fpl = espressopp.FixedPairList(self.system.storage)
+        # swapped ids are stored with the lower id first, like addBonds does
+        fpl.addBondsArray(self.bonds[:, ::-1])
+        ref = espressopp.FixedPairList(self.system.storage)
+        ref.addBonds([(int(b[0]), int(b[1])) for b in self.bonds])
+        self.assertEqual(sum(fpl.size()), len(self.bonds))
+        self.assertEqual(sorted(b for bonds in fpl.getBonds() for b in bonds),
+                         sorted(b for bonds in ref.getBonds() for b in bonds))
+
+    def test_add_triples_array(self):
+        ftl = espressopp.FixedTripleList(self.system.storage)
+        ftl.addTriplesArray(self.triples)
+        ref = espressopp.FixedTripleList(self.system.storage)
+        ref.addTriples([tuple(int(p) for p in t) for t in self.triples])
+        self.assertEqual(sum(ftl.size()), len(self.triples))
+        self.assertEqual(sorted(t for triples in ftl.getTriples() for t in triples),
+                         sorted(t for triples in ref.getTriples() for t in triples))
+
+    def test_sorted_after_migration(self):
+        fpl = espressopp.FixedPairList(self.system.storage)
+        fpl.addBondsArray(self.bonds[::-1])
+        ftl = espressopp.FixedTripleList(self.system.storage)
+        ftl.addTriplesArray(self.triples[::-1])
+        # move the chain by half a box, so that its particles change their CPU
+        for pid in range(len(self.bonds) + 1):
+            pos = self.system.storage.getParticle(pid).pos
+            self.system.storage.modifyParticle(pid, 'pos', pos + espressopp.Real3D(0.0, 0.0, 5.0))
+        self.system.storage.decompose()
+
+        # the tuples of every CPU are sorted by the id of their first or central particle
+        for bonds in fpl.getBonds():
+            self.assertEqual(list(bonds), sorted(bonds, key=lambda b: b[0]))
+        for triples in ftl.getTriples():
+            self.assertEqual(list(triples), sorted(triples, key=lambda t: t[1]))
+        self.assertEqual(sorted(b for bonds in fpl.getBonds() for b in bonds),
+                         [(int(b[0]), int(b[1])) for b in self.bonds])
+        self.assertEqual(sorted(t for triples in ftl.getTriples() for t in triples),
+                         [tuple(int(p) for p in t) for t in self.triples])
+
+    def test_add_triples_array_missing(self):
+        ftl = espressopp.FixedTripleList(self.system.storage)
+        # the last triple refers to a particle that does not exist
+        triples = numpy.vstack((self.triples, [[18, 19, 100]]))
+        with self.assertRaises(RuntimeError):
+            ftl.addTriplesArray(triples)
+        # none of the valid triples was added either
+        self.assertEqual(sum(ftl.size()), 0)
+        self.assertEqual(sum(len(triples) for triples in ftl.getTriples()), 0)
+
+
+if __name__ == '__main__':
+    unittest.main()
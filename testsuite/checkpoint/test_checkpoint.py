@@ -0,0 +1,163 @@
+#  Copyright (C) 2017
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+import os
+import shutil
+import struct
+import unittest
+
+import espressopp
+
+checkpoint_dir = 'test_checkpoint.ckp'
+empty_dir = 'test_checkpoint_empty.ckp'
+merged_dir = 'test_checkpoint_merged.ckp'
+box = (10., 10., 10.)
+# chains of 8 particles along the rows of a 8x8x8 lattice
+num_particles = 512
+
+
+class TestCheckpoint(unittest.TestCase):
+    def create_system(self):
+        system, integrator = espressopp.standard_system.Minimal(0, box, temperature=1.0)
+        fpl = espressopp.FixedPairList(system.storage)
+        interaction = espressopp.interaction.FixedPairListHarmonic(
+            system, fpl, potential=espressopp.interaction.Harmonic(K=30.0, r0=1.0))
+        system.addInteraction(interaction)
+        return system, integrator, fpl
+
+    def add_particles(self, system, fpl):
+        particle_list = []
+        for pid in range(1, num_particles + 1):
+            i = pid - 1
+            pos = espressopp.Real3D(0.5 + 1.25 * (i % 8), 0.5 + 1.25 * (i // 8 % 8), 0.5 + 1.25 * (i // 64))
+            v = espressopp.Real3D(0.1 * (pid % 3 - 1), 0.05 * (pid % 5 - 2), 0.2 * (pid % 2 - 0.5))
+            particle_list.append((pid, pid % 2, 1.0 + pid % 3, pos, v))
+        system.storage.addParticles(particle_list, 'id', 'type', 'mass', 'pos', 'v')
+        system.storage.decompose()
+        fpl.addBonds([(pid, pid + 1) for pid in range(1, num_particles) if pid % 8 != 0])
+
+    def state(self, system):
+        state = {}
+        for pid in range(1, num_particles + 1):
+            p = system.storage.getParticle(pid)
+            state[pid] = (p.type, p.mass, tuple(p.pos), tuple(p.v), tuple(p.imageBox))
+        return state
+
+    def bonds(self, fpl):
+        return sorted(tuple(b) for local in fpl.getBonds() for b in local)
+
+    def forces(self, system, integrator):
+        integrator.run(0)
+        return [system.storage.getParticle(pid).f for pid in range(1, num_particles + 1)]
+
+    def compare_positions(self, state, reference):
+        for pid in range(1, num_particles + 1):
+            for k in range(3):
+                self.assertAlmostEqual(state[pid][2][k], reference[pid][2][k], places=8)
+                self.assertAlmostEqual(state[pid][3][k], reference[pid][3][k], places=8)
+
+    def compare_forces(self, forces, reference):
+        for f, ref_f in zip(forces, reference):
+            for k in range(3):
+                self.assertAlmostEqual(f[k], ref_f[k], places=10)
+
+    def test_checkpoint_restore(self):
+        system, integrator, fpl = self.create_system()
+        self.add_particles(system, fpl)
+        integrator.run(10)
+
+        system.checkpoint(checkpoint_dir, integrator)
+        saved = self.state(system)
+        saved_bonds = self.bonds(fpl)
+        # the thermostat continues the random numbers of the checkpoint
+        draws = [system.rng() for i in range(5)]
+        integrator.run(10)
+        reference = self.state(system)
+
+        # a fresh system, set up by the same script without particles
+        system, integrator, fpl = self.create_system()
+        system.restore(checkpoint_dir, integrator)
+
+        self.assertEqual(integrator.step, 10)
+        self.assertEqual(self.bonds(fpl), saved_bonds)
+        self.assertEqual(self.state(system), saved)
+        self.assertEqual([system.rng() for i in range(5)], draws)
+        integrator.run(10)
+        self.compare_positions(self.state(system), reference)
+
+    def test_checkpoint_keeps_system(self):
+        # the same run with and without a checkpoint in between
+        runs = []
+        for write in (False, True):
+            system, integrator, fpl = self.create_system()
+            self.add_particles(system, fpl)
+            integrator.run(10)
+            if write:
+                system.checkpoint(checkpoint_dir, integrator)
+            bonds = fpl.getBonds()
+            integrator.run(10)
+            runs.append((bonds, self.state(system)))
+
+        # the bonds keep their order in the lists
+        self.assertEqual(runs[1][0], runs[0][0])
+        self.assertEqual(runs[1][1], runs[0][1])
+
+    def test_restore_other_cpu_count(self):
+        system, integrator, fpl = self.create_system()
+        self.add_particles(system, fpl)
+        integrator.run(10)
+        system.checkpoint(checkpoint_dir, integrator)
+        saved = self.state(system)
+        saved_bonds = self.bonds(fpl)
+        reference = self.forces(system, integrator)
+
+        # the files of twice as many CPUs: the first half of the CPUs had
+        # no particles, the second half has those of this checkpoint
+        system, integrator, fpl = self.create_system()
+        system.checkpoint(empty_dir, integrator)
+        size = espressopp.MPI.COMM_WORLD.size
+        os.mkdir(merged_dir)
+        for rank in range(size):
+            shutil.copy(os.path.join(empty_dir, 'rank.%d.bin' % rank),
+                        os.path.join(merged_dir, 'rank.%d.bin' % rank))
+            shutil.copy(os.path.join(checkpoint_dir, 'rank.%d.bin' % rank),
+                        os.path.join(merged_dir, 'rank.%d.bin' % (rank + size)))
+        with open(os.path.join(checkpoint_dir, 'header.bin'), 'rb') as f:
+            header = f.read()
+        # the number of CPUs is the second of the integers of the header
+        magic, nranks = struct.unpack('qq', header[:16])
+        self.assertEqual(nranks, size)
+        with open(os.path.join(merged_dir, 'header.bin'), 'wb') as f:
+            f.write(struct.pack('qq', magic, 2 * size) + header[16:])
+
+        system.restore(merged_dir, integrator)
+
+        self.assertEqual(integrator.step, 10)
+        self.assertEqual(int(espressopp.analysis.NPart(system).compute()), num_particles)
+        self.assertEqual(self.bonds(fpl), saved_bonds)
+        self.assertEqual(self.state(system), saved)
+        self.compare_forces(self.forces(system, integrator), reference)
+
+    def tearDown(self):
+        for path in (checkpoint_dir, empty_dir, merged_dir):
+            shutil.rmtree(path, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,69 @@
+'''
+#  Compares the K space part of P3M with the one of the Ewald sums for the
+#  system in 'ini_struct_deserno.dat' (see ewald_eppDeserno_comparison.py).
+#  On several CPUs it checks the distributed mesh and FFT of P3M.
+'''
+
+import unittest
+import mpi4py.MPI as MPI
+import espressopp
+
+from espressopp import Real3D, Int3D
+from espressopp.tools import espresso_old
+
+alpha          = 1.112583061
+rspacecutoff   = 4.9
+kspacecutoff   = 30
+skin           = 0.09
+mesh           = Int3D(32, 32, 32)
+order          = 7
+coulomb_prefactor = 1.0
+
+class TestP3M(unittest.TestCase):
+  def setUp(self):
+    Lx, Ly, Lz, x, y, z, type, q, vx,vy,vz,fx,fy,fz,bondpairs = espresso_old.read('ini_struct_deserno.dat')
+    box = (Lx, Ly, Lz)
+    self.num_particles = len(x)
+
+    nodeGrid       = espressopp.tools.decomp.nodeGrid(MPI.COMM_WORLD.size)
+    cellGrid       = espressopp.tools.decomp.cellGrid(box, nodeGrid, rspacecutoff, skin)
+    system         = espressopp.System()
+    system.rng     = espressopp.esutil.RNG()
+    system.bc      = espressopp.bc.OrthorhombicBC(system.rng, box)
+    system.skin    = skin
+    system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+
+    props = ['id', 'pos', 'type', 'q']
+    new_particles = []
+    for i in range(0, self.num_particles):
+      new_particles.append([ i, Real3D(x[i], y[i], z[i]), type[i], q[i] ])
+    system.storage.addParticles(new_particles, *props)
+    system.storage.decompose()
+
+    self.system = system
+    self.integrator = espressopp.integrator.VelocityVerlet(system)
+    self.integrator.dt = 0.0001
+
+  # the energy and the forces of a K space interaction alone
+  def compute(self, interaction):
+    self.system.addInteraction(interaction)
+    self.integrator.run(0)
+    energy = interaction.computeEnergy()
+    forces = [self.system.storage.getParticle(pid).f for pid in range(self.num_particles)]
+    self.system.removeInteraction(0)
+    return energy, forces
+
+  def test_ewald(self):
+    ewald_pot = espressopp.interaction.CoulombKSpaceEwald(self.system, coulomb_prefactor, alpha, kspacecutoff)
+    energy_ewald, forces_ewald = self.compute(espressopp.interaction.CellListCoulombKSpaceEwald(self.system.storage, ewald_pot))
+
+    p3m_pot = espressopp.interaction.CoulombKSpaceP3M(self.system, coulomb_prefactor, alpha, mesh, order, rspacecutoff)
+    energy_p3m, forces_p3m = self.compute(espressopp.interaction.CellListCoulombKSpaceP3M(self.system.storage, p3m_pot))
+
+    self.assertAlmostEqual(energy_p3m, energy_ewald, places=3)
+    for f, ref_f in zip(forces_p3m, forces_ewald):
+      for k in range(3):
+        self.assertAlmostEqual(f[k], ref_f[k], places=3)
+
+if __name__ == '__main__':
+  unittest.main()
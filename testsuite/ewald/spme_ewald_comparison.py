@@ -0,0 +1,108 @@
+'''
+#  Compares the smooth particle mesh Ewald K space part with the results of
+#  Markus Deserno for the system in 'ini_struct_deserno.dat' (see
+#  ewald_eppDeserno_comparison.py): the R space part is the same, the
+#  K space part is computed with CoulombKSpaceSPME instead of Ewald sums.
+#  The virial and the virial tensor are compared with CoulombKSpaceEwald.
+#  On several CPUs it checks the sum of the charge meshes.
+'''
+
+import unittest
+import mpi4py.MPI as MPI
+import espressopp
+
+from espressopp import Real3D, Int3D
+from espressopp.tools import espresso_old
+
+# reads the energy and the forces of Deserno from "deserno_ewald.dat"
+def readingDesernoForcesFile():
+  forces = []
+  energy = 0.0
+  file = open("deserno_ewald.dat")
+  for i, line in enumerate(file):
+    if i==6:
+      energy = float(line.split()[0])
+    if i>=9:
+      tmp = line.replace('{','').replace('}','').split()
+      forces.append((float(tmp[0]), float(tmp[1]), float(tmp[2])))
+  file.close()
+  return energy, forces
+
+alpha          = 1.112583061
+rspacecutoff   = 4.9
+kspacecutoff   = 30
+skin           = 0.09
+mesh           = Int3D(48, 48, 48)
+order          = 7
+coulomb_prefactor = 1.0
+
+class TestSPME(unittest.TestCase):
+  def setUp(self):
+    Lx, Ly, Lz, x, y, z, type, q, vx,vy,vz,fx,fy,fz,bondpairs = espresso_old.read('ini_struct_deserno.dat')
+    box = (Lx, Ly, Lz)
+    self.num_particles = len(x)
+    self.volume = Lx * Ly * Lz
+
+    nodeGrid       = espressopp.tools.decomp.nodeGrid(MPI.COMM_WORLD.size)
+    cellGrid       = espressopp.tools.decomp.cellGrid(box, nodeGrid, rspacecutoff, skin)
+    system         = espressopp.System()
+    system.rng     = espressopp.esutil.RNG()
+    system.bc      = espressopp.bc.OrthorhombicBC(system.rng, box)
+    system.skin    = skin
+    system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+
+    props = ['id', 'pos', 'type', 'q']
+    new_particles = []
+    for i in range(0, self.num_particles):
+      new_particles.append([ i, Real3D(x[i], y[i], z[i]), type[i], q[i] ])
+    system.storage.addParticles(new_particles, *props)
+    system.storage.decompose()
+
+    vl = espressopp.VerletList(system, rspacecutoff+skin)
+    coulombR_pot = espressopp.interaction.CoulombRSpace(coulomb_prefactor, alpha, rspacecutoff)
+    self.coulombR_int = espressopp.interaction.VerletListCoulombRSpace(vl)
+    self.coulombR_int.setPotential(type1=0, type2=0, potential = coulombR_pot)
+    system.addInteraction(self.coulombR_int)
+
+    spme_pot = espressopp.interaction.CoulombKSpaceSPME(system, coulomb_prefactor, alpha, mesh, order)
+    self.spme_int = espressopp.interaction.CellListCoulombKSpaceSPME(system.storage, spme_pot)
+    system.addInteraction(self.spme_int)
+
+    self.system = system
+    self.integrator = espressopp.integrator.VelocityVerlet(system)
+    self.integrator.dt = 0.0001
+
+  def test_deserno(self):
+    self.integrator.run(0)
+    energy_Deserno, forces_Deserno = readingDesernoForcesFile()
+
+    enTot = self.coulombR_int.computeEnergy() + self.spme_int.computeEnergy()
+    self.assertAlmostEqual(enTot, energy_Deserno, places=3)
+
+    for pid in range(self.num_particles):
+      f = self.system.storage.getParticle(pid).f
+      for k in range(3):
+        self.assertAlmostEqual(f[k], forces_Deserno[pid][k], places=3)
+
+  def test_virial(self):
+    self.integrator.run(0)
+    virial_spme = self.spme_int.computeVirial()
+    # the pressure tensor times the volume is the virial tensor, the
+    # particles are at rest
+    tensor_spme = espressopp.analysis.PressureTensor(self.system).compute()
+
+    # the same with the Ewald sums in place of SPME
+    self.system.removeInteraction(1)
+    ewald_pot = espressopp.interaction.CoulombKSpaceEwald(self.system, coulomb_prefactor, alpha, kspacecutoff)
+    ewald_int = espressopp.interaction.CellListCoulombKSpaceEwald(self.system.storage, ewald_pot)
+    self.system.addInteraction(ewald_int)
+    self.integrator.run(0)
+    virial_ewald = ewald_int.computeVirial()
+    tensor_ewald = espressopp.analysis.PressureTensor(self.system).compute()
+
+    self.assertAlmostEqual(virial_spme, virial_ewald, places=3)
+    for k in range(6):
+      self.assertAlmostEqual(tensor_spme[k] * self.volume, tensor_ewald[k] * self.volume, places=3)
+
+if __name__ == '__main__':
+  unittest.main()
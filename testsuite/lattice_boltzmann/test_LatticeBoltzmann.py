@@ -4,6 +4,7 @@ from espressopp import Int3D
 from espressopp import Real3D
 
 import unittest
+import os
 
 runSteps = 500
 temperature = 1.0
@@ -55,6 +56,91 @@ class TestPureLB(unittest.TestCase):
 
         self.check_averages(initVel) # sin-like wave is killed by temperature
 
+    def test_threads(self):
+        print "Checking that the thermal LB fluid does not depend on the number of threads"
+
+        nodeGrid = self.lb.nodeGrid
+        moms = []
+        for numThreads in [1, 2]:
+            self.make_lb(nodeGrid)
+            self.lb.numThreads = numThreads
+            if self.lb.usedThreads != numThreads:
+                self.skipTest("built without OpenMP")
+            initPop = espressopp.integrator.LBInitPopWave(self.system,self.lb)
+            initPop.createDenVel(initDen, Real3D(initVel, initVel, initVelSin))
+            self.lb.lbTemp = temperature
+            self.integrator.run(50)
+
+            halo = 1
+            myNi = self.lb.getMyNi
+            moms.append([self.lb.getLBMom(Int3D(i,j,k), m)
+                         for i in range (halo, myNi[0]-halo)
+                         for j in range (halo, myNi[1]-halo)
+                         for k in range (halo, myNi[2]-halo)
+                         for m in range (4)])
+
+        for a, b in zip(moms[0], moms[1]):
+            self.assertEqual(a, b)
+
+    def test_checkpoint(self):
+        print "Checking binary checkpoint and restart of the LB fluid"
+        filename = "lb_checkpoint.bin"
+
+        initPop = espressopp.integrator.LBInitPopWave(self.system,self.lb)
+        initPop.createDenVel(initDen, Real3D(initVel, initVel, initVelSin))
+        self.integrator.run(20)
+        self.lb.saveLBCheckpoint(filename)
+        nodeGrid = self.lb.nodeGrid
+        saved = self.lb_state(self.lb.getMyNi)
+
+        # restart into a fresh lattice
+        self.make_lb(nodeGrid)
+        self.lb.readLBCheckpoint(filename)
+        self.assertEqual(self.lb_state(self.lb.getMyNi), saved)
+
+        # restart on a different nodeGrid (the same one on a single CPU). The
+        # first CPU starts with the global site 0 on any grid, so the sites
+        # both of its lattices have in common can be compared directly.
+        otherNodeGrid = Int3D(nodeGrid[2], nodeGrid[0], nodeGrid[1])
+        self.make_lb(otherNodeGrid)
+        self.lb.readLBCheckpoint(filename)
+        myNi = self.lb.getMyNi
+        commonNi = Int3D(min(myNi[0], saved[0][0]), min(myNi[1], saved[0][1]), min(myNi[2], saved[0][2]))
+        self.assertEqual(self.lb_state(commonNi), self.common_state(saved, commonNi))
+
+        if espressopp.MPI.COMM_WORLD.rank == 0:
+            os.remove(filename)
+
+    # a fresh system and LB fluid on the given nodeGrid
+    def make_lb(self, nodeGrid):
+        system, integrator = espressopp.standard_system.LennardJones(0, box=(Ni, Ni, Ni), temperature=temperature)
+        lb = espressopp.integrator.LatticeBoltzmann(system, nodeGrid)
+        integrator.addExtension(lb)
+
+        self.system = system
+        self.lb = lb
+        self.integrator = integrator
+
+    # the moments and populations of the real sites of the first CPU, which
+    # are in the box of myNi sites (halo included)
+    def lb_state(self, myNi):
+        halo = 1
+        sites = [Int3D(i,j,k) for i in range (halo, myNi[0]-halo)
+                              for j in range (halo, myNi[1]-halo)
+                              for k in range (halo, myNi[2]-halo)]
+        return ((myNi[0], myNi[1], myNi[2]), [[self.lb.getLBMom(s, m) for m in range (4)] +
+                       [self.lb.getPops(s, l) for l in range (19)] for s in sites])
+
+    # the part of a state within a smaller box of sites
+    def common_state(self, state, commonNi):
+        myNi, values = state
+        halo = 1
+        idx = [((i - halo) * (myNi[1] - 2*halo) + j - halo) * (myNi[2] - 2*halo) + k - halo
+               for i in range (halo, commonNi[0]-halo)
+               for j in range (halo, commonNi[1]-halo)
+               for k in range (halo, commonNi[2]-halo)]
+        return ((commonNi[0], commonNi[1], commonNi[2]), [values[n] for n in idx])
+
     def check_averages(self, _v):
         # variables to hold average density and mass flux
         av_den = 0.
@@ -0,0 +1,55 @@
+import espressopp
+import mpi4py.MPI as MPI
+from espressopp import Int3D
+from espressopp import Real3D
+
+import unittest
+import math
+
+# a shear wave v_z(x) = u0 * sin(2 pi x / Ni) of the athermal fluid decays
+# as exp(-nu k^2 t). With gamma_s = 0 the kinematic viscosity is
+# nu = (1 + gamma_s) / (6 (1 - gamma_s)) = 1/6 in lattice units.
+runSteps = 50
+Ni = 16
+initDen = 1.
+initVelSin = 0.01
+gammaS = 0.
+
+class TestShearWaveLB(unittest.TestCase):
+    def setUp(self):
+        system, integrator = espressopp.standard_system.LennardJones(0, box=(Ni, Ni, Ni))
+        nodeGrid = espressopp.tools.decomp.nodeGrid(espressopp.MPI.COMM_WORLD.size)
+
+        lb = espressopp.integrator.LatticeBoltzmann(system, nodeGrid)
+        integrator.addExtension(lb)
+        lb.gamma_s = gammaS
+
+        initPop = espressopp.integrator.LBInitPopWave(system, lb)
+        initPop.createDenVel(initDen, Real3D(0., 0., initVelSin))
+
+        self.lb = lb
+        self.integrator = integrator
+
+    def test_decay(self):
+        print "Checking the decay of a shear wave against its analytic solution"
+        self.integrator.run(runSteps)
+
+        nu = (1. + gammaS) / (6. * (1. - gammaS))
+        k = 2. * math.pi / Ni
+        decay = math.exp(-nu * k * k * runSteps)
+
+        # the sites of the first CPU, whose first real site is the global site 0
+        halo = 1
+        myNi = self.lb.getMyNi
+        for i in range (halo, myNi[0]-halo):
+            jz_ref = initDen * initVelSin * decay * math.sin(k * (i - halo))
+            for j in range (halo, myNi[1]-halo):
+                for k_ in range (halo, myNi[2]-halo):
+                    site = Int3D(i,j,k_)
+                    self.assertAlmostEqual(self.lb.getLBMom(site, 0), initDen, places=8)
+                    self.assertAlmostEqual(self.lb.getLBMom(site, 1), 0., places=8)
+                    self.assertAlmostEqual(self.lb.getLBMom(site, 2), 0., places=8)
+                    self.assertAlmostEqual(self.lb.getLBMom(site, 3), jz_ref, delta=0.01*initVelSin)
+
+if __name__ == '__main__':
+    unittest.main()
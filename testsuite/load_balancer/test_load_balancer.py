@@ -0,0 +1,114 @@
+#  Copyright (C) 2017
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+import unittest
+
+import espressopp
+
+box = (12., 12., 12.)
+rc = 1.12
+skin = 0.3
+
+
+class TestLoadBalancer(unittest.TestCase):
+    def setUp(self):
+        self.system, self.integrator = espressopp.standard_system.LennardJones(
+            500, box, rc=rc, skin=skin, dt=0.001, temperature=1.0)
+
+    def test_domain_bounds(self):
+        storage = self.system.storage
+        node_grid = storage.getNodeGrid()
+        for axis in range(3):
+            bounds = storage.getDomainBounds(axis)
+            self.assertEqual(len(bounds), node_grid[axis] + 1)
+            self.assertAlmostEqual(bounds[0], 0.0)
+            self.assertAlmostEqual(bounds[-1], box[axis])
+
+    # an exception on the workers ends their PMI loop
+    @unittest.skipIf(espressopp.MPI.COMM_WORLD.size > 1, "raises on all CPUs")
+    def test_domain_bounds_mismatch(self):
+        storage = self.system.storage
+        # one boundary too few along x
+        bounds = [storage.getDomainBounds(axis) for axis in range(3)]
+        bounds[0] = bounds[0][:-1]
+        self.assertRaises(Exception, storage.setDomainBounds, *bounds)
+
+    def test_particles_conserved(self):
+        balancer = espressopp.integrator.LoadBalancer(self.system, interval=10,
+                                                      threshold=0.0, damping=1.0)
+        self.integrator.addExtension(balancer)
+        self.integrator.run(100)
+        balancer.balance()
+        self.assertGreaterEqual(balancer.imbalance, 0.0)
+        self.assertEqual(int(espressopp.analysis.NPart(self.system).compute()), 500)
+
+    def test_bounds_after_balance(self):
+        balancer = espressopp.integrator.LoadBalancer(self.system, interval=10,
+                                                      threshold=0.0, damping=1.0)
+        self.integrator.addExtension(balancer)
+        self.integrator.run(100)
+        balancer.balance()
+        storage = self.system.storage
+        node_grid = storage.getNodeGrid()
+        for axis in range(3):
+            bounds = storage.getDomainBounds(axis)
+            self.assertEqual(len(bounds), node_grid[axis] + 1)
+            self.assertAlmostEqual(bounds[0], 0.0)
+            self.assertAlmostEqual(bounds[-1], box[axis])
+            for j in range(node_grid[axis]):
+                self.assertGreaterEqual(bounds[j + 1] - bounds[j], rc + skin - 1e-10)
+
+    def test_balance_axis(self):
+        balancer = espressopp.integrator.LoadBalancer(self.system, threshold=0.0, damping=1.0)
+        bounds = [0.0, 4.0, 8.0, 12.0]
+        # the boundaries split the cumulative load into thirds
+        new_bounds = balancer.balanceAxis(bounds, [3.0, 1.0, 1.0], 1.0)
+        for b, expected in zip(new_bounds, [0.0, 8.0 / 3.0, 8.0, 12.0]):
+            self.assertAlmostEqual(b, expected)
+        # no load leaves the boundaries where they are
+        new_bounds = balancer.balanceAxis(bounds, [0.0, 0.0, 0.0], 1.0)
+        for b, expected in zip(new_bounds, bounds):
+            self.assertAlmostEqual(b, expected)
+        # only half of the shift with damping 0.5
+        balancer.damping = 0.5
+        new_bounds = balancer.balanceAxis(bounds, [3.0, 1.0, 1.0], 1.0)
+        for b, expected in zip(new_bounds, [0.0, 10.0 / 3.0, 8.0, 12.0]):
+            self.assertAlmostEqual(b, expected)
+
+    def test_balance_axis_min_width(self):
+        balancer = espressopp.integrator.LoadBalancer(self.system, threshold=0.0, damping=1.0)
+        bounds = [0.0, 4.0, 8.0, 12.0]
+        # balanced at 1.36 and 2.72, but no domain is narrower than 3
+        new_bounds = balancer.balanceAxis(bounds, [100.0, 1.0, 1.0], 3.0)
+        for b, expected in zip(new_bounds, [0.0, 3.0, 6.0, 12.0]):
+            self.assertAlmostEqual(b, expected)
+        # the same from the other end
+        new_bounds = balancer.balanceAxis(bounds, [1.0, 1.0, 100.0], 3.0)
+        for b, expected in zip(new_bounds, [0.0, 6.0, 9.0, 12.0]):
+            self.assertAlmostEqual(b, expected)
+
+    @unittest.skipIf(espressopp.MPI.COMM_WORLD.size > 1, "raises on all CPUs")
+    def test_balance_axis_mismatch(self):
+        balancer = espressopp.integrator.LoadBalancer(self.system)
+        self.assertRaises(Exception, balancer.balanceAxis, [0.0, 4.0, 8.0, 12.0], [1.0, 1.0], 3.0)
+
+
+if __name__ == '__main__':
+    unittest.main()
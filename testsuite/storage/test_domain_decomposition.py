@@ -0,0 +1,290 @@
+#  Copyright (C) 2017
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import random
+import unittest
+
+import espressopp
+
+# initial parameters of the simulation
+L              = 8.
+box            = (L, L, L)
+rc             = 2.5
+skin           = 0.3
+num_particles  = 400
+
+
+def morton(c):
+    """interleave the bits of three integers like DomainDecomposition::sortRealCells"""
+    key = 0
+    for b in range(21):
+        for d in range(3):
+            key |= ((c[d] >> b) & 1) << (3 * b + d)
+    return key
+
+
+# an exception on the workers ends their PMI loop, so the error checks
+# run on one CPU only
+single_cpu = unittest.skipIf(espressopp.MPI.COMM_WORLD.size > 1, "raises on all CPUs")
+
+
+class makeConf(unittest.TestCase):
+    def setUp(self):
+        system, integrator = espressopp.standard_system.Default(box, rc=rc, skin=skin, dt=0.005)
+
+        random.seed(1234)
+        props = ['id', 'type', 'pos', 'v']
+        new_particles = []
+        # jittered lattice, so that no two particles come too close
+        for pid in range(1, num_particles + 1):
+            i, j, k = (pid - 1) % 8, ((pid - 1) / 8) % 8, (pid - 1) / 64
+            pos = espressopp.Real3D(i + 0.5 + random.uniform(-0.1, 0.1),
+                                    j + 0.5 + random.uniform(-0.1, 0.1),
+                                    k + 0.5 + random.uniform(-0.1, 0.1))
+            v = espressopp.Real3D(random.gauss(0., 1.), random.gauss(0., 1.), random.gauss(0., 1.))
+            new_particles.append([pid, pid % 2, pos, v])
+        system.storage.addParticles(new_particles, *props)
+        system.storage.decompose()
+
+        self.system = system
+        self.integrator = integrator
+
+    def setLJ(self):
+        interaction = espressopp.interaction.VerletListLennardJones(espressopp.VerletList(self.system, cutoff=rc))
+        interaction.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(1.0, 1.0, rc))
+        interaction.setPotential(type1=0, type2=1, potential=espressopp.interaction.LennardJones(1.2, 0.9, rc))
+        interaction.setPotential(type1=1, type2=1, potential=espressopp.interaction.LennardJones(0.8, 1.1, rc))
+        self.system.addInteraction(interaction)
+
+    def setBonds(self):
+        # chains along the rows of the lattice
+        pairs = [(pid, pid + 1) for pid in range(1, num_particles) if pid % 8 != 0]
+        bonds = espressopp.FixedPairList(self.system.storage)
+        bonds.addBonds(pairs)
+        interaction = espressopp.interaction.FixedPairListHarmonic(
+            self.system, bonds, potential=espressopp.interaction.Harmonic(K=30.0, r0=1.0))
+        self.system.addInteraction(interaction)
+        return bonds, pairs
+
+    def forces(self):
+        self.integrator.run(0)
+        return [self.system.storage.getParticle(pid).f for pid in range(1, num_particles + 1)]
+
+    def compare_forces(self, forces, reference):
+        for f, ref_f in zip(forces, reference):
+            for k in range(3):
+                self.assertAlmostEqual(f[k], ref_f[k], places=10)
+
+    def positions(self):
+        return dict((pid, self.system.storage.getParticle(pid).pos) for pid in range(1, num_particles + 1))
+
+
+class TestDomainDecomposition(makeConf):
+    def check_particle_arrays(self, velocities):
+        entries = [e for data in self.system.storage.getParticleArraysData() for e in data]
+        reals = [e for e in entries if not e[3]]
+        self.assertEqual(sorted(e[0] for e in reals), range(1, num_particles + 1))
+        self.assertGreater(len(entries), len(reals))
+
+        positions = self.positions()
+        for pid, pos, v, ghost in entries:
+            for k in range(3):
+                # ghosts are periodic images of the real particle
+                shift = (pos[k] - positions[pid][k]) / L
+                self.assertAlmostEqual(shift, 0.0 if not ghost else round(shift), places=10)
+            if velocities and not ghost:
+                ref_v = self.system.storage.getParticle(pid).v
+                for k in range(3):
+                    self.assertAlmostEqual(v[k], ref_v[k], places=12)
+
+    def test_particle_arrays(self):
+        # the arrays are not kept by default
+        self.assertEqual(sum(len(data) for data in self.system.storage.getParticleArraysData()), 0)
+        self.system.storage.useParticleArrays = True
+        self.check_particle_arrays(velocities=True)
+
+        self.system.storage.decompose()
+        self.check_particle_arrays(velocities=True)
+
+        # the ghost updates of the steps refresh the positions only
+        self.integrator.run(20)
+        self.check_particle_arrays(velocities=False)
+
+    def test_flat_ghost_comm(self):
+        self.setLJ()
+        reference = self.forces()
+        self.system.storage.flatGhostComm = True
+        self.system.storage.decompose()
+        self.compare_forces(self.forces(), reference)
+        # the ghost updates of the steps use the flat buffers as well
+        self.integrator.run(10)
+        reference = [self.system.storage.getParticle(pid).f for pid in range(1, num_particles + 1)]
+        self.system.storage.flatGhostComm = False
+        self.compare_forces(self.forces(), reference)
+
+    def test_shared_ghost_comm(self):
+        self.setLJ()
+        reference = self.forces()
+        self.system.storage.flatGhostComm = True
+        self.system.storage.sharedGhostComm = True
+        self.system.storage.decompose()
+        self.compare_forces(self.forces(), reference)
+        # the neighbors on the same node read the ghosts in place during the steps
+        self.integrator.run(10)
+        reference = [self.system.storage.getParticle(pid).f for pid in range(1, num_particles + 1)]
+        self.system.storage.sharedGhostComm = False
+        self.compare_forces(self.forces(), reference)
+
+    @single_cpu
+    def test_shared_ghost_comm_needs_flat(self):
+        storage = self.system.storage
+        self.assertRaises(ValueError, setattr, storage, 'sharedGhostComm', True)
+        self.assertFalse(storage.sharedGhostComm)
+        storage.flatGhostComm = True
+        storage.sharedGhostComm = True
+        self.assertRaises(ValueError, setattr, storage, 'flatGhostComm', False)
+        self.assertTrue(storage.flatGhostComm)
+
+    def test_overlap(self):
+        self.setLJ()
+        # an extension that adds its forces right after the initialization
+        group = espressopp.ParticleGroup(self.system.storage)
+        for pid in range(1, num_particles + 1, 3):
+            group.add(pid)
+        ext_force = espressopp.integrator.ExtForce(self.system, espressopp.Real3D(0.3, -0.2, 0.1), group)
+        self.integrator.addExtension(ext_force)
+        reference = self.forces()
+
+        self.system.storage.flatGhostComm = True
+        self.system.storage.decompose()
+        self.integrator.overlapCommunication = True
+        self.compare_forces(self.forces(), reference)
+        # the steps split the real pairs around the ghost communication as well
+        self.integrator.run(10)
+        reference = [self.system.storage.getParticle(pid).f for pid in range(1, num_particles + 1)]
+        self.integrator.overlapCommunication = False
+        self.compare_forces(self.forces(), reference)
+
+    def test_eighth_shell(self):
+        self.setLJ()
+        reference = self.forces()
+        vl = espressopp.VerletList(self.system, cutoff=rc)
+        ref_size = vl.totalSize()
+
+        # pairs of two ghosts, also of other CPUs, are computed here now
+        self.system.storage.eighthShell = True
+        self.assertEqual(vl.totalSize(), ref_size)
+        self.compare_forces(self.forces(), reference)
+        # and so are the steps
+        self.integrator.run(10)
+        reference = [self.system.storage.getParticle(pid).f for pid in range(1, num_particles + 1)]
+        self.system.storage.eighthShell = False
+        self.compare_forces(self.forces(), reference)
+
+    @single_cpu
+    def test_eighth_shell_bonds(self):
+        storage = self.system.storage
+        # bonds need the ghosts of all neighbors
+        storage.eighthShell = True
+        self.assertRaises(RuntimeError, espressopp.FixedPairList, storage)
+        storage.eighthShell = False
+        bonds = espressopp.FixedPairList(storage)
+        bonds.add(1, 2)
+        self.assertRaises(RuntimeError, setattr, storage, 'eighthShell', True)
+        self.assertFalse(storage.eighthShell)
+
+    def test_direct_migration(self):
+        storage = self.system.storage
+        self.setLJ()
+        bonds, pairs = self.setBonds()
+        reference = self.forces()
+        start = [(pid, storage.getParticle(pid).pos, storage.getParticle(pid).v)
+                 for pid in range(1, num_particles + 1)]
+        self.integrator.run(50)
+        ref_positions = self.positions()
+
+        # the same steps with the particles sent directly to their CPUs
+        for pid, pos, v in start:
+            storage.modifyParticle(pid, 'pos', pos)
+            storage.modifyParticle(pid, 'v', v)
+        storage.directMigration = True
+        storage.decompose()
+        self.compare_forces(self.forces(), reference)
+        self.integrator.run(50)
+        positions = self.positions()
+        for pid in range(1, num_particles + 1):
+            for k in range(3):
+                self.assertAlmostEqual(positions[pid][k], ref_positions[pid][k], places=8)
+
+        # a shift by more than one domain keeps all particles and bonds
+        reference = self.forces()
+        shift = espressopp.Real3D(3.0, -5.0, 4.5)
+        for pid in range(1, num_particles + 1):
+            storage.modifyParticle(pid, 'pos', positions[pid] + shift)
+        storage.decompose()
+        self.assertEqual(int(espressopp.analysis.NPart(self.system).compute()), num_particles)
+        self.assertEqual(sorted(tuple(b) for local in bonds.getBonds() for b in local), pairs)
+        self.compare_forces(self.forces(), reference)
+
+    def test_dense_id_limit(self):
+        storage = self.system.storage
+        self.setLJ()
+        reference = self.forces()
+        positions = self.positions()
+
+        # half of the ids in the flat array, the others in the hash table
+        storage.denseIdLimit = num_particles // 2
+        storage.decompose()
+        self.compare_forces(self.forces(), reference)
+
+        # moving all ids between the array and the hash table loses none
+        storage.denseIdLimit = 0
+        storage.denseIdLimit = 2 * num_particles
+        for pid in range(1, num_particles + 1):
+            self.assertTrue(storage.particleExists(pid))
+            self.assertEqual(storage.getParticle(pid).id, pid)
+        self.assertFalse(storage.particleExists(num_particles + 1))
+        self.assertEqual(self.positions(), positions)
+
+    def test_morton_sort(self):
+        storage = self.system.storage
+        self.setLJ()
+        reference = self.forces()
+
+        storage.sortInterval = 1
+        storage.decompose()
+        self.compare_forces(self.forces(), reference)
+
+        # the real particles of each CPU, in cell order, follow the curve
+        node_grid, cell_grid = storage.getNodeGrid(), storage.getCellGrid()
+        cell_size = [L / (node_grid[d] * cell_grid[d]) for d in range(3)]
+        for ids in storage.getRealParticleIDs():
+            pos = [storage.getParticle(pid).pos for pid in ids]
+            cells = [[int(p[d] / cell_size[d]) for d in range(3)] for p in pos]
+            # every cell holds particles, so the lowest cells are the domain corner
+            first = [min(c[d] for c in cells) for d in range(3)]
+            keys = []
+            for p, c in zip(pos, cells):
+                q = [min(int((p[d] - first[d] * cell_size[d]) / (cell_grid[d] * cell_size[d]) * 2**21), 2**21 - 1)
+                     for d in range(3)]
+                keys.append((morton([c[d] - first[d] for d in range(3)]), morton(q)))
+            self.assertEqual(keys, sorted(keys))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,182 @@
+import espressopp
+import random
+import unittest
+
+# initial parameters of the simulation
+L              = 8.
+box            = (L, L, L)
+rc             = 2.5
+skin           = 0.3
+num_particles  = 400
+
+class makeConf(unittest.TestCase):
+    def setUp(self):
+
+        system, integrator = espressopp.standard_system.Default(box, rc=rc, skin=skin, dt=0.005, temperature=1.)
+
+        random.seed(4321)
+        props = ['id', 'type', 'pos']
+        new_particles = []
+        # jittered lattice, so that no two particles come too close
+        for pid in range(1, num_particles + 1):
+            i, j, k = (pid - 1) % 8, ((pid - 1) / 8) % 8, (pid - 1) / 64
+            pos = espressopp.Real3D(i + 0.5 + random.uniform(-0.1, 0.1),
+                                    j + 0.5 + random.uniform(-0.1, 0.1),
+                                    k + 0.5 + random.uniform(-0.1, 0.1))
+            new_particles.append([pid, pid % 2, pos])
+        system.storage.addParticles(new_particles, *props)
+        system.storage.decompose()
+
+        self.system = system
+        self.integrator = integrator
+        self.vl = espressopp.VerletList(system, cutoff=rc)
+
+    def setLJ(self, interaction):
+        interaction.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(1.0, 1.0, rc))
+        interaction.setPotential(type1=0, type2=1, potential=espressopp.interaction.LennardJones(1.2, 0.9, rc))
+        interaction.setPotential(type1=1, type2=1, potential=espressopp.interaction.LennardJones(0.8, 1.1, rc))
+        self.system.addInteraction(interaction)
+
+    def setLJcos(self, interaction):
+        interaction.setPotential(type1=0, type2=0, potential=espressopp.interaction.LJcos(phi=1.0))
+        interaction.setPotential(type1=0, type2=1, potential=espressopp.interaction.LJcos(phi=0.5))
+        interaction.setPotential(type1=1, type2=1, potential=espressopp.interaction.LJcos(phi=0.2))
+        self.system.addInteraction(interaction)
+
+    def setMorse(self, interaction):
+        interaction.setPotential(type1=0, type2=0, potential=espressopp.interaction.Morse(1.0, 2.0, 1.1, rc))
+        interaction.setPotential(type1=0, type2=1, potential=espressopp.interaction.Morse(0.5, 1.5, 1.2, rc))
+        interaction.setPotential(type1=1, type2=1, potential=espressopp.interaction.Morse(0.8, 2.5, 1.0, rc))
+        self.system.addInteraction(interaction)
+
+    def setLJGeneric(self, interaction):
+        LJGeneric = espressopp.interaction.LennardJonesGeneric
+        interaction.setPotential(type1=0, type2=0, potential=LJGeneric(1.0, 1.0, 12, 6, rc))
+        interaction.setPotential(type1=0, type2=1, potential=LJGeneric(1.2, 0.9, 9, 6, rc))
+        interaction.setPotential(type1=1, type2=1, potential=LJGeneric(0.8, 1.1, 10, 4, rc))
+        self.system.addInteraction(interaction)
+
+    def compute(self):
+        # energy, virial and the forces of the first step
+        self.integrator.run(0)
+        energy = espressopp.analysis.EnergyPot(self.system).compute()
+        pressure = espressopp.analysis.PressureTensor(self.system).compute()
+        forces = [self.system.storage.getParticle(pid).f for pid in range(1, num_particles + 1)]
+        return energy, pressure, forces
+
+    def reference(self, setPotentials=None, interaction=None):
+        if setPotentials is None:
+            setPotentials, interaction = self.setLJ, espressopp.interaction.VerletListLennardJones
+        setPotentials(interaction(self.vl))
+        result = self.compute()
+        self.system.removeInteraction(0)
+        return result
+
+    def compare(self, result, reference):
+        energy, pressure, forces = result
+        ref_energy, ref_pressure, ref_forces = reference
+        self.assertAlmostEqual(energy, ref_energy, places=8)
+        for k in range(6):
+            self.assertAlmostEqual(pressure[k], ref_pressure[k], places=8)
+        for f, ref_f in zip(forces, ref_forces):
+            for k in range(3):
+                self.assertAlmostEqual(f[k], ref_f[k], places=8)
+
+class TestVerletListKernels(makeConf):
+    def test_threaded(self):
+        reference = self.reference()
+        interaction = espressopp.interaction.VerletListThreadedLennardJones(self.vl)
+        interaction.numThreads = 2
+        self.setLJ(interaction)
+        self.compare(self.compute(), reference)
+
+    def test_packed(self):
+        reference = self.reference()
+        vl = espressopp.PackedVerletList(self.system, cutoff=rc)
+        self.assertEqual(vl.totalSize(), self.vl.totalSize())
+        self.setLJ(espressopp.interaction.PackedVerletListLennardJones(vl))
+        self.compare(self.compute(), reference)
+
+    def test_packed_pressure_layer(self):
+        # the first layer is closer to the box boundary than the cutoff
+        layers = (0.3, 4.1)
+        self.setLJ(espressopp.interaction.VerletListLennardJones(self.vl))
+        reference = [espressopp.analysis.PressureTensorLayer(self.system, z, 0.5).compute() for z in layers]
+        self.system.removeInteraction(0)
+        vl = espressopp.PackedVerletList(self.system, cutoff=rc)
+        self.setLJ(espressopp.interaction.PackedVerletListLennardJones(vl))
+        for z, ref_p in zip(layers, reference):
+            p = espressopp.analysis.PressureTensorLayer(self.system, z, 0.5).compute()
+            for k in range(6):
+                self.assertAlmostEqual(p[k], ref_p[k], places=8)
+
+    def test_packed_ljcos(self):
+        reference = self.reference(self.setLJcos, espressopp.interaction.VerletListLJcos)
+        vl = espressopp.PackedVerletList(self.system, cutoff=rc)
+        self.setLJcos(espressopp.interaction.PackedVerletListLJcos(vl))
+        self.compare(self.compute(), reference)
+
+    def test_packed_lj_generic(self):
+        reference = self.reference(self.setLJGeneric, espressopp.interaction.VerletListLennardJonesGeneric)
+        vl = espressopp.PackedVerletList(self.system, cutoff=rc)
+        self.setLJGeneric(espressopp.interaction.PackedVerletListLennardJonesGeneric(vl))
+        self.compare(self.compute(), reference)
+
+    def test_packed_morse(self):
+        reference = self.reference(self.setMorse, espressopp.interaction.VerletListMorse)
+        vl = espressopp.PackedVerletList(self.system, cutoff=rc)
+        self.setMorse(espressopp.interaction.PackedVerletListMorse(vl))
+        self.compare(self.compute(), reference)
+
+    def pair_set(self, vl):
+        return set(frozenset(pair) for pairs in vl.getAllPairs() for pair in pairs)
+
+    def test_inplace_rebuild(self):
+        self.setLJ(espressopp.interaction.VerletListLennardJones(self.vl))
+        # the lattice keeps the particles far from the cell boundaries, so
+        # the first rebuild after moving half the skin is done in place
+        self.integrator.run(0)
+        resorts = self.integrator.getNumResorts()
+        for step in range(500):
+            self.integrator.run(1)
+            if self.integrator.getNumRebuilds() > 0:
+                break
+        self.assertEqual(self.integrator.getNumRebuilds(), 1)
+        self.assertEqual(self.integrator.getNumResorts(), resorts)
+        inplace = self.pair_set(self.vl)
+        self.assertEqual(len(inplace), self.vl.totalSize())
+
+        # the full rebuild after redistributing the particles finds the same pairs
+        self.system.storage.decompose()
+        self.assertEqual(self.pair_set(self.vl), inplace)
+
+    def test_overlap(self):
+        reference = self.reference()
+        self.system.storage.flatGhostComm = True
+        self.system.storage.decompose()
+        self.integrator.overlapCommunication = True
+        self.setLJ(espressopp.interaction.VerletListLennardJones(self.vl))
+        self.compare(self.compute(), reference)
+
+    def test_eighth_shell_packed(self):
+        ref_size = self.vl.totalSize()
+        reference = self.reference()
+        self.system.storage.eighthShell = True
+        vl = espressopp.PackedVerletList(self.system, cutoff=rc)
+        self.assertEqual(vl.totalSize(), ref_size)
+        self.setLJ(espressopp.interaction.PackedVerletListLennardJones(vl))
+        self.compare(self.compute(), reference)
+
+    def test_cell_subdivision(self):
+        ref_size = self.vl.totalSize()
+        reference = self.reference()
+        for subdivision in (3, 2):
+            self.system.storage.cellSubdivision = subdivision
+            self.assertEqual(self.vl.totalSize(), ref_size)
+        self.system.storage.eighthShell = True
+        self.assertEqual(self.vl.totalSize(), ref_size)
+        self.setLJ(espressopp.interaction.VerletListLennardJones(self.vl))
+        self.compare(self.compute(), reference)
+
+if __name__ == '__main__':
+    unittest.main()